@@ -0,0 +1,356 @@
+// Content-addressed, deduplicated backup store for save slots and base data files.
+#include "backup_store.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include "pm3_defs.hh"
+#include "save_journal.h"
+
+namespace backup_store {
+
+namespace {
+constexpr const char *kManifestHeader = "PM3000-BACKUP 1";
+constexpr const char *kManifestExtension = ".man";
+constexpr std::size_t kDefaultChunkSize = 4096;
+
+// MurmurHash3 x64_128 (public domain, Austin Appleby). Not cryptographic, but 128 bits keeps accidental
+// collisions out of reach for the few thousand chunks a PM3 folder produces.
+uint64_t rotl64(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+uint64_t fmix64(uint64_t k) {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+std::string hash128(const uint8_t *data, std::size_t len) {
+    const std::size_t nblocks = len / 16;
+    uint64_t h1 = 0x504d33303030ULL; // "PM3000"
+    uint64_t h2 = 0x504d33303030ULL;
+    const uint64_t c1 = 0x87c37b91114253d5ULL;
+    const uint64_t c2 = 0x4cf5ad432745937fULL;
+
+    for (std::size_t i = 0; i < nblocks; ++i) {
+        uint64_t k1;
+        uint64_t k2;
+        std::memcpy(&k1, data + i * 16, 8);
+        std::memcpy(&k2, data + i * 16 + 8, 8);
+
+        k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; h1 ^= k1;
+        h1 = rotl64(h1, 27); h1 += h2; h1 = h1 * 5 + 0x52dce729;
+        k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2 ^= k2;
+        h2 = rotl64(h2, 31); h2 += h1; h2 = h2 * 5 + 0x38495ab5;
+    }
+
+    const uint8_t *tail = data + nblocks * 16;
+    uint64_t k1 = 0;
+    uint64_t k2 = 0;
+    switch (len & 15) {
+        case 15: k2 ^= static_cast<uint64_t>(tail[14]) << 48; [[fallthrough]];
+        case 14: k2 ^= static_cast<uint64_t>(tail[13]) << 40; [[fallthrough]];
+        case 13: k2 ^= static_cast<uint64_t>(tail[12]) << 32; [[fallthrough]];
+        case 12: k2 ^= static_cast<uint64_t>(tail[11]) << 24; [[fallthrough]];
+        case 11: k2 ^= static_cast<uint64_t>(tail[10]) << 16; [[fallthrough]];
+        case 10: k2 ^= static_cast<uint64_t>(tail[9]) << 8; [[fallthrough]];
+        case 9: k2 ^= static_cast<uint64_t>(tail[8]);
+            k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2 ^= k2;
+            [[fallthrough]];
+        case 8: k1 ^= static_cast<uint64_t>(tail[7]) << 56; [[fallthrough]];
+        case 7: k1 ^= static_cast<uint64_t>(tail[6]) << 48; [[fallthrough]];
+        case 6: k1 ^= static_cast<uint64_t>(tail[5]) << 40; [[fallthrough]];
+        case 5: k1 ^= static_cast<uint64_t>(tail[4]) << 32; [[fallthrough]];
+        case 4: k1 ^= static_cast<uint64_t>(tail[3]) << 24; [[fallthrough]];
+        case 3: k1 ^= static_cast<uint64_t>(tail[2]) << 16; [[fallthrough]];
+        case 2: k1 ^= static_cast<uint64_t>(tail[1]) << 8; [[fallthrough]];
+        case 1: k1 ^= static_cast<uint64_t>(tail[0]);
+            k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; h1 ^= k1;
+            break;
+        default:
+            break;
+    }
+
+    h1 ^= len;
+    h2 ^= len;
+    h1 += h2;
+    h2 += h1;
+    h1 = fmix64(h1);
+    h2 = fmix64(h2);
+    h1 += h2;
+    h2 += h1;
+
+    char text[33];
+    std::snprintf(text, sizeof(text), "%016llx%016llx", static_cast<unsigned long long>(h1),
+                  static_cast<unsigned long long>(h2));
+    return text;
+}
+
+std::vector<uint8_t> readBytes(const std::filesystem::path &path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Could not read backup file: " + path.string());
+    }
+    return std::vector<uint8_t>((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+struct ManifestFile {
+    std::string fileName;
+    std::size_t size = 0;
+    std::vector<std::string> chunks;
+};
+
+struct Manifest {
+    std::time_t created = 0;
+    std::vector<ManifestFile> files;
+};
+
+std::string manifestBody(const std::vector<ManifestFile> &files) {
+    std::ostringstream body;
+    for (const auto &file : files) {
+        body << "file " << file.fileName << " " << file.size << "\n";
+        for (const auto &chunk : file.chunks) {
+            body << chunk << "\n";
+        }
+    }
+    body << "end\n";
+    return body.str();
+}
+
+bool readManifest(const std::filesystem::path &path, Manifest &manifest) {
+    std::ifstream in(path);
+    std::string line;
+    if (!std::getline(in, line) || line != kManifestHeader) {
+        return false;
+    }
+
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string tag;
+        fields >> tag;
+        if (tag == "created") {
+            long long created = 0;
+            fields >> created;
+            manifest.created = static_cast<std::time_t>(created);
+        } else if (tag == "file") {
+            ManifestFile file;
+            fields >> file.fileName >> file.size;
+            manifest.files.push_back(file);
+        } else if (tag == "end") {
+            return true;
+        } else if (tag.size() == 32 && !manifest.files.empty()) {
+            manifest.files.back().chunks.push_back(tag);
+        } else {
+            return false;
+        }
+    }
+    return false;
+}
+
+std::vector<uint32_t> listVersions(const std::filesystem::path &setDir) {
+    std::vector<uint32_t> ids;
+    std::error_code ec;
+    for (const auto &entry : std::filesystem::directory_iterator(setDir, ec)) {
+        if (entry.path().extension() != kManifestExtension) {
+            continue;
+        }
+        unsigned long id = std::strtoul(entry.path().stem().string().c_str(), nullptr, 10);
+        if (id > 0) {
+            ids.push_back(static_cast<uint32_t>(id));
+        }
+    }
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+} // namespace
+
+std::string slotSetName(int gameNumber) {
+    return std::string{kGameFilePrefix} + std::to_string(gameNumber);
+}
+
+std::size_t chunkSizeFor(std::size_t fileSize) {
+    switch (fileSize) {
+        case sizeof(gameb):
+            return sizeof(ClubRecord) * 7;
+        case sizeof(gamec):
+            return sizeof(PlayerRecord) * 100;
+        default:
+            return kDefaultChunkSize;
+    }
+}
+
+Store::Store(std::filesystem::path root) : rootDir(std::move(root)) {}
+
+std::filesystem::path Store::manifestPath(const std::string &set, uint32_t version) const {
+    char name[16];
+    std::snprintf(name, sizeof(name), "%08u", version);
+    return rootDir / "versions" / set / (std::string{name} + kManifestExtension);
+}
+
+std::filesystem::path Store::chunkPath(const std::string &hash) const {
+    return rootDir / "chunks" / hash.substr(0, 2) / hash;
+}
+
+SnapshotResult Store::snapshot(const std::string &set, const std::vector<std::filesystem::path> &files) {
+    SnapshotResult result;
+    std::vector<ManifestFile> manifestFiles;
+    std::error_code ec;
+
+    for (const auto &path : files) {
+        if (!std::filesystem::exists(path, ec)) {
+            continue;
+        }
+        std::vector<uint8_t> bytes = readBytes(path);
+        ManifestFile file;
+        file.fileName = path.filename().string();
+        file.size = bytes.size();
+
+        const std::size_t chunkSize = chunkSizeFor(bytes.size());
+        for (std::size_t offset = 0; offset < bytes.size(); offset += chunkSize) {
+            std::size_t len = std::min(chunkSize, bytes.size() - offset);
+            std::string hash = hash128(bytes.data() + offset, len);
+            std::filesystem::path chunk = chunkPath(hash);
+            if (!std::filesystem::exists(chunk, ec)) {
+                std::filesystem::create_directories(chunk.parent_path());
+                save_journal::replaceFileDurably(chunk, bytes.data() + offset, len);
+                ++result.newChunks;
+                result.newBytes += len;
+            }
+            file.chunks.push_back(std::move(hash));
+        }
+        manifestFiles.push_back(std::move(file));
+    }
+
+    if (manifestFiles.empty()) {
+        return result;
+    }
+
+    std::string body = manifestBody(manifestFiles);
+    uint32_t latest = latestVersion(set);
+    if (latest != 0) {
+        Manifest previous;
+        if (readManifest(manifestPath(set, latest), previous) && manifestBody(previous.files) == body) {
+            result.version = latest;
+            result.unchanged = true;
+            return result;
+        }
+    }
+
+    std::ostringstream text;
+    text << kManifestHeader << "\n" << "created " << static_cast<long long>(std::time(nullptr)) << "\n" << body;
+    std::string manifest = text.str();
+
+    result.version = latest + 1;
+    std::filesystem::path path = manifestPath(set, result.version);
+    std::filesystem::create_directories(path.parent_path());
+    save_journal::replaceFileDurably(path, manifest.data(), manifest.size());
+    save_journal::syncDirectory(path.parent_path());
+    return result;
+}
+
+std::vector<VersionInfo> Store::versions(const std::string &set) const {
+    std::vector<VersionInfo> infos;
+    for (uint32_t id : listVersions(rootDir / "versions" / set)) {
+        Manifest manifest;
+        if (!readManifest(manifestPath(set, id), manifest)) {
+            continue;
+        }
+        VersionInfo info;
+        info.id = id;
+        info.created = manifest.created;
+        for (const auto &file : manifest.files) {
+            info.totalBytes += file.size;
+        }
+        infos.push_back(info);
+    }
+    return infos;
+}
+
+uint32_t Store::latestVersion(const std::string &set) const {
+    std::vector<uint32_t> ids = listVersions(rootDir / "versions" / set);
+    return ids.empty() ? 0 : ids.back();
+}
+
+std::vector<FileImage> Store::read(const std::string &set, uint32_t version) const {
+    Manifest manifest;
+    if (!readManifest(manifestPath(set, version), manifest)) {
+        throw std::runtime_error("Backup version " + std::to_string(version) + " of " + set + " not found");
+    }
+
+    std::vector<FileImage> images;
+    for (const auto &file : manifest.files) {
+        FileImage image;
+        image.fileName = file.fileName;
+        image.contents.reserve(file.size);
+        for (const auto &hash : file.chunks) {
+            std::vector<uint8_t> chunk = readBytes(chunkPath(hash));
+            if (hash128(chunk.data(), chunk.size()) != hash) {
+                throw std::runtime_error("Corrupt backup chunk " + hash);
+            }
+            image.contents.insert(image.contents.end(), chunk.begin(), chunk.end());
+        }
+        if (image.contents.size() != file.size) {
+            throw std::runtime_error("Backup of " + file.fileName + " has the wrong size");
+        }
+        images.push_back(std::move(image));
+    }
+    return images;
+}
+
+std::size_t Store::prune(const std::string &set, std::size_t keep) {
+    std::vector<uint32_t> ids = listVersions(rootDir / "versions" / set);
+    if (ids.size() <= keep) {
+        return 0;
+    }
+
+    std::size_t removed = 0;
+    std::error_code ec;
+    for (std::size_t i = 0; i + keep < ids.size(); ++i) {
+        removed += std::filesystem::remove(manifestPath(set, ids[i]), ec) ? 1 : 0;
+    }
+    return removed;
+}
+
+std::size_t Store::collectGarbage() {
+    std::set<std::string> live;
+    std::error_code ec;
+    for (const auto &setDir : std::filesystem::directory_iterator(rootDir / "versions", ec)) {
+        for (uint32_t id : listVersions(setDir.path())) {
+            Manifest manifest;
+            if (!readManifest(manifestPath(setDir.path().filename().string(), id), manifest)) {
+                // An unreadable manifest might still reference anything; keep every chunk.
+                return 0;
+            }
+            for (const auto &file : manifest.files) {
+                live.insert(file.chunks.begin(), file.chunks.end());
+            }
+        }
+    }
+
+    std::vector<std::filesystem::path> dead;
+    for (const auto &entry : std::filesystem::recursive_directory_iterator(rootDir / "chunks", ec)) {
+        if (entry.is_regular_file() && live.count(entry.path().filename().string()) == 0) {
+            dead.push_back(entry.path());
+        }
+    }
+
+    std::size_t removed = 0;
+    for (const auto &path : dead) {
+        removed += std::filesystem::remove(path, ec) ? 1 : 0;
+    }
+    return removed;
+}
+
+} // namespace backup_store
@@ -0,0 +1,68 @@
+// Content-addressed, deduplicated backup store for save slots and base data files.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace backup_store {
+
+inline constexpr const char *kStoreFolder = "store";
+inline constexpr std::size_t kDefaultKeepVersions = 200;
+
+struct VersionInfo {
+    uint32_t id = 0;
+    std::time_t created = 0;
+    std::size_t totalBytes = 0;
+};
+
+struct FileImage {
+    std::string fileName;
+    std::vector<uint8_t> contents;
+};
+
+struct SnapshotResult {
+    uint32_t version = 0;
+    bool unchanged = false;      // identical to the previous version, nothing new was recorded
+    std::size_t newChunks = 0;
+    std::size_t newBytes = 0;
+};
+
+// A set of files ("GAME3", "BASE", ...) is versioned as a manifest of chunk hashes. Chunks are split on
+// record boundaries where the file layout is known (7 clubs, 100 players) so an edit to one record
+// produces one new chunk, and every unique chunk is stored once across all sets and versions.
+class Store {
+public:
+    explicit Store(std::filesystem::path root);
+
+    const std::filesystem::path &root() const { return rootDir; }
+
+    // Records the current on-disk contents of `files` (missing files are skipped) as a new version of `set`.
+    SnapshotResult snapshot(const std::string &set, const std::vector<std::filesystem::path> &files);
+
+    std::vector<VersionInfo> versions(const std::string &set) const;
+    uint32_t latestVersion(const std::string &set) const;
+
+    // Reassembles a version from its chunks, verifying each chunk hash. Throws if anything is missing.
+    std::vector<FileImage> read(const std::string &set, uint32_t version) const;
+
+    // Drops all but the newest `keep` versions of `set`. Returns the number of manifests removed.
+    std::size_t prune(const std::string &set, std::size_t keep);
+
+    // Removes chunks no manifest refers to. Returns the number of chunks deleted.
+    std::size_t collectGarbage();
+
+private:
+    std::filesystem::path manifestPath(const std::string &set, uint32_t version) const;
+    std::filesystem::path chunkPath(const std::string &hash) const;
+
+    std::filesystem::path rootDir;
+};
+
+std::string slotSetName(int gameNumber);
+std::size_t chunkSizeFor(std::size_t fileSize);
+
+} // namespace backup_store
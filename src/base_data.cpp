@@ -0,0 +1,88 @@
+// The installation's pristine GAMEDATA.DAT, CLUBDATA.DAT and PLAYDATA.DAT, mapped read-only once and shared.
+#include "base_data.h"
+
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include "fat_image.h"
+#include "io.h"
+
+namespace io {
+
+namespace {
+
+constexpr std::size_t kMinimumSizes[3] = {sizeof(gamea), sizeof(gameb), sizeof(gamec)};
+
+std::mutex gBaseDataMutex;
+std::shared_ptr<const BaseData> gBaseData;
+
+} // namespace
+
+BaseData::BaseData(std::filesystem::path gamePath) : root(std::move(gamePath)) {
+    const std::string names[3] = {std::string{kGameDataFile}, std::string{kClubDataFile},
+                                  std::string{kPlayDataFile}};
+    for (int i = 0; i < 3; ++i) {
+        paths[i] = constructGameFilePath(root, names[i]);
+        std::filesystem::path image;
+        std::string inner;
+        if (splitDiskImagePath(paths[i], image, inner)) {
+            stampPaths[i] = image;
+            fat_image::Image disk(image);
+            std::optional<fat_image::Entry> entry = disk.find(inner);
+            if (!entry || entry->directory) {
+                throw std::runtime_error("Missing file: " + paths[i].string());
+            }
+            copies[i] = disk.read(*entry);
+            fileSizes[i] = copies[i].size();
+        } else {
+            stampPaths[i] = paths[i];
+            std::error_code ec;
+            fileSizes[i] = static_cast<std::size_t>(std::filesystem::file_size(paths[i], ec));
+            if (ec) {
+                throw std::runtime_error("Missing file: " + paths[i].string());
+            }
+            // Checked here, since MappedFile insists on an exact size and GAMEDATA.DAT may carry a tail.
+            if (fileSizes[i] >= kMinimumSizes[i] && !mapped[i].open(paths[i], fileSizes[i], false)) {
+                throw std::runtime_error(pm3LastError());
+            }
+        }
+        if (fileSizes[i] < kMinimumSizes[i]) {
+            throw std::runtime_error("File too small: " + paths[i].string());
+        }
+        std::error_code ec;
+        stampSizes[i] = std::filesystem::file_size(stampPaths[i], ec);
+        stampTimes[i] = std::filesystem::last_write_time(stampPaths[i], ec);
+    }
+}
+
+bool BaseData::matchesDisk() const {
+    for (int i = 0; i < 3; ++i) {
+        std::error_code ec;
+        if (std::filesystem::file_size(stampPaths[i], ec) != stampSizes[i] || ec ||
+            std::filesystem::last_write_time(stampPaths[i], ec) != stampTimes[i] || ec) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::shared_ptr<const BaseData> baseDataFor(const std::filesystem::path &gamePath) {
+    std::lock_guard<std::mutex> lock(gBaseDataMutex);
+    // Only the current folder is cached, like the installation descriptor; a hit costs three stat() calls.
+    if (!gBaseData || gBaseData->gamePath() != gamePath || !gBaseData->matchesDisk()) {
+        gBaseData.reset();
+        gBaseData = std::make_shared<const BaseData>(gamePath);
+    }
+    return gBaseData;
+}
+
+void invalidateBaseData() {
+    std::lock_guard<std::mutex> lock(gBaseDataMutex);
+    gBaseData.reset();
+}
+
+} // namespace io
@@ -0,0 +1,58 @@
+// The installation's pristine GAMEDATA.DAT, CLUBDATA.DAT and PLAYDATA.DAT, mapped read-only once and shared.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include "mapped_save.h"
+#include "pm3_defs.hh"
+
+namespace io {
+
+// Typed, read-only views of the base data, for anything that needs "the original value of X": a club's manager
+// before a team change, the club names shown before a game is loaded, or a fresh copy for the SWOS import.
+// Host files are memory-mapped; files inside a disk image are read once into memory. Throws std::runtime_error
+// if a file is missing or too small.
+class BaseData {
+public:
+    explicit BaseData(std::filesystem::path gamePath);
+
+    const std::filesystem::path &gamePath() const { return root; }
+
+    const gamea &gameA() const { return *reinterpret_cast<const gamea *>(bytes(0)); }
+    const gameb &gameB() const { return *reinterpret_cast<const gameb *>(bytes(1)); }
+    const gamec &gameC() const { return *reinterpret_cast<const gamec *>(bytes(2)); }
+    const ClubRecord &club(int clubIdx) const { return gameB().club[clubIdx]; }
+    const PlayerRecord &player(int16_t playerIdx) const { return gameC().player[playerIdx]; }
+
+    // Bytes of GAMEDATA.DAT past the gamea record, which some versions of PM3 have.
+    const uint8_t *gameaTail() const { return bytes(0) + sizeof(gamea); }
+    std::size_t gameaTailSize() const { return fileSizes[0] - sizeof(gamea); }
+
+    // True if the files (or the disk image holding them) still have the size and mtime they had when loaded.
+    bool matchesDisk() const;
+
+private:
+    const uint8_t *bytes(int file) const { return mapped[file].isOpen() ? mapped[file].data() : copies[file].data(); }
+
+    std::filesystem::path root;
+    std::filesystem::path paths[3];
+    MappedFile mapped[3];
+    std::vector<uint8_t> copies[3];
+    std::size_t fileSizes[3]{};
+    // The file itself, or the disk image it is in.
+    std::filesystem::path stampPaths[3];
+    uintmax_t stampSizes[3]{};
+    std::filesystem::file_time_type stampTimes[3]{};
+};
+
+// The store for `gamePath`, loaded on first use and reused until another folder is asked for or the base files
+// change on disk. Safe to call from the I/O worker.
+std::shared_ptr<const BaseData> baseDataFor(const std::filesystem::path &gamePath);
+// Drops the store, e.g. before the base files are rewritten; holders keep their views until they let go.
+void invalidateBaseData();
+
+} // namespace io
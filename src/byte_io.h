@@ -0,0 +1,51 @@
+// Little-endian integer packing shared by the PM3000 sidecar formats (.HST, .EDT, .LDG and patches).
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace byte_io {
+
+// Appends `value` least significant byte first, whatever the host's byte order.
+template <typename T>
+void put(std::vector<uint8_t> &out, T value) {
+    static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>);
+    auto bits = static_cast<std::make_unsigned_t<T>>(value);
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        out.push_back(static_cast<uint8_t>(bits >> (8 * i)));
+    }
+}
+
+// Reads a T stored by put() at `p`.
+template <typename T>
+T load(const uint8_t *p) {
+    static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>);
+    using Bits = std::make_unsigned_t<T>;
+    Bits bits = 0;
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        bits = static_cast<Bits>(bits | static_cast<Bits>(static_cast<Bits>(p[i]) << (8 * i)));
+    }
+    return static_cast<T>(bits);
+}
+
+// Reads a T and advances `p` past it. The caller has checked there is room.
+template <typename T>
+T get(const uint8_t *&p) {
+    T value = load<T>(p);
+    p += sizeof(T);
+    return value;
+}
+
+// Reads a T and advances `p`, or returns false without moving when fewer than sizeof(T) bytes remain.
+template <typename T>
+bool get(const uint8_t *&p, const uint8_t *end, T &value) {
+    if (static_cast<std::size_t>(end - p) < sizeof(T)) {
+        return false;
+    }
+    value = get<T>(p);
+    return true;
+}
+
+} // namespace byte_io
@@ -15,6 +15,13 @@ inline constexpr int SCREEN_HEIGHT = 400;
 inline constexpr int MARGIN_LEFT = 40;
 inline constexpr int MARGIN_TOP = 19;
 
+// Load/Save slot list: each slot is a small line with a player-sized summary line under it, so all eight fit
+// above the footer
+inline constexpr int SLOT_LIST_TOP = 73;
+inline constexpr int SLOT_ROW_HEIGHT = 28;
+inline constexpr int SLOT_SUMMARY_INDENT = 16;
+inline constexpr int SLOT_SUMMARY_OFFSET = 18;
+
 // Icon layout
 inline constexpr int ICON_WIDTH = 48;
 inline constexpr int ICON_HEIGHT = 37;
@@ -0,0 +1,134 @@
+// CRC32C (Castagnoli) checksums, using the CPU's CRC instructions when available.
+#include "crc32c.h"
+
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define PM3_CRC32C_X86 1
+#include <nmmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#define PM3_CRC32C_ARM 1
+#include <arm_acle.h>
+#endif
+
+namespace crc32c {
+
+namespace {
+
+constexpr uint32_t kPolynomial = 0x82F63B78; // reflected 0x1EDC6F41
+
+using Tables = std::array<std::array<uint32_t, 256>, 8>;
+
+Tables makeTables() {
+    Tables tables{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ ((crc & 1) ? kPolynomial : 0);
+        }
+        tables[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; ++i) {
+        for (std::size_t t = 1; t < tables.size(); ++t) {
+            tables[t][i] = (tables[t - 1][i] >> 8) ^ tables[0][tables[t - 1][i] & 0xFF];
+        }
+    }
+    return tables;
+}
+
+const Tables &tables() {
+    static const Tables kTables = makeTables();
+    return kTables;
+}
+
+uint64_t load64(const uint8_t *p) {
+    uint64_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+#if defined(PM3_CRC32C_X86)
+#if defined(__GNUC__)
+__attribute__((target("sse4.2")))
+#endif
+uint32_t extendSse42(uint32_t crc, const uint8_t *p, std::size_t size) {
+    uint64_t state = ~crc;
+    for (; size >= 8; p += 8, size -= 8) {
+        state = _mm_crc32_u64(state, load64(p));
+    }
+    auto state32 = static_cast<uint32_t>(state);
+    for (; size > 0; ++p, --size) {
+        state32 = _mm_crc32_u8(state32, *p);
+    }
+    return ~state32;
+}
+
+bool detectSse42() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 20)) != 0;
+#else
+    return __builtin_cpu_supports("sse4.2");
+#endif
+}
+#elif defined(PM3_CRC32C_ARM)
+uint32_t extendArm(uint32_t crc, const uint8_t *p, std::size_t size) {
+    uint32_t state = ~crc;
+    for (; size >= 8; p += 8, size -= 8) {
+        state = __crc32cd(state, load64(p));
+    }
+    for (; size > 0; ++p, --size) {
+        state = __crc32cb(state, *p);
+    }
+    return ~state;
+}
+#endif
+
+} // namespace
+
+uint32_t extendPortable(uint32_t crc, const void *data, std::size_t size) {
+    const Tables &t = tables();
+    const auto *p = static_cast<const uint8_t *>(data);
+    uint32_t state = ~crc;
+    // Slicing-by-8 assumes little-endian loads, which holds on every platform PM3000 builds for.
+    for (; size >= 8; p += 8, size -= 8) {
+        uint64_t word = load64(p) ^ state;
+        state = t[7][word & 0xFF] ^ t[6][(word >> 8) & 0xFF] ^ t[5][(word >> 16) & 0xFF] ^
+                t[4][(word >> 24) & 0xFF] ^ t[3][(word >> 32) & 0xFF] ^ t[2][(word >> 40) & 0xFF] ^
+                t[1][(word >> 48) & 0xFF] ^ t[0][word >> 56];
+    }
+    for (; size > 0; ++p, --size) {
+        state = (state >> 8) ^ t[0][(state ^ *p) & 0xFF];
+    }
+    return ~state;
+}
+
+bool hardwareAccelerated() {
+#if defined(PM3_CRC32C_X86)
+    static const bool kSupported = detectSse42();
+    return kSupported;
+#elif defined(PM3_CRC32C_ARM)
+    return true;
+#else
+    return false;
+#endif
+}
+
+uint32_t extend(uint32_t crc, const void *data, std::size_t size) {
+    const auto *p = static_cast<const uint8_t *>(data);
+#if defined(PM3_CRC32C_X86)
+    if (hardwareAccelerated()) {
+        return extendSse42(crc, p, size);
+    }
+#elif defined(PM3_CRC32C_ARM)
+    return extendArm(crc, p, size);
+#endif
+    return extendPortable(crc, p, size);
+}
+
+} // namespace crc32c
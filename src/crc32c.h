@@ -0,0 +1,22 @@
+// CRC32C (Castagnoli) checksums, using the CPU's CRC instructions when available.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace crc32c {
+
+// Continues `crc` (the value returned by a previous call, 0 to start) over `size` more bytes.
+uint32_t extend(uint32_t crc, const void *data, std::size_t size);
+
+inline uint32_t compute(const void *data, std::size_t size) {
+    return extend(0, data, size);
+}
+
+// The portable slicing-by-8 implementation, exposed for tests and benchmarks.
+uint32_t extendPortable(uint32_t crc, const void *data, std::size_t size);
+
+// True when extend() runs on SSE4.2 (x86-64) or ARMv8 CRC instructions.
+bool hardwareAccelerated();
+
+} // namespace crc32c
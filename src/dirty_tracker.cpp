@@ -0,0 +1,149 @@
+// Dirty-range tracking over the loaded save structs (gameData/clubData/playerData) for partial saves.
+#include "dirty_tracker.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "pm3_data.h"
+
+namespace dirty_tracker {
+
+namespace {
+// Raw spans are coalesced in place once this many have accumulated (e.g. levelAggression touching every player).
+constexpr std::size_t kCompactThreshold = 1024;
+
+std::vector<Span> gSpans[kSaveFileCount];
+WriteReport gLastWrite;
+TouchObserver gObserver = nullptr;
+
+const uint8_t *fileBase(int file) {
+    switch (file) {
+        case kGameA:
+            return reinterpret_cast<const uint8_t *>(&gameData);
+        case kGameB:
+            return reinterpret_cast<const uint8_t *>(&clubData);
+        default:
+            return reinterpret_cast<const uint8_t *>(&playerData);
+    }
+}
+
+std::vector<Span> coalesce(std::vector<Span> spans, std::size_t mergeGap) {
+    if (spans.empty()) {
+        return spans;
+    }
+
+    std::sort(spans.begin(), spans.end(), [](const Span &a, const Span &b) { return a.offset < b.offset; });
+    std::vector<Span> merged;
+    merged.push_back(spans.front());
+    for (std::size_t i = 1; i < spans.size(); ++i) {
+        Span &last = merged.back();
+        std::size_t lastEnd = last.offset + last.length;
+        if (spans[i].offset <= lastEnd + mergeGap) {
+            last.length = std::max(lastEnd, spans[i].offset + spans[i].length) - last.offset;
+        } else {
+            merged.push_back(spans[i]);
+        }
+    }
+    return merged;
+}
+} // namespace
+
+std::size_t WriteReport::total() const {
+    std::size_t sum = metadataBytes;
+    for (std::size_t bytes : bytesWritten) {
+        sum += bytes;
+    }
+    return sum;
+}
+
+std::size_t fileSize(SaveFile file) {
+    switch (file) {
+        case kGameA:
+            return sizeof(gamea);
+        case kGameB:
+            return sizeof(gameb);
+        default:
+            return sizeof(gamec);
+    }
+}
+
+void touch(const void *address, std::size_t size) {
+    const auto *bytes = static_cast<const uint8_t *>(address);
+    for (int file = 0; file < kSaveFileCount; ++file) {
+        const uint8_t *base = fileBase(file);
+        const uint8_t *end = base + fileSize(static_cast<SaveFile>(file));
+        if (bytes < base || bytes >= end) {
+            continue;
+        }
+
+        std::size_t offset = static_cast<std::size_t>(bytes - base);
+        std::size_t length = std::min<std::size_t>(size, static_cast<std::size_t>(end - bytes));
+        if (gObserver) {
+            gObserver(static_cast<SaveFile>(file), offset, length);
+        }
+        std::vector<Span> &spans = gSpans[file];
+        spans.push_back({offset, length});
+        if (spans.size() >= kCompactThreshold) {
+            spans = coalesce(std::move(spans), 0);
+        }
+        return;
+    }
+}
+
+void setTouchObserver(TouchObserver observer) {
+    gObserver = observer;
+}
+
+void touchClub(int clubIdx) {
+    if (clubIdx >= 0 && clubIdx < static_cast<int>(std::size(clubData.club))) {
+        touch(clubData.club[clubIdx]);
+    }
+}
+
+void touchPlayer(int16_t playerIdx) {
+    if (playerIdx >= 0 && playerIdx < static_cast<int16_t>(std::size(playerData.player))) {
+        touch(playerData.player[playerIdx]);
+    }
+}
+
+void markAllDirty() {
+    for (int file = 0; file < kSaveFileCount; ++file) {
+        gSpans[file].assign(1, {0, fileSize(static_cast<SaveFile>(file))});
+    }
+}
+
+void clear() {
+    for (auto &spans : gSpans) {
+        spans.clear();
+    }
+}
+
+void clear(SaveFile file) {
+    gSpans[file].clear();
+}
+
+bool isDirty(SaveFile file) {
+    return !gSpans[file].empty();
+}
+
+std::size_t dirtyBytes(SaveFile file) {
+    std::size_t total = 0;
+    for (const Span &span : coalesce(gSpans[file], 0)) {
+        total += span.length;
+    }
+    return total;
+}
+
+std::vector<Span> dirtySpans(SaveFile file, std::size_t mergeGap) {
+    return coalesce(gSpans[file], mergeGap);
+}
+
+void recordWrite(const WriteReport &report) {
+    gLastWrite = report;
+}
+
+const WriteReport &lastWrite() {
+    return gLastWrite;
+}
+
+} // namespace dirty_tracker
@@ -0,0 +1,68 @@
+// Dirty-range tracking over the loaded save structs (gameData/clubData/playerData) for partial saves.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "pm3_defs.hh"
+
+namespace dirty_tracker {
+
+enum SaveFile : int {
+    kGameA = 0,
+    kGameB = 1,
+    kGameC = 2,
+};
+
+inline constexpr int kSaveFileCount = 3;
+
+// Spans closer together than this are written as one; a few clean bytes are cheaper than another syscall.
+inline constexpr std::size_t kMergeGap = 64;
+
+struct Span {
+    std::size_t offset;
+    std::size_t length;
+};
+
+struct WriteReport {
+    std::size_t bytesWritten[kSaveFileCount] = {};
+    bool fullRewrite[kSaveFileCount] = {};
+    std::size_t metadataBytes = 0;
+
+    std::size_t total() const;
+};
+
+// Records bytes about to be modified. Call before the mutation so observers can still see the old value.
+// Addresses outside gameData/clubData/playerData are ignored, so scratch copies can be passed safely.
+// The save structs are packed: pass whole records (or byte fields) to the template, since a multi-byte
+// packed member binds to a temporary copy and would be silently ignored.
+void touch(const void *address, std::size_t size);
+
+template <typename T>
+void touch(const T &object) {
+    touch(&object, sizeof(T));
+}
+
+// Called by touch() for bytes inside the save structs, before they change. The edit journal keeps old values
+// this way. Pass nullptr to stop observing.
+using TouchObserver = void (*)(SaveFile file, std::size_t offset, std::size_t length);
+void setTouchObserver(TouchObserver observer);
+
+void touchClub(int clubIdx);
+void touchPlayer(int16_t playerIdx);
+
+void markAllDirty();
+void clear();
+// Forgets one file's spans, e.g. after it was reloaded from disk.
+void clear(SaveFile file);
+
+bool isDirty(SaveFile file);
+std::size_t dirtyBytes(SaveFile file);
+std::vector<Span> dirtySpans(SaveFile file, std::size_t mergeGap = kMergeGap);
+std::size_t fileSize(SaveFile file);
+
+void recordWrite(const WriteReport &report);
+const WriteReport &lastWrite();
+
+} // namespace dirty_tracker
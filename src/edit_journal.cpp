@@ -0,0 +1,413 @@
+// Undo/redo for edits to the loaded save (gameData/clubData/playerData), with a crash file for unsaved edits.
+#include "edit_journal.h"
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <utility>
+
+#include "config/constants.h"
+#include "byte_io.h"
+#include "crc32c.h"
+#include "dirty_tracker.h"
+#include "pm3_data.h"
+
+namespace edit_journal {
+
+namespace {
+
+constexpr char kMagic[8] = {'P', 'M', '3', 'E', 'D', 'I', 'T', 'S'};
+constexpr uint16_t kVersion = 1;
+constexpr std::size_t kHeaderSize = sizeof(kMagic) + sizeof(uint16_t) + sizeof(uint8_t) +
+                                    dirty_tracker::kSaveFileCount * sizeof(uint32_t);
+// Unchanged runs this short between two changes are kept in one Change; its header costs more.
+constexpr std::size_t kMergeGap = 8;
+
+enum RecordKind : uint8_t {
+    kStepRecord = 'S',
+    kUndoRecord = 'U',
+    kRedoRecord = 'R',
+};
+
+// Old bytes of a range touched during the open step.
+struct Capture {
+    int file;
+    std::size_t offset;
+    std::vector<uint8_t> bytes;
+};
+
+bool gOpen = false;
+std::vector<Capture> gCaptures;
+std::deque<Step> gUndo;
+std::vector<Step> gRedo;
+// The crash file being appended to; empty when there is none.
+std::filesystem::path gPath;
+const std::string kNoLabel;
+
+uint8_t *fileData(int file) {
+    switch (file) {
+        case dirty_tracker::kGameA:
+            return reinterpret_cast<uint8_t *>(&gameData);
+        case dirty_tracker::kGameB:
+            return reinterpret_cast<uint8_t *>(&clubData);
+        default:
+            return reinterpret_cast<uint8_t *>(&playerData);
+    }
+}
+
+std::size_t fileSize(int file) {
+    return dirty_tracker::fileSize(static_cast<dirty_tracker::SaveFile>(file));
+}
+
+using byte_io::get;
+using byte_io::put;
+
+// Copies the parts of [offset, offset + length) that the open step has not captured yet.
+void capture(dirty_tracker::SaveFile file, std::size_t offset, std::size_t length) {
+    if (!gOpen) {
+        return;
+    }
+    std::vector<std::pair<std::size_t, std::size_t>> pieces = {{offset, offset + length}};
+    for (const Capture &existing : gCaptures) {
+        if (existing.file != file) {
+            continue;
+        }
+        std::size_t start = existing.offset;
+        std::size_t end = existing.offset + existing.bytes.size();
+        std::vector<std::pair<std::size_t, std::size_t>> remaining;
+        for (const auto &piece : pieces) {
+            if (piece.second <= start || piece.first >= end) {
+                remaining.push_back(piece);
+                continue;
+            }
+            if (piece.first < start) {
+                remaining.emplace_back(piece.first, start);
+            }
+            if (piece.second > end) {
+                remaining.emplace_back(end, piece.second);
+            }
+        }
+        pieces = std::move(remaining);
+        if (pieces.empty()) {
+            return;
+        }
+    }
+    const uint8_t *data = fileData(file);
+    for (const auto &piece : pieces) {
+        gCaptures.push_back({file, piece.first, std::vector<uint8_t>(data + piece.first, data + piece.second)});
+    }
+}
+
+// The crash file is a safety net, so failures are logged and the file is given up on.
+void appendRecord(RecordKind kind, const std::vector<uint8_t> &payload) {
+    if (gPath.empty()) {
+        return;
+    }
+    std::vector<uint8_t> body;
+    body.push_back(kind);
+    body.insert(body.end(), payload.begin(), payload.end());
+    std::vector<uint8_t> record;
+    put<uint32_t>(record, static_cast<uint32_t>(body.size()));
+    record.insert(record.end(), body.begin(), body.end());
+    put<uint32_t>(record, crc32c::compute(body.data(), body.size()));
+
+    // Flushed, not fsynced: the file guards against the editor crashing, not the machine.
+    std::ofstream out(gPath, std::ios::binary | std::ios::app);
+    if (!out.write(reinterpret_cast<const char *>(record.data()), static_cast<std::streamsize>(record.size())) ||
+        !out.flush()) {
+        std::cerr << "Could not write the edit journal " << gPath.string() << std::endl;
+        gPath.clear();
+    }
+}
+
+std::vector<uint8_t> encodeStep(const Step &step) {
+    std::vector<uint8_t> out;
+    put<uint16_t>(out, static_cast<uint16_t>(step.label.size()));
+    out.insert(out.end(), step.label.begin(), step.label.end());
+    put<uint32_t>(out, static_cast<uint32_t>(step.changes.size()));
+    for (const Change &change : step.changes) {
+        put<uint8_t>(out, static_cast<uint8_t>(change.file));
+        put<uint32_t>(out, change.offset);
+        put<uint32_t>(out, static_cast<uint32_t>(change.after.size()));
+        out.insert(out.end(), change.before.begin(), change.before.end());
+        out.insert(out.end(), change.after.begin(), change.after.end());
+    }
+    return out;
+}
+
+bool decodeStep(const uint8_t *p, const uint8_t *end, Step &step) {
+    uint16_t labelLength = 0;
+    if (!get(p, end, labelLength) || static_cast<std::size_t>(end - p) < labelLength) {
+        return false;
+    }
+    step.label.assign(reinterpret_cast<const char *>(p), labelLength);
+    p += labelLength;
+    uint32_t count = 0;
+    if (!get(p, end, count)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        uint8_t file = 0;
+        Change change;
+        uint32_t length = 0;
+        if (!get(p, end, file) || !get(p, end, change.offset) || !get(p, end, length) ||
+            file >= dirty_tracker::kSaveFileCount || std::size_t{change.offset} + length > fileSize(file) ||
+            static_cast<std::size_t>(end - p) < 2 * std::size_t{length}) {
+            return false;
+        }
+        change.file = file;
+        change.before.assign(p, p + length);
+        change.after.assign(p + length, p + 2 * std::size_t{length});
+        p += 2 * std::size_t{length};
+        step.changes.push_back(std::move(change));
+    }
+    return p == end;
+}
+
+bool holds(const Step &step, bool after) {
+    return std::all_of(step.changes.begin(), step.changes.end(), [after](const Change &change) {
+        const std::vector<uint8_t> &bytes = after ? change.after : change.before;
+        return std::memcmp(fileData(change.file) + change.offset, bytes.data(), bytes.size()) == 0;
+    });
+}
+
+// Writes one side of the step into memory and marks it dirty. Undo goes through the changes backwards.
+void write(const Step &step, bool after) {
+    auto apply = [after](const Change &change) {
+        const std::vector<uint8_t> &bytes = after ? change.after : change.before;
+        uint8_t *target = fileData(change.file) + change.offset;
+        dirty_tracker::touch(target, bytes.size());
+        std::memcpy(target, bytes.data(), bytes.size());
+        if (change.file == dirty_tracker::kGameB) {
+            defaultGameState.squadsReplaced();
+        }
+    };
+    if (after) {
+        std::for_each(step.changes.begin(), step.changes.end(), apply);
+    } else {
+        std::for_each(step.changes.rbegin(), step.changes.rend(), apply);
+    }
+}
+
+void push(Step step) {
+    gRedo.clear();
+    gUndo.push_back(std::move(step));
+    if (gUndo.size() > kMaxSteps) {
+        gUndo.pop_front();
+    }
+}
+
+std::vector<uint8_t> header(int gameNumber) {
+    std::vector<uint8_t> out(kMagic, kMagic + sizeof(kMagic));
+    put<uint16_t>(out, kVersion);
+    put<uint8_t>(out, static_cast<uint8_t>(gameNumber));
+    for (int file = 0; file < dirty_tracker::kSaveFileCount; ++file) {
+        put<uint32_t>(out, crc32c::compute(fileData(file), fileSize(file)));
+    }
+    return out;
+}
+
+void reset() {
+    gOpen = false;
+    gCaptures.clear();
+    gUndo.clear();
+    gRedo.clear();
+    gPath.clear();
+}
+
+} // namespace
+
+void begin() {
+    dirty_tracker::setTouchObserver(capture);
+    gCaptures.clear();
+    gOpen = true;
+}
+
+bool commit(const std::string &label) {
+    gOpen = false;
+    std::sort(gCaptures.begin(), gCaptures.end(), [](const Capture &a, const Capture &b) {
+        return a.file != b.file ? a.file < b.file : a.offset < b.offset;
+    });
+
+    Step step;
+    step.label = label;
+    for (const Capture &captured : gCaptures) {
+        const uint8_t *live = fileData(captured.file) + captured.offset;
+        const std::size_t size = captured.bytes.size();
+        std::size_t pos = 0;
+        while (pos < size) {
+            if (live[pos] == captured.bytes[pos]) {
+                ++pos;
+                continue;
+            }
+            std::size_t start = pos;
+            std::size_t end = pos + 1;
+            for (std::size_t scan = end; scan < size && scan - end <= kMergeGap; ++scan) {
+                if (live[scan] != captured.bytes[scan]) {
+                    end = scan + 1;
+                }
+            }
+            Change change;
+            change.file = captured.file;
+            change.offset = static_cast<uint32_t>(captured.offset + start);
+            change.before.assign(captured.bytes.begin() + start, captured.bytes.begin() + end);
+            change.after.assign(live + start, live + end);
+            step.changes.push_back(std::move(change));
+            pos = end;
+        }
+    }
+    gCaptures.clear();
+    if (step.changes.empty()) {
+        return false;
+    }
+    appendRecord(kStepRecord, encodeStep(step));
+    push(std::move(step));
+    return true;
+}
+
+bool rollback() {
+    gOpen = false;
+    bool changed = false;
+    for (const Capture &captured : gCaptures) {
+        uint8_t *live = fileData(captured.file) + captured.offset;
+        if (std::memcmp(live, captured.bytes.data(), captured.bytes.size()) == 0) {
+            continue;
+        }
+        std::memcpy(live, captured.bytes.data(), captured.bytes.size());
+        changed = true;
+        if (captured.file == dirty_tracker::kGameB) {
+            defaultGameState.squadsReplaced();
+        }
+    }
+    gCaptures.clear();
+    return changed;
+}
+
+bool canUndo() {
+    return !gUndo.empty();
+}
+
+bool canRedo() {
+    return !gRedo.empty();
+}
+
+const std::string &undoLabel() {
+    return gUndo.empty() ? kNoLabel : gUndo.back().label;
+}
+
+const std::string &redoLabel() {
+    return gRedo.empty() ? kNoLabel : gRedo.back().label;
+}
+
+bool undo() {
+    if (gUndo.empty() || !holds(gUndo.back(), true)) {
+        return false;
+    }
+    write(gUndo.back(), false);
+    gRedo.push_back(std::move(gUndo.back()));
+    gUndo.pop_back();
+    appendRecord(kUndoRecord, {});
+    return true;
+}
+
+bool redo() {
+    if (gRedo.empty() || !holds(gRedo.back(), false)) {
+        return false;
+    }
+    write(gRedo.back(), true);
+    gUndo.push_back(std::move(gRedo.back()));
+    gRedo.pop_back();
+    appendRecord(kRedoRecord, {});
+    return true;
+}
+
+void restart(const std::filesystem::path &path, int gameNumber) {
+    reset();
+    if (path.empty()) {
+        return;
+    }
+    std::vector<uint8_t> bytes = header(gameNumber);
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()))) {
+        std::cerr << "Could not start the edit journal " << path.string() << std::endl;
+        return;
+    }
+    gPath = path;
+}
+
+std::size_t recover(const std::filesystem::path &path, int gameNumber) {
+    reset();
+    std::ifstream in(path, std::ios::binary);
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::vector<uint8_t> expected = header(gameNumber);
+    if (path.empty() || bytes.size() < kHeaderSize || !std::equal(expected.begin(), expected.end(), bytes.begin())) {
+        restart(path, gameNumber);
+        return 0;
+    }
+
+    // Replays until the first record that is torn, damaged or no longer fits, and drops it and the rest.
+    const uint8_t *p = bytes.data() + kHeaderSize;
+    const uint8_t *end = bytes.data() + bytes.size();
+    while (p < end) {
+        const uint8_t *record = p;
+        uint32_t length = 0;
+        uint32_t crc = 0;
+        if (!get(p, end, length) || length == 0 || static_cast<std::size_t>(end - p) < std::size_t{length} + 4) {
+            p = record;
+            break;
+        }
+        const uint8_t *body = p;
+        p += length;
+        get(p, end, crc);
+        if (crc != crc32c::compute(body, length)) {
+            p = record;
+            break;
+        }
+
+        bool replayed = false;
+        switch (body[0]) {
+            case kStepRecord: {
+                Step step;
+                if (decodeStep(body + 1, body + length, step) && holds(step, false)) {
+                    write(step, true);
+                    push(std::move(step));
+                    replayed = true;
+                }
+                break;
+            }
+            case kUndoRecord:
+                replayed = undo();
+                break;
+            case kRedoRecord:
+                replayed = redo();
+                break;
+            default:
+                break;
+        }
+        if (!replayed) {
+            p = record;
+            break;
+        }
+    }
+
+    std::size_t kept = static_cast<std::size_t>(p - bytes.data());
+    std::error_code ec;
+    if (kept < bytes.size()) {
+        std::filesystem::resize_file(path, kept, ec);
+    }
+    if (!ec) {
+        gPath = path;
+    }
+    return gUndo.size();
+}
+
+std::filesystem::path crashFilePath(const std::filesystem::path &backupDir, int gameNumber) {
+    return backupDir / (std::string{kGameFilePrefix} + std::to_string(gameNumber) + kFileSuffix);
+}
+
+} // namespace edit_journal
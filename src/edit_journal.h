@@ -0,0 +1,61 @@
+// Undo/redo for edits to the loaded save (gameData/clubData/playerData), with a crash file for unsaved edits.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace edit_journal {
+
+inline constexpr const char *kFileSuffix = ".EDT";
+// Older steps are dropped from the undo history beyond this.
+inline constexpr std::size_t kMaxSteps = 256;
+
+// One run of changed bytes in GAMEnA/B/C (0, 1, 2).
+struct Change {
+    int file = 0;
+    uint32_t offset = 0;
+    std::vector<uint8_t> before;
+    std::vector<uint8_t> after;
+};
+
+// What one user action changed, e.g. a transfer or a training camp.
+struct Step {
+    std::string label;
+    std::vector<Change> changes;
+};
+
+// Groups everything dirty_tracker::touch() reports until commit() into one step. The old bytes are copied when
+// they are touched, so the cost is the size of what the action touches, not the size of the save.
+void begin();
+// Ends the step and keeps the bytes that actually changed. Returns false, recording nothing, if none did.
+// A new step clears the redo history.
+bool commit(const std::string &label);
+// Ends the step without recording it and puts back the old bytes of everything it changed, for an action that is
+// not allowed right now. The bytes stay marked dirty. Returns false if nothing had changed.
+bool rollback();
+
+bool canUndo();
+bool canRedo();
+// Label of the step undo() or redo() would revert or reapply.
+const std::string &undoLabel();
+const std::string &redoLabel();
+
+// Reverts the last step, or reapplies the last undone one, and marks the bytes dirty for the next save. Fails,
+// changing nothing, if the bytes no longer hold what the step left there (e.g. the slot was reloaded from disk).
+bool undo();
+bool redo();
+
+// Forgets the history and starts a crash file for `gameNumber` at `path`, whose contents are now in memory.
+// An empty `path` keeps the history in memory only.
+void restart(const std::filesystem::path &path, int gameNumber);
+// Replays the crash file at `path` if it was written for `gameNumber` and the slot in memory is the one it
+// started from, then keeps appending to it. Returns how many steps were recovered; otherwise starts a new file.
+std::size_t recover(const std::filesystem::path &path, int gameNumber);
+
+// <backup dir>/GAMEn.EDT
+std::filesystem::path crashFilePath(const std::filesystem::path &backupDir, int gameNumber);
+
+} // namespace edit_journal
@@ -0,0 +1,337 @@
+// Userspace reader/writer for FAT12/16 disk images, such as the hard-disk images DOSBox mounts with imgmount.
+#include "fat_image.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+#include <utility>
+
+namespace fat_image {
+
+namespace {
+constexpr std::size_t kSectorSize = 512;
+constexpr std::size_t kDirEntrySize = 32;
+constexpr std::size_t kPartitionTable = 0x1BE;
+constexpr uint8_t kAttrDirectory = 0x10;
+constexpr uint8_t kAttrVolume = 0x08;
+constexpr uint8_t kAttrLongName = 0x0F;
+// Cluster counts that decide the FAT type, per the Microsoft FAT specification.
+constexpr uint32_t kMaxFat12Clusters = 4084;
+constexpr uint32_t kMaxFat16Clusters = 65524;
+
+uint16_t le16(const uint8_t *p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t le32(const uint8_t *p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) |
+           (static_cast<uint32_t>(p[3]) << 24);
+}
+
+bool isPowerOfTwo(uint32_t value) {
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+// A boot sector whose BIOS parameter block describes a usable FAT volume.
+bool hasBpb(const uint8_t *sector) {
+    uint16_t bytesPerSector = le16(sector + 0x0B);
+    return (sector[0] == 0xEB || sector[0] == 0xE9) && bytesPerSector >= 512 && bytesPerSector <= 4096 &&
+           isPowerOfTwo(bytesPerSector) && isPowerOfTwo(sector[0x0D]) && le16(sector + 0x0E) != 0 && sector[0x10] != 0;
+}
+
+bool isFatPartition(uint8_t type) {
+    return type == 0x01 || type == 0x04 || type == 0x06 || type == 0x0E;
+}
+
+std::string upper(std::string text) {
+    for (char &c : text) {
+        c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+    return text;
+}
+
+std::vector<std::string> splitPath(const std::string &path) {
+    std::vector<std::string> parts;
+    std::string part;
+    for (char c : path) {
+        if (c == '/' || c == '\\') {
+            if (!part.empty()) {
+                parts.push_back(upper(part));
+            }
+            part.clear();
+        } else {
+            part += c;
+        }
+    }
+    if (!part.empty()) {
+        parts.push_back(upper(part));
+    }
+    return parts;
+}
+
+std::string entryName(const uint8_t *raw) {
+    std::string base(reinterpret_cast<const char *>(raw), 8);
+    std::string ext(reinterpret_cast<const char *>(raw + 8), 3);
+    if (static_cast<uint8_t>(base[0]) == 0x05) {
+        base[0] = static_cast<char>(0xE5); // a real leading 0xE5, escaped so it does not read as deleted
+    }
+    base.erase(base.find_last_not_of(' ') + 1);
+    ext.erase(ext.find_last_not_of(' ') + 1);
+    return ext.empty() ? base : base + "." + ext;
+}
+} // namespace
+
+Image::Image(std::filesystem::path path, bool writable)
+    : imagePath(std::move(path)), writable(writable) {
+    auto mode = std::ios::binary | std::ios::in | (writable ? std::ios::out : std::ios::openmode{});
+    stream.open(imagePath, mode);
+    if (!stream) {
+        throw std::runtime_error("Could not open disk image " + imagePath.string());
+    }
+
+    uint8_t sector[kSectorSize];
+    readAt(0, sector, sizeof(sector));
+    if (!hasBpb(sector)) {
+        if (sector[510] != 0x55 || sector[511] != 0xAA) {
+            throw std::runtime_error(imagePath.string() + " has neither a FAT boot sector nor a partition table");
+        }
+        for (int i = 0; i < 4 && volumeStart == 0; ++i) {
+            const uint8_t *partition = sector + kPartitionTable + i * 16;
+            if (isFatPartition(partition[4]) && le32(partition + 8) != 0) {
+                volumeStart = static_cast<uint64_t>(le32(partition + 8)) * kSectorSize;
+            }
+        }
+        if (volumeStart == 0) {
+            throw std::runtime_error(imagePath.string() + " has no FAT12/16 partition");
+        }
+        readAt(volumeStart, sector, sizeof(sector));
+        if (!hasBpb(sector)) {
+            throw std::runtime_error(imagePath.string() + ": the FAT partition has no valid boot sector");
+        }
+    }
+
+    const uint32_t bytesPerSector = le16(sector + 0x0B);
+    const uint32_t sectorsPerCluster = sector[0x0D];
+    const uint32_t reservedSectors = le16(sector + 0x0E);
+    const uint32_t fatCount = sector[0x10];
+    const uint32_t sectorsPerFat = le16(sector + 0x16);
+    const uint32_t totalSectors = le16(sector + 0x13) != 0 ? le16(sector + 0x13) : le32(sector + 0x20);
+    rootEntries = le16(sector + 0x11);
+    if (sectorsPerFat == 0 || rootEntries == 0) {
+        throw std::runtime_error(imagePath.string() + " is FAT32, only FAT12/16 images are supported");
+    }
+
+    const uint32_t rootSectors = (rootEntries * kDirEntrySize + bytesPerSector - 1) / bytesPerSector;
+    const uint32_t metaSectors = reservedSectors + fatCount * sectorsPerFat + rootSectors;
+    if (totalSectors <= metaSectors) {
+        throw std::runtime_error(imagePath.string() + ": the boot sector describes an empty volume");
+    }
+    clusterBytes = static_cast<std::size_t>(bytesPerSector) * sectorsPerCluster;
+    clusterCount = (totalSectors - metaSectors) / sectorsPerCluster;
+    if (clusterCount > kMaxFat16Clusters) {
+        throw std::runtime_error(imagePath.string() + " is FAT32, only FAT12/16 images are supported");
+    }
+    bits = clusterCount <= kMaxFat12Clusters ? 12 : 16;
+
+    const uint64_t fatStart = volumeStart + static_cast<uint64_t>(reservedSectors) * bytesPerSector;
+    rootStart = fatStart + static_cast<uint64_t>(fatCount) * sectorsPerFat * bytesPerSector;
+    dataStart = rootStart + static_cast<uint64_t>(rootSectors) * bytesPerSector;
+    // Only the first FAT is read; the copies are never written since chains do not change.
+    fat.resize(static_cast<std::size_t>(sectorsPerFat) * bytesPerSector);
+    readAt(fatStart, fat.data(), fat.size());
+}
+
+uint32_t Image::nextCluster(uint32_t cluster) const {
+    if (bits == 12) {
+        std::size_t offset = cluster + cluster / 2;
+        if (offset + 1 >= fat.size()) {
+            return 0;
+        }
+        uint16_t value = le16(fat.data() + offset);
+        return (cluster & 1) ? value >> 4 : value & 0x0FFF;
+    }
+    std::size_t offset = static_cast<std::size_t>(cluster) * 2;
+    return offset + 1 < fat.size() ? le16(fat.data() + offset) : 0;
+}
+
+std::vector<Entry> Image::readDirectory(const Entry *directory) const {
+    // The fixed root directory is one run; a subdirectory is a cluster chain like any file.
+    std::vector<std::pair<uint64_t, std::size_t>> runs;
+    if (!directory) {
+        runs.emplace_back(rootStart, static_cast<std::size_t>(rootEntries) * kDirEntrySize);
+    } else {
+        uint32_t cluster = directory->firstCluster;
+        for (uint32_t steps = 0; validCluster(cluster) && steps < clusterCount; ++steps) {
+            runs.emplace_back(clusterOffset(cluster), clusterBytes);
+            cluster = nextCluster(cluster);
+        }
+    }
+
+    std::vector<Entry> entries;
+    std::vector<uint8_t> buffer;
+    for (const auto &[offset, length] : runs) {
+        buffer.resize(length);
+        readAt(offset, buffer.data(), length);
+        for (std::size_t i = 0; i + kDirEntrySize <= length; i += kDirEntrySize) {
+            const uint8_t *raw = buffer.data() + i;
+            if (raw[0] == 0x00) {
+                return entries;
+            }
+            uint8_t attributes = raw[11];
+            if (raw[0] == 0xE5 || raw[0] == '.' || attributes == kAttrLongName || (attributes & kAttrVolume)) {
+                continue;
+            }
+            Entry entry;
+            entry.name = entryName(raw);
+            entry.directory = (attributes & kAttrDirectory) != 0;
+            entry.firstCluster = le16(raw + 26);
+            entry.size = entry.directory ? 0 : le32(raw + 28);
+            entry.entryOffset = offset + i;
+            entries.push_back(std::move(entry));
+        }
+    }
+    return entries;
+}
+
+std::vector<Entry> Image::list(const std::string &directory) const {
+    std::vector<std::string> parts = splitPath(directory);
+    if (parts.empty()) {
+        return readDirectory(nullptr);
+    }
+    std::optional<Entry> entry = find(directory);
+    if (!entry || !entry->directory) {
+        throw std::runtime_error("No directory " + directory + " in " + imagePath.string());
+    }
+    return readDirectory(&*entry);
+}
+
+std::optional<Entry> Image::find(const std::string &path) const {
+    std::vector<std::string> parts = splitPath(path);
+    if (parts.empty()) {
+        return std::nullopt;
+    }
+    std::optional<Entry> current;
+    for (std::size_t i = 0; i < parts.size(); ++i) {
+        if (current && !current->directory) {
+            return std::nullopt;
+        }
+        std::vector<Entry> entries = readDirectory(current ? &*current : nullptr);
+        auto it = std::find_if(entries.begin(), entries.end(),
+                               [&](const Entry &entry) { return upper(entry.name) == parts[i]; });
+        if (it == entries.end()) {
+            return std::nullopt;
+        }
+        current = *it;
+    }
+    return current;
+}
+
+template <typename Visit>
+void Image::forEachRun(const Entry &file, uint64_t offset, std::size_t length, Visit visit) const {
+    if (file.directory || offset + length > file.size) {
+        throw std::runtime_error(file.name + ": access past the end of the file in " + imagePath.string());
+    }
+    if (length == 0) {
+        return;
+    }
+
+    // Skip whole clusters up to the start of the range, then merge neighbouring clusters into single runs.
+    uint32_t cluster = file.firstCluster;
+    uint32_t steps = 0;
+    for (uint64_t skip = offset / clusterBytes; skip > 0; --skip) {
+        cluster = nextCluster(cluster);
+        if (!validCluster(cluster) || ++steps > clusterCount) {
+            throw std::runtime_error(file.name + ": broken cluster chain in " + imagePath.string());
+        }
+    }
+
+    uint64_t within = offset % clusterBytes;
+    std::size_t done = 0;
+    while (done < length) {
+        if (!validCluster(cluster)) {
+            throw std::runtime_error(file.name + ": broken cluster chain in " + imagePath.string());
+        }
+        uint64_t runStart = clusterOffset(cluster) + within;
+        std::size_t runLength = std::min(length - done, static_cast<std::size_t>(clusterBytes - within));
+        uint32_t next = nextCluster(cluster);
+        while (done + runLength < length && next == cluster + 1) {
+            cluster = next;
+            runLength += std::min(length - done - runLength, clusterBytes);
+            next = nextCluster(cluster);
+        }
+        visit(runStart, runLength, done);
+        done += runLength;
+        cluster = next;
+        within = 0;
+        if (++steps > clusterCount) {
+            throw std::runtime_error(file.name + ": broken cluster chain in " + imagePath.string());
+        }
+    }
+}
+
+void Image::read(const Entry &file, uint64_t offset, void *out, std::size_t length) const {
+    auto *bytes = static_cast<uint8_t *>(out);
+    forEachRun(file, offset, length, [&](uint64_t at, std::size_t runLength, std::size_t bufferOffset) {
+        readAt(at, bytes + bufferOffset, runLength);
+    });
+}
+
+std::vector<uint8_t> Image::read(const Entry &file) const {
+    std::vector<uint8_t> contents(file.size);
+    read(file, 0, contents.data(), contents.size());
+    return contents;
+}
+
+void Image::write(const Entry &file, uint64_t offset, const void *data, std::size_t length) {
+    if (!writable) {
+        throw std::runtime_error(imagePath.string() + " was opened read-only");
+    }
+    const auto *bytes = static_cast<const uint8_t *>(data);
+    forEachRun(file, offset, length, [&](uint64_t at, std::size_t runLength, std::size_t bufferOffset) {
+        writeAt(at, bytes + bufferOffset, runLength);
+    });
+
+    // DOS time and date: 2-second resolution, years counted from 1980.
+    std::time_t now = std::time(nullptr);
+    std::tm local{};
+#if defined(_WIN32)
+    localtime_s(&local, &now);
+#else
+    localtime_r(&now, &local);
+#endif
+    uint16_t dosTime = static_cast<uint16_t>((local.tm_hour << 11) | (local.tm_min << 5) | (local.tm_sec / 2));
+    uint16_t dosDate = static_cast<uint16_t>(((std::max(local.tm_year, 80) - 80) << 9) | ((local.tm_mon + 1) << 5) |
+                                             local.tm_mday);
+    const uint8_t stamp[4] = {static_cast<uint8_t>(dosTime), static_cast<uint8_t>(dosTime >> 8),
+                              static_cast<uint8_t>(dosDate), static_cast<uint8_t>(dosDate >> 8)};
+    writeAt(file.entryOffset + 22, stamp, sizeof(stamp));
+    stream.flush();
+    if (!stream) {
+        throw std::runtime_error("Could not write to " + imagePath.string());
+    }
+}
+
+void Image::readAt(uint64_t offset, void *out, std::size_t length) const {
+    stream.seekg(static_cast<std::streamoff>(offset));
+    if (!stream.read(static_cast<char *>(out), static_cast<std::streamsize>(length))) {
+        stream.clear();
+        throw std::runtime_error(imagePath.string() + " is truncated");
+    }
+}
+
+void Image::writeAt(uint64_t offset, const void *data, std::size_t length) {
+    stream.seekp(static_cast<std::streamoff>(offset));
+    if (!stream.write(static_cast<const char *>(data), static_cast<std::streamsize>(length))) {
+        stream.clear();
+        throw std::runtime_error("Could not write to " + imagePath.string());
+    }
+}
+
+bool isImageFile(const std::filesystem::path &path) {
+    std::string extension = upper(path.extension().string());
+    return extension == ".IMG" || extension == ".IMA";
+}
+
+} // namespace fat_image
@@ -0,0 +1,75 @@
+// Userspace reader/writer for FAT12/16 disk images, such as the hard-disk images DOSBox mounts with imgmount.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace fat_image {
+
+// A directory entry. Names are the 8.3 form stored on disk ("GAME1A", "SAVES.DIR"); long names are ignored,
+// as PM3 never sees them.
+struct Entry {
+    std::string name;
+    bool directory = false;
+    uint32_t firstCluster = 0;
+    uint32_t size = 0;
+    uint64_t entryOffset = 0; // of the 32-byte directory entry within the image
+};
+
+// Opens either a bare FAT volume (floppy images) or a partitioned hard-disk image, in which case the first
+// FAT12/16 partition of the MBR is used. Only the boot sector and the FAT are read up front; file contents are
+// streamed along their cluster chains. Files can be rewritten in place but never grow, shrink or move, so the
+// FAT and the directories are not modified apart from the entry's write time. Throws std::runtime_error for
+// anything that is not a FAT12/16 volume.
+class Image {
+public:
+    explicit Image(std::filesystem::path path, bool writable = false);
+
+    const std::filesystem::path &path() const { return imagePath; }
+    int fatBits() const { return bits; }
+    std::size_t clusterSize() const { return clusterBytes; }
+
+    // Entries of a directory given as "DIR/SUB" ("" for the root), in on-disk order. Throws if it is missing.
+    std::vector<Entry> list(const std::string &directory) const;
+    // Case-insensitive lookup of "DIR/FILE.EXT"; '\\' separators are accepted too.
+    std::optional<Entry> find(const std::string &path) const;
+
+    void read(const Entry &file, uint64_t offset, void *out, std::size_t length) const;
+    std::vector<uint8_t> read(const Entry &file) const;
+    // Overwrites [offset, offset + length) of an existing file and stamps its write time.
+    void write(const Entry &file, uint64_t offset, const void *data, std::size_t length);
+
+private:
+    uint32_t nextCluster(uint32_t cluster) const;
+    bool validCluster(uint32_t cluster) const { return cluster >= 2 && cluster < clusterCount + 2; }
+    uint64_t clusterOffset(uint32_t cluster) const { return dataStart + (cluster - 2) * clusterBytes; }
+    // The root directory when `directory` is null.
+    std::vector<Entry> readDirectory(const Entry *directory) const;
+    // Calls `visit(imageOffset, length, bufferOffset)` for the runs of contiguous clusters covering the range.
+    template <typename Visit>
+    void forEachRun(const Entry &file, uint64_t offset, std::size_t length, Visit visit) const;
+    void readAt(uint64_t offset, void *out, std::size_t length) const;
+    void writeAt(uint64_t offset, const void *data, std::size_t length);
+
+    std::filesystem::path imagePath;
+    mutable std::fstream stream;
+    bool writable = false;
+    int bits = 0;
+    uint64_t volumeStart = 0;
+    uint64_t rootStart = 0;
+    uint32_t rootEntries = 0;
+    uint64_t dataStart = 0;
+    std::size_t clusterBytes = 0;
+    uint32_t clusterCount = 0;
+    std::vector<uint8_t> fat;
+};
+
+// Disk images are recognised by extension (.img or .ima, in any case).
+bool isImageFile(const std::filesystem::path &path);
+
+} // namespace fat_image
@@ -6,12 +6,16 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <iterator>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "base_data.h"
+#include "dirty_tracker.h"
 #include "pm3_data.h"
 #include "io.h"
+#include "save_ledger.h"
 
 static double computeRoleRating(char role, const PlayerRecord &p) {
     auto clamp = [](double v) { return std::clamp(v, 0.0, 99.0); };
@@ -119,7 +123,7 @@ static int normalizedLeagueTier(const ClubRecord &club) {
     return 4; // bottom tier fallback
 }
 
-int determinePlayerPrice(const PlayerRecord &player, const ClubRecord &club, int squadSlot) {
+int determinePlayerPrice(const GameState &state, const PlayerRecord &player, const ClubRecord &club, int squadSlot) {
     char valuationRole = determineValuationRole(player);
     int rating = static_cast<int>(std::lround(computeRoleRating(valuationRole, player)));
     int age = player.age;
@@ -143,7 +147,7 @@ int determinePlayerPrice(const PlayerRecord &player, const ClubRecord &club, int
     double baseValue = static_cast<double>(rating) * static_cast<double>(rating) * 1200.0;
 
     // Importance based on relative quality in the squad.
-    int importance = determinePlayerImportance(player, club);
+    int importance = determinePlayerImportance(state, player, club);
     double importanceFactor = 1.0;
     switch (importance) {
         case 4: importanceFactor = 1.6; break;
@@ -198,7 +202,7 @@ int determinePlayerPrice(const PlayerRecord &player, const ClubRecord &club, int
     return static_cast<int>(std::max<double>(value, wageInfluence));
 }
 
-int determinePlayerImportance(const PlayerRecord &player, const ClubRecord &club) {
+int determinePlayerImportance(const GameState &state, const PlayerRecord &player, const ClubRecord &club) {
     PlayerRecord &mutablePlayer = const_cast<PlayerRecord &>(player);
     char playerType = determinePlayerType(mutablePlayer);
     int rating = determinePlayerRating(mutablePlayer);
@@ -214,7 +218,7 @@ int determinePlayerImportance(const PlayerRecord &player, const ClubRecord &club
         }
         ++squadSize;
 
-        PlayerRecord &clubPlayer = getPlayer(idx);
+        PlayerRecord &clubPlayer = const_cast<PlayerRecord &>(state.player(idx));
         int clubRating = determinePlayerRating(clubPlayer);
         bestOverall = std::max(bestOverall, clubRating);
 
@@ -241,9 +245,19 @@ int determinePlayerImportance(const PlayerRecord &player, const ClubRecord &club
     return importance;
 }
 
-void changeClub(int16_t newClubIdx, const std::filesystem::path &gamePath, int player) {
-    gamea::ManagerRecord &manager = gameData.manager[player];
+// dirty_tracker::touchClub for any GameState; only the default instance is tracked.
+static void touchClub(const GameState &state, int clubIdx) {
+    if (clubIdx >= 0 && clubIdx < static_cast<int>(std::size(state.clubs.club))) {
+        dirty_tracker::touch(state.club(clubIdx));
+    }
+}
+
+void changeClub(GameState &state, int16_t newClubIdx, const std::filesystem::path &gamePath, int player) {
+    gamea::ManagerRecord &manager = state.game.manager[player];
     int oldClubIdx = manager.club_idx;
+    dirty_tracker::touch(manager);
+    touchClub(state, newClubIdx);
+    touchClub(state, oldClubIdx);
     manager.club_idx = newClubIdx;
 
     auto fillSafety = [&](int value) {
@@ -397,62 +411,63 @@ void changeClub(int16_t newClubIdx, const std::filesystem::path &gamePath, int p
         std::exit(EXIT_FAILURE);
     }
 
-    clubData.club[newClubIdx].player_image = clubData.club[oldClubIdx].player_image;
-    std::strncpy(clubData.club[newClubIdx].manager, clubData.club[oldClubIdx].manager, 16);
+    state.club(newClubIdx).player_image = state.club(oldClubIdx).player_image;
+    std::strncpy(state.club(newClubIdx).manager, state.club(oldClubIdx).manager, 16);
 
-    gameb defaultClubData{};
-    io::loadDefaultClubdata(gamePath, defaultClubData);
-    std::strncpy(clubData.club[oldClubIdx].manager, defaultClubData.club[oldClubIdx].manager, 16);
+    std::strncpy(state.club(oldClubIdx).manager, io::baseDataFor(gamePath)->club(oldClubIdx).manager, 16);
 }
 
-std::vector<club_player> findFreePlayers() {
-    std::vector<club_player> freePlayers;
+std::vector<PlayerHandle> findFreePlayers(const GameState &state) {
+    std::vector<PlayerHandle> freePlayers;
 
     for (int clubIdx = 0; clubIdx < 114; ++clubIdx) {
-        ClubRecord &club = getClub(clubIdx);
+        const ClubRecord &club = state.club(clubIdx);
         for (int slot = 0; slot < 24; ++slot) {
             int16_t playerIdx = club.player_index[slot];
             if (playerIdx == -1) {
                 continue;
             }
 
-            PlayerRecord &player = playerData.player[playerIdx];
-            if (club.league == 0 || player.contract != 0) {
+            if (club.league == 0 || state.player(playerIdx).contract != 0) {
                 continue;
             }
 
-            freePlayers.push_back({club, player});
+            freePlayers.push_back({playerIdx, static_cast<int16_t>(clubIdx), static_cast<int8_t>(slot)});
         }
     }
     return freePlayers;
 }
 
-std::vector<club_player> getMyPlayers(int player) {
-    std::vector<club_player> myPlayers;
+std::vector<PlayerHandle> getMyPlayers(const GameState &state, int player) {
+    return squadPlayers(state, state.game.manager[player].club_idx);
+}
 
-    ClubRecord &club = getClub(gameData.manager[player].club_idx);
+std::vector<PlayerHandle> squadPlayers(const GameState &state, int clubIdx) {
+    std::vector<PlayerHandle> players;
+
+    const ClubRecord &club = state.club(clubIdx);
     for (int i = 0; i < 24; ++i) {
         int16_t playerIdx = club.player_index[i];
         if (playerIdx == -1) {
             continue;
         }
 
-        PlayerRecord &p = playerData.player[playerIdx];
-        myPlayers.push_back({club, p});
+        players.push_back({playerIdx, static_cast<int16_t>(clubIdx), static_cast<int8_t>(i)});
     }
-    return myPlayers;
+    return players;
 }
 
-void levelAggression() {
+void levelAggression(GameState &state) {
+    dirty_tracker::touch(state.players);
     for (int16_t i = 0; i < 3932; ++i) {
-        PlayerRecord &player = getPlayer(i);
+        PlayerRecord &player = state.player(i);
         player.aggr = 5;
     }
 }
 
 namespace game_utils {
 
-OfferResponse assessOffer(const club_player &playerInfo, int offerAmount, int currentGame) {
+OfferResponse assessOffer(GameState &state, const PlayerHandle &handle, int offerAmount, int currentGame) {
     OfferResponse result{false, ""};
 
     if (offerAmount <= 0) {
@@ -465,38 +480,29 @@ OfferResponse assessOffer(const club_player &playerInfo, int offerAmount, int cu
         return result;
     }
 
-    int16_t playerIdx = findPlayerIndex(playerInfo.player);
-    if (playerIdx == -1) {
+    if (handle.playerIdx < 0 || handle.playerIdx >= 3932) {
         snprintf(result.message, sizeof(result.message), "Player not found in save");
         return result;
     }
 
-    int fromClubIdx = findClubIndexForPlayer(playerIdx);
+    // The list may be older than the last transfer; go by where the player is now.
+    PlayerHandle current = state.isCurrent(handle) ? handle : state.handleFor(handle.playerIdx);
+    int16_t playerIdx = current.playerIdx;
+    int fromClubIdx = current.clubIdx < 114 ? current.clubIdx : -1;
     if (fromClubIdx == -1) {
         snprintf(result.message, sizeof(result.message), "Unable to locate player's club");
         return result;
     }
 
-    int myClubIdx = gameData.manager[0].club_idx;
+    int myClubIdx = state.game.manager[0].club_idx;
     if (fromClubIdx == myClubIdx) {
         snprintf(result.message, sizeof(result.message), "Player already in your squad");
         return result;
     }
 
-    int squadSlot = -1;
-    const ClubRecord &sourceClub = playerInfo.club;
-    for (int i = 0; i < 24; ++i) {
-        if (sourceClub.player_index[i] == -1) {
-            continue;
-        }
-        if (std::memcmp(&playerData.player[sourceClub.player_index[i]], &playerInfo.player, sizeof(PlayerRecord)) == 0) {
-            squadSlot = i;
-            break;
-        }
-    }
-
-    int basePrice = determinePlayerPrice(playerInfo.player, playerInfo.club, squadSlot);
-    int importance = std::max(determinePlayerImportance(playerInfo.player, playerInfo.club), 1);
+    const PlayerRecord &player = state.player(current);
+    int basePrice = determinePlayerPrice(state, player, state.club(current), current.slot);
+    int importance = std::max(determinePlayerImportance(state, player, state.club(current)), 1);
     int askingPrice = static_cast<int>(basePrice * (1.0 + (importance - 1) * 0.15));
 
     if (offerAmount < askingPrice) {
@@ -505,60 +511,44 @@ OfferResponse assessOffer(const club_player &playerInfo, int offerAmount, int cu
         return result;
     }
 
-    ClubRecord &myClub = getClub(myClubIdx);
+    ClubRecord &myClub = state.club(myClubIdx);
     if (findEmptySlot(myClub) == -1) {
         snprintf(result.message, sizeof(result.message), "No free slot in your squad");
         return result;
     }
 
-    completeTransfer(playerIdx, fromClubIdx, myClubIdx, offerAmount);
+    completeTransfer(state, playerIdx, fromClubIdx, myClubIdx, offerAmount);
 
-    snprintf(result.message, sizeof(result.message), "Offer accepted - %12.12s signed", playerInfo.player.name);
+    snprintf(result.message, sizeof(result.message), "Offer accepted - %12.12s signed", player.name);
     result.accepted = true;
     return result;
 }
 
-void beginOffer(InputHandler &input, char *footer, size_t footerSize, const club_player &playerInfo, int currentGame) {
+void beginOffer(GameState &state, InputHandler &input, char *footer, size_t footerSize, const PlayerHandle &handle,
+                int currentGame) {
     input.resetKeyPressCallbacks();
-    input.startReadingTextInput([&input, footer, footerSize, playerInfo] {
+    input.startReadingTextInput([&state, &input, footer, footerSize, handle] {
         const char *buffer = input.getTextInput();
         std::string formattedAmount = std::strlen(buffer) ? formatCurrency(std::atoi(buffer)) : "..........";
         snprintf(footer, footerSize, "           Offer amount for %12.12s £%13.13s",
-                 playerInfo.player.name, formattedAmount.c_str());
+                 state.player(handle).name, formattedAmount.c_str());
     });
 
-    snprintf(footer, footerSize, "           Offer amount for %12.12s £..........", playerInfo.player.name);
+    snprintf(footer, footerSize, "           Offer amount for %12.12s £..........", state.player(handle).name);
 
-    input.addKeyPressCallback(SDLK_RETURN, [&input, footer, footerSize, playerInfo, currentGame] {
+    input.addKeyPressCallback(SDLK_RETURN, [&state, &input, footer, footerSize, handle, currentGame] {
         int offer = std::atoi(input.getTextInput());
-        auto response = assessOffer(playerInfo, offer, currentGame);
+        auto response = assessOffer(state, handle, offer, currentGame);
         snprintf(footer, footerSize, "           %.58s", response.message);
         input.resetKeyPressCallbacks();
         input.endReadingTextInput();
     });
 }
 
-int16_t findPlayerIndex(const PlayerRecord &player) {
-    for (int16_t idx = 0; idx < 3932; ++idx) {
-        if (std::memcmp(&getPlayer(idx), &player, sizeof(PlayerRecord)) == 0) {
-            return idx;
-        }
-    }
-
-    return -1;
-}
-
-int findClubIndexForPlayer(int16_t playerIdx) {
-    for (int clubIdx = 0; clubIdx < 114; ++clubIdx) {
-        ClubRecord &club = getClub(clubIdx);
-        for (int slot = 0; slot < 24; ++slot) {
-            if (club.player_index[slot] == playerIdx) {
-                return clubIdx;
-            }
-        }
-    }
-
-    return -1;
+int findClubIndexForPlayer(const GameState &state, int16_t playerIdx) {
+    // Only the 114 league clubs; a player whose first squad is past them is not at a league club.
+    SquadPlace place = state.squadPlace(playerIdx);
+    return place.clubIdx < 114 ? place.clubIdx : -1;
 }
 
 int findEmptySlot(ClubRecord &club) {
@@ -570,13 +560,16 @@ int findEmptySlot(ClubRecord &club) {
     return -1;
 }
 
-void completeTransfer(int16_t playerIdx, int fromClubIdx, int toClubIdx, int offerAmount) {
-    ClubRecord &fromClub = getClub(fromClubIdx);
-    ClubRecord &toClub = getClub(toClubIdx);
+void completeTransfer(GameState &state, int16_t playerIdx, int fromClubIdx, int toClubIdx, int offerAmount) {
+    ClubRecord &fromClub = state.club(fromClubIdx);
+    ClubRecord &toClub = state.club(toClubIdx);
+    dirty_tracker::touch(fromClub);
+    dirty_tracker::touch(toClub);
+    dirty_tracker::touch(state.player(playerIdx));
 
     for (int slot = 0; slot < 24; ++slot) {
         if (fromClub.player_index[slot] == playerIdx) {
-            fromClub.player_index[slot] = -1;
+            state.setSquadSlot(fromClubIdx, slot, -1);
             break;
         }
     }
@@ -586,17 +579,20 @@ void completeTransfer(int16_t playerIdx, int fromClubIdx, int toClubIdx, int off
     toClub.bank_account -= offerAmount;
 
     if (destSlot != -1) {
-        toClub.player_index[destSlot] = playerIdx;
+        state.setSquadSlot(toClubIdx, destSlot, playerIdx);
     }
 
-    PlayerRecord &player = getPlayer(playerIdx);
+    PlayerRecord &player = state.player(playerIdx);
     player.contract = std::max<uint8_t>(player.contract, static_cast<uint8_t>(2));
     player.morl = std::max<uint8_t>(player.morl, static_cast<uint8_t>(6));
+    save_ledger::recordTransfer(state, playerIdx, fromClubIdx, toClubIdx, offerAmount);
 }
 
-void convertPlayerToCoach(struct gamea::ManagerRecord &manager, ClubRecord &club, int8_t clubPlayerIdx, char *footer,
-                          size_t footerSize) {
-    PlayerRecord &player = getPlayer(club.player_index[clubPlayerIdx]);
+void convertPlayerToCoach(GameState &state, struct gamea::ManagerRecord &manager, ClubRecord &club,
+                          int8_t clubPlayerIdx, char *footer, size_t footerSize) {
+    int16_t playerIdx = club.player_index[clubPlayerIdx];
+    int clubIdx = static_cast<int>(&club - state.clubs.club);
+    PlayerRecord &player = state.player(playerIdx);
 
     std::unordered_map<char, int> playerTypeToEmployeePosition = {
             {'G', 8}, {'D', 9}, {'M', 10}, {'A', 11}
@@ -604,6 +600,9 @@ void convertPlayerToCoach(struct gamea::ManagerRecord &manager, ClubRecord &club
 
     char playerType = determinePlayerType(player);
     int8_t playerRating = determinePlayerRating(player);
+    dirty_tracker::touch(manager);
+    dirty_tracker::touch(player);
+    dirty_tracker::touch(club);
 
     struct gamea::ManagerRecord::employee &employee = manager.employee[playerTypeToEmployeePosition[playerType]];
     strncpy(employee.name, player.name, 12);
@@ -635,11 +634,13 @@ void convertPlayerToCoach(struct gamea::ManagerRecord &manager, ClubRecord &club
     player.u23 = 0;
     player.u25 = 0;
 
-    club.player_index[clubPlayerIdx] = -1;
-
-    ClubRecord &new_club = getClub(92 + (std::rand() % (113 - 92 + 1)));
+    state.setSquadSlot(clubIdx, clubPlayerIdx, -1);
 
-    new_club.player_index[23] = clubPlayerIdx;
+    int newClubIdx = 92 + (std::rand() % (113 - 92 + 1));
+    ClubRecord &new_club = state.club(newClubIdx);
+    dirty_tracker::touch(new_club);
+    state.setSquadSlot(newClubIdx, 23, playerIdx);
+    save_ledger::recordCoachConversion(state, playerIdx, clubIdx, newClubIdx);
 
     snprintf(footer, footerSize, "CONVERTED TO A COACH");
 }
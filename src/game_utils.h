@@ -15,28 +15,28 @@ struct OfferResponse {
     char message[75];
 };
 
-ClubRecord& getClub(int idx);
-PlayerRecord& getPlayer(int16_t idx);
 char determinePlayerType(PlayerRecord &player);
 uint8_t determinePlayerRating(PlayerRecord &player);
 char determineValuationRole(const PlayerRecord &player);
-int determinePlayerPrice(const PlayerRecord &player, const ClubRecord &club, int squadSlot);
-int determinePlayerImportance(const PlayerRecord &player, const ClubRecord &club);
-std::vector<club_player> findFreePlayers();
-std::vector<club_player> getMyPlayers(int player);
-void levelAggression();
-void changeClub(int16_t newClubIdx, const std::filesystem::path &gamePath, int player=0);
+int determinePlayerPrice(const GameState &state, const PlayerRecord &player, const ClubRecord &club, int squadSlot);
+// The functions below read or change one GameState; pass defaultGameState for the save open in the editor.
+int determinePlayerImportance(const GameState &state, const PlayerRecord &player, const ClubRecord &club);
+std::vector<PlayerHandle> findFreePlayers(const GameState &state);
+std::vector<PlayerHandle> getMyPlayers(const GameState &state, int player);
+std::vector<PlayerHandle> squadPlayers(const GameState &state, int clubIdx);
+void levelAggression(GameState &state);
+void changeClub(GameState &state, int16_t newClubIdx, const std::filesystem::path &gamePath, int player=0);
 
 namespace game_utils {
 
-OfferResponse assessOffer(const club_player &playerInfo, int offerAmount, int currentGame);
-void beginOffer(InputHandler &input, char *footer, size_t footerSize, const club_player &playerInfo, int currentGame);
-int16_t findPlayerIndex(const PlayerRecord &player);
-int findClubIndexForPlayer(int16_t playerIdx);
+OfferResponse assessOffer(GameState &state, const PlayerHandle &handle, int offerAmount, int currentGame);
+void beginOffer(GameState &state, InputHandler &input, char *footer, size_t footerSize, const PlayerHandle &handle,
+                int currentGame);
+int findClubIndexForPlayer(const GameState &state, int16_t playerIdx);
 int findEmptySlot(ClubRecord &club);
-void completeTransfer(int16_t playerIdx, int fromClubIdx, int toClubIdx, int offerAmount);
-void convertPlayerToCoach(struct gamea::ManagerRecord &manager, ClubRecord &club, int8_t clubPlayerIdx, char *footer,
-                          size_t footerSize);
+void completeTransfer(GameState &state, int16_t playerIdx, int fromClubIdx, int toClubIdx, int offerAmount);
+void convertPlayerToCoach(GameState &state, struct gamea::ManagerRecord &manager, ClubRecord &club,
+                          int8_t clubPlayerIdx, char *footer, size_t footerSize);
 std::string formatCurrency(int amount);
 
 } // namespace game_utils
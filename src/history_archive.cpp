@@ -0,0 +1,393 @@
+// Append-only, delta-compressed history of a save slot's GAMEnA/B/C contents.
+#include "history_archive.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include "backup_store.h"
+#include "byte_io.h"
+#include "crc32c.h"
+#include "pm3_defs.hh"
+
+namespace history_archive {
+
+namespace {
+
+constexpr char kMagic[8] = {'P', 'M', '3', 'H', 'I', 'S', 'T', '1'};
+constexpr uint32_t kRecordMagic = 0x50414e53; // "SNAP"
+constexpr std::size_t kHeaderSize = sizeof(kMagic) + 4 * kFileCount;
+constexpr std::size_t kRecordHeaderSize = 12; // magic, body length, CRC32C of the body
+constexpr std::size_t kBodyHeaderSize = 16;   // recorded, year, turn, entry count
+constexpr std::size_t kEntrySize = 8;         // file, key, chunk, payload length
+constexpr std::size_t kFileSizes[kFileCount] = {sizeof(gamea), sizeof(gameb), sizeof(gamec)};
+// Zero runs shorter than this stay inside a literal; a run costs at least two length bytes.
+constexpr std::size_t kMinZeroRun = 3;
+
+using byte_io::load;
+using byte_io::put;
+
+void putVarint(std::vector<uint8_t> &out, std::size_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+std::size_t getVarint(const uint8_t *&p, const uint8_t *end) {
+    std::size_t value = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7) {
+        uint8_t byte = *p++;
+        value |= static_cast<std::size_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return value;
+        }
+    }
+    throw std::runtime_error("Corrupt history archive payload");
+}
+
+// `bytes` as (zero run, literal length, literal) triples; mostly zero when it is an XOR against the last state.
+void encode(const uint8_t *bytes, std::size_t size, std::vector<uint8_t> &out) {
+    std::size_t i = 0;
+    while (i < size) {
+        std::size_t zeros = 0;
+        while (i + zeros < size && bytes[i + zeros] == 0) {
+            ++zeros;
+        }
+        i += zeros;
+        std::size_t literal = i;
+        while (literal < size) {
+            std::size_t run = 0;
+            while (literal + run < size && run < kMinZeroRun && bytes[literal + run] == 0) {
+                ++run;
+            }
+            if (run == kMinZeroRun || literal + run == size) {
+                break;
+            }
+            literal += run + 1;
+        }
+        putVarint(out, zeros);
+        putVarint(out, literal - i);
+        out.insert(out.end(), bytes + i, bytes + literal);
+        i = literal;
+    }
+}
+
+// XORs an encoded payload into `state`.
+void apply(const std::vector<uint8_t> &payload, uint8_t *state, std::size_t size) {
+    const uint8_t *p = payload.data();
+    const uint8_t *end = p + payload.size();
+    std::size_t pos = 0;
+    while (p < end) {
+        pos += getVarint(p, end);
+        std::size_t literal = getVarint(p, end);
+        if (pos + literal > size || literal > static_cast<std::size_t>(end - p)) {
+            throw std::runtime_error("Corrupt history archive payload");
+        }
+        for (std::size_t i = 0; i < literal; ++i) {
+            state[pos++] ^= *p++;
+        }
+    }
+}
+
+std::vector<uint8_t> readAt(std::ifstream &in, uint64_t offset, std::size_t length) {
+    std::vector<uint8_t> bytes(length);
+    in.seekg(static_cast<std::streamoff>(offset));
+    if (!in.read(reinterpret_cast<char *>(bytes.data()), static_cast<std::streamsize>(length))) {
+        in.clear();
+        throw std::runtime_error("Could not read history archive");
+    }
+    return bytes;
+}
+
+std::ifstream openForRead(const std::filesystem::path &path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Could not open history archive: " + path.string());
+    }
+    return in;
+}
+
+} // namespace
+
+Archive::Archive(std::filesystem::path path) : archiveFile(std::move(path)) {
+    for (int file = 0; file < kFileCount; ++file) {
+        std::size_t chunkSize = backup_store::chunkSizeFor(kFileSizes[file]);
+        entries[file].resize((kFileSizes[file] + chunkSize - 1) / chunkSize);
+    }
+    loadIndex();
+}
+
+std::size_t Archive::chunkLength(int file, std::size_t chunk) const {
+    std::size_t chunkSize = backup_store::chunkSizeFor(kFileSizes[file]);
+    return std::min(chunkSize, kFileSizes[file] - chunk * chunkSize);
+}
+
+void Archive::loadIndex() {
+    std::error_code ec;
+    uint64_t fileSize = std::filesystem::file_size(archiveFile, ec);
+    if (ec) {
+        return;
+    }
+    std::ifstream in = openForRead(archiveFile);
+    if (fileSize < kHeaderSize) {
+        return;
+    }
+    std::vector<uint8_t> header = readAt(in, 0, kHeaderSize);
+    if (std::memcmp(header.data(), kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error("Not a history archive: " + archiveFile.string());
+    }
+    for (int file = 0; file < kFileCount; ++file) {
+        if (load<uint32_t>(header.data() + sizeof(kMagic) + 4 * file) != kFileSizes[file]) {
+            throw std::runtime_error("History archive has different file sizes: " + archiveFile.string());
+        }
+    }
+
+    uint64_t pos = kHeaderSize;
+    while (pos + kRecordHeaderSize <= fileSize) {
+        std::vector<uint8_t> recordHeader = readAt(in, pos, kRecordHeaderSize);
+        uint64_t bodyLength = load<uint32_t>(recordHeader.data() + 4);
+        uint64_t body = pos + kRecordHeaderSize;
+        if (load<uint32_t>(recordHeader.data()) != kRecordMagic || bodyLength < kBodyHeaderSize ||
+            body + bodyLength > fileSize) {
+            break;
+        }
+        // Only the last record can be torn by a crash mid-append; it is the only one whose payloads are checked.
+        bool last = body + bodyLength == fileSize;
+        if (last) {
+            std::vector<uint8_t> whole = readAt(in, body, bodyLength);
+            if (crc32c::compute(whole.data(), whole.size()) != load<uint32_t>(recordHeader.data() + 8)) {
+                break;
+            }
+        }
+
+        std::vector<uint8_t> head = readAt(in, body, kBodyHeaderSize);
+        SnapshotInfo info;
+        info.index = static_cast<uint32_t>(snapshotList.size());
+        info.recorded = static_cast<int64_t>(load<uint64_t>(head.data()));
+        info.year = load<uint16_t>(head.data() + 8);
+        info.turn = load<uint16_t>(head.data() + 10);
+        uint64_t entryCount = load<uint32_t>(head.data() + 12);
+        if (kBodyHeaderSize + entryCount * kEntrySize > bodyLength) {
+            throw std::runtime_error("Corrupt history archive: " + archiveFile.string());
+        }
+
+        std::vector<uint8_t> list = readAt(in, body + kBodyHeaderSize, entryCount * kEntrySize);
+        uint64_t payload = body + kBodyHeaderSize + entryCount * kEntrySize;
+        for (uint64_t i = 0; i < entryCount; ++i) {
+            const uint8_t *e = list.data() + i * kEntrySize;
+            int file = e[0];
+            std::size_t chunk = load<uint16_t>(e + 2);
+            auto length = load<uint32_t>(e + 4);
+            if (file >= kFileCount || chunk >= entries[file].size()) {
+                throw std::runtime_error("Corrupt history archive: " + archiveFile.string());
+            }
+            entries[file][chunk].push_back({info.index, e[1] != 0, payload, length});
+            payload += length;
+        }
+        if (payload != body + bodyLength) {
+            throw std::runtime_error("Corrupt history archive: " + archiveFile.string());
+        }
+        snapshotList.push_back(info);
+        pos = body + bodyLength;
+    }
+    validEnd = pos;
+}
+
+void Archive::replay(std::ifstream &in, int file, std::size_t chunk, std::size_t entry, uint8_t *state) const {
+    const auto &list = entries[file][chunk];
+    std::size_t key = entry;
+    while (key > 0 && !list[key].key) {
+        --key;
+    }
+    std::size_t length = chunkLength(file, chunk);
+    std::memset(state, 0, length);
+    for (std::size_t i = key; i <= entry; ++i) {
+        apply(readAt(in, list[i].offset, list[i].length), state, length);
+    }
+}
+
+void Archive::loadTip() {
+    if (tipLoaded) {
+        return;
+    }
+    std::ifstream in;
+    if (!snapshotList.empty()) {
+        in = openForRead(archiveFile);
+    }
+    for (int file = 0; file < kFileCount; ++file) {
+        tip[file].assign(kFileSizes[file], 0);
+        std::size_t chunkSize = backup_store::chunkSizeFor(kFileSizes[file]);
+        for (std::size_t chunk = 0; chunk < entries[file].size(); ++chunk) {
+            if (!entries[file][chunk].empty()) {
+                replay(in, file, chunk, entries[file][chunk].size() - 1, tip[file].data() + chunk * chunkSize);
+            }
+        }
+    }
+    tipLoaded = true;
+}
+
+AppendResult Archive::append(const void *const (&files)[kFileCount], int64_t recorded) {
+    loadTip();
+
+    struct Pending {
+        int file;
+        std::size_t chunk;
+        bool key;
+        std::vector<uint8_t> payload;
+    };
+    std::vector<Pending> pending;
+    std::vector<uint8_t> delta;
+    for (int file = 0; file < kFileCount; ++file) {
+        const auto *bytes = static_cast<const uint8_t *>(files[file]);
+        std::size_t chunkSize = backup_store::chunkSizeFor(kFileSizes[file]);
+        for (std::size_t chunk = 0; chunk < entries[file].size(); ++chunk) {
+            std::size_t start = chunk * chunkSize;
+            std::size_t length = chunkLength(file, chunk);
+            if (std::memcmp(tip[file].data() + start, bytes + start, length) == 0) {
+                continue;
+            }
+            const auto &list = entries[file][chunk];
+            std::size_t chain = 0;
+            while (chain < list.size() && !list[list.size() - 1 - chain].key) {
+                ++chain;
+            }
+            bool key = list.empty() || chain + 1 >= kKeyInterval;
+            delta.assign(bytes + start, bytes + start + length);
+            if (!key) {
+                for (std::size_t i = 0; i < length; ++i) {
+                    delta[i] ^= tip[file][start + i];
+                }
+            }
+            Pending next{file, chunk, key, {}};
+            encode(delta.data(), length, next.payload);
+            pending.push_back(std::move(next));
+        }
+    }
+
+    AppendResult result;
+    if (pending.empty()) {
+        result.unchanged = true;
+        return result;
+    }
+
+    const auto *game = static_cast<const gamea *>(files[0]);
+    std::vector<uint8_t> body;
+    put<uint64_t>(body, static_cast<uint64_t>(recorded));
+    put<uint16_t>(body, game->year);
+    put<uint16_t>(body, game->turn);
+    put<uint32_t>(body, pending.size());
+    for (const auto &p : pending) {
+        put<uint8_t>(body, static_cast<uint8_t>(p.file));
+        put<uint8_t>(body, p.key ? 1 : 0);
+        put<uint16_t>(body, p.chunk);
+        put<uint32_t>(body, p.payload.size());
+    }
+    for (const auto &p : pending) {
+        body.insert(body.end(), p.payload.begin(), p.payload.end());
+    }
+    std::vector<uint8_t> record;
+    put<uint32_t>(record, kRecordMagic);
+    put<uint32_t>(record, body.size());
+    put<uint32_t>(record, crc32c::compute(body.data(), body.size()));
+    record.insert(record.end(), body.begin(), body.end());
+
+    // Start a new archive, or cut off a torn record left by an interrupted append.
+    std::error_code ec;
+    if (validEnd == 0) {
+        std::filesystem::create_directories(archiveFile.parent_path(), ec);
+        std::vector<uint8_t> header(kMagic, kMagic + sizeof(kMagic));
+        for (std::size_t size : kFileSizes) {
+            put<uint32_t>(header, size);
+        }
+        record.insert(record.begin(), header.begin(), header.end());
+        std::ofstream(archiveFile, std::ios::binary | std::ios::trunc);
+    } else if (std::filesystem::file_size(archiveFile, ec) != validEnd) {
+        std::filesystem::resize_file(archiveFile, validEnd);
+    }
+    std::ofstream out(archiveFile, std::ios::binary | std::ios::app);
+    out.write(reinterpret_cast<const char *>(record.data()), static_cast<std::streamsize>(record.size()));
+    out.flush();
+    if (!out) {
+        throw std::runtime_error("Could not append to history archive: " + archiveFile.string());
+    }
+
+    SnapshotInfo info;
+    info.index = static_cast<uint32_t>(snapshotList.size());
+    info.recorded = recorded;
+    info.year = game->year;
+    info.turn = game->turn;
+    uint64_t payload = validEnd + record.size() - body.size() + kBodyHeaderSize + pending.size() * kEntrySize;
+    for (const auto &p : pending) {
+        entries[p.file][p.chunk].push_back({info.index, p.key, payload, static_cast<uint32_t>(p.payload.size())});
+        payload += p.payload.size();
+        std::size_t start = p.chunk * backup_store::chunkSizeFor(kFileSizes[p.file]);
+        std::memcpy(tip[p.file].data() + start, static_cast<const uint8_t *>(files[p.file]) + start,
+                    chunkLength(p.file, p.chunk));
+    }
+    snapshotList.push_back(info);
+    validEnd += record.size();
+
+    result.changedChunks = pending.size();
+    result.bytesWritten = record.size();
+    return result;
+}
+
+void Archive::history(int file, std::size_t offset, std::size_t length, const HistoryVisitor &visitor) const {
+    if (file < 0 || file >= kFileCount || length == 0 || offset + length > kFileSizes[file]) {
+        throw std::out_of_range("History query outside the save file");
+    }
+    if (snapshotList.empty()) {
+        return;
+    }
+    std::ifstream in = openForRead(archiveFile);
+    std::size_t chunkSize = backup_store::chunkSizeFor(kFileSizes[file]);
+    std::size_t first = offset / chunkSize;
+    std::size_t last = (offset + length - 1) / chunkSize;
+    std::vector<uint8_t> state((last - first + 1) * chunkSize, 0);
+    std::vector<std::size_t> next(last - first + 1, 0);
+
+    for (const SnapshotInfo &snapshot : snapshotList) {
+        for (std::size_t chunk = first; chunk <= last; ++chunk) {
+            const auto &list = entries[file][chunk];
+            std::size_t &i = next[chunk - first];
+            uint8_t *chunkState = state.data() + (chunk - first) * chunkSize;
+            for (; i < list.size() && list[i].snapshot == snapshot.index; ++i) {
+                if (list[i].key) {
+                    std::memset(chunkState, 0, chunkLength(file, chunk));
+                }
+                apply(readAt(in, list[i].offset, list[i].length), chunkState, chunkLength(file, chunk));
+            }
+        }
+        visitor(snapshot, state.data() + (offset - first * chunkSize));
+    }
+}
+
+std::vector<uint8_t> Archive::read(int file, uint32_t snapshot) const {
+    if (file < 0 || file >= kFileCount || snapshot >= snapshotList.size()) {
+        throw std::out_of_range("No such snapshot in the history archive");
+    }
+    std::ifstream in = openForRead(archiveFile);
+    std::vector<uint8_t> contents(kFileSizes[file], 0);
+    std::size_t chunkSize = backup_store::chunkSizeFor(kFileSizes[file]);
+    for (std::size_t chunk = 0; chunk < entries[file].size(); ++chunk) {
+        const auto &list = entries[file][chunk];
+        auto after = std::upper_bound(list.begin(), list.end(), snapshot,
+                                      [](uint32_t s, const Entry &entry) { return s < entry.snapshot; });
+        if (after != list.begin()) {
+            replay(in, file, chunk, static_cast<std::size_t>(after - list.begin()) - 1,
+                   contents.data() + chunk * chunkSize);
+        }
+    }
+    return contents;
+}
+
+std::filesystem::path archivePath(const std::filesystem::path &backupDir, int gameNumber) {
+    return backupDir / (std::string{kGameFilePrefix} + std::to_string(gameNumber) + kArchiveSuffix);
+}
+
+} // namespace history_archive
@@ -0,0 +1,79 @@
+// Append-only, delta-compressed history of a save slot's GAMEnA/B/C contents.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <iosfwd>
+#include <vector>
+
+namespace history_archive {
+
+inline constexpr int kFileCount = 3;
+inline constexpr const char *kArchiveSuffix = ".HST";
+// A chunk's delta chain is cut by a full copy after this many deltas, bounding the work to read one snapshot.
+inline constexpr uint32_t kKeyInterval = 256;
+
+struct SnapshotInfo {
+    uint32_t index = 0;
+    int64_t recorded = 0; // time_t of the load or save that produced it
+    uint16_t year = 0;
+    uint16_t turn = 0;
+};
+
+struct AppendResult {
+    bool unchanged = false; // identical to the last snapshot, nothing was written
+    std::size_t changedChunks = 0;
+    std::size_t bytesWritten = 0;
+};
+
+// Files are split into the same record-aligned chunks as the backup store (7 clubs, 100 players). Each snapshot
+// stores, for every chunk that changed, the XOR against the chunk's previous contents with runs of zeros
+// elided. Queries replay only the chunks covering the bytes asked for.
+class Archive {
+public:
+    // Reads the snapshot index of `path`, if it exists. A torn record at the end is ignored and overwritten by
+    // the next append. Throws if the file is not a history archive.
+    explicit Archive(std::filesystem::path path);
+
+    const std::vector<SnapshotInfo> &snapshots() const { return snapshotList; }
+
+    // Appends the slot's contents (gamea, gameb, gamec) unless they match the last snapshot.
+    AppendResult append(const void *const (&files)[kFileCount], int64_t recorded);
+
+    // Calls `visitor` for every snapshot with bytes [offset, offset + length) of `file` as they were then.
+    using HistoryVisitor = std::function<void(const SnapshotInfo &snapshot, const uint8_t *bytes)>;
+    void history(int file, std::size_t offset, std::size_t length, const HistoryVisitor &visitor) const;
+
+    // The full contents of `file` at one snapshot.
+    std::vector<uint8_t> read(int file, uint32_t snapshot) const;
+
+    std::uintmax_t sizeOnDisk() const { return validEnd; }
+
+private:
+    struct Entry {
+        uint32_t snapshot;
+        bool key;
+        uint64_t offset;
+        uint32_t length;
+    };
+
+    void loadIndex();
+    void loadTip();
+    // Rebuilds `chunk` as of entries[file][chunk][entry] from the nearest key at or before it.
+    void replay(std::ifstream &in, int file, std::size_t chunk, std::size_t entry, uint8_t *state) const;
+    std::size_t chunkLength(int file, std::size_t chunk) const;
+
+    std::filesystem::path archiveFile;
+    std::vector<SnapshotInfo> snapshotList;
+    std::vector<std::vector<Entry>> entries[kFileCount];
+    uint64_t validEnd = 0;
+    bool tipLoaded = false;
+    std::vector<uint8_t> tip[kFileCount];
+};
+
+// <saves>/PM3000/GAMEn.HST
+std::filesystem::path archivePath(const std::filesystem::path &backupDir, int gameNumber);
+
+} // namespace history_archive
@@ -0,0 +1,198 @@
+// Cached description of a PM3 folder: game type, saves directory and which slot files exist.
+#include "installation.h"
+
+#include <cctype>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include "fat_image.h"
+#include "io.h"
+
+namespace io {
+
+namespace {
+
+// Matches GAME<n><letter> without regard to case, the way DOS (and most DOSBox mounts) see the files.
+bool parseSaveFileName(const std::string &name, int &gameNumber, int &letter) {
+    if (name.size() != kGameFilePrefix.size() + 2) {
+        return false;
+    }
+    for (std::size_t i = 0; i < kGameFilePrefix.size(); ++i) {
+        if (std::toupper(static_cast<unsigned char>(name[i])) != kGameFilePrefix[i]) {
+            return false;
+        }
+    }
+    gameNumber = name[kGameFilePrefix.size()] - '0';
+    letter = std::toupper(static_cast<unsigned char>(name[kGameFilePrefix.size() + 1])) - 'A';
+    return gameNumber >= 1 && gameNumber <= kSaveSlotCount && letter >= 0 && letter < kSaveSlotLetters;
+}
+
+std::mutex gInstallationMutex;
+std::shared_ptr<const Installation> gInstallation;
+
+} // namespace
+
+Installation::Installation(std::filesystem::path gamePath) : root(std::move(gamePath)) {
+    // Watch before probing so a change that lands mid-scan still marks the result stale.
+    watch();
+    type = getPm3GameType(root);
+    if (const char *folder = getSavesFolder(type)) {
+        saves = root / folder;
+        scanSavesFolder();
+    }
+}
+
+Installation::~Installation() {
+#if defined(__linux__)
+    if (watchFd >= 0) {
+        ::close(watchFd);
+    }
+#endif
+}
+
+void Installation::scanSavesFolder() {
+    std::filesystem::path image;
+    std::string inner;
+    if (splitDiskImagePath(saves, image, inner)) {
+        try {
+            fat_image::Image disk(image);
+            for (const auto &entry : disk.list(inner)) {
+                int gameNumber = 0;
+                int letter = 0;
+                if (!entry.directory && parseSaveFileName(entry.name, gameNumber, letter)) {
+                    present[gameNumber - 1][letter] = true;
+                    sizes[gameNumber - 1][letter] = entry.size;
+                }
+            }
+        } catch (const std::exception &) {
+            // A missing saves directory simply means no slots, as on the host.
+        }
+        return;
+    }
+
+    std::error_code ec;
+    for (std::filesystem::directory_iterator it(saves, ec), end; !ec && it != end; it.increment(ec)) {
+        int gameNumber = 0;
+        int letter = 0;
+        if (!parseSaveFileName(it->path().filename().string(), gameNumber, letter)) {
+            continue;
+        }
+        std::error_code sizeEc;
+        uintmax_t size = it->file_size(sizeEc);
+        if (sizeEc) {
+            continue;
+        }
+        present[gameNumber - 1][letter] = true;
+        sizes[gameNumber - 1][letter] = size;
+    }
+}
+
+void Installation::watch() {
+#if defined(__linux__)
+    watchFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (watchFd < 0) {
+        return;
+    }
+    constexpr uint32_t kLayoutEvents = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF |
+                                       IN_MOVE_SELF;
+    std::filesystem::path image;
+    std::string inner;
+    if (splitDiskImagePath(root, image, inner)) {
+        // Inside a disk image any write to the image may have changed the saves.
+        rootWatch = inotify_add_watch(watchFd, image.c_str(), IN_MODIFY | IN_CLOSE_WRITE | IN_DELETE_SELF |
+                                                                  IN_MOVE_SELF);
+        if (rootWatch < 0) {
+            ::close(watchFd);
+            watchFd = -1;
+        }
+        return;
+    }
+    rootWatch = inotify_add_watch(watchFd, root.c_str(), kLayoutEvents);
+    if (rootWatch < 0) {
+        ::close(watchFd);
+        watchFd = -1;
+        return;
+    }
+    // Both saves folder spellings are watched so the descriptor notices whichever one exists; a missing one
+    // simply fails to register, and creating it later shows up as IN_CREATE on the root. Only the layout is
+    // cached, so writes into existing files are left to the SaveWatcher.
+    for (std::string_view folder : {kStandardSavesPath, kDeluxeSavesPath}) {
+        std::filesystem::path path = root / std::string{folder};
+        inotify_add_watch(watchFd, path.c_str(), kLayoutEvents);
+    }
+#endif
+}
+
+bool Installation::changed() const {
+#if defined(__linux__)
+    if (watchFd < 0) {
+        return false;
+    }
+    alignas(struct inotify_event) char buffer[4096];
+    bool any = false;
+    for (;;) {
+        ssize_t n = ::read(watchFd, buffer, sizeof(buffer));
+        if (n <= 0) {
+            break;
+        }
+        // In the saves folder only slot files count: the temp files, SAVES.DIR and PREFS that PM3000 writes
+        // there do not change which slots exist.
+        for (ssize_t at = 0; at < n;) {
+            const auto *event = reinterpret_cast<const struct inotify_event *>(buffer + at);
+            at += static_cast<ssize_t>(sizeof(struct inotify_event) + event->len);
+            int gameNumber = 0;
+            int letter = 0;
+            any = any || event->wd == rootWatch || event->len == 0 ||
+                  (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED | IN_Q_OVERFLOW)) != 0 ||
+                  parseSaveFileName(event->name, gameNumber, letter);
+        }
+    }
+    return any;
+#else
+    return false;
+#endif
+}
+
+std::filesystem::path Installation::saveFilePath(int gameNumber, char gameLetter) const {
+    return saves / (std::string{kGameFilePrefix} + std::to_string(gameNumber) + gameLetter);
+}
+
+bool Installation::hasSaveFile(int gameNumber, char gameLetter) const {
+    int letter = gameLetter - 'A';
+    if (gameNumber < 1 || gameNumber > kSaveSlotCount || letter < 0 || letter >= kSaveSlotLetters) {
+        return false;
+    }
+    return present[gameNumber - 1][letter];
+}
+
+bool Installation::hasSlot(int gameNumber) const {
+    return hasSaveFile(gameNumber, 'A') && hasSaveFile(gameNumber, 'B') && hasSaveFile(gameNumber, 'C');
+}
+
+uintmax_t Installation::saveFileSize(int gameNumber, char gameLetter) const {
+    return hasSaveFile(gameNumber, gameLetter) ? sizes[gameNumber - 1][gameLetter - 'A'] : 0;
+}
+
+std::shared_ptr<const Installation> installationFor(const std::filesystem::path &gamePath) {
+    std::lock_guard<std::mutex> lock(gInstallationMutex);
+    // Only the current folder is cached; tools and tests that switch folders simply re-probe.
+    if (!gInstallation || gInstallation->gamePath() != gamePath || gInstallation->changed()) {
+        gInstallation = std::make_shared<const Installation>(gamePath);
+    }
+    return gInstallation;
+}
+
+void invalidateInstallation() {
+    std::lock_guard<std::mutex> lock(gInstallationMutex);
+    gInstallation.reset();
+}
+
+} // namespace io
@@ -0,0 +1,63 @@
+// Cached description of a PM3 folder: game type, saves directory and which slot files exist.
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+
+#include "pm3_defs.hh"
+
+namespace io {
+
+inline constexpr int kSaveSlotCount = 8;
+inline constexpr int kSaveSlotLetters = 3;
+
+// Built by probing the folder once; path lookups afterwards are pure string work. On Linux the folder and its
+// saves directory (or the disk image holding them) are watched with inotify and the descriptor is rebuilt when a
+// slot file is created, removed or renamed (for an image, when it is written). Elsewhere callers refresh it
+// explicitly (see installationFor).
+class Installation {
+public:
+    explicit Installation(std::filesystem::path gamePath);
+    ~Installation();
+
+    Installation(const Installation &) = delete;
+    Installation &operator=(const Installation &) = delete;
+
+    const std::filesystem::path &gamePath() const { return root; }
+    Pm3GameType gameType() const { return type; }
+    // Empty when the folder holds no PM3 executable.
+    const std::filesystem::path &savesFolder() const { return saves; }
+    std::filesystem::path saveFilePath(int gameNumber, char gameLetter) const;
+
+    bool hasSaveFile(int gameNumber, char gameLetter) const;
+    bool hasSlot(int gameNumber) const;
+    // Size recorded when the folder was scanned, 0 for a missing file.
+    uintmax_t saveFileSize(int gameNumber, char gameLetter) const;
+
+    // True if the folder is watched, i.e. the cached state tracks the disk on its own.
+    bool watched() const { return watchFd >= 0; }
+    // Drains pending change notifications; true if anything relevant happened since the last call.
+    bool changed() const;
+
+private:
+    void scanSavesFolder();
+    void watch();
+
+    std::filesystem::path root;
+    std::filesystem::path saves;
+    Pm3GameType type = Pm3GameType::Unknown;
+    bool present[kSaveSlotCount][kSaveSlotLetters]{};
+    uintmax_t sizes[kSaveSlotCount][kSaveSlotLetters]{};
+    int watchFd = -1;
+    // Watch on the PM3 folder, or on the disk image holding the saves.
+    int rootWatch = -1;
+};
+
+// The descriptor for `gamePath`, rebuilt if the folder changed since it was last probed. Safe to call from
+// the I/O worker; the returned object is immutable.
+std::shared_ptr<const Installation> installationFor(const std::filesystem::path &gamePath);
+// Forces the next installationFor() to re-probe, for platforms without change notification.
+void invalidateInstallation();
+
+} // namespace io
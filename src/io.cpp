@@ -1,29 +1,126 @@
 // IO/persistence helpers for saves, metadata, and prefs.
 #include "io.h"
 
+#include <algorithm>
 #include <array>
+#include <cstddef>
 #include <string_view>
 #include <cstdio>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #include <cstring>
+#include <ctime>
 
 #include "nfd.h"
 #include "config/constants.h"
 #include "input.h"
+#include "io_worker.h"
+#include "backup_store.h"
+#include "base_data.h"
+#include "dirty_tracker.h"
+#include "edit_journal.h"
+#include "fat_image.h"
+#include "history_archive.h"
+#include "installation.h"
+#include "mapped_save.h"
 #include "pm3_data.h"
-
-static std::string gPm3LastError;
+#include "pm3_schema.h"
+#include "save_fingerprint.h"
+#include "save_journal.h"
+#include "save_ledger.h"
+#include "slot_summary.h"
+
+// Per thread, so jobs on the I/O worker cannot clobber the message the UI is showing.
+static thread_local std::string gPm3LastError;
 static std::vector<uint8_t> gGameaTail;
 static std::size_t gGameaExtraBytes = 0;
 
+static bool load_whole_file(const std::filesystem::path &filepath, std::vector<uint8_t> &contents) {
+    std::filesystem::path image;
+    std::string inner;
+    if (io::splitDiskImagePath(filepath, image, inner)) {
+        try {
+            fat_image::Image disk(image);
+            std::optional<fat_image::Entry> entry = disk.find(inner);
+            if (!entry || entry->directory) {
+                gPm3LastError = "Missing file: " + filepath.string();
+                return false;
+            }
+            contents = disk.read(*entry);
+        } catch (const std::exception &e) {
+            gPm3LastError = e.what();
+            return false;
+        }
+        return true;
+    }
+
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file) {
+        gPm3LastError = "Missing file: " + filepath.string();
+        return false;
+    }
+    contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+// Inside a disk image the file must already exist with exactly `size` bytes; it is overwritten in place.
+static void save_whole_file(const std::filesystem::path &filepath, const void *data, std::size_t size) {
+    std::filesystem::path image;
+    std::string inner;
+    if (io::splitDiskImagePath(filepath, image, inner)) {
+        fat_image::Image disk(image, true);
+        std::optional<fat_image::Entry> entry = disk.find(inner);
+        if (!entry || entry->directory || entry->size != size) {
+            throw std::runtime_error(filepath.string() + " must already exist with " + std::to_string(size) +
+                                     " bytes to be written inside a disk image");
+        }
+        disk.write(*entry, 0, data, size);
+        return;
+    }
+
+    std::ofstream file(filepath, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Could not open file for writing: " + filepath.string());
+    }
+    file.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+}
+
+// For files the base data store may have mapped: a host file is written beside and renamed over, so a mapping
+// of the old file keeps reading the old bytes instead of faulting on the truncation.
+static void replace_whole_file(const std::filesystem::path &filepath, const void *data, std::size_t size) {
+    std::filesystem::path image;
+    std::string inner;
+    if (io::splitDiskImagePath(filepath, image, inner)) {
+        save_whole_file(filepath, data, size);
+        return;
+    }
+
+    save_journal::replaceFileDurably(filepath, data, size);
+}
+
 template <typename T>
 static bool load_binary_file(const std::filesystem::path &filepath, T &data) {
+    std::filesystem::path image;
+    std::string inner;
+    if (io::splitDiskImagePath(filepath, image, inner)) {
+        std::vector<uint8_t> contents;
+        if (!load_whole_file(filepath, contents)) {
+            return false;
+        }
+        std::memcpy(&data, contents.data(), std::min(contents.size(), sizeof(T)));
+        return true;
+    }
+
     std::ifstream file(filepath, std::ios::binary);
     if (!file) {
         gPm3LastError = "Missing file: " + filepath.string();
@@ -35,11 +132,7 @@ static bool load_binary_file(const std::filesystem::path &filepath, T &data) {
 
 template <typename T>
 static void save_binary_file(const std::filesystem::path &filepath, const T &data) {
-    std::ofstream file(filepath, std::ios::binary);
-    if (!file) {
-        throw std::runtime_error("Could not open file for writing: " + filepath.string());
-    }
-    file.write(reinterpret_cast<const char*>(&data), sizeof(T));
+    save_whole_file(filepath, &data, sizeof(T));
 }
 
 namespace io {
@@ -52,50 +145,38 @@ void loadBinaries(int game_nr, const std::filesystem::path &game_path, gamea &ga
     }
 }
 
-void loadDefaultGamedata(const std::filesystem::path &game_path, gamea &game_data) {
-    gGameaTail.clear();
-    std::filesystem::path path = constructGameFilePath(game_path, std::string{kGameDataFile});
-    std::ifstream file(path, std::ios::binary);
-    if (!file) {
-        gPm3LastError = "Missing file: " + path.string();
-        throw std::runtime_error(gPm3LastError);
-    }
-    std::vector<char> buf((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-    if (buf.size() < sizeof(gamea)) {
-        gPm3LastError = "File too small: " + path.string();
+// The base files are read through the shared store, so repeated loads of an unchanged installation cost a memcpy.
+static std::shared_ptr<const BaseData> base_data_or_throw(const std::filesystem::path &game_path) {
+    try {
+        return baseDataFor(game_path);
+    } catch (const std::exception &e) {
+        gPm3LastError = e.what();
         throw std::runtime_error(gPm3LastError);
     }
-    std::memcpy(&game_data, buf.data(), sizeof(gamea));
-    if (buf.size() > sizeof(gamea)) {
-        gGameaTail.assign(buf.begin() + static_cast<std::ptrdiff_t>(sizeof(gamea)), buf.end());
-        gGameaExtraBytes = buf.size() - sizeof(gamea);
-    } else {
-        gGameaExtraBytes = 0;
-    }
+}
+
+void loadDefaultGamedata(const std::filesystem::path &game_path, gamea &game_data) {
+    std::shared_ptr<const BaseData> base = base_data_or_throw(game_path);
+    std::memcpy(&game_data, &base->gameA(), sizeof(gamea));
+    gGameaTail.assign(base->gameaTail(), base->gameaTail() + base->gameaTailSize());
+    gGameaExtraBytes = base->gameaTailSize();
 }
 
 void loadDefaultClubdata(const std::filesystem::path &game_path, gameb &club_data) {
-    if (!load_binary_file(constructGameFilePath(game_path, std::string{kClubDataFile}), club_data)) {
-        throw std::runtime_error(gPm3LastError);
-    }
+    std::memcpy(&club_data, &base_data_or_throw(game_path)->gameB(), sizeof(gameb));
 }
 
 void loadDefaultPlaydata(const std::filesystem::path &game_path, gamec &player_data) {
-    if (!load_binary_file(constructGameFilePath(game_path, std::string{kPlayDataFile}), player_data)) {
-        throw std::runtime_error(gPm3LastError);
-    }
+    std::memcpy(&player_data, &base_data_or_throw(game_path)->gameC(), sizeof(gamec));
 }
 
 void saveDefaultGamedata(const std::filesystem::path &game_path, const gamea &game_data) {
+    invalidateBaseData();
     std::filesystem::path path = constructGameFilePath(game_path, std::string{kGameDataFile});
-    std::ofstream file(path, std::ios::binary);
-    if (!file) {
-        throw std::runtime_error("Could not open file for writing: " + path.string());
-    }
-    file.write(reinterpret_cast<const char*>(&game_data), sizeof(gamea));
-    if (!gGameaTail.empty()) {
-        file.write(reinterpret_cast<const char*>(gGameaTail.data()), static_cast<std::streamsize>(gGameaTail.size()));
-    }
+    std::vector<uint8_t> contents(reinterpret_cast<const uint8_t *>(&game_data),
+                                  reinterpret_cast<const uint8_t *>(&game_data) + sizeof(gamea));
+    contents.insert(contents.end(), gGameaTail.begin(), gGameaTail.end());
+    replace_whole_file(path, contents.data(), contents.size());
 }
 
 std::size_t getGameaExtraBytes() {
@@ -103,14 +184,11 @@ std::size_t getGameaExtraBytes() {
 }
 
 bool loadMetadata(const std::filesystem::path &game_path, saves &saves_dir_data, prefs &prefs_data) {
-    Pm3GameType game_type = getPm3GameType(game_path);
-    const char* saves_folder = getSavesFolder(game_type);
-    if (saves_folder == nullptr) {
-        gPm3LastError = "Invalid PM3 folder: could not find PM3 executable in " + game_path.string();
+    std::filesystem::path full_path = constructSavesFolderPath(game_path);
+    if (full_path.empty()) {
         return false;
     }
 
-    std::filesystem::path full_path = game_path / saves_folder;
     bool saves_ok = load_binary_file(full_path / std::string{kSavesDirFile}, saves_dir_data);
     bool prefs_ok = load_binary_file(full_path / std::string{kPrefsFile}, prefs_data);
 
@@ -130,12 +208,44 @@ void saveBinaries(int game_nr, const std::filesystem::path &game_path, gamea &ga
     save_binary_file(constructSaveFilePath(game_path, game_nr, 'C'), player_data);
 }
 
+void loadBinaries(int game_nr, const std::filesystem::path &game_path, GameState &state) {
+    loadBinaries(game_nr, game_path, state.game, state.clubs, state.players);
+    state.squadsReplaced();
+}
+
+void saveBinaries(int game_nr, const std::filesystem::path &game_path, const GameState &state) {
+    save_binary_file(constructSaveFilePath(game_path, game_nr, 'A'), state.game);
+    save_binary_file(constructSaveFilePath(game_path, game_nr, 'B'), state.clubs);
+    save_binary_file(constructSaveFilePath(game_path, game_nr, 'C'), state.players);
+}
+
+void loadDefaultData(const std::filesystem::path &game_path, GameState &state) {
+    std::shared_ptr<const BaseData> base = base_data_or_throw(game_path);
+    std::memcpy(&state.game, &base->gameA(), sizeof(gamea));
+    std::memcpy(&state.clubs, &base->gameB(), sizeof(gameb));
+    std::memcpy(&state.players, &base->gameC(), sizeof(gamec));
+    state.gameaTail.assign(base->gameaTail(), base->gameaTail() + base->gameaTailSize());
+    state.squadsReplaced();
+}
+
+void saveDefaultData(const std::filesystem::path &game_path, const GameState &state) {
+    invalidateBaseData();
+    std::vector<uint8_t> contents(reinterpret_cast<const uint8_t *>(&state.game),
+                                  reinterpret_cast<const uint8_t *>(&state.game) + sizeof(gamea));
+    contents.insert(contents.end(), state.gameaTail.begin(), state.gameaTail.end());
+    replace_whole_file(constructGameFilePath(game_path, std::string{kGameDataFile}), contents.data(), contents.size());
+    replace_whole_file(constructGameFilePath(game_path, std::string{kClubDataFile}), &state.clubs, sizeof(gameb));
+    replace_whole_file(constructGameFilePath(game_path, std::string{kPlayDataFile}), &state.players, sizeof(gamec));
+}
+
 void saveDefaultClubdata(const std::filesystem::path &game_path, const gameb &club_data) {
-    save_binary_file(constructGameFilePath(game_path, std::string{kClubDataFile}), club_data);
+    invalidateBaseData();
+    replace_whole_file(constructGameFilePath(game_path, std::string{kClubDataFile}), &club_data, sizeof(gameb));
 }
 
 void saveDefaultPlaydata(const std::filesystem::path &game_path, const gamec &player_data) {
-    save_binary_file(constructGameFilePath(game_path, std::string{kPlayDataFile}), player_data);
+    invalidateBaseData();
+    replace_whole_file(constructGameFilePath(game_path, std::string{kPlayDataFile}), &player_data, sizeof(gamec));
 }
 
 void saveMetadata(const std::filesystem::path &game_path, saves &saves_dir_data, prefs &prefs_data) {
@@ -143,32 +253,37 @@ void saveMetadata(const std::filesystem::path &game_path, saves &saves_dir_data,
     save_binary_file(constructGameFilePath(game_path, std::string{kPrefsFile}), prefs_data);
 }
 
-void updateMetadata(int game_nr, const std::filesystem::path &game_path) {
-    (void) game_path;
-    savesDir.game[game_nr - 1].turn = gameData.turn;
-    savesDir.game[game_nr - 1].year = gameData.year;
+static void fillSaveEntry(saves &saves_dir_data, int game_nr, const gamea &game_data) {
+    saves_dir_data.game[game_nr - 1].turn = game_data.turn;
+    saves_dir_data.game[game_nr - 1].year = game_data.year;
     for (int i = 0; i < 2; ++i) {
-        std::memcpy(savesDir.game[game_nr - 1].manager[i].name,
-                    gameData.manager[i].name,
-                    sizeof(savesDir.game[game_nr - 1].manager[i].name));
-        savesDir.game[game_nr - 1].manager[i].club_idx =
-                static_cast<uint8_t>(gameData.manager[i].club_idx);
+        std::memcpy(saves_dir_data.game[game_nr - 1].manager[i].name,
+                    game_data.manager[i].name,
+                    sizeof(saves_dir_data.game[game_nr - 1].manager[i].name));
+        saves_dir_data.game[game_nr - 1].manager[i].club_idx =
+                static_cast<uint8_t>(game_data.manager[i].club_idx);
     }
 }
 
-std::filesystem::path constructSavesFolderPath(const std::filesystem::path& game_path) {
-    Pm3GameType game_type = getPm3GameType(game_path);
-    const char *savesFolder = getSavesFolder(game_type);
-    if (savesFolder == nullptr) {
+void updateMetadata(int game_nr, const std::filesystem::path &game_path) {
+    (void) game_path;
+    fillSaveEntry(savesDir, game_nr, gameData);
+}
+
+static std::shared_ptr<const Installation> checkedInstallation(const std::filesystem::path &game_path) {
+    auto installation = installationFor(game_path);
+    if (installation->savesFolder().empty()) {
         gPm3LastError = "Invalid PM3 folder: could not find PM3 executable in " + game_path.string();
-        return {};
     }
+    return installation;
+}
 
-    return game_path / savesFolder;
+std::filesystem::path constructSavesFolderPath(const std::filesystem::path& game_path) {
+    return checkedInstallation(game_path)->savesFolder();
 }
 
 std::filesystem::path constructSaveFilePath(const std::filesystem::path& game_path, int gameNumber, char gameLetter) {
-    return constructSavesFolderPath(game_path) / (std::string{kGameFilePrefix} + std::to_string(gameNumber) + gameLetter);
+    return checkedInstallation(game_path)->saveFilePath(gameNumber, gameLetter);
 }
 
 std::filesystem::path constructGameFilePath(const std::filesystem::path &game_path, const std::string &file_name) {
@@ -176,6 +291,23 @@ std::filesystem::path constructGameFilePath(const std::filesystem::path &game_pa
 }
 
 Pm3GameType getPm3GameType(const std::filesystem::path &game_path) {
+    std::filesystem::path image;
+    std::string inner;
+    if (splitDiskImagePath(game_path, image, inner)) {
+        try {
+            fat_image::Image disk(image);
+            if (disk.find(inner + "/" + std::string{kExeStandardFilename})) {
+                return Pm3GameType::Standard;
+            }
+            if (disk.find(inner + "/" + std::string{kExeDeluxeFilename})) {
+                return Pm3GameType::Deluxe;
+            }
+        } catch (const std::exception &e) {
+            gPm3LastError = e.what();
+        }
+        return Pm3GameType::Unknown;
+    }
+
     std::filesystem::path full_path;
     full_path = game_path / kExeStandardFilename;
     if (std::filesystem::exists(full_path)) {
@@ -190,6 +322,45 @@ Pm3GameType getPm3GameType(const std::filesystem::path &game_path) {
     return Pm3GameType::Unknown;
 }
 
+bool splitDiskImagePath(const std::filesystem::path &path, std::filesystem::path &image, std::string &inner) {
+    std::filesystem::path prefix;
+    for (auto it = path.begin(); it != path.end(); ++it) {
+        prefix /= *it;
+        std::error_code ec;
+        if (!fat_image::isImageFile(prefix) || !std::filesystem::is_regular_file(prefix, ec)) {
+            continue;
+        }
+        image = prefix;
+        inner.clear();
+        for (++it; it != path.end(); ++it) {
+            inner += (inner.empty() ? "" : "/") + it->string();
+        }
+        return true;
+    }
+    return false;
+}
+
+std::filesystem::path findPm3InDiskImage(const std::filesystem::path &image) {
+    try {
+        fat_image::Image disk(image);
+        auto holdsPm3 = [&disk](const std::string &folder) {
+            return disk.find(folder + "/" + std::string{kExeStandardFilename}) ||
+                   disk.find(folder + "/" + std::string{kExeDeluxeFilename});
+        };
+        if (holdsPm3("")) {
+            return image;
+        }
+        for (const auto &entry : disk.list("")) {
+            if (entry.directory && holdsPm3(entry.name)) {
+                return image / entry.name;
+            }
+        }
+    } catch (const std::exception &e) {
+        gPm3LastError = e.what();
+    }
+    return {};
+}
+
 const char* getSavesFolder(Pm3GameType game_type) {
     switch (game_type) {
         case Pm3GameType::Standard:
@@ -205,9 +376,123 @@ const std::string& pm3LastError() {
     return gPm3LastError;
 }
 
+void setPm3LastError(const std::string &message) {
+    gPm3LastError = message;
+}
+
 namespace {
-const int saveGameSizes[3] = {29554, 139080, 157280};
+const int saveGameSizes[3] = {pm3_schema::kGameAFileSize, pm3_schema::kGameBFileSize, pm3_schema::kGameCFileSize};
+
+// Patching costs two writes per dirty byte (journal temp + target); past this share a plain rewrite is cheaper.
+constexpr double kFullRewriteRatio = 0.5;
+
+// The slot whose on-disk bytes match the in-memory structs apart from the tracked dirty spans. Loads install
+// it on the UI thread while saves update it on the I/O worker, hence the mutex. Every load bumps the
+// generation so a save that finishes after another slot was loaded cannot claim the baseline back.
+struct SaveBaseline {
+    int gameNumber = 0;
+    unsigned generation = 0;
+    std::filesystem::file_time_type writeTimes[dirty_tracker::kSaveFileCount]{};
+};
+SaveBaseline gSaveBaseline;
+std::mutex gSaveBaselineMutex;
+
+bool readWriteTimes(int game_nr, const std::filesystem::path &game_path,
+                    std::filesystem::file_time_type (&times)[dirty_tracker::kSaveFileCount]) {
+    std::error_code ec;
+    for (int i = 0; i < dirty_tracker::kSaveFileCount; ++i) {
+        times[i] = std::filesystem::last_write_time(constructSaveFilePath(game_path, game_nr, static_cast<char>('A' + i)), ec);
+        if (ec) {
+            return false;
+        }
+    }
+    return true;
+}
+
+unsigned saveBaselineGeneration() {
+    std::lock_guard<std::mutex> lock(gSaveBaselineMutex);
+    return gSaveBaseline.generation;
+}
+
+void installSaveBaseline(int game_nr, const std::filesystem::file_time_type (&times)[dirty_tracker::kSaveFileCount]) {
+    std::lock_guard<std::mutex> lock(gSaveBaselineMutex);
+    gSaveBaseline.gameNumber = game_nr;
+    ++gSaveBaseline.generation;
+    std::copy(std::begin(times), std::end(times), std::begin(gSaveBaseline.writeTimes));
+}
+
+void captureSaveBaseline(int game_nr, const std::filesystem::path &game_path, unsigned generation) {
+    std::filesystem::file_time_type times[dirty_tracker::kSaveFileCount];
+    bool ok = readWriteTimes(game_nr, game_path, times);
+    std::lock_guard<std::mutex> lock(gSaveBaselineMutex);
+    if (gSaveBaseline.generation != generation) {
+        return;
+    }
+    gSaveBaseline.gameNumber = ok ? game_nr : 0;
+    std::copy(std::begin(times), std::end(times), std::begin(gSaveBaseline.writeTimes));
+}
+
+void resetSaveBaseline(unsigned generation) {
+    std::lock_guard<std::mutex> lock(gSaveBaselineMutex);
+    if (gSaveBaseline.generation == generation) {
+        gSaveBaseline.gameNumber = 0;
+    }
+}
+
+bool matchesSaveBaseline(int game_nr, const std::filesystem::path &game_path) {
+    SaveBaseline baseline;
+    {
+        std::lock_guard<std::mutex> lock(gSaveBaselineMutex);
+        baseline = gSaveBaseline;
+    }
+    if (baseline.gameNumber != game_nr) {
+        return false;
+    }
+    std::error_code ec;
+    for (int i = 0; i < dirty_tracker::kSaveFileCount; ++i) {
+        std::filesystem::path path = constructSaveFilePath(game_path, game_nr, static_cast<char>('A' + i));
+        auto size = std::filesystem::file_size(path, ec);
+        if (ec || size != dirty_tracker::fileSize(static_cast<dirty_tracker::SaveFile>(i)) ||
+            std::filesystem::last_write_time(path, ec) != baseline.writeTimes[i] || ec) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#ifndef NDEBUG
+// Debug builds compare against the slot on disk so a mutation that forgot to call touch() shows up
+// as a warning (and a full rewrite) rather than a silently lost edit.
+bool dirtySpansCoverChanges(const PendingSave &pending) {
+    const void *live[dirty_tracker::kSaveFileCount] = {pending.gameA.get(), pending.gameB.get(), pending.gameC.get()};
+    for (int i = 0; i < dirty_tracker::kSaveFileCount; ++i) {
+        auto file = static_cast<dirty_tracker::SaveFile>(i);
+        std::filesystem::path path = constructSaveFilePath(pending.gamePath, pending.gameNumber, static_cast<char>('A' + i));
+        std::ifstream in(path, std::ios::binary);
+        std::vector<uint8_t> onDisk((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        if (onDisk.size() != dirty_tracker::fileSize(file)) {
+            return false;
+        }
+
+        const auto *bytes = static_cast<const uint8_t *>(live[i]);
+        const std::vector<dirty_tracker::Span> &spans = pending.dirty[i];
+        std::size_t next = 0;
+        for (std::size_t offset = 0; offset < onDisk.size(); ++offset) {
+            while (next < spans.size() && spans[next].offset + spans[next].length <= offset) {
+                ++next;
+            }
+            bool covered = next < spans.size() && spans[next].offset <= offset;
+            if (!covered && bytes[offset] != onDisk[offset]) {
+                std::cerr << "Untracked change in " << path.filename().string() << " at offset " << offset
+                          << "; falling back to a full save" << std::endl;
+                return false;
+            }
+        }
+    }
+    return true;
 }
+#endif
+} // namespace
 
 void loadPrefs(Settings &settings) {
     if (!std::filesystem::exists(PREFS_PATH)) {
@@ -231,15 +516,18 @@ void savePrefs(const Settings &settings) {
 }
 
 bool checkSaveFileExists(const Settings &settings, int gameNumber, char gameLetter) {
-    return std::filesystem::exists(constructSaveFilePath(settings.gamePath, gameNumber, gameLetter));
+    return installationFor(settings.gamePath)->hasSaveFile(gameNumber, gameLetter);
 }
 
 void memoizeSaveFiles(const Settings &settings, std::bitset<8> &saveFiles) {
+    auto installation = installationFor(settings.gamePath);
+    if (!installation->watched()) {
+        // Without change notification the slot list could be stale; one directory scan is still cheap.
+        invalidateInstallation();
+        installation = installationFor(settings.gamePath);
+    }
     for (int i = 1; i <= 8; i++) {
-        saveFiles.set(i - 1,
-                      checkSaveFileExists(settings, i, 'A') &&
-                      checkSaveFileExists(settings, i, 'B') &&
-                      checkSaveFileExists(settings, i, 'C'));
+        saveFiles.set(i - 1, installation->hasSlot(i));
     }
 }
 
@@ -252,108 +540,1164 @@ bool ensureMetadataLoaded(const Settings &settings, int currentGame, std::bitset
     memoizeSaveFiles(settings, saveFiles);
     if (currentGame == 0) {
         loadDefaultClubdata(settings.gamePath);
+        defaultGameState.squadsReplaced();
     }
 
     if (!loadMetadata(settings.gamePath)) {
         snprintf(footer, footerSize, "%.64s", pm3LastError().c_str());
         return false;
     }
+    loadSlotSummaries(settings.gamePath);
 
     return true;
 }
 
+std::filesystem::path backupStorePath(const std::filesystem::path &backup_dir) {
+    std::filesystem::path image;
+    std::string inner;
+    if (splitDiskImagePath(backup_dir, image, inner)) {
+        // Nothing can be created inside a disk image, so its backups live beside it.
+        return image.parent_path() / BACKUP_SAVE_PATH / image.filename() / backup_store::kStoreFolder;
+    }
+    return backup_dir / backup_store::kStoreFolder;
+}
+
+static bool snapshotToStore(const std::filesystem::path &backup_dir, const std::string &set,
+                            const std::vector<std::filesystem::path> &files) {
+    try {
+        backup_store::Store store(backupStorePath(backup_dir));
+        std::filesystem::path image;
+        std::string inner;
+        if (!files.empty() && splitDiskImagePath(files.front(), image, inner)) {
+            // The store reads host files, so files inside a disk image are copied out first.
+            std::filesystem::path staging = store.root().parent_path() / "staging";
+            std::filesystem::create_directories(staging);
+            std::vector<std::filesystem::path> staged;
+            for (const auto &file : files) {
+                std::vector<uint8_t> contents;
+                if (!load_whole_file(file, contents)) {
+                    throw std::runtime_error(gPm3LastError);
+                }
+                staged.push_back(staging / file.filename());
+                save_whole_file(staged.back(), contents.data(), contents.size());
+            }
+            store.snapshot(set, staged);
+            std::filesystem::remove_all(staging);
+        } else {
+            store.snapshot(set, files);
+        }
+        if (store.prune(set, backup_store::kDefaultKeepVersions) > 0) {
+            store.collectGarbage();
+        }
+    } catch (const std::exception &e) {
+        gPm3LastError = std::string("Error backing up ") + set + ": " + e.what();
+        std::cerr << gPm3LastError << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Where the sidecars PM3000 appends to while a slot is open go; none inside a disk image, where there is no room.
+static std::filesystem::path writableBackupDir(const std::filesystem::path &game_path) {
+    std::filesystem::path image;
+    std::string inner;
+    std::filesystem::path saves_path = constructSavesFolderPath(game_path);
+    if (saves_path.empty() || splitDiskImagePath(saves_path, image, inner)) {
+        return {};
+    }
+    return saves_path / BACKUP_SAVE_PATH;
+}
+
+// Where unsaved edits to the slot are journaled.
+static std::filesystem::path editJournalPath(const std::filesystem::path &game_path, int game_nr) {
+    std::filesystem::path dir = writableBackupDir(game_path);
+    return dir.empty() ? dir : edit_journal::crashFilePath(dir, game_nr);
+}
+
+static std::filesystem::path ledgerPath(const std::filesystem::path &game_path, int game_nr) {
+    std::filesystem::path dir = writableBackupDir(game_path);
+    return dir.empty() ? dir : save_ledger::ledgerPath(dir, game_nr);
+}
+
+static std::filesystem::path fingerprintSidecar(const std::filesystem::path &game_path, int game_nr) {
+    return save_fingerprint::sidecarPath(constructSavesFolderPath(game_path) / BACKUP_SAVE_PATH, game_nr);
+}
+
+// Reads the slot's sidecar and checks that every file still has the recorded size and mtime.
+static bool currentSlotFingerprint(const std::filesystem::path &game_path, int game_nr,
+                                   save_fingerprint::SlotFingerprint &slot) {
+    if (!save_fingerprint::read(fingerprintSidecar(game_path, game_nr), slot)) {
+        return false;
+    }
+    for (int i = 0; i < save_fingerprint::kSlotFileCount; ++i) {
+        std::filesystem::path path = constructSaveFilePath(game_path, game_nr, static_cast<char>('A' + i));
+        if (!save_fingerprint::matchesDisk(slot.files[i], path)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Records CRCs for slot contents known to be on disk with the given mtimes. The sidecar is only a cache, so
+// failures are logged and otherwise ignored.
+static void recordSlotFingerprint(const std::filesystem::path &game_path, int game_nr,
+                                  const void *const (&contents)[dirty_tracker::kSaveFileCount],
+                                  const std::filesystem::file_time_type (&write_times)[dirty_tracker::kSaveFileCount]) {
+    save_fingerprint::SlotFingerprint slot;
+    for (int i = 0; i < save_fingerprint::kSlotFileCount; ++i) {
+        slot.files[i] = save_fingerprint::compute(contents[i], static_cast<std::size_t>(saveGameSizes[i]));
+        slot.files[i].writeTime = static_cast<int64_t>(write_times[i].time_since_epoch().count());
+    }
+    try {
+        save_fingerprint::write(fingerprintSidecar(game_path, game_nr), slot);
+    } catch (const std::exception &e) {
+        std::cerr << "Could not record checksums for game " << game_nr << ": " << e.what() << std::endl;
+    }
+}
+
+// Appends loaded or saved slot contents to the slot's history archive. The history is an extra, so failures are
+// logged and otherwise ignored.
+static void recordHistory(const std::filesystem::path &game_path, int game_nr,
+                          const void *const (&contents)[dirty_tracker::kSaveFileCount]) {
+    try {
+        history_archive::Archive archive(
+                history_archive::archivePath(constructSavesFolderPath(game_path) / BACKUP_SAVE_PATH, game_nr));
+        archive.append(contents, static_cast<int64_t>(std::time(nullptr)));
+    } catch (const std::exception &e) {
+        std::cerr << "Could not record history for game " << game_nr << ": " << e.what() << std::endl;
+    }
+}
+
+static std::mutex gSlotIndexMutex;
+// Summaries read from the index for the Load and Save screens; UI thread only.
+static std::optional<slot_summary::Summary> gSlotSummaries[slot_summary::kSlotCount];
+
+static std::filesystem::path slotIndexPath(const std::filesystem::path &game_path) {
+    return slot_summary::indexPath(constructSavesFolderPath(game_path) / BACKUP_SAVE_PATH);
+}
+
+static void slotFilePaths(const std::filesystem::path &game_path, int game_nr,
+                          std::filesystem::path (&paths)[slot_summary::kSlotFileCount]) {
+    for (int i = 0; i < slot_summary::kSlotFileCount; ++i) {
+        paths[i] = constructSaveFilePath(game_path, game_nr, static_cast<char>('A' + i));
+    }
+}
+
+// Read-modify-write of the summary index. The index is only a cache, so failures are logged and otherwise ignored.
+static void updateSlotIndex(const std::filesystem::path &game_path,
+                            const std::function<void(slot_summary::Index &)> &update) {
+    std::lock_guard<std::mutex> lock(gSlotIndexMutex);
+    try {
+        std::filesystem::path path = slotIndexPath(game_path);
+        slot_summary::Index index = slot_summary::read(path);
+        update(index);
+        slot_summary::write(path, index);
+    } catch (const std::exception &e) {
+        std::cerr << "Could not update the slot index: " << e.what() << std::endl;
+    }
+}
+
+static bool slotSummaryCurrent(const std::filesystem::path &game_path, int game_nr) {
+    std::filesystem::path paths[slot_summary::kSlotFileCount];
+    slotFilePaths(game_path, game_nr, paths);
+    slot_summary::Index index;
+    {
+        std::lock_guard<std::mutex> lock(gSlotIndexMutex);
+        index = slot_summary::read(slotIndexPath(game_path));
+    }
+    return index.slots[game_nr - 1] && slot_summary::matchesDisk(*index.slots[game_nr - 1], paths);
+}
+
+// Summarises slot contents known to be on disk with the given mtimes.
+static slot_summary::Summary recordSlotSummary(const std::filesystem::path &game_path, int game_nr, const gamea &game_data,
+                              const gameb &club_data, const gamec &player_data,
+                              const std::filesystem::file_time_type (&write_times)[dirty_tracker::kSaveFileCount]) {
+    slot_summary::Summary summary = slot_summary::compute(game_data, club_data, player_data);
+    for (int i = 0; i < slot_summary::kSlotFileCount; ++i) {
+        summary.files[i].writeTime = static_cast<int64_t>(write_times[i].time_since_epoch().count());
+    }
+    updateSlotIndex(game_path, [game_nr, &summary](slot_summary::Index &index) {
+        index.slots[game_nr - 1] = summary;
+    });
+    return summary;
+}
+
+void loadSlotSummaries(const std::filesystem::path &game_path) {
+    slot_summary::Index index;
+    {
+        std::lock_guard<std::mutex> lock(gSlotIndexMutex);
+        index = slot_summary::read(slotIndexPath(game_path));
+    }
+    for (int i = 0; i < slot_summary::kSlotCount; ++i) {
+        std::filesystem::path paths[slot_summary::kSlotFileCount];
+        slotFilePaths(game_path, i + 1, paths);
+        gSlotSummaries[i].reset();
+        if (index.slots[i] && slot_summary::matchesDisk(*index.slots[i], paths)) {
+            gSlotSummaries[i] = index.slots[i];
+            continue;
+        }
+
+        // A slot PM3 wrote since we last saw it is summarised straight from read-only mappings, so filling in
+        // all eight costs page faults rather than reads into copies. Files inside a disk image cannot be mapped
+        // and keep no summary until they are loaded.
+        std::filesystem::file_time_type writeTimes[dirty_tracker::kSaveFileCount];
+        std::error_code ec;
+        for (int f = 0; f < slot_summary::kSlotFileCount && !ec; ++f) {
+            writeTimes[f] = std::filesystem::last_write_time(paths[f], ec);
+        }
+        MappedGame mapped;
+        if (ec || !mapped.open(game_path, i + 1)) {
+            continue;
+        }
+        gSlotSummaries[i] = recordSlotSummary(game_path, i + 1, mapped.gameA(), mapped.gameB(), mapped.gameC(),
+                                              writeTimes);
+    }
+}
+
+bool formatSlotSummary(int i, char *summaryLabel, size_t summaryLabelSize) {
+    if (i < 1 || i > slot_summary::kSlotCount || !gSlotSummaries[i - 1]) {
+        return false;
+    }
+    snprintf(summaryLabel, summaryLabelSize, "%s", slot_summary::describe(*gSlotSummaries[i - 1]).c_str());
+    return true;
+}
+
 bool backupSaveFile(const Settings &settings, int gameNumber) {
+    std::filesystem::path savesFolder = constructSavesFolderPath(settings.gamePath);
+    if (savesFolder.empty()) {
+        return false;
+    }
+
+    // An unchanged slot that was already backed up needs no read at all.
+    save_fingerprint::SlotFingerprint slot;
+    bool fingerprinted = currentSlotFingerprint(settings.gamePath, gameNumber, slot);
+    if (fingerprinted && slot.backedUp) {
+        return true;
+    }
+
+    std::vector<std::filesystem::path> files;
     for (char c = 'A'; c <= 'C'; ++c) {
-        std::filesystem::path saveGamePath = constructSaveFilePath(settings.gamePath, gameNumber, c);
+        files.push_back(constructSaveFilePath(settings.gamePath, gameNumber, c));
+    }
+    if (!snapshotToStore(savesFolder / BACKUP_SAVE_PATH, backup_store::slotSetName(gameNumber), files)) {
+        return false;
+    }
 
+    if (fingerprinted && currentSlotFingerprint(settings.gamePath, gameNumber, slot)) {
+        slot.backedUp = true;
         try {
-            if (!std::filesystem::exists(saveGamePath)) {
-                return true;
-            }
+            save_fingerprint::write(fingerprintSidecar(settings.gamePath, gameNumber), slot);
+        } catch (const std::exception &e) {
+            std::cerr << "Could not record checksums for game " << gameNumber << ": " << e.what() << std::endl;
+        }
+    }
+    return true;
+}
 
-            std::filesystem::path backupPath = constructSavesFolderPath(settings.gamePath) / BACKUP_SAVE_PATH;
+bool backupPm3Files(const std::filesystem::path &game_path) {
+    std::vector<std::filesystem::path> files;
+    const std::array<std::string_view, 3> pm3Files = {kGameDataFile, kClubDataFile, kPlayDataFile};
+    for (const auto &fileName : pm3Files) {
+        std::filesystem::path source = constructGameFilePath(game_path, std::string{fileName});
+        std::vector<uint8_t> contents;
+        std::filesystem::path image;
+        std::string inner;
+        if (splitDiskImagePath(source, image, inner) ? !load_whole_file(source, contents)
+                                                     : !std::filesystem::exists(source)) {
+            gPm3LastError = "Missing PM3 file: " + source.string();
+            return false;
+        }
+        files.push_back(source);
+    }
+    return snapshotToStore(game_path / BACKUP_SAVE_PATH, kBaseBackupSet, files);
+}
 
-            if (!std::filesystem::exists(backupPath)) {
-                if (!std::filesystem::create_directories(backupPath)) {
-                    std::cerr << "Failed to create backup directory: " << backupPath << std::endl;
-                    return false;
-                }
+bool restoreSaveBackup(const std::filesystem::path &game_path, int game_nr, uint32_t version) {
+    std::filesystem::path saves_path = constructSavesFolderPath(game_path);
+    if (saves_path.empty()) {
+        return false;
+    }
+    std::filesystem::path image;
+    std::string inner;
+    if (splitDiskImagePath(saves_path, image, inner)) {
+        gPm3LastError = "Backups cannot be restored into a disk image";
+        return false;
+    }
+
+    try {
+        backup_store::Store store(backupStorePath(saves_path / BACKUP_SAVE_PATH));
+        std::vector<backup_store::FileImage> images = store.read(backup_store::slotSetName(game_nr), version);
+
+        saves saves_dir_data{};
+        prefs prefs_data{};
+        bool haveMetadata = loadMetadata(game_path, saves_dir_data, prefs_data);
+
+        save_journal::Transaction transaction(saves_path);
+        for (const auto &image : images) {
+            transaction.replace(image.fileName, image.contents.data(), image.contents.size());
+            if (haveMetadata && image.contents.size() == sizeof(gamea)) {
+                fillSaveEntry(saves_dir_data, game_nr, *reinterpret_cast<const gamea *>(image.contents.data()));
             }
+        }
+        if (haveMetadata) {
+            transaction.replace(std::string{kSavesDirFile}, &saves_dir_data, sizeof(saves));
+        }
+        transaction.commit();
+    } catch (const std::exception &e) {
+        gPm3LastError = std::string("Error restoring backup: ") + e.what();
+        return false;
+    }
+
+    gPm3LastError.clear();
+    return true;
+}
 
-            std::filesystem::path dest = backupPath / saveGamePath.filename();
-            std::filesystem::copy(saveGamePath, dest, std::filesystem::copy_options::overwrite_existing);
-        } catch (const std::filesystem::filesystem_error &e) {
-            std::cerr << "Error copying file: " << e.what() << std::endl;
+static bool slotOnDisk(const std::filesystem::path &saves_path, int game_nr) {
+    for (int i = 0; i < dirty_tracker::kSaveFileCount; ++i) {
+        std::error_code ec;
+        std::filesystem::path path =
+                saves_path / (std::string{kGameFilePrefix} + std::to_string(game_nr) + static_cast<char>('A' + i));
+        if (std::filesystem::file_size(path, ec) != static_cast<uintmax_t>(saveGameSizes[i]) || ec) {
             return false;
         }
     }
-
     return true;
 }
 
-bool backupPm3Files(const std::filesystem::path &game_path) {
-    std::filesystem::path backupDir = game_path / BACKUP_SAVE_PATH;
+const char *slotOperationName(SlotOperation operation) {
+    switch (operation) {
+        case SlotOperation::Copy:
+            return "COPY";
+        case SlotOperation::Move:
+            return "MOVE";
+        case SlotOperation::Swap:
+            return "SWAP";
+        case SlotOperation::Delete:
+            return "DELETE";
+    }
+    return "";
+}
+
+// A sidecar in <saves>/PM3000 as the transaction on <saves> names it.
+static std::string sidecarName(const std::filesystem::path &backup_dir, const std::filesystem::path &path) {
+    return (backup_dir.filename() / path.filename()).generic_string();
+}
+
+static void removeSidecar(save_journal::Transaction &transaction, const std::filesystem::path &backup_dir,
+                          const std::filesystem::path &path) {
+    std::error_code ec;
+    if (std::filesystem::exists(path, ec)) {
+        transaction.remove(sidecarName(backup_dir, path));
+    }
+}
+
+// Stages `from_file` as `to_file`, or the removal of `to_file` if the source slot has none. A ledger (`to_slot`
+// not 0) is renumbered for its new slot on the way.
+static void stageSidecar(save_journal::Transaction &transaction, const std::filesystem::path &backup_dir,
+                         const std::filesystem::path &from_file, const std::filesystem::path &to_file, int to_slot) {
+    std::error_code ec;
+    if (!std::filesystem::exists(from_file, ec)) {
+        removeSidecar(transaction, backup_dir, to_file);
+        return;
+    }
+    if (to_slot == 0) {
+        transaction.replaceWithCopy(sidecarName(backup_dir, to_file), from_file);
+        return;
+    }
+    std::vector<uint8_t> ledger;
+    if (!load_whole_file(from_file, ledger) || !save_ledger::renumber(ledger, to_slot)) {
+        removeSidecar(transaction, backup_dir, to_file);
+        return;
+    }
+    transaction.replace(sidecarName(backup_dir, to_file), ledger.data(), ledger.size());
+}
+
+bool manageSlot(const std::filesystem::path &game_path, SlotOperation operation, int from, int to, std::string &error,
+                save_journal::CopyMethod *method) {
+    const bool twoSlots = operation != SlotOperation::Delete;
+    std::filesystem::path saves_path = constructSavesFolderPath(game_path);
+    if (saves_path.empty()) {
+        error = gPm3LastError;
+        return false;
+    }
+    if (from < 1 || from > 8 || (twoSlots && (to < 1 || to > 8 || to == from))) {
+        error = "INVALID GAME NUMBER";
+        return false;
+    }
+    std::filesystem::path image;
+    std::string inner;
+    if (splitDiskImagePath(saves_path, image, inner)) {
+        error = "NOT POSSIBLE IN A DISK IMAGE";
+        return false;
+    }
+    int empty = 0;
+    if (!slotOnDisk(saves_path, from)) {
+        empty = from;
+    } else if (operation == SlotOperation::Swap && !slotOnDisk(saves_path, to)) {
+        empty = to;
+    }
+    if (empty != 0) {
+        error = "GAME " + std::to_string(empty) + " IS EMPTY";
+        return false;
+    }
+
+    // Whatever is overwritten or removed goes into the backup store first.
+    Settings settings;
+    settings.gamePath = game_path;
+    int overwritten[2] = {operation == SlotOperation::Delete ? from : to,
+                          operation == SlotOperation::Swap ? from : 0};
+    for (int slot : overwritten) {
+        if (slot != 0 && slotOnDisk(saves_path, slot) && !backupSaveFile(settings, slot)) {
+            error = "COULDN'T BACKUP GAME " + std::to_string(slot);
+            return false;
+        }
+    }
+
+    // Summaries that still describe their slots move with the files.
+    slot_summary::Index summaries;
+    {
+        std::lock_guard<std::mutex> lock(gSlotIndexMutex);
+        summaries = slot_summary::read(slotIndexPath(game_path));
+    }
+    for (int slot : {from, to}) {
+        std::filesystem::path paths[slot_summary::kSlotFileCount];
+        if (slot != 0 && summaries.slots[slot - 1]) {
+            slotFilePaths(game_path, slot, paths);
+            if (!slot_summary::matchesDisk(*summaries.slots[slot - 1], paths)) {
+                summaries.slots[slot - 1].reset();
+            }
+        }
+    }
+
+    auto fileName = [](int game_nr, int i) {
+        return std::string{kGameFilePrefix} + std::to_string(game_nr) + static_cast<char>('A' + i);
+    };
+    const std::filesystem::path backup_dir = saves_path / BACKUP_SAVE_PATH;
     try {
-        if (!std::filesystem::exists(backupDir)) {
-            if (!std::filesystem::create_directories(backupDir)) {
-                gPm3LastError = "Failed to create backup directory: " + backupDir.string();
-                return false;
+        saves saves_dir_data{};
+        prefs prefs_data{};
+        bool haveMetadata = loadMetadata(game_path, saves_dir_data, prefs_data);
+
+        save_journal::Transaction transaction(saves_path);
+        for (int i = 0; i < dirty_tracker::kSaveFileCount; ++i) {
+            switch (operation) {
+                case SlotOperation::Copy:
+                    transaction.replaceWithCopy(fileName(to, i), saves_path / fileName(from, i));
+                    break;
+                case SlotOperation::Move:
+                    transaction.replaceWithCopy(fileName(to, i), saves_path / fileName(from, i));
+                    transaction.remove(fileName(from, i));
+                    break;
+                case SlotOperation::Swap:
+                    transaction.replaceWithCopy(fileName(to, i), saves_path / fileName(from, i));
+                    transaction.replaceWithCopy(fileName(from, i), saves_path / fileName(to, i));
+                    break;
+                case SlotOperation::Delete:
+                    transaction.remove(fileName(from, i));
+                    break;
             }
         }
 
-        const std::array<std::string_view, 3> pm3Files = {kGameDataFile, kClubDataFile, kPlayDataFile};
-        for (const auto &fileName : pm3Files) {
-            std::filesystem::path source = constructGameFilePath(game_path, std::string{fileName});
-            if (!std::filesystem::exists(source)) {
-                gPm3LastError = "Missing PM3 file: " + source.string();
-                return false;
+        // Only the entries of the slots involved are rewritten in SAVES.DIR.
+        if (haveMetadata) {
+            auto &entries = saves_dir_data.game;
+            using Entry = std::remove_reference_t<decltype(entries[0])>;
+            switch (operation) {
+                case SlotOperation::Copy:
+                    entries[to - 1] = entries[from - 1];
+                    break;
+                case SlotOperation::Move:
+                    entries[to - 1] = entries[from - 1];
+                    entries[from - 1] = Entry{};
+                    break;
+                case SlotOperation::Swap:
+                    std::swap(entries[to - 1], entries[from - 1]);
+                    break;
+                case SlotOperation::Delete:
+                    entries[from - 1] = Entry{};
+                    break;
+            }
+            for (int slot : {from, to}) {
+                if (slot != 0 && (slot != from || operation != SlotOperation::Copy)) {
+                    transaction.patch(std::string{kSavesDirFile}, offsetof(saves, game) + (slot - 1) * sizeof(Entry),
+                                      &entries[slot - 1], sizeof(Entry));
+                }
             }
+        }
 
-            std::filesystem::path dest = backupDir / source.filename();
-            std::filesystem::copy(source, dest, std::filesystem::copy_options::overwrite_existing);
+        // The slot's history and ledger follow the game it now holds, in the same commit, so a crash cannot leave
+        // them behind. A deleted slot keeps its history but not its ledger.
+        if (twoSlots) {
+            stageSidecar(transaction, backup_dir, history_archive::archivePath(backup_dir, from),
+                         history_archive::archivePath(backup_dir, to), 0);
+            stageSidecar(transaction, backup_dir, save_ledger::ledgerPath(backup_dir, from),
+                         save_ledger::ledgerPath(backup_dir, to), to);
         }
-    } catch (const std::filesystem::filesystem_error &e) {
-        gPm3LastError = std::string("Error backing up PM3 files: ") + e.what();
+        if (operation == SlotOperation::Swap) {
+            stageSidecar(transaction, backup_dir, history_archive::archivePath(backup_dir, to),
+                         history_archive::archivePath(backup_dir, from), 0);
+            stageSidecar(transaction, backup_dir, save_ledger::ledgerPath(backup_dir, to),
+                         save_ledger::ledgerPath(backup_dir, from), from);
+        } else if (operation != SlotOperation::Copy) {
+            if (operation == SlotOperation::Move) {
+                removeSidecar(transaction, backup_dir, history_archive::archivePath(backup_dir, from));
+            }
+            removeSidecar(transaction, backup_dir, save_ledger::ledgerPath(backup_dir, from));
+        }
+        transaction.commit();
+        if (method) {
+            *method = transaction.copyMethod();
+        }
+    } catch (const std::exception &e) {
+        gPm3LastError = e.what();
+        error = std::string("ERROR: ") + e.what();
         return false;
     }
+    invalidateInstallation();
 
+    // The slot's checksums no longer describe its files.
+    std::error_code ec;
+    for (int slot : {from, to}) {
+        if (slot != 0) {
+            std::filesystem::remove(save_fingerprint::sidecarPath(backup_dir, slot), ec);
+        }
+    }
+    // Unsaved edits recorded for a slot no longer apply once its files are replaced or gone. Neither slot is the
+    // loaded one, except the source of a copy, whose files and crash file are left alone.
+    for (int slot : {from, to}) {
+        if (slot != 0 && (slot != from || operation != SlotOperation::Copy)) {
+            std::filesystem::remove(edit_journal::crashFilePath(backup_dir, slot), ec);
+        }
+    }
+    updateSlotIndex(game_path, [&](slot_summary::Index &index) {
+        switch (operation) {
+            case SlotOperation::Copy:
+                index.slots[to - 1] = summaries.slots[from - 1];
+                break;
+            case SlotOperation::Move:
+                index.slots[to - 1] = summaries.slots[from - 1];
+                index.slots[from - 1].reset();
+                break;
+            case SlotOperation::Swap:
+                index.slots[to - 1] = summaries.slots[from - 1];
+                index.slots[from - 1] = summaries.slots[to - 1];
+                break;
+            case SlotOperation::Delete:
+                index.slots[from - 1].reset();
+                break;
+        }
+        // The copies hold the same bytes, so their CRCs still apply; only the mtimes are new.
+        for (int slot : {from, to}) {
+            if (slot == 0 || (slot == from && operation != SlotOperation::Swap) || !index.slots[slot - 1]) {
+                continue;
+            }
+            std::filesystem::path paths[slot_summary::kSlotFileCount];
+            slotFilePaths(game_path, slot, paths);
+            for (int i = 0; i < slot_summary::kSlotFileCount; ++i) {
+                index.slots[slot - 1]->files[i].writeTime = save_fingerprint::writeTimeOf(paths[i]);
+            }
+        }
+    });
     return true;
 }
 
-bool loadGame(const Settings &settings, int gameNumber, char *footer, size_t footerSize) {
-    std::filesystem::path gameaPath = constructSaveFilePath(settings.gamePath, gameNumber, 'A');
-    std::filesystem::path gamebPath = constructSaveFilePath(settings.gamePath, gameNumber, 'B');
-    std::filesystem::path gamecPath = constructSaveFilePath(settings.gamePath, gameNumber, 'C');
+static void logRepairs(int game_nr, const save_validator::Report &report) {
+    constexpr std::size_t kLoggedIssues = 8;
+    const std::vector<save_validator::Issue> &issues = report.issues;
+    for (std::size_t i = 0; i < issues.size() && i < kLoggedIssues; ++i) {
+        std::cerr << "Game " << game_nr << ": " << save_validator::describe(issues[i])
+                  << (issues[i].repaired ? " (repaired)" : " (left as is)") << std::endl;
+    }
+    if (issues.size() > kLoggedIssues) {
+        std::cerr << "Game " << game_nr << ": " << issues.size() - kLoggedIssues << " more issues" << std::endl;
+    }
+}
+
+// Repairs change the slot in memory only, so they are marked dirty for the next save to write. The dirty tracker
+// follows the editor's state, so this is only called for defaultGameState.
+static void touchRepairs(const save_validator::Report &report) {
+    const uint8_t *const files[dirty_tracker::kSaveFileCount] = {
+            reinterpret_cast<const uint8_t *>(&defaultGameState.game),
+            reinterpret_cast<const uint8_t *>(&defaultGameState.clubs),
+            reinterpret_cast<const uint8_t *>(&defaultGameState.players)};
+    for (const save_validator::Issue &issue : report.issues) {
+        if (issue.repaired) {
+            dirty_tracker::touch(files[issue.file] + issue.offset, issue.width);
+        }
+    }
+}
+
+bool readGame(const std::filesystem::path &game_path, int game_nr, LoadedGame &loaded, std::string &error) {
+    const std::filesystem::path paths[dirty_tracker::kSaveFileCount] = {
+            constructSaveFilePath(game_path, game_nr, 'A'),
+            constructSaveFilePath(game_path, game_nr, 'B'),
+            constructSaveFilePath(game_path, game_nr, 'C'),
+    };
+    std::filesystem::path image;
+    std::string inner;
+    bool inImage = splitDiskImagePath(game_path, image, inner);
+    auto installation = installationFor(game_path);
+    for (int i = 0; i < dirty_tracker::kSaveFileCount; ++i) {
+        std::error_code ec;
+        // Inside a disk image the sizes come from the directory entries read when the installation was probed.
+        uintmax_t size = inImage ? installation->saveFileSize(game_nr, static_cast<char>('A' + i))
+                                 : std::filesystem::file_size(paths[i], ec);
+        if (size != static_cast<uintmax_t>(saveGameSizes[i]) || ec) {
+            error = "INVALID " + paths[i].string() + " FILESIZE";
+            return false;
+        }
+    }
+
+    loaded.gameNumber = game_nr;
+    loaded.gamePath = game_path;
+    loaded.gameA = std::make_unique<gamea>();
+    loaded.gameB = std::make_unique<gameb>();
+    loaded.gameC = std::make_unique<gamec>();
+    // Stat before reading: if the files change underneath us the next save sees new times and rewrites fully.
+    loaded.baselineValid = readWriteTimes(game_nr, game_path, loaded.writeTimes);
+    try {
+        loadBinaries(game_nr, game_path, *loaded.gameA, *loaded.gameB, *loaded.gameC);
+    } catch (const std::exception &e) {
+        error = e.what();
+        return false;
+    }
+
+    save_fingerprint::SlotFingerprint slot;
+    if (loaded.baselineValid && !currentSlotFingerprint(game_path, game_nr, slot)) {
+        const void *const contents[dirty_tracker::kSaveFileCount] = {loaded.gameA.get(), loaded.gameB.get(),
+                                                                     loaded.gameC.get()};
+        recordSlotFingerprint(game_path, game_nr, contents, loaded.writeTimes);
+        // A slot whose fingerprint still matches was already recorded when it was last loaded or saved.
+        recordHistory(game_path, game_nr, contents);
+    }
+    if (loaded.baselineValid && !slotSummaryCurrent(game_path, game_nr)) {
+        recordSlotSummary(game_path, game_nr, *loaded.gameA, *loaded.gameB, *loaded.gameC, loaded.writeTimes);
+    }
+
+    // After the fingerprint, history and summary, which record the slot as it is on disk.
+    loaded.validation = save_validator::validate(*loaded.gameA, *loaded.gameB, *loaded.gameC, {true});
+    logRepairs(game_nr, loaded.validation);
+    return true;
+}
+
+void installLoadedGame(LoadedGame &loaded, GameState &state) {
+    std::memcpy(&state.game, loaded.gameA.get(), sizeof(gamea));
+    std::memcpy(&state.clubs, loaded.gameB.get(), sizeof(gameb));
+    std::memcpy(&state.players, loaded.gameC.get(), sizeof(gamec));
+    state.squadsReplaced();
+    if (&state != &defaultGameState) {
+        return;
+    }
+    dirty_tracker::clear();
+    touchRepairs(loaded.validation);
+    installSaveBaseline(loaded.baselineValid ? loaded.gameNumber : 0, loaded.writeTimes);
+    loaded.recoveredEdits = edit_journal::recover(editJournalPath(loaded.gamePath, loaded.gameNumber),
+                                                  loaded.gameNumber);
+    // After the journal, so loans its recovered edits made are still in the save.
+    save_ledger::open(ledgerPath(loaded.gamePath, loaded.gameNumber), loaded.gameNumber, defaultGameState,
+                      loaded.recoveredEdits > 0);
+}
+
+// Reads `path` and copies into `target` only the 4 KB chunks that differ from what is in memory, so an outside
+// rewrite that left most of the file alone (PM3 rewrites all three files on every save) stays cheap. Chunks are
+// compared byte for byte, so afterwards memory holds exactly the file.
+static bool reloadChangedChunks(const std::filesystem::path &path, void *target, std::size_t size,
+                                std::size_t &copied, std::string &error) {
+    std::vector<uint8_t> fresh(size);
+    std::ifstream in(path, std::ios::binary);
+    if (!in.read(reinterpret_cast<char *>(fresh.data()), static_cast<std::streamsize>(size))) {
+        error = "COULD NOT RELOAD " + path.filename().string();
+        return false;
+    }
+
+    auto *bytes = static_cast<uint8_t *>(target);
+    copied = 0;
+    for (std::size_t offset = 0; offset < size; offset += save_fingerprint::kChunkSize) {
+        std::size_t length = std::min(save_fingerprint::kChunkSize, size - offset);
+        if (std::memcmp(bytes + offset, fresh.data() + offset, length) != 0) {
+            std::memcpy(bytes + offset, fresh.data() + offset, length);
+            copied += length;
+        }
+    }
+    return true;
+}
+
+Reload reloadSaveFile(const std::filesystem::path &game_path, int game_nr, char game_letter, GameState &state,
+                      std::string &error) {
+    int index = game_letter - 'A';
+    if (index < 0 || index >= dirty_tracker::kSaveFileCount) {
+        return Reload::Unchanged;
+    }
+    std::filesystem::path path = constructSaveFilePath(game_path, game_nr, game_letter);
+    std::error_code ec;
+    auto writeTime = std::filesystem::last_write_time(path, ec);
+    if (ec || std::filesystem::file_size(path, ec) != static_cast<uintmax_t>(saveGameSizes[index]) || ec) {
+        error = "INVALID " + path.string() + " FILESIZE";
+        return Reload::Failed;
+    }
+    const bool editor = &state == &defaultGameState;
+    if (editor) {
+        // Our own saves leave the baseline pointing at the bytes they wrote; nothing to pick up.
+        std::lock_guard<std::mutex> lock(gSaveBaselineMutex);
+        if (gSaveBaseline.gameNumber == game_nr && gSaveBaseline.writeTimes[index] == writeTime) {
+            return Reload::Unchanged;
+        }
+    }
+    // Unsaved edits are never overwritten behind the user's back. Taking the new file means dropping them, and the
+    // undo history built on them, which a full load of the slot does.
+    if (editor && dirty_tracker::isDirty(static_cast<dirty_tracker::SaveFile>(index))) {
+        return Reload::HeldForEdits;
+    }
+
+    void *const targets[dirty_tracker::kSaveFileCount] = {&state.game, &state.clubs, &state.players};
+    std::size_t copied = 0;
+    if (!reloadChangedChunks(path, targets[index], static_cast<std::size_t>(saveGameSizes[index]), copied, error)) {
+        return Reload::Failed;
+    }
+
+    // Memory now matches the file byte for byte, whether or not anything was copied. New contents are then checked
+    // and repaired as on a full load; the repairs are dirty, which also keeps the summary below from following them.
+    if (copied > 0) {
+        save_validator::Report repairs = save_validator::validate(state.game, state.clubs, state.players, {true});
+        logRepairs(game_nr, repairs);
+        if (editor) {
+            touchRepairs(repairs);
+        }
+        if (index == dirty_tracker::kGameB || repairs.repaired > 0) {
+            state.squadsReplaced();
+        }
+    }
+    if (!editor) {
+        return copied > 0 ? Reload::Reloaded : Reload::Unchanged;
+    }
+    std::filesystem::file_time_type writeTimes[dirty_tracker::kSaveFileCount];
+    bool baselined = false;
+    {
+        std::lock_guard<std::mutex> lock(gSaveBaselineMutex);
+        if (gSaveBaseline.gameNumber == game_nr) {
+            gSaveBaseline.writeTimes[index] = writeTime;
+            std::copy(std::begin(gSaveBaseline.writeTimes), std::end(gSaveBaseline.writeTimes), writeTimes);
+            baselined = true;
+        }
+    }
+    if (copied > 0 && baselined) {
+        save_ledger::reconcile(defaultGameState);
+    }
+    // With no unsaved edits, memory is the slot as the game left it, so its summary can follow the change.
+    if (copied > 0 && baselined && !dirty_tracker::isDirty(dirty_tracker::kGameA) &&
+        !dirty_tracker::isDirty(dirty_tracker::kGameB) && !dirty_tracker::isDirty(dirty_tracker::kGameC)) {
+        recordSlotSummary(game_path, game_nr, state.game, state.clubs, state.players, writeTimes);
+    }
+    return copied > 0 ? Reload::Reloaded : Reload::Unchanged;
+}
+
+bool reloadSavesDir(const std::filesystem::path &game_path, std::string &error) {
+    std::filesystem::path path = constructSavesFolderPath(game_path) / std::string{kSavesDirFile};
+    std::error_code ec;
+    if (std::filesystem::file_size(path, ec) != sizeof(saves) || ec) {
+        error = "INVALID " + path.string() + " FILESIZE";
+        return false;
+    }
+    std::size_t copied = 0;
+    return reloadChangedChunks(path, &savesDir, sizeof(saves), copied, error) && copied > 0;
+}
+
+void forgetSaveBaseline() {
+    std::lock_guard<std::mutex> lock(gSaveBaselineMutex);
+    gSaveBaseline.gameNumber = 0;
+    ++gSaveBaseline.generation;
+}
 
-    if (std::filesystem::file_size(gameaPath) != static_cast<uintmax_t>(saveGameSizes[0])) {
-        std::string gameaName = gameaPath.string();
-        snprintf(footer, footerSize, "INVALID %s FILESIZE", gameaName.c_str());
+bool loadGame(const Settings &settings, int gameNumber, char *footer, size_t footerSize) {
+    LoadedGame loaded;
+    std::string error;
+    if (!readGame(settings.gamePath, gameNumber, loaded, error)) {
+        snprintf(footer, footerSize, "%s", error.c_str());
         return false;
-    } else if (std::filesystem::file_size(gamebPath) != static_cast<uintmax_t>(saveGameSizes[1])) {
-        std::string gamebName = gamebPath.string();
-        snprintf(footer, footerSize, "INVALID %s FILESIZE", gamebName.c_str());
+    }
+    installLoadedGame(loaded, defaultGameState);
+    return true;
+}
+
+dirty_tracker::WriteReport commitSaveGame(int game_nr, const std::filesystem::path &game_path, const gamea &game_data,
+                                          const gameb &club_data, const gamec &player_data,
+                                          const saves &saves_dir_data, const prefs &prefs_data,
+                                          const std::vector<dirty_tracker::Span> *dirty_spans) {
+    std::filesystem::path saves_path = constructSavesFolderPath(game_path);
+    if (saves_path.empty()) {
+        throw std::runtime_error(gPm3LastError);
+    }
+
+    const std::string prefix = std::string{kGameFilePrefix} + std::to_string(game_nr);
+    const uint8_t *contents[dirty_tracker::kSaveFileCount] = {
+            reinterpret_cast<const uint8_t *>(&game_data),
+            reinterpret_cast<const uint8_t *>(&club_data),
+            reinterpret_cast<const uint8_t *>(&player_data),
+    };
+
+    dirty_tracker::WriteReport report;
+    std::filesystem::path image;
+    std::string inner;
+    if (splitDiskImagePath(saves_path, image, inner)) {
+        // A disk image has no room for a journal: the files are overwritten in place, slot files first.
+        for (int i = 0; i < dirty_tracker::kSaveFileCount; ++i) {
+            std::size_t size = dirty_tracker::fileSize(static_cast<dirty_tracker::SaveFile>(i));
+            save_whole_file(saves_path / (prefix + static_cast<char>('A' + i)), contents[i], size);
+            report.bytesWritten[i] = size;
+            report.fullRewrite[i] = true;
+        }
+        save_binary_file(saves_path / std::string{kSavesDirFile}, saves_dir_data);
+        save_binary_file(saves_path / std::string{kPrefsFile}, prefs_data);
+        report.metadataBytes = sizeof(saves) + sizeof(prefs);
+        return report;
+    }
+
+    save_journal::Transaction transaction(saves_path);
+    for (int i = 0; i < dirty_tracker::kSaveFileCount; ++i) {
+        auto file = static_cast<dirty_tracker::SaveFile>(i);
+        std::string fileName = prefix + static_cast<char>('A' + i);
+        std::size_t size = dirty_tracker::fileSize(file);
+
+        std::size_t dirtyBytes = 0;
+        if (dirty_spans) {
+            for (const auto &span : dirty_spans[i]) {
+                dirtyBytes += span.length;
+            }
+        }
+        if (dirty_spans && dirtyBytes < static_cast<std::size_t>(size * kFullRewriteRatio)) {
+            for (const auto &span : dirty_spans[i]) {
+                transaction.patch(fileName, span.offset, contents[i] + span.offset, span.length);
+                report.bytesWritten[i] += span.length;
+            }
+            continue;
+        }
+
+        transaction.replace(fileName, contents[i], size);
+        report.bytesWritten[i] = size;
+        report.fullRewrite[i] = true;
+    }
+    transaction.replace(std::string{kSavesDirFile}, &saves_dir_data, sizeof(saves));
+    transaction.replace(std::string{kPrefsFile}, &prefs_data, sizeof(prefs));
+    report.metadataBytes = sizeof(saves) + sizeof(prefs);
+    transaction.commit();
+    return report;
+}
+
+bool recoverInterruptedSave(const std::filesystem::path &game_path) {
+    std::filesystem::path image;
+    std::string inner;
+    if (installationFor(game_path)->gameType() == Pm3GameType::Unknown ||
+        splitDiskImagePath(game_path, image, inner)) {
         return false;
-    } else if (std::filesystem::file_size(gamecPath) != static_cast<uintmax_t>(saveGameSizes[2])) {
-        std::string gamecName = gamecPath.string();
-        snprintf(footer, footerSize, "INVALID %s FILESIZE", gamecName.c_str());
+    }
+
+    try {
+        switch (save_journal::recover(constructSavesFolderPath(game_path))) {
+            case save_journal::Recovery::RolledForward:
+                std::cerr << "Completed an interrupted save in " << game_path << std::endl;
+                return true;
+            case save_journal::Recovery::RolledBack:
+                std::cerr << "Discarded an incomplete save in " << game_path << std::endl;
+                return true;
+            case save_journal::Recovery::Clean:
+                break;
+        }
+    } catch (const std::filesystem::filesystem_error &e) {
+        gPm3LastError = std::string("Error recovering save: ") + e.what();
+    }
+    return false;
+}
+
+PendingSave captureSave(const Settings &settings, int gameNumber, const GameState &state) {
+    fillSaveEntry(savesDir, gameNumber, state.game);
+
+    PendingSave pending;
+    pending.gameNumber = gameNumber;
+    pending.gamePath = settings.gamePath;
+    pending.gameA = std::make_unique<gamea>(state.game);
+    pending.gameB = std::make_unique<gameb>(state.clubs);
+    pending.gameC = std::make_unique<gamec>(state.players);
+    pending.savesDir = savesDir;
+    pending.preferences = preferences;
+    pending.tracked = &state == &defaultGameState;
+    if (!pending.tracked) {
+        return pending;
+    }
+    pending.baselineGeneration = saveBaselineGeneration();
+    for (int i = 0; i < dirty_tracker::kSaveFileCount; ++i) {
+        pending.dirty[i] = dirty_tracker::dirtySpans(static_cast<dirty_tracker::SaveFile>(i));
+    }
+    // Edits made while the save is in flight are tracked against the state captured here.
+    dirty_tracker::clear();
+    return pending;
+}
+
+void finishSave(const PendingSave &pending) {
+    if (!pending.tracked) {
+        return;
+    }
+    edit_journal::restart(editJournalPath(pending.gamePath, pending.gameNumber), pending.gameNumber);
+    save_ledger::markSaved(ledgerPath(pending.gamePath, pending.gameNumber), pending.gameNumber);
+}
+
+bool writeSave(const PendingSave &pending, dirty_tracker::WriteReport &report, std::string &error,
+               const std::function<void(const std::string &)> &progress) {
+    auto step = [&progress](const std::string &text) {
+        if (progress) {
+            progress(text);
+        }
+    };
+
+    // A host folder needs no copy into the backup store first: the save journal keeps the commit crash-consistent,
+    // and the version being replaced is already in the history archive, recorded when it was loaded or last saved.
+    // Inside a disk image there is no history archive, so the store is still the only earlier copy.
+    std::filesystem::path image;
+    std::string inner;
+    if (splitDiskImagePath(pending.gamePath, image, inner)) {
+        Settings settings;
+        settings.gamePath = pending.gamePath;
+        step("BACKING UP GAME " + std::to_string(pending.gameNumber));
+        if (!backupSaveFile(settings, pending.gameNumber)) {
+            error = "ERROR SAVING: COULDN'T BACKUP SAVE GAME " + std::to_string(pending.gameNumber);
+            if (pending.tracked) {
+                resetSaveBaseline(pending.baselineGeneration);
+            }
+            return false;
+        }
+    }
+
+    bool incremental = pending.tracked && matchesSaveBaseline(pending.gameNumber, pending.gamePath);
+#ifndef NDEBUG
+    incremental = incremental && dirtySpansCoverChanges(pending);
+#endif
+
+    step("WRITING GAME " + std::to_string(pending.gameNumber));
+    try {
+        report = commitSaveGame(pending.gameNumber, pending.gamePath, *pending.gameA, *pending.gameB, *pending.gameC,
+                                pending.savesDir, pending.preferences, incremental ? pending.dirty : nullptr);
+    } catch (const std::exception &e) {
+        // The dirty spans were handed to this save; without a baseline the next save rewrites everything.
+        if (pending.tracked) {
+            resetSaveBaseline(pending.baselineGeneration);
+        }
+        gPm3LastError = e.what();
+        error = std::string("ERROR SAVING GAME ") + std::to_string(pending.gameNumber) + ": " + e.what();
         return false;
     }
 
-    loadBinaries(gameNumber, settings.gamePath);
+    if (pending.tracked) {
+        captureSaveBaseline(pending.gameNumber, pending.gamePath, pending.baselineGeneration);
+    }
+    std::filesystem::file_time_type writeTimes[dirty_tracker::kSaveFileCount];
+    if (readWriteTimes(pending.gameNumber, pending.gamePath, writeTimes)) {
+        const void *const contents[dirty_tracker::kSaveFileCount] = {pending.gameA.get(), pending.gameB.get(),
+                                                                     pending.gameC.get()};
+        recordSlotFingerprint(pending.gamePath, pending.gameNumber, contents, writeTimes);
+        recordHistory(pending.gamePath, pending.gameNumber, contents);
+        recordSlotSummary(pending.gamePath, pending.gameNumber, *pending.gameA, *pending.gameB, *pending.gameC,
+                          writeTimes);
+    }
     return true;
 }
 
+static void reportSave(int gameNumber, bool ok, const dirty_tracker::WriteReport &report, const std::string &error,
+                       char *footer, size_t footerSize) {
+    if (!ok) {
+        snprintf(footer, footerSize, "%.69s", error.c_str());
+        return;
+    }
+    dirty_tracker::recordWrite(report);
+    snprintf(footer, footerSize, "GAME %d SAVED (%zu BYTES WRITTEN)", gameNumber, report.total());
+}
+
 bool saveGame(const Settings &settings, int gameNumber, char *footer, size_t footerSize) {
-    if (backupSaveFile(settings, gameNumber)) {
-        updateMetadata(gameNumber, settings.gamePath);
-        saveBinaries(gameNumber, settings.gamePath);
-        saveMetadata(constructSavesFolderPath(settings.gamePath));
-        snprintf(footer, footerSize, "GAME %d SAVED", gameNumber);
-        return true;
+    PendingSave pending = captureSave(settings, gameNumber, defaultGameState);
+    dirty_tracker::WriteReport report;
+    std::string error;
+    bool ok = writeSave(pending, report, error);
+    if (ok) {
+        finishSave(pending);
     }
+    reportSave(gameNumber, ok, report, error, footer, footerSize);
+    return ok;
+}
 
-    snprintf(footer, footerSize, "ERROR SAVING: COULDN'T BACKUP SAVE GAME %d", gameNumber);
-    return false;
+void loadGameAsync(IoWorker &worker, const Settings &settings, int gameNumber, int &currentGame, char *footer,
+                   size_t footerSize) {
+    std::filesystem::path gamePath = settings.gamePath;
+    bool queued = worker.submit(gameNumber, [gamePath, gameNumber, &currentGame, footer, footerSize](
+            const IoWorker::Report &progress) -> IoWorker::Completion {
+        progress("LOADING GAME " + std::to_string(gameNumber));
+        auto loaded = std::make_shared<LoadedGame>();
+        auto error = std::make_shared<std::string>();
+        bool ok = readGame(gamePath, gameNumber, *loaded, *error);
+        return [ok, loaded, error, gameNumber, &currentGame, footer, footerSize]() {
+            if (!ok) {
+                snprintf(footer, footerSize, "%.69s", error->c_str());
+                return;
+            }
+            installLoadedGame(*loaded, defaultGameState);
+            currentGame = gameNumber;
+            if (loaded->recoveredEdits > 0) {
+                snprintf(footer, footerSize, "GAME %d LOADED, %zu UNSAVED EDITS RECOVERED", gameNumber,
+                         loaded->recoveredEdits);
+            } else if (loaded->validation.repaired > 0) {
+                snprintf(footer, footerSize, "GAME %d LOADED, %zu ERRORS REPAIRED", gameNumber,
+                         loaded->validation.repaired);
+            } else {
+                snprintf(footer, footerSize, "GAME %d LOADED", gameNumber);
+            }
+        };
+    });
+    if (!queued) {
+        snprintf(footer, footerSize, "GAME %d IS BUSY", gameNumber);
+    }
+}
+
+void saveGameAsync(IoWorker &worker, const Settings &settings, int gameNumber, char *footer, size_t footerSize) {
+    if (worker.isBusy(gameNumber)) {
+        snprintf(footer, footerSize, "GAME %d IS BUSY", gameNumber);
+        return;
+    }
+
+    auto pending = std::make_shared<PendingSave>(captureSave(settings, gameNumber, defaultGameState));
+    worker.submit(gameNumber, [pending, footer, footerSize](const IoWorker::Report &progress) -> IoWorker::Completion {
+        auto report = std::make_shared<dirty_tracker::WriteReport>();
+        auto error = std::make_shared<std::string>();
+        bool ok = writeSave(*pending, *report, *error, progress);
+        return [ok, report, error, pending, footer, footerSize]() {
+            if (ok) {
+                finishSave(*pending);
+            }
+            reportSave(pending->gameNumber, ok, *report, *error, footer, footerSize);
+            loadSlotSummaries(pending->gamePath);
+        };
+    });
+}
+
+void manageSlotAsync(IoWorker &worker, const Settings &settings, SlotOperation operation, int from, int to,
+                     std::bitset<8> &saveFiles, char *footer, size_t footerSize) {
+    std::filesystem::path gamePath = settings.gamePath;
+    bool queued = worker.submit({from, to}, [gamePath, operation, from, to, &saveFiles, footer, footerSize](
+            const IoWorker::Report &progress) -> IoWorker::Completion {
+        progress(std::string(slotOperationName(operation)) + " GAME " + std::to_string(from));
+        auto error = std::make_shared<std::string>();
+        bool ok = manageSlot(gamePath, operation, from, to, *error);
+        return [ok, error, gamePath, operation, from, to, &saveFiles, footer, footerSize]() {
+            if (!ok) {
+                snprintf(footer, footerSize, "%.69s", error->c_str());
+                return;
+            }
+            Settings settings;
+            settings.gamePath = gamePath;
+            loadMetadata(gamePath);
+            memoizeSaveFiles(settings, saveFiles);
+            loadSlotSummaries(gamePath);
+            switch (operation) {
+                case SlotOperation::Copy:
+                    snprintf(footer, footerSize, "GAME %d COPIED TO GAME %d", from, to);
+                    break;
+                case SlotOperation::Move:
+                    snprintf(footer, footerSize, "GAME %d MOVED TO GAME %d", from, to);
+                    break;
+                case SlotOperation::Swap:
+                    snprintf(footer, footerSize, "GAMES %d AND %d SWAPPED", from, to);
+                    break;
+                case SlotOperation::Delete:
+                    snprintf(footer, footerSize, "GAME %d DELETED", from);
+                    break;
+            }
+        };
+    });
+    if (!queued) {
+        snprintf(footer, footerSize, "GAME %d IS BUSY", worker.isBusy(from) ? from : to);
+    }
+}
+
+// The loaded slot's files must not change underneath the edits held in memory; copying it elsewhere is fine.
+static bool changesSlot(SlotOperation operation, int from, int to, int gameNumber) {
+    return gameNumber != 0 && (to == gameNumber || (operation != SlotOperation::Copy && from == gameNumber));
+}
+
+static void confirmSlotOperation(InputHandler &input, IoWorker &worker, const Settings &settings,
+                                 SlotOperation operation, int from, int to, int currentGame,
+                                 std::bitset<8> &saveFiles, char *footer, size_t footerSize) {
+    input.resetKeyPressCallbacks();
+    if (changesSlot(operation, from, to, currentGame)) {
+        snprintf(footer, footerSize, "GAME %d IS LOADED", currentGame);
+        return;
+    }
+
+    auto run = [&input, &worker, &settings, operation, from, to, &saveFiles, footer, footerSize]() {
+        input.resetKeyPressCallbacks();
+        manageSlotAsync(worker, settings, operation, from, to, saveFiles, footer, footerSize);
+    };
+    // A swap loses nothing; anything else that replaces or removes a game asks first.
+    bool destroys = operation == SlotOperation::Delete ||
+                    (operation != SlotOperation::Swap && saveFiles.test(static_cast<std::size_t>(to - 1)));
+    if (!destroys) {
+        run();
+        return;
+    }
+
+    if (operation == SlotOperation::Delete) {
+        snprintf(footer, footerSize, "Delete Game %d: Are you sure? (Y/N)", from);
+    } else {
+        snprintf(footer, footerSize, "Overwrite Game %d with Game %d? (Y/N)", to, from);
+    }
+    auto cancel = [&input, footer]() {
+        footer[0] = '\0';
+        input.resetKeyPressCallbacks();
+    };
+    input.addKeyPressCallback('y', run);
+    input.addKeyPressCallback('Y', run);
+    input.addKeyPressCallback('n', cancel);
+    input.addKeyPressCallback('N', cancel);
+}
+
+static void chooseSlotTarget(InputHandler &input, IoWorker &worker, const Settings &settings,
+                             SlotOperation operation, int from, int currentGame, std::bitset<8> &saveFiles,
+                             char *footer, size_t footerSize) {
+    if (operation == SlotOperation::Delete) {
+        confirmSlotOperation(input, worker, settings, operation, from, 0, currentGame, saveFiles, footer, footerSize);
+        return;
+    }
+
+    input.resetKeyPressCallbacks();
+    const char *verb = operation == SlotOperation::Copy ? "Copy" : operation == SlotOperation::Move ? "Move" : "Swap";
+    snprintf(footer, footerSize, "%s Game %d %s which game? (1-8)", verb, from,
+             operation == SlotOperation::Swap ? "with" : "to");
+    for (int to = 1; to <= 8; ++to) {
+        if (to == from) {
+            continue;
+        }
+        input.addKeyPressCallback('0' + to, [&input, &worker, &settings, operation, from, to, currentGame, &saveFiles,
+                                             footer, footerSize]() {
+            confirmSlotOperation(input, worker, settings, operation, from, to, currentGame, saveFiles, footer,
+                                 footerSize);
+        });
+    }
+    input.addKeyPressCallback('n', [&input, footer]() {
+        footer[0] = '\0';
+        input.resetKeyPressCallbacks();
+    });
+}
+
+// C, M, S and D on a slot prompt start a copy, move, swap or delete of that slot.
+static void addSlotOperationKeys(InputHandler &input, IoWorker &worker, const Settings &settings, int gameNumber,
+                                 int currentGame, std::bitset<8> &saveFiles, char *footer, size_t footerSize) {
+    const std::pair<char, SlotOperation> slotKeys[] = {
+            {'c', SlotOperation::Copy}, {'m', SlotOperation::Move}, {'s', SlotOperation::Swap},
+            {'d', SlotOperation::Delete}};
+    for (const auto &[key, operation] : slotKeys) {
+        auto slotCallback = [&input, &worker, &settings, operation = operation, gameNumber, currentGame, &saveFiles,
+                             footer, footerSize]() {
+            chooseSlotTarget(input, worker, settings, operation, gameNumber, currentGame, saveFiles, footer,
+                             footerSize);
+        };
+        input.addKeyPressCallback(key, slotCallback);
+        input.addKeyPressCallback(key - 'a' + 'A', slotCallback);
+    }
 }
 
 void choosePm3Folder(Settings &settings, std::bitset<8> &saveFiles) {
@@ -370,9 +1714,21 @@ void choosePm3Folder(Settings &settings, std::bitset<8> &saveFiles) {
     nfdresult_t result = NFD_PickFolder(&outPath, defaultPathPtr);
     if (result == NFD_OKAY && outPath) {
         std::filesystem::path selectedPath(outPath);
-        settings.gameType = getPm3GameType(selectedPath);
+        if (installationFor(selectedPath)->gameType() == Pm3GameType::Unknown) {
+            // A folder holding a DOSBox disk image stands for the PM3 folder inside the image.
+            std::error_code ec;
+            for (std::filesystem::directory_iterator it(selectedPath, ec), end; !ec && it != end; it.increment(ec)) {
+                std::filesystem::path inImage;
+                if (fat_image::isImageFile(it->path()) && !(inImage = findPm3InDiskImage(it->path())).empty()) {
+                    selectedPath = inImage;
+                    break;
+                }
+            }
+        }
+        settings.gameType = installationFor(selectedPath)->gameType();
         settings.gamePath = selectedPath;
         NFD_FreePath(outPath);
+        recoverInterruptedSave(settings.gamePath);
         savePrefs(settings);
         memoizeSaveFiles(settings, saveFiles);
     } else if (result == NFD_ERROR) {
@@ -384,20 +1740,21 @@ void choosePm3Folder(Settings &settings, std::bitset<8> &saveFiles) {
     NFD_Quit();
 }
 
-void loadGameConfirm(InputHandler &input, Settings &settings, int gameNumber, int &currentGame, char *footer,
-                     size_t footerSize) {
-    snprintf(footer, footerSize, "Load Game %d: Are you sure? (Y/N)", gameNumber);
+void loadGameConfirm(InputHandler &input, IoWorker &worker, Settings &settings, int gameNumber, int &currentGame,
+                     std::bitset<8> &saveFiles, char *footer, size_t footerSize) {
+    if (worker.isBusy(gameNumber)) {
+        snprintf(footer, footerSize, "GAME %d IS BUSY", gameNumber);
+        return;
+    }
+    snprintf(footer, footerSize, "Load Game %d? (Y/N) or C)opy M)ove S)wap D)elete", gameNumber);
 
     auto clearFooterAndCallbacks = [&input, footer]() {
         footer[0] = '\0';
         input.resetKeyPressCallbacks();
     };
 
-    auto loadCallback = [&input, &settings, gameNumber, &currentGame, footer, footerSize]() {
-        if (loadGame(settings, gameNumber, footer, footerSize)) {
-            currentGame = gameNumber;
-            snprintf(footer, footerSize, "GAME %d LOADED", gameNumber);
-        }
+    auto loadCallback = [&input, &worker, &settings, gameNumber, &currentGame, footer, footerSize]() {
+        loadGameAsync(worker, settings, gameNumber, currentGame, footer, footerSize);
         input.resetKeyPressCallbacks();
     };
 
@@ -405,13 +1762,19 @@ void loadGameConfirm(InputHandler &input, Settings &settings, int gameNumber, in
     input.addKeyPressCallback('Y', loadCallback);
     input.addKeyPressCallback('n', clearFooterAndCallbacks);
     input.addKeyPressCallback('N', clearFooterAndCallbacks);
+    addSlotOperationKeys(input, worker, settings, gameNumber, currentGame, saveFiles, footer, footerSize);
 }
 
-void saveGameConfirm(InputHandler &input, const Settings &settings, int gameNumber, char *footer, size_t footerSize) {
-    snprintf(footer, footerSize, "Save Game %d: Are you sure? (Y/N)", gameNumber);
+void saveGameConfirm(InputHandler &input, IoWorker &worker, const Settings &settings, int gameNumber, int currentGame,
+                     std::bitset<8> &saveFiles, char *footer, size_t footerSize) {
+    if (worker.isBusy(gameNumber)) {
+        snprintf(footer, footerSize, "GAME %d IS BUSY", gameNumber);
+        return;
+    }
+    snprintf(footer, footerSize, "Save Game %d? (Y/N) or C)opy M)ove S)wap D)elete", gameNumber);
 
-    auto saveCallback = [&input, &settings, gameNumber, footer, footerSize]() {
-        saveGame(settings, gameNumber, footer, footerSize);
+    auto saveCallback = [&input, &worker, &settings, gameNumber, footer, footerSize]() {
+        saveGameAsync(worker, settings, gameNumber, footer, footerSize);
         input.resetKeyPressCallbacks();
     };
 
@@ -424,6 +1787,7 @@ void saveGameConfirm(InputHandler &input, const Settings &settings, int gameNumb
     input.addKeyPressCallback('Y', saveCallback);
     input.addKeyPressCallback('n', cancelCallback);
     input.addKeyPressCallback('N', cancelCallback);
+    addSlotOperationKeys(input, worker, settings, gameNumber, currentGame, saveFiles, footer, footerSize);
 }
 
 void formatSaveGameLabel(int i, char *gameLabel, size_t gameLabelSize) {
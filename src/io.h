@@ -3,8 +3,14 @@
 
 #include <bitset>
 #include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
 #include <vector>
 
+#include "dirty_tracker.h"
+#include "save_journal.h"
+#include "save_validator.h"
 #include "settings.h"
 #include "pm3_defs.hh"
 #include "pm3_data.h"
@@ -13,6 +19,39 @@ class InputHandler;
 
 namespace io {
 
+class IoWorker;
+
+// A slot read off the UI thread; installLoadedGame() copies it into a GameState.
+struct LoadedGame {
+    int gameNumber = 0;
+    std::filesystem::path gamePath;
+    std::unique_ptr<gamea> gameA;
+    std::unique_ptr<gameb> gameB;
+    std::unique_ptr<gamec> gameC;
+    bool baselineValid = false;
+    std::filesystem::file_time_type writeTimes[dirty_tracker::kSaveFileCount]{};
+    // Already repaired in gameA/B/C; installLoadedGame marks the repaired bytes dirty so the next save keeps them.
+    save_validator::Report validation;
+    // Unsaved edits replayed from the slot's edit journal by installLoadedGame, e.g. after a crash.
+    std::size_t recoveredEdits = 0;
+};
+
+// Everything a save writes, copied out of a GameState so the UI can keep editing while it is on disk.
+struct PendingSave {
+    int gameNumber = 0;
+    std::filesystem::path gamePath;
+    std::unique_ptr<gamea> gameA;
+    std::unique_ptr<gameb> gameB;
+    std::unique_ptr<gamec> gameC;
+    saves savesDir{};
+    prefs preferences{};
+    std::vector<dirty_tracker::Span> dirty[dirty_tracker::kSaveFileCount];
+    unsigned baselineGeneration = 0;
+    // Captured from defaultGameState. Only the editor's state has dirty spans, a save baseline, an undo history
+    // and a ledger; a save of any other state rewrites its files in full and leaves those alone.
+    bool tracked = false;
+};
+
 void loadPrefs(Settings &settings);
 void savePrefs(const Settings &settings);
 
@@ -22,15 +61,56 @@ void memoizeSaveFiles(const Settings &settings, std::bitset<8> &saveFiles);
 bool ensureMetadataLoaded(const Settings &settings, int currentGame, std::bitset<8> &saveFiles, char *footer,
                           size_t footerSize, bool attachClickCallbacks);
 
+inline constexpr const char *kBaseBackupSet = "BASE";
+
+// Both backups record a new deduplicated version in <dir>/PM3000/store (see backup_store.h).
 bool backupSaveFile(const Settings &settings, int gameNumber);
 bool loadGame(const Settings &settings, int gameNumber, char *footer, size_t footerSize);
 bool saveGame(const Settings &settings, int gameNumber, char *footer, size_t footerSize);
 
+// The steps of loadGame/saveGame, which work on defaultGameState. readGame and writeSave touch only their arguments
+// and the disk, so they may run on the I/O worker; installLoadedGame, captureSave and finishSave read or write
+// `state` and SAVES.DIR and belong on the UI thread. For defaultGameState they also reset or read the dirty
+// tracker, edit journal and ledger; other states are loaded and saved whole. finishSave follows a successful
+// writeSave: it starts a new undo history and marks the ledger saved.
+bool readGame(const std::filesystem::path &gamePath, int gameNumber, LoadedGame &loaded, std::string &error);
+void installLoadedGame(LoadedGame &loaded, GameState &state);
+PendingSave captureSave(const Settings &settings, int gameNumber, const GameState &state);
+bool writeSave(const PendingSave &pending, dirty_tracker::WriteReport &report, std::string &error,
+               const std::function<void(const std::string &)> &progress = nullptr);
+void finishSave(const PendingSave &pending);
+
+// Queue a load/save on `worker`; the footer is updated when the completion is pumped on the UI thread.
+void loadGameAsync(IoWorker &worker, const Settings &settings, int gameNumber, int &currentGame, char *footer,
+                   size_t footerSize);
+void saveGameAsync(IoWorker &worker, const Settings &settings, int gameNumber, char *footer, size_t footerSize);
+
+enum class Reload {
+    Unchanged, // our own last save, or nothing differed
+    Reloaded,
+    HeldForEdits, // the file has unsaved edits, which were kept; reload the whole slot to take the new file
+    Failed,
+};
+// Re-read one file of the slot in `state` (or SAVES.DIR) after another program rewrote it. For defaultGameState,
+// reloadSaveFile leaves memory alone if the file is the one our last save wrote, or if it has unsaved edits.
+Reload reloadSaveFile(const std::filesystem::path &gamePath, int gameNumber, char gameLetter, GameState &state,
+                      std::string &error);
+bool reloadSavesDir(const std::filesystem::path &gamePath, std::string &error);
+// Makes the next save of the loaded slot rewrite its files in full, for when memory stops following them without
+// the dirty tracker seeing it, e.g. while the live view copies in the running game.
+void forgetSaveBaseline();
+
 void choosePm3Folder(Settings &settings, std::bitset<8> &saveFiles);
-void loadGameConfirm(InputHandler &input, Settings &settings, int gameNumber, int &currentGame, char *footer,
-                     size_t footerSize);
-void saveGameConfirm(InputHandler &input, const Settings &settings, int gameNumber, char *footer, size_t footerSize);
+// Ask to load or save `gameNumber`; C, M, S or D instead copy, move, swap or delete that slot (see manageSlot).
+void loadGameConfirm(InputHandler &input, IoWorker &worker, Settings &settings, int gameNumber, int &currentGame,
+                     std::bitset<8> &saveFiles, char *footer, size_t footerSize);
+void saveGameConfirm(InputHandler &input, IoWorker &worker, const Settings &settings, int gameNumber, int currentGame,
+                     std::bitset<8> &saveFiles, char *footer, size_t footerSize);
 void formatSaveGameLabel(int i, char *gameLabel, size_t gameLabelSize);
+// Reads the slot summary index (PM3000/SLOTS.IDX) and keeps the summaries whose files are unchanged.
+void loadSlotSummaries(const std::filesystem::path &gamePath);
+// False if slot `i` has no current summary; nothing is read from disk.
+bool formatSlotSummary(int i, char *summaryLabel, size_t summaryLabelSize);
 
 void loadBinaries(int gameNumber, const std::filesystem::path &gamePath, gamea &gameDataOut=gameData, gameb &clubDataOut=clubData, gamec &playerDataOut=playerData);
 void loadDefaultGamedata(const std::filesystem::path &gamePath, gamea &gameDataOut=gameData);
@@ -43,13 +123,59 @@ std::size_t getGameaExtraBytes();
 void saveDefaultClubdata(const std::filesystem::path &gamePath, const gameb &clubDataOut=clubData);
 void saveDefaultPlaydata(const std::filesystem::path &gamePath, const gamec &playerDataOut=playerData);
 void saveMetadata(const std::filesystem::path &gamePath, saves &savesDirOut=savesDir, prefs &prefsOut=preferences);
+// The same for any GameState, e.g. one of several a tool works on in parallel. These do not touch the globals or
+// the dirty tracker, and the base data keeps its own GAMEDATA.DAT tail.
+void loadBinaries(int gameNumber, const std::filesystem::path &gamePath, GameState &state);
+void saveBinaries(int gameNumber, const std::filesystem::path &gamePath, const GameState &state);
+void loadDefaultData(const std::filesystem::path &gamePath, GameState &state);
+void saveDefaultData(const std::filesystem::path &gamePath, const GameState &state);
 void updateMetadata(int gameNumber, const std::filesystem::path &gamePath);
+// Publishes all files of a save slot plus SAVES.DIR/PREFS as one journaled transaction; throws on failure.
+// With `dirtySpans` (one list per GAMEnA/B/C), those files are patched in place, falling back to a full rewrite
+// of any file that is mostly dirty.
+dirty_tracker::WriteReport commitSaveGame(int gameNumber, const std::filesystem::path &gamePath,
+                                          const gamea &gameDataIn, const gameb &clubDataIn,
+                                          const gamec &playerDataIn, const saves &savesDirIn, const prefs &prefsIn,
+                                          const std::vector<dirty_tracker::Span> *dirtySpans = nullptr);
+// Finishes or discards a save that was interrupted by a crash. Returns true if anything was recovered.
+bool recoverInterruptedSave(const std::filesystem::path &gamePath);
 bool backupPm3Files(const std::filesystem::path &gamePath);
+std::filesystem::path backupStorePath(const std::filesystem::path &backupDir);
+// Puts a stored version of GAMEnA/B/C back in place (and refreshes its SAVES.DIR entry) in one transaction.
+bool restoreSaveBackup(const std::filesystem::path &gamePath, int gameNumber, uint32_t version);
+
+enum class SlotOperation {
+    Copy,
+    Move,
+    Swap,
+    Delete,
+};
+const char *slotOperationName(SlotOperation operation);
+
+// Copies, moves or swaps slot `from` onto slot `to`, or deletes `from` (`to` unused), in one transaction. Files
+// are staged as reflinks or with copy_file_range where the filesystem allows, and only the two slots' SAVES.DIR
+// entries are patched. Slots that are overwritten or deleted are backed up first; the history archive follows
+// the game.
+bool manageSlot(const std::filesystem::path &gamePath, SlotOperation operation, int from, int to, std::string &error,
+                save_journal::CopyMethod *method = nullptr);
+// Runs manageSlot on `worker`, claiming both slots, then reloads SAVES.DIR and the slot list.
+void manageSlotAsync(IoWorker &worker, const Settings &settings, SlotOperation operation, int from, int to,
+                     std::bitset<8> &saveFiles, char *footer, size_t footerSize);
 std::filesystem::path constructSavesFolderPath(const std::filesystem::path& gamePath);
 std::filesystem::path constructSaveFilePath(const std::filesystem::path& gamePath, int gameNumber, char gameLetter);
 std::filesystem::path constructGameFilePath(const std::filesystem::path &gamePath, const std::string &fileName);
+// Probes the disk on every call; prefer installationFor(gamePath)->gameType() (installation.h).
 Pm3GameType getPm3GameType(const std::filesystem::path &gamePath);
+
+// A game path may lead into a FAT disk image, e.g. /dos/hdd.img/PM3: every file below it is then read and written
+// inside the image (see fat_image.h). Slot files can only be rewritten in place there, so new slots, slot
+// management, restores and the journal are unavailable; backups go to PM3000/<image name> next to the image.
+// Splits such a path into the image file and the path inside it; false for ordinary paths.
+bool splitDiskImagePath(const std::filesystem::path &path, std::filesystem::path &image, std::string &inner);
+// The game path of the PM3 folder inside `image` (its root or a top-level directory), or empty if there is none.
+std::filesystem::path findPm3InDiskImage(const std::filesystem::path &image);
 const char* getSavesFolder(Pm3GameType gameType);
 const std::string& pm3LastError();
+void setPm3LastError(const std::string &message);
 
 } // namespace io
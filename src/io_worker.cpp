@@ -0,0 +1,146 @@
+// Background thread that owns save/load file I/O so the render loop never blocks on disk.
+#include "io_worker.h"
+
+#include <exception>
+#include <string>
+#include <utility>
+
+namespace io {
+
+IoWorker::IoWorker(Notify notifyCallback) : notify(std::move(notifyCallback)) {
+    thread = std::thread([this] { run(); });
+}
+
+IoWorker::~IoWorker() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    // Queued saves still run to completion; only their main-thread completions are dropped.
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+bool IoWorker::submit(int slot, Work work) {
+    return submit({slot}, std::move(work));
+}
+
+bool IoWorker::submit(std::initializer_list<int> slots, Work work) {
+    Slots claim;
+    for (int slot : slots) {
+        if (slot > 0) {
+            claim.set(slot);
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if ((busy & claim).any()) {
+            return false;
+        }
+        busy |= claim;
+        queue.push_back({claim, std::move(work)});
+    }
+    wake.notify_one();
+    return true;
+}
+
+bool IoWorker::isBusy(int slot) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return slot > 0 && busy.test(slot);
+}
+
+bool IoWorker::idle() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return queue.empty() && done.empty() && !running;
+}
+
+std::string IoWorker::progress() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return progressText;
+}
+
+std::string IoWorker::takeError() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return std::exchange(lastError, std::string());
+}
+
+std::size_t IoWorker::pump() {
+    std::deque<Done> ready;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ready.swap(done);
+    }
+
+    for (auto &item : ready) {
+        if (item.completion) {
+            item.completion();
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        busy &= ~item.slots;
+        if (!item.error.empty()) {
+            lastError = std::move(item.error);
+        }
+    }
+    return ready.size();
+}
+
+void IoWorker::drain() {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [this] { return queue.empty() && !running; });
+    }
+    pump();
+}
+
+void IoWorker::report(const std::string &text) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        progressText = text;
+    }
+    if (notify) {
+        notify();
+    }
+}
+
+void IoWorker::run() {
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) {
+                return;
+            }
+            job = std::move(queue.front());
+            queue.pop_front();
+            running = true;
+        }
+
+        Completion completion;
+        std::string error;
+        try {
+            completion = job.work([this](const std::string &text) { report(text); });
+        } catch (const std::exception &ex) {
+            error = ex.what();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            done.push_back({job.slots, std::move(completion), std::move(error)});
+            progressText.clear();
+        }
+        if (notify) {
+            notify();
+        }
+        // Only count the job as finished once the owner has been told, so drain() never outruns the wake-up.
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            running = false;
+        }
+        finished.notify_all();
+    }
+}
+
+} // namespace io
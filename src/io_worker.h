@@ -0,0 +1,79 @@
+// Background thread that owns save/load file I/O so the render loop never blocks on disk.
+#pragma once
+
+#include <bitset>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace io {
+
+// Jobs run one at a time on the worker thread and hand back a completion that the owner runs on its own
+// thread from pump(). Each job may claim a save slot (1-8); the slot stays busy until its completion has run,
+// so only that slot's load/save is locked while the rest of the UI keeps working.
+class IoWorker {
+public:
+    using Notify = std::function<void()>;
+    using Report = std::function<void(const std::string &)>;
+    using Completion = std::function<void()>;
+    using Work = std::function<Completion(const Report &)>;
+
+    explicit IoWorker(Notify notify = nullptr);
+    ~IoWorker();
+
+    IoWorker(const IoWorker &) = delete;
+    IoWorker &operator=(const IoWorker &) = delete;
+
+    // Returns false without queueing if `slot` already has a job in flight.
+    bool submit(int slot, Work work);
+    // Claims every slot in `slots` or none of them, for jobs that touch two slots such as a slot copy.
+    bool submit(std::initializer_list<int> slots, Work work);
+
+    bool isBusy(int slot) const;
+    bool idle() const;
+    std::string progress() const;
+    // The message of the last job that threw instead of returning a completion, once pump() has reached it; empty
+    // if none has since the last call.
+    std::string takeError();
+
+    // Runs finished completions on the calling thread. Returns how many ran.
+    std::size_t pump();
+
+    // Blocks until the queue is empty, then runs the completions. Used on shutdown and in tests.
+    void drain();
+
+private:
+    using Slots = std::bitset<9>;
+
+    struct Job {
+        Slots slots;
+        Work work;
+    };
+    struct Done {
+        Slots slots;
+        Completion completion;
+        std::string error;
+    };
+
+    void run();
+    void report(const std::string &text);
+
+    Notify notify;
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    std::deque<Job> queue;
+    std::deque<Done> done;
+    Slots busy;
+    std::string progressText;
+    std::string lastError;
+    bool running = false;
+    bool stopping = false;
+    std::thread thread;
+};
+
+} // namespace io
@@ -0,0 +1,337 @@
+// Read-only view of the gamea/gameb/gamec that PM3 holds in memory while it runs under DOSBox.
+#include "live_attach.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <set>
+#include <sstream>
+#include <system_error>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <sys/uio.h>
+#endif
+
+namespace io {
+
+namespace {
+
+// Bytes the reference expects at an offset into a block.
+struct Probe {
+    std::size_t offset;
+    std::vector<uint8_t> bytes;
+};
+
+// A block is where at least `required` of its probes match. The first few probes are searched for; the rest
+// only confirm a candidate.
+struct Signature {
+    std::size_t size = 0;
+    std::vector<Probe> probes;
+    std::size_t required = 0;
+};
+
+constexpr std::size_t kSampledProbes = 32;
+constexpr std::size_t kAnchors = 3;
+constexpr std::size_t kMinimumProbes = 4;
+// Memory is scanned this much at a time.
+constexpr std::size_t kScanChunk = 4 * 1024 * 1024;
+
+struct Region {
+    uint64_t start;
+    uint64_t end;
+};
+
+// A name worth matching: a few letters, not blanks or padding.
+bool meaningfulName(const char *name, std::size_t size) {
+    std::size_t letters = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+        letters += std::isalpha(static_cast<unsigned char>(name[i])) ? 1 : 0;
+    }
+    return letters >= 3;
+}
+
+// Probes at `count` records of `recordSize` bytes, whose name of `nameSize` bytes starts `nameOffset` into each.
+Signature nameSignature(const uint8_t *block, std::size_t size, std::size_t count, std::size_t recordSize,
+                        std::size_t nameOffset, std::size_t nameSize, std::size_t requiredPercent) {
+    Signature signature;
+    signature.size = size;
+    std::size_t step = std::max<std::size_t>(1, count / kSampledProbes);
+    for (std::size_t i = 0; i < count && signature.probes.size() < kSampledProbes; i += step) {
+        std::size_t offset = i * recordSize + nameOffset;
+        const auto *name = reinterpret_cast<const char *>(block + offset);
+        if (meaningfulName(name, nameSize)) {
+            signature.probes.push_back({offset, std::vector<uint8_t>(block + offset, block + offset + nameSize)});
+        }
+    }
+    signature.required = (signature.probes.size() * requiredPercent + 99) / 100;
+    return signature;
+}
+
+// gamea has no names, but its league history only changes once a season.
+Signature historySignature(const gamea &game) {
+    Signature signature;
+    signature.size = sizeof(gamea);
+    const auto *block = reinterpret_cast<const uint8_t *>(&game);
+    constexpr std::size_t kEntrySize = sizeof(game.league[0].history[0]);
+    constexpr std::size_t kEntries = sizeof(game.league) / kEntrySize;
+    for (std::size_t i = 0; i < kEntries; ++i) {
+        std::size_t offset = offsetof(gamea, league) + i * kEntrySize;
+        const uint8_t *entry = block + offset;
+        if (std::any_of(entry, entry + kEntrySize, [](uint8_t b) { return b != 0; })) {
+            signature.probes.push_back({offset, std::vector<uint8_t>(entry, entry + kEntrySize)});
+        }
+    }
+    signature.required = (signature.probes.size() + 1) / 2;
+    return signature;
+}
+
+#if defined(__linux__)
+std::vector<Region> writableRegions(int pid) {
+    std::vector<Region> regions;
+    std::ifstream maps("/proc/" + std::to_string(pid) + "/maps");
+    std::string line;
+    while (std::getline(maps, line)) {
+        std::istringstream fields(line);
+        std::string range;
+        std::string perms;
+        fields >> range >> perms;
+        std::size_t dash = range.find('-');
+        if (dash == std::string::npos || perms.size() < 2 || perms[0] != 'r' || perms[1] != 'w') {
+            continue;
+        }
+        Region region{std::stoull(range.substr(0, dash), nullptr, 16),
+                      std::stoull(range.substr(dash + 1), nullptr, 16)};
+        if (region.end > region.start) {
+            regions.push_back(region);
+        }
+    }
+    return regions;
+}
+
+bool readRemote(int pid, uint64_t address, uint8_t *dest, std::size_t length) {
+    iovec local{dest, length};
+    iovec remote{reinterpret_cast<void *>(address), length};
+    return ::process_vm_readv(pid, &local, 1, &remote, 1, 0) == static_cast<ssize_t>(length);
+}
+
+// Where in `pid`'s writable memory the signature scores best, counting only places where one of its anchors
+// occurs and at least the required probes match. 0 if there is none.
+uint64_t locate(int pid, const std::vector<Region> &regions, const Signature &signature) {
+    std::size_t anchors = std::min(kAnchors, signature.probes.size());
+    std::size_t overlap = 0;
+    for (std::size_t a = 0; a < anchors; ++a) {
+        overlap = std::max(overlap, signature.probes[a].bytes.size());
+    }
+
+    std::set<uint64_t> candidates;
+    std::vector<uint8_t> chunk;
+    for (const Region &region : regions) {
+        for (uint64_t from = region.start; from < region.end; from += kScanChunk) {
+            std::size_t length = static_cast<std::size_t>(std::min<uint64_t>(kScanChunk + overlap, region.end - from));
+            chunk.resize(length);
+            if (!readRemote(pid, from, chunk.data(), length)) {
+                continue;
+            }
+            for (std::size_t a = 0; a < anchors; ++a) {
+                const Probe &anchor = signature.probes[a];
+                std::boyer_moore_horspool_searcher searcher(anchor.bytes.begin(), anchor.bytes.end());
+                for (auto it = std::search(chunk.begin(), chunk.end(), searcher); it != chunk.end();
+                     it = std::search(it + 1, chunk.end(), searcher)) {
+                    uint64_t hit = from + static_cast<uint64_t>(it - chunk.begin());
+                    if (hit >= region.start + anchor.offset && hit - anchor.offset + signature.size <= region.end) {
+                        candidates.insert(hit - anchor.offset);
+                    }
+                }
+            }
+        }
+    }
+
+    uint64_t best = 0;
+    std::size_t bestScore = 0;
+    std::vector<uint8_t> block(signature.size);
+    for (uint64_t candidate : candidates) {
+        if (!readRemote(pid, candidate, block.data(), block.size())) {
+            continue;
+        }
+        std::size_t score = std::count_if(signature.probes.begin(), signature.probes.end(), [&block](const Probe &p) {
+            return std::equal(p.bytes.begin(), p.bytes.end(), block.begin() + static_cast<std::ptrdiff_t>(p.offset));
+        });
+        if (score >= signature.required && score > bestScore) {
+            best = candidate;
+            bestScore = score;
+        }
+    }
+    return best;
+}
+
+uint8_t *blockOf(GameState &state, int file) {
+    switch (file) {
+        case kWatchGameA:
+            return reinterpret_cast<uint8_t *>(&state.game);
+        case kWatchGameB:
+            return reinterpret_cast<uint8_t *>(&state.clubs);
+        default:
+            return reinterpret_cast<uint8_t *>(&state.players);
+    }
+}
+
+constexpr std::size_t kBlockSizes[] = {sizeof(gamea), sizeof(gameb), sizeof(gamec)};
+#endif
+
+} // namespace
+
+std::vector<int> LiveAttach::findDosbox() {
+    std::vector<int> pids;
+#if defined(__linux__)
+    std::error_code ec;
+    for (const auto &entry : std::filesystem::directory_iterator("/proc", ec)) {
+        const std::string name = entry.path().filename().string();
+        if (name.empty() || !std::all_of(name.begin(), name.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+            continue;
+        }
+        std::ifstream comm(entry.path() / "comm");
+        std::string command;
+        std::getline(comm, command);
+        std::transform(command.begin(), command.end(), command.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        if (command.find("dosbox") != std::string::npos) {
+            pids.push_back(std::stoi(name));
+        }
+    }
+    std::sort(pids.begin(), pids.end());
+#endif
+    return pids;
+}
+
+bool LiveAttach::find(int pid, const GameState &reference, Location &location, std::string &error) {
+#if defined(__linux__)
+    std::vector<Region> regions = writableRegions(pid);
+    if (regions.empty()) {
+        error = "CANNOT READ PROCESS " + std::to_string(pid);
+        return false;
+    }
+
+    Signature signatures[kBlockCount] = {
+            historySignature(reference.game),
+            nameSignature(reinterpret_cast<const uint8_t *>(&reference.clubs), sizeof(gameb),
+                          std::extent_v<decltype(gameb::club)>, sizeof(ClubRecord), offsetof(ClubRecord, name),
+                          sizeof(ClubRecord::name), 75),
+            nameSignature(reinterpret_cast<const uint8_t *>(&reference.players), sizeof(gamec),
+                          std::extent_v<decltype(gamec::player)>, sizeof(PlayerRecord),
+                          offsetof(PlayerRecord, name), sizeof(PlayerRecord::name), 50),
+    };
+    uint64_t found[kBlockCount]{};
+    for (int file = 0; file < kBlockCount; ++file) {
+        if (signatures[file].probes.size() >= kMinimumProbes) {
+            found[file] = locate(pid, regions, signatures[file]);
+        }
+    }
+    if (found[kWatchGameB] == 0 || found[kWatchGameC] == 0) {
+        error = std::string("NO PM3 ") + (found[kWatchGameB] == 0 ? "CLUBS" : "PLAYERS") + " IN PROCESS " +
+                std::to_string(pid);
+        return false;
+    }
+
+    location.pid = pid;
+    std::copy(std::begin(found), std::end(found), location.addresses);
+    return true;
+#else
+    (void)reference;
+    (void)location;
+    error = "LIVE VIEW NEEDS LINUX (PROCESS " + std::to_string(pid) + ")";
+    return false;
+#endif
+}
+
+void LiveAttach::attach(const Location &location) {
+    detach();
+    processId = location.pid;
+    std::copy(std::begin(location.addresses), std::end(location.addresses), addresses);
+}
+
+void LiveAttach::detach() {
+    processId = 0;
+    for (int file = 0; file < kBlockCount; ++file) {
+        addresses[file] = 0;
+        previous[file].clear();
+        scratch[file].clear();
+    }
+    copied = 0;
+}
+
+WatchedFiles LiveAttach::refresh(GameState &state, std::string &error) {
+    WatchedFiles changed;
+    copied = 0;
+    if (!isAttached()) {
+        return changed;
+    }
+#if defined(__linux__)
+    // One call for all three blocks, so they come from as close to one moment as the other process allows.
+    iovec local[kBlockCount];
+    iovec remote[kBlockCount];
+    unsigned long count = 0;
+    std::size_t expected = 0;
+    for (int file = 0; file < kBlockCount; ++file) {
+        if (addresses[file] == 0) {
+            continue;
+        }
+        scratch[file].resize(kBlockSizes[file]);
+        local[count] = {scratch[file].data(), kBlockSizes[file]};
+        remote[count] = {reinterpret_cast<void *>(addresses[file]), kBlockSizes[file]};
+        expected += kBlockSizes[file];
+        ++count;
+    }
+    if (::process_vm_readv(processId, local, count, remote, count, 0) != static_cast<ssize_t>(expected)) {
+        error = "LOST PROCESS " + std::to_string(processId);
+        detach();
+        return changed;
+    }
+
+    for (int file = 0; file < kBlockCount; ++file) {
+        if (addresses[file] == 0) {
+            continue;
+        }
+        const std::vector<uint8_t> &fresh = scratch[file];
+        std::vector<uint8_t> &seen = previous[file];
+        uint8_t *target = blockOf(state, file);
+        bool first = seen.empty();
+        if (first) {
+            seen.assign(fresh.size(), 0);
+        }
+        for (std::size_t offset = 0; offset < fresh.size(); offset += kChunkSize) {
+            std::size_t length = std::min(kChunkSize, fresh.size() - offset);
+            if (!first && std::memcmp(fresh.data() + offset, seen.data() + offset, length) == 0) {
+                continue;
+            }
+            std::memcpy(seen.data() + offset, fresh.data() + offset, length);
+            if (std::memcmp(target + offset, fresh.data() + offset, length) != 0) {
+                std::memcpy(target + offset, fresh.data() + offset, length);
+                copied += length;
+                changed.set(file);
+            }
+        }
+    }
+    if (changed.test(kWatchGameB)) {
+        state.squadsReplaced();
+    }
+#else
+    (void)state;
+    (void)error;
+#endif
+    return changed;
+}
+
+WatchedFiles LiveAttach::poll(GameState &state, std::string &error, Clock::time_point now) {
+    if (!isAttached() || now - lastRefresh < refreshInterval) {
+        return {};
+    }
+    lastRefresh = now;
+    return refresh(state, error);
+}
+
+} // namespace io
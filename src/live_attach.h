@@ -0,0 +1,76 @@
+// Read-only view of the gamea/gameb/gamec that PM3 holds in memory while it runs under DOSBox.
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "pm3_data.h"
+#include "save_watcher.h"
+
+namespace io {
+
+// Finds PM3's copies of the three blocks in another process and copies them out as the game changes them, so
+// PM3000 shows the game as it is played rather than as last saved. The other process is only ever read, never
+// written to or stopped. Linux only (process_vm_readv); find() fails elsewhere. Not thread-safe; poll it from
+// the UI loop.
+class LiveAttach {
+public:
+    using Clock = std::chrono::steady_clock;
+    static constexpr std::chrono::milliseconds kDefaultInterval{250};
+    // Blocks are compared and copied in chunks of this size.
+    static constexpr std::size_t kChunkSize = 4096;
+    static constexpr int kBlockCount = 3;
+
+    // Where the blocks are in process `pid`; an address is 0 for a block that was not found.
+    struct Location {
+        int pid = 0;
+        uint64_t addresses[kBlockCount]{};
+    };
+
+    LiveAttach() = default;
+    LiveAttach(const LiveAttach &) = delete;
+    LiveAttach &operator=(const LiveAttach &) = delete;
+
+    // Processes whose name contains "dosbox", oldest first.
+    static std::vector<int> findDosbox();
+
+    // Scans the writable memory of `pid` for the blocks. Club and player names and the league history in
+    // `reference` (the base data, or the slot last loaded) serve as signatures, so most of them must still match
+    // what the game has in memory. gamea is optional: without league history in `reference` only gameb and gamec
+    // are found. Touches no LiveAttach, so the scan, which reads all of DOSBox's memory, can run on the I/O worker.
+    static bool find(int pid, const GameState &reference, Location &location, std::string &error);
+    // Starts following the blocks at `location`, as found by find().
+    void attach(const Location &location);
+    void detach();
+
+    bool isAttached() const { return processId != 0; }
+    int pid() const { return processId; }
+    // Where block `file` (kWatchGameA, B or C) is in the other process; 0 if it was not found.
+    uint64_t address(int file) const { return addresses[file]; }
+
+    void setInterval(std::chrono::milliseconds interval) { refreshInterval = interval; }
+    std::chrono::milliseconds interval() const { return refreshInterval; }
+
+    // Reads the blocks and copies into `state` only the chunks that changed since the previous refresh, so edits
+    // to the rest of `state` are left alone. The first refresh after attach() copies everything. Detaches, with
+    // `error` set, once the process has gone. Returns the files that changed.
+    WatchedFiles refresh(GameState &state, std::string &error);
+    // refresh() at most once per interval.
+    WatchedFiles poll(GameState &state, std::string &error, Clock::time_point now = Clock::now());
+    // Bytes copied into the state by the last refresh.
+    std::size_t lastCopied() const { return copied; }
+
+private:
+    int processId = 0;
+    uint64_t addresses[kBlockCount]{};
+    std::vector<uint8_t> previous[kBlockCount];
+    std::vector<uint8_t> scratch[kBlockCount];
+    std::chrono::milliseconds refreshInterval = kDefaultInterval;
+    Clock::time_point lastRefresh{};
+    std::size_t copied = 0;
+};
+
+} // namespace io
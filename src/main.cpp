@@ -5,6 +5,8 @@
 #include <map>
 #include <filesystem>
 #include <bitset>
+#include <chrono>
+#include <algorithm>
 #include <random>
 #include <memory>
 #include <exception>
@@ -16,7 +18,14 @@
 #include "gfx.h"
 #include "input.h"
 #include "io.h"
+#include "io_worker.h"
+#include "installation.h"
+#include "live_attach.h"
+#include "save_watcher.h"
+#include "dirty_tracker.h"
+#include "edit_journal.h"
 #include "game_utils.h"
+#include "save_ledger.h"
 #include "settings.h"
 #include "swos_import.h"
 #include "nfd.h"
@@ -62,6 +71,9 @@ public:
 
     void run();
 
+    // Follows PM3 running in DOSBox process `pid` (the first DOSBox found when 0), refreshing every `interval`.
+    void enableLiveView(int pid, std::chrono::milliseconds interval);
+
 private:
     Graphics gfx;
     InputHandler input;
@@ -74,7 +86,7 @@ private:
 
     std::bitset<8> saveFiles{};
 
-    std::vector<club_player> freePlayers{};
+    std::vector<PlayerHandle> freePlayers{};
 
     Settings settings{};
 
@@ -96,6 +108,24 @@ private:
 
     char footer[70]{};
 
+    // Save/load jobs run here; completions come back to the event loop as ioEventType user events.
+    Uint32 ioEventType = 0;
+    std::unique_ptr<io::IoWorker> ioWorker;
+
+    // Picks up slot files rewritten by PM3 itself (e.g. running in DOSBox alongside).
+    io::SaveWatcher saveWatcher;
+
+    // With --live, reads the game state straight out of DOSBox between saves. The view is read-only: it only
+    // attaches while there are no unsaved edits, and edits, undo and saves are refused while it is attached.
+    bool liveView = false;
+    int livePid = 0;
+    io::LiveAttach liveAttach;
+    // The slot the view was matched against, and whether the search for it is on the I/O worker.
+    int liveGame = 0;
+    bool liveSearching = false;
+    bool liveHeldShown = false;
+    std::chrono::steady_clock::time_point nextLiveAttach{};
+
     void initializeSDL();
     void initializeScreens();
 
@@ -105,8 +135,16 @@ private:
 
     void toggleWindowed();
 
+    void pollSaveWatcher();
+    void pollLiveView();
+    void refreshCurrentScreen();
+
     void importSwosTeams();
 
+    void recordEdit();
+    void undoEdit();
+    void redoEdit();
+
     [[noreturn]] static void exitError(const std::string &errorMessage);
 
 };
@@ -114,6 +152,9 @@ private:
 bool windowed = true;
 
 Application::~Application() {
+    if (ioWorker) {
+        ioWorker->drain();
+    }
     gfx.cleanup();
 }
 
@@ -125,8 +166,16 @@ void Application::initializeSDL() {
     }
     SDL_SetRelativeMouseMode(SDL_TRUE);
 
+    ioEventType = SDL_RegisterEvents(1);
+    ioWorker = std::make_unique<io::IoWorker>([this] {
+        SDL_Event wake{};
+        wake.type = ioEventType;
+        SDL_PushEvent(&wake);
+    });
+
     io::loadPrefs(settings);
-    settings.gameType = io::getPm3GameType(settings.gamePath);
+    settings.gameType = io::installationFor(settings.gamePath)->gameType();
+    io::recoverInterruptedSave(settings.gamePath);
 
 #if defined linux && SDL_VERSION_ATLEAST(2, 0, 8)
     // Disable compositor bypass
@@ -180,6 +229,18 @@ void Application::initializeScreens() {
             exitError(ex.what());
         }
     };
+    screenContext.writeTextAt = [this](const char *text, int x, int y, SDL_Color color, int textType,
+                                       const std::function<void(void)> &cb) {
+        if (!textRenderer) {
+            return;
+        }
+        try {
+            text_utils::renderText(*textRenderer, text, color, x, y, SCREEN_WIDTH, TEXT_JUSTIFICATION_LEFT, textType,
+                                   cb, true);
+        } catch (const std::exception &ex) {
+            exitError(ex.what());
+        }
+    };
     screenContext.defaultTextColor = [this](int line) {
         if (!textRenderer) {
             return Colors::TEXT_1;
@@ -191,6 +252,7 @@ void Application::initializeScreens() {
     screenContext.setPagination = [this](int page, int total) { currentPage = page; totalPages = total; };
     screenContext.gamePath = [this]() -> const std::filesystem::path & { return settings.gamePath; };
     screenContext.gameType = [this]() { return settings.gameType; };
+    screenContext.game = []() -> GameState & { return defaultGameState; };
     screenContext.choosePm3Folder = [this]() {
         try {
             io::choosePm3Folder(settings, saveFiles);
@@ -201,18 +263,27 @@ void Application::initializeScreens() {
     screenContext.importSwosTeams = [this]() {
         importSwosTeams();
     };
-    screenContext.levelAggression = [this]() { levelAggression(); };
+    screenContext.levelAggression = []() { levelAggression(defaultGameState); };
     screenContext.setFooter = [this](const char *text) { strncpy(footer, text, sizeof(footer) - 1); footer[sizeof(footer)-1] = '\0'; };
     screenContext.ensureMetadataLoaded = [this](bool attach) {
         return io::ensureMetadataLoaded(settings, currentGame, saveFiles, footer, sizeof(footer), attach);
     };
     screenContext.formatSaveGameLabel = [](int i, char *label, size_t size) { io::formatSaveGameLabel(i, label, size); };
+    screenContext.formatSlotSummary = [](int i, char *label, size_t size) {
+        return io::formatSlotSummary(i, label, size);
+    };
     screenContext.saveFiles = [this]() -> const std::bitset<8> & { return saveFiles; };
     screenContext.loadGameConfirm = [this](int gameNumber) {
-        io::loadGameConfirm(input, settings, gameNumber, currentGame, footer, sizeof(footer));
+        io::loadGameConfirm(input, *ioWorker, settings, gameNumber, currentGame, saveFiles, footer,
+                            sizeof(footer));
     };
     screenContext.saveGameConfirm = [this](int gameNumber) {
-        io::saveGameConfirm(input, settings, gameNumber, footer, sizeof(footer));
+        if (liveAttach.isAttached()) {
+            snprintf(footer, sizeof(footer), "LIVE VIEW IS READ-ONLY - SAVE IN PM3 INSTEAD");
+            return;
+        }
+        io::saveGameConfirm(input, *ioWorker, settings, gameNumber, currentGame, saveFiles, footer,
+                            sizeof(footer));
     };
     screenContext.writeHeader = [this](const char *text, int /*line*/, const std::function<void(void)> &cb) {
         if (textRenderer) {
@@ -224,14 +295,14 @@ void Application::initializeScreens() {
             text_utils::writeSubHeader(*textRenderer, text, cb);
         }
     };
-    screenContext.freePlayersRef = [this]() -> std::vector<club_player> & { return freePlayers; };
-    screenContext.refreshFreePlayers = [this]() { freePlayers = findFreePlayers(); };
-    screenContext.writePlayers = [this](std::vector<club_player> &players, int &line,
-                                        const std::function<void(const club_player &)> &cb) {
+    screenContext.freePlayersRef = [this]() -> std::vector<PlayerHandle> & { return freePlayers; };
+    screenContext.refreshFreePlayers = [this]() { freePlayers = findFreePlayers(defaultGameState); };
+    screenContext.writePlayers = [this](const std::vector<PlayerHandle> &players, int &line,
+                                        const std::function<void(const PlayerHandle &)> &cb) {
         if (!textRenderer) {
             return line;
         }
-        return text_utils::writePlayers(*textRenderer, players, line, cb);
+        return text_utils::writePlayers(*textRenderer, defaultGameState, players, line, cb);
     };
     screenContext.setFooterLine = [this](const char *text) { snprintf(footer, sizeof(footer), "%s", text); };
     screenContext.selectedDivision = [this]() { return selectedDivision; };
@@ -248,8 +319,8 @@ void Application::initializeScreens() {
     };
     screenContext.endReadingTextInput = [this]() { input.endReadingTextInput(); };
     screenContext.currentTextInput = [this]() -> const char * { return input.getTextInput(); };
-    screenContext.makeOffer = [this](const club_player &playerInfo) {
-        game_utils::beginOffer(input, footer, sizeof(footer), playerInfo, currentGame);
+    screenContext.makeOffer = [this](const PlayerHandle &handle) {
+        game_utils::beginOffer(defaultGameState, input, footer, sizeof(footer), handle, currentGame);
     };
     screenContext.writeDivisionsMenu = [this](const char *heading, bool attach) {
         ui::writeDivisionsMenu(screenContext, selectedDivision, selectedClub, heading, attach);
@@ -258,7 +329,7 @@ void Application::initializeScreens() {
         ui::writeClubMenu(screenContext, selectedClub, selectedDivision, heading, attach);
     };
     screenContext.convertPlayerToCoach = [this](struct gamea::ManagerRecord &manager, ClubRecord &club, int8_t idx) {
-        game_utils::convertPlayerToCoach(manager, club, idx, footer, sizeof(footer));
+        game_utils::convertPlayerToCoach(defaultGameState, manager, club, idx, footer, sizeof(footer));
     };
     screenContext.writePlayer = [this](const char *text, char position, int line, const std::function<void(void)> &cb) {
         if (textRenderer) {
@@ -345,6 +416,15 @@ void Application::run() {
         while (SDL_PollEvent(&event)) {
             if (event.type == SDL_QUIT || this->quit) {
                 quit = true;
+            } else if (event.type == ioEventType) {
+                ioWorker->pump();
+                std::string failure = ioWorker->takeError();
+                std::string progress = ioWorker->progress();
+                if (!failure.empty()) {
+                    snprintf(footer, sizeof(footer), "%.69s", failure.c_str());
+                } else if (!progress.empty()) {
+                    snprintf(footer, sizeof(footer), "%s", progress.c_str());
+                }
             } else if (input.handleTextInputEvent(event)) {
                 // handled in input module
             } else if (event.type == SDL_MOUSEBUTTONDOWN) {
@@ -353,9 +433,21 @@ void Application::run() {
                 } else {
                     gfx.setRightClickCursor();
                 }
+                edit_journal::begin();
                 input.checkClickableArea(event.button.x, event.button.y);
+                recordEdit();
             } else if (event.type == SDL_MOUSEBUTTONUP) {
                 gfx.setStandardCursor();
+            } else if (event.type == SDL_KEYDOWN && (event.key.keysym.mod & KMOD_CTRL) &&
+                       (event.key.keysym.sym == SDLK_z || event.key.keysym.sym == SDLK_y)) {
+                // Ctrl+Z / Ctrl+Y, so plain letters still reach text entry and the screens' key callbacks.
+                if (input.isReadingTextInput()) {
+                    // Not while a number is being typed.
+                } else if (event.key.keysym.sym == SDLK_z) {
+                    undoEdit();
+                } else {
+                    redoEdit();
+                }
             } else if (event.type == SDL_KEYDOWN) {
                 switch (event.key.keysym.sym) {
                     case SDLK_f:
@@ -365,7 +457,9 @@ void Application::run() {
                         quit = true;
                         break;
                     default:
+                        edit_journal::begin();
                         input.checkKeyPressCallback(event.key.keysym.sym);
+                        recordEdit();
                 }
             }
 
@@ -379,6 +473,8 @@ void Application::run() {
             SDL_RenderCopyEx(renderer, texTarget, nullptr, nullptr, 0, nullptr, SDL_FLIP_NONE);
             SDL_RenderPresent(renderer);
         }
+        pollSaveWatcher();
+        pollLiveView();
         SDL_Delay(16);
     }
 }
@@ -410,6 +506,197 @@ void Application::changeScreen(screen newScreen) {
     totalPages = 0;
 }
 
+// Which watched files each screen reads; a reload only redraws the screen if it depends on what changed.
+static io::WatchedFiles screenDependencies(screen s) {
+    io::WatchedFiles files;
+    switch (s) {
+        case LOAD_GAME_SCREEN:
+        case SAVE_GAME_SCREEN:
+            files.set(io::kWatchSavesDir);
+            break;
+        case MY_TEAM_SCREEN:
+        case SCOUT_SCREEN:
+        case TELEPHONE_SCREEN:
+        case CONVERT_COACH_SCREEN:
+            files.set(io::kWatchGameA).set(io::kWatchGameB).set(io::kWatchGameC);
+            break;
+        case FREE_PLAYERS_SCREEN:
+        case CHANGE_TEAM_SCREEN:
+            files.set(io::kWatchGameB).set(io::kWatchGameC);
+            break;
+        default:
+            break;
+    }
+    return files;
+}
+
+void Application::refreshCurrentScreen() {
+    input.resetTransientClickableAreas();
+    if (textRenderer) {
+        text_utils::resetTextBlocks(*textRenderer);
+    }
+    clickableAreasConfigured = false;
+}
+
+void Application::pollSaveWatcher() {
+    if (settings.gamePath.empty()) {
+        return;
+    }
+    if (saveWatcher.gamePath() != settings.gamePath || saveWatcher.gameNumber() != currentGame) {
+        saveWatcher.watch(settings.gamePath, currentGame);
+    }
+    // Leave the slot alone while our own load/save of it is in flight; the events stay queued.
+    if (ioWorker->isBusy(currentGame)) {
+        return;
+    }
+
+    io::WatchedFiles changed = saveWatcher.poll();
+    if (changed.none()) {
+        return;
+    }
+
+    io::WatchedFiles reloaded;
+    bool held = false;
+    std::string error;
+    for (int file = io::kWatchGameA; file <= io::kWatchGameC; ++file) {
+        if (!changed.test(file)) {
+            continue;
+        }
+        io::Reload result = io::reloadSaveFile(settings.gamePath, currentGame, static_cast<char>('A' + file),
+                                               defaultGameState, error);
+        reloaded.set(file, result == io::Reload::Reloaded);
+        held = held || result == io::Reload::HeldForEdits;
+    }
+    if (changed.test(io::kWatchSavesDir) && io::reloadSavesDir(settings.gamePath, error)) {
+        reloaded.set(io::kWatchSavesDir);
+        io::memoizeSaveFiles(settings, saveFiles);
+    }
+
+    if (!error.empty()) {
+        snprintf(footer, sizeof(footer), "%.69s", error.c_str());
+    } else if (held) {
+        // Keeping the edits is the default; the next save then rewrites the files in full.
+        snprintf(footer, sizeof(footer), "GAME %d CHANGED ON DISK - RELOAD AND LOSE EDITS? (Y/N)", currentGame);
+        auto reloadCallback = [this]() {
+            io::loadGameAsync(*ioWorker, settings, currentGame, currentGame, footer, sizeof(footer));
+            input.resetKeyPressCallbacks();
+        };
+        auto keepCallback = [this]() {
+            footer[0] = '\0';
+            input.resetKeyPressCallbacks();
+        };
+        input.resetKeyPressCallbacks();
+        input.addKeyPressCallback('y', reloadCallback);
+        input.addKeyPressCallback('Y', reloadCallback);
+        input.addKeyPressCallback('n', keepCallback);
+        input.addKeyPressCallback('N', keepCallback);
+    } else if (reloaded.any()) {
+        snprintf(footer, sizeof(footer), "GAME %d CHANGED ON DISK - RELOADED", currentGame);
+    } else {
+        return;
+    }
+    if ((screenDependencies(currentScreen) & reloaded).any()) {
+        refreshCurrentScreen();
+    }
+
+    // Wake the event loop so the new state is drawn.
+    SDL_Event wake{};
+    wake.type = ioEventType;
+    SDL_PushEvent(&wake);
+}
+
+void Application::enableLiveView(int pid, std::chrono::milliseconds interval) {
+    liveView = true;
+    livePid = pid;
+    liveAttach.setInterval(interval);
+}
+
+static bool hasUnsavedEdits() {
+    return dirty_tracker::isDirty(dirty_tracker::kGameA) || dirty_tracker::isDirty(dirty_tracker::kGameB) ||
+           dirty_tracker::isDirty(dirty_tracker::kGameC);
+}
+
+void Application::pollLiveView() {
+    // The loaded slot's club and player names are what the game's memory is searched for.
+    if (!liveView || currentGame == 0 || liveSearching) {
+        return;
+    }
+    // A load of the slot replaces what the view copied in, so the view starts over once it has landed. So does
+    // loading another slot.
+    if (liveAttach.isAttached() && (ioWorker->isBusy(currentGame) || liveGame != currentGame)) {
+        liveAttach.detach();
+    }
+    if (ioWorker->isBusy(currentGame)) {
+        return;
+    }
+    std::string error;
+    if (!liveAttach.isAttached()) {
+        constexpr std::chrono::seconds kRetryInterval{5};
+        auto now = std::chrono::steady_clock::now();
+        if (now < nextLiveAttach) {
+            return;
+        }
+        nextLiveAttach = now + kRetryInterval;
+        std::vector<int> candidates = livePid != 0 ? std::vector<int>{livePid} : io::LiveAttach::findDosbox();
+        if (candidates.empty()) {
+            return;
+        }
+        // The game's memory replaces the editor's, so unsaved edits are never attached over.
+        if (hasUnsavedEdits()) {
+            if (!liveHeldShown) {
+                snprintf(footer, sizeof(footer), "SAVE GAME %d TO START THE LIVE VIEW", currentGame);
+                liveHeldShown = true;
+            }
+            return;
+        }
+        liveHeldShown = false;
+
+        // The search reads all of DOSBox's memory, so it runs on the I/O worker against a copy of the slot, which
+        // stays busy until the search is done.
+        int pid = candidates.front();
+        int game = currentGame;
+        auto reference = std::make_shared<const GameState>(defaultGameState);
+        liveSearching = ioWorker->submit(game, [this, pid, game, reference](
+                const io::IoWorker::Report &progress) -> io::IoWorker::Completion {
+            progress("SEARCHING DOSBOX PROCESS " + std::to_string(pid));
+            auto location = std::make_shared<io::LiveAttach::Location>();
+            auto searchError = std::make_shared<std::string>();
+            bool found = io::LiveAttach::find(pid, *reference, *location, *searchError);
+            return [this, found, location, searchError, game]() {
+                liveSearching = false;
+                if (!found) {
+                    snprintf(footer, sizeof(footer), "%.69s", searchError->c_str());
+                    return;
+                }
+                // Edited or reloaded during the search; the next attempt starts over.
+                if (game != currentGame || hasUnsavedEdits()) {
+                    return;
+                }
+                liveAttach.attach(*location);
+                liveGame = game;
+                // From here memory follows the game rather than the files.
+                io::forgetSaveBaseline();
+                snprintf(footer, sizeof(footer), "LIVE VIEW OF DOSBOX PROCESS %d", location->pid);
+            };
+        });
+        return;
+    }
+
+    io::WatchedFiles changed = liveAttach.poll(defaultGameState, error);
+    if (!error.empty()) {
+        snprintf(footer, sizeof(footer), "%.69s", error.c_str());
+    }
+    if (changed.none()) {
+        return;
+    }
+    if ((screenDependencies(currentScreen) & changed).any()) {
+        refreshCurrentScreen();
+    }
+    SDL_Event wake{};
+    wake.type = ioEventType;
+    SDL_PushEvent(&wake);
+}
+
 void Application::drawCurrentScreen() {
     try {
         gfx.drawBackground(SCREEN_IMAGE_PATH, SCREEN_WIDTH, SCREEN_HEIGHT);
@@ -459,6 +746,10 @@ void Application::importSwosTeams() {
         io::loadDefaultGamedata(settings.gamePath, gameData);
         io::loadDefaultClubdata(settings.gamePath, clubData);
         io::loadDefaultPlaydata(settings.gamePath, playerData);
+        defaultGameState.squadsReplaced();
+        dirty_tracker::markAllDirty();
+        edit_journal::restart({}, 0);
+        save_ledger::open({}, 0, defaultGameState, false);
     } catch (const std::exception &ex) {
         snprintf(footer, sizeof(footer), "Load failed: %.64s", ex.what());
         return;
@@ -476,7 +767,7 @@ void Application::importSwosTeams() {
         NFD_FreePath(teamPathRaw);
         try {
             std::string pm3PathUtf8 = settings.gamePath.u8string();
-            auto report = swos_import::importTeamsFromFile(teamPath.u8string(), pm3PathUtf8);
+            auto report = swos_import::importTeamsFromFile(defaultGameState, teamPath.u8string(), pm3PathUtf8);
             io::saveDefaultGamedata(settings.gamePath, gameData);
             io::saveDefaultClubdata(settings.gamePath, clubData);
             io::saveDefaultPlaydata(settings.gamePath, playerData);
@@ -499,6 +790,85 @@ void Application::importSwosTeams() {
     snprintf(footer, sizeof(footer), "%s", message.c_str());
 }
 
+// What the undo history calls a step: the screen it was made on.
+static const char *screenLabel(screen s) {
+    switch (s) {
+        case FREE_PLAYERS_SCREEN:
+            return "FREE PLAYERS";
+        case MY_TEAM_SCREEN:
+            return "MY TEAM";
+        case SCOUT_SCREEN:
+            return "SCOUT";
+        case CHANGE_TEAM_SCREEN:
+            return "CHANGE TEAM";
+        case TELEPHONE_SCREEN:
+            return "TELEPHONE";
+        case CONVERT_COACH_SCREEN:
+            return "CONVERT COACH";
+        default:
+            return "EDIT";
+    }
+}
+
+void Application::recordEdit() {
+    if (liveAttach.isAttached()) {
+        // Whatever the action changed is put back. Nothing was dirty when the view attached and the next save
+        // rewrites the files in full, so the spans it left go too.
+        if (edit_journal::rollback()) {
+            snprintf(footer, sizeof(footer), "LIVE VIEW IS READ-ONLY");
+            refreshCurrentScreen();
+        }
+        dirty_tracker::clear();
+        return;
+    }
+    edit_journal::commit(screenLabel(currentScreen));
+}
+
+void Application::undoEdit() {
+    if (currentGame == 0) {
+        return;
+    }
+    if (liveAttach.isAttached()) {
+        snprintf(footer, sizeof(footer), "LIVE VIEW IS READ-ONLY");
+        return;
+    }
+    if (!edit_journal::canUndo()) {
+        snprintf(footer, sizeof(footer), "NOTHING TO UNDO");
+        return;
+    }
+    std::string label = edit_journal::undoLabel();
+    if (!edit_journal::undo()) {
+        snprintf(footer, sizeof(footer), "CAN'T UNDO %.28s: GAME CHANGED ON DISK", label.c_str());
+        return;
+    }
+    // The ledger follows the save: a loan the undo took back is closed.
+    save_ledger::reconcile(defaultGameState);
+    snprintf(footer, sizeof(footer), "UNDONE: %.40s CHANGE", label.c_str());
+    refreshCurrentScreen();
+}
+
+void Application::redoEdit() {
+    if (currentGame == 0) {
+        return;
+    }
+    if (liveAttach.isAttached()) {
+        snprintf(footer, sizeof(footer), "LIVE VIEW IS READ-ONLY");
+        return;
+    }
+    if (!edit_journal::canRedo()) {
+        snprintf(footer, sizeof(footer), "NOTHING TO REDO");
+        return;
+    }
+    std::string label = edit_journal::redoLabel();
+    if (!edit_journal::redo()) {
+        snprintf(footer, sizeof(footer), "CAN'T REDO %.28s: GAME CHANGED ON DISK", label.c_str());
+        return;
+    }
+    save_ledger::reconcile(defaultGameState);
+    snprintf(footer, sizeof(footer), "REDONE: %.40s CHANGE", label.c_str());
+    refreshCurrentScreen();
+}
+
 void Application::toggleWindowed() {
     windowed = !windowed;
     SDL_Window *window = gfx.getWindow();
@@ -508,8 +878,26 @@ void Application::toggleWindowed() {
     }
 }
 
-int main() {
+int main(int argc, char **argv) {
     Application app;
+    // --live[=<pid>] follows PM3 running in DOSBox; --live-interval=<ms> sets how often it is read.
+    bool live = false;
+    int pid = 0;
+    std::chrono::milliseconds interval = io::LiveAttach::kDefaultInterval;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--live") {
+            live = true;
+        } else if (arg.rfind("--live=", 0) == 0) {
+            live = true;
+            pid = std::atoi(arg.c_str() + 7);
+        } else if (arg.rfind("--live-interval=", 0) == 0) {
+            interval = std::chrono::milliseconds(std::max(16, std::atoi(arg.c_str() + 16)));
+        }
+    }
+    if (live) {
+        app.enableLiveView(pid, interval);
+    }
     app.run();
     return 0;
 }
@@ -0,0 +1,271 @@
+// Memory-mapped, copy-on-write views over the GAMEnA/B/C save files.
+#include "mapped_save.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "io.h"
+
+namespace io {
+
+namespace {
+constexpr std::size_t kSaveFileSizes[3] = {sizeof(gamea), sizeof(gameb), sizeof(gamec)};
+
+#if !defined(_WIN32)
+bool readSpan(int fd, uint8_t *dest, std::size_t len, std::size_t offset) {
+    while (len > 0) {
+        ssize_t got = ::pread(fd, dest, len, static_cast<off_t>(offset));
+        if (got <= 0) {
+            return false;
+        }
+        dest += got;
+        offset += static_cast<std::size_t>(got);
+        len -= static_cast<std::size_t>(got);
+    }
+    return true;
+}
+
+bool writeSpan(int fd, const uint8_t *src, std::size_t len, std::size_t offset) {
+    while (len > 0) {
+        ssize_t put = ::pwrite(fd, src, len, static_cast<off_t>(offset));
+        if (put <= 0) {
+            return false;
+        }
+        src += put;
+        offset += static_cast<std::size_t>(put);
+        len -= static_cast<std::size_t>(put);
+    }
+    return true;
+}
+#endif
+} // namespace
+
+std::size_t mappedPageSize() {
+#if defined(_WIN32)
+    return 4096;
+#else
+    static const std::size_t pageSize = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    return pageSize;
+#endif
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+    if (this != &other) {
+        close();
+        view = std::exchange(other.view, nullptr);
+        length = std::exchange(other.length, 0);
+        writable = std::exchange(other.writable, false);
+        filePath = std::move(other.filePath);
+#if defined(_WIN32)
+        buffer = std::move(other.buffer);
+        original = std::move(other.original);
+#endif
+    }
+    return *this;
+}
+
+bool MappedFile::open(const std::filesystem::path &path, std::size_t expectedSize, bool writableView) {
+    close();
+
+    std::error_code ec;
+    auto actualSize = std::filesystem::file_size(path, ec);
+    if (ec) {
+        setPm3LastError("Missing file: " + path.string());
+        return false;
+    }
+    if (actualSize != expectedSize) {
+        setPm3LastError("Invalid file size: " + path.string());
+        return false;
+    }
+
+#if defined(_WIN32)
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        setPm3LastError("Missing file: " + path.string());
+        return false;
+    }
+    buffer.resize(expectedSize);
+    file.read(reinterpret_cast<char *>(buffer.data()), static_cast<std::streamsize>(expectedSize));
+    if (!file) {
+        setPm3LastError("Could not read file: " + path.string());
+        return false;
+    }
+    if (writableView) {
+        original = buffer;
+    }
+    view = buffer.data();
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        setPm3LastError("Missing file: " + path.string());
+        return false;
+    }
+    int prot = writableView ? (PROT_READ | PROT_WRITE) : PROT_READ;
+    void *mapped = ::mmap(nullptr, expectedSize, prot, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        setPm3LastError("Could not map file: " + path.string());
+        return false;
+    }
+    view = static_cast<uint8_t *>(mapped);
+#endif
+
+    length = expectedSize;
+    writable = writableView;
+    filePath = path;
+    return true;
+}
+
+void MappedFile::close() {
+    if (view == nullptr) {
+        return;
+    }
+#if defined(_WIN32)
+    buffer.clear();
+    original.clear();
+#else
+    ::munmap(view, length);
+#endif
+    view = nullptr;
+    length = 0;
+    writable = false;
+    filePath.clear();
+}
+
+std::vector<std::size_t> MappedFile::touchedPages() const {
+    const std::size_t pageSize = mappedPageSize();
+    const std::size_t pageCount = (length + pageSize - 1) / pageSize;
+    std::vector<std::size_t> pages;
+
+#if defined(__linux__)
+    // A private mapping keeps pointing at the page cache until a page is written; the kernel then swaps in an
+    // anonymous copy. pagemap exposes that as "present but not file-backed", which lets us skip clean pages
+    // without reading them. A copy the kernel has since pushed out to swap is no longer present, but it is
+    // still ours and still dirty, so swapped entries count as touched too.
+    int fd = ::open("/proc/self/pagemap", O_RDONLY);
+    if (fd >= 0) {
+        std::vector<uint64_t> entries(pageCount);
+        std::size_t firstEntry = reinterpret_cast<uintptr_t>(view) / pageSize;
+        bool ok = readSpan(fd, reinterpret_cast<uint8_t *>(entries.data()), entries.size() * sizeof(uint64_t),
+                           firstEntry * sizeof(uint64_t));
+        ::close(fd);
+        if (ok) {
+            constexpr uint64_t kPresent = 1ULL << 63;
+            constexpr uint64_t kSwapped = 1ULL << 62;
+            constexpr uint64_t kFileOrShared = 1ULL << 61;
+            for (std::size_t page = 0; page < pageCount; ++page) {
+                bool anonymous = (entries[page] & kPresent) && !(entries[page] & kFileOrShared);
+                if (anonymous || (entries[page] & kSwapped)) {
+                    pages.push_back(page);
+                }
+            }
+            return pages;
+        }
+    }
+#endif
+
+    for (std::size_t page = 0; page < pageCount; ++page) {
+        pages.push_back(page);
+    }
+    return pages;
+}
+
+std::size_t MappedFile::commit() {
+    if (!view || !writable) {
+        return 0;
+    }
+
+    const std::size_t pageSize = mappedPageSize();
+    std::size_t written = 0;
+
+#if defined(_WIN32)
+    std::fstream file(filePath, std::ios::binary | std::ios::in | std::ios::out);
+    if (!file) {
+        throw std::runtime_error("Could not open file for writing: " + filePath.string());
+    }
+    for (std::size_t offset = 0; offset < length; offset += pageSize) {
+        std::size_t len = std::min(pageSize, length - offset);
+        if (std::memcmp(view + offset, original.data() + offset, len) == 0) {
+            continue;
+        }
+        file.seekp(static_cast<std::streamoff>(offset));
+        file.write(reinterpret_cast<const char *>(view + offset), static_cast<std::streamsize>(len));
+        std::memcpy(original.data() + offset, view + offset, len);
+        written += len;
+    }
+#else
+    int fd = ::open(filePath.c_str(), O_RDWR);
+    if (fd < 0) {
+        throw std::runtime_error("Could not open file for writing: " + filePath.string());
+    }
+    std::vector<uint8_t> onDisk(pageSize);
+    for (std::size_t page : touchedPages()) {
+        std::size_t offset = page * pageSize;
+        std::size_t len = std::min(pageSize, length - offset);
+        if (readSpan(fd, onDisk.data(), len, offset) && std::memcmp(onDisk.data(), view + offset, len) == 0) {
+            continue;
+        }
+        if (!writeSpan(fd, view + offset, len, offset)) {
+            ::close(fd);
+            throw std::runtime_error("Could not write file: " + filePath.string());
+        }
+        written += len;
+    }
+    ::close(fd);
+#endif
+
+    return written;
+}
+
+bool MappedGame::open(const std::filesystem::path &gamePath, int gameNumber, bool writable) {
+    close();
+    for (int i = 0; i < 3; ++i) {
+        std::filesystem::path path = constructSaveFilePath(gamePath, gameNumber, static_cast<char>('A' + i));
+        if (!files[i].open(path, kSaveFileSizes[i], writable)) {
+            close();
+            return false;
+        }
+    }
+    slot = gameNumber;
+    return true;
+}
+
+void MappedGame::close() {
+    for (auto &file : files) {
+        file.close();
+    }
+    slot = 0;
+}
+
+bool MappedGame::isOpen() const {
+    return files[0].isOpen() && files[1].isOpen() && files[2].isOpen();
+}
+
+std::size_t MappedGame::commit() {
+    std::size_t written = 0;
+    for (auto &file : files) {
+        written += file.commit();
+    }
+    return written;
+}
+
+} // namespace io
@@ -0,0 +1,76 @@
+// Memory-mapped, copy-on-write views over the GAMEnA/B/C save files.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include "pm3_defs.hh"
+
+namespace io {
+
+// A single file mapped into memory. Read-only views share the page cache; writable views are private
+// copy-on-write mappings, so edits stay in memory until commit() writes the touched pages back.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+
+    bool open(const std::filesystem::path &path, std::size_t expectedSize, bool writable);
+    void close();
+
+    bool isOpen() const { return view != nullptr; }
+    bool isWritable() const { return writable; }
+    std::size_t size() const { return length; }
+    uint8_t *data() { return view; }
+    const uint8_t *data() const { return view; }
+    const std::filesystem::path &path() const { return filePath; }
+
+    // Writes back only the pages that were modified through the view. Returns the number of bytes written.
+    std::size_t commit();
+
+private:
+    std::vector<std::size_t> touchedPages() const;
+
+    uint8_t *view = nullptr;
+    std::size_t length = 0;
+    bool writable = false;
+    std::filesystem::path filePath;
+#if defined(_WIN32)
+    std::vector<uint8_t> buffer;
+    std::vector<uint8_t> original;
+#endif
+};
+
+// The three files of one save slot mapped as typed views.
+class MappedGame {
+public:
+    bool open(const std::filesystem::path &gamePath, int gameNumber, bool writable = false);
+    void close();
+
+    bool isOpen() const;
+    int gameNumber() const { return slot; }
+
+    gamea &gameA() { return *reinterpret_cast<gamea *>(files[0].data()); }
+    gameb &gameB() { return *reinterpret_cast<gameb *>(files[1].data()); }
+    gamec &gameC() { return *reinterpret_cast<gamec *>(files[2].data()); }
+    const gamea &gameA() const { return *reinterpret_cast<const gamea *>(files[0].data()); }
+    const gameb &gameB() const { return *reinterpret_cast<const gameb *>(files[1].data()); }
+    const gamec &gameC() const { return *reinterpret_cast<const gamec *>(files[2].data()); }
+
+    std::size_t commit();
+
+private:
+    MappedFile files[3];
+    int slot = 0;
+};
+
+std::size_t mappedPageSize();
+
+} // namespace io
@@ -0,0 +1,234 @@
+// Byte-order codec for the save structs, driven by a table of their multi-byte fields.
+#include "pm3_codec.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+#include "pm3_schema.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define PM3_CODEC_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#define PM3_CODEC_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace pm3_codec {
+
+namespace {
+
+// Adds one run, keeping the table canonical: a group that fills its stride is a single contiguous run.
+void add(std::vector<SwapRun> &runs, std::size_t offset, uint8_t width, std::size_t count, std::size_t repeat = 1,
+         std::size_t stride = 0) {
+    SwapRun run{static_cast<uint32_t>(offset), width, static_cast<uint32_t>(count), static_cast<uint32_t>(repeat),
+                static_cast<uint32_t>(stride)};
+    if (run.repeat == 1 || run.stride == run.count * width) {
+        run.count *= run.repeat;
+        run.repeat = 1;
+        run.stride = run.count * width;
+    }
+    runs.push_back(run);
+}
+
+// Sorts by offset and folds each run into an earlier one it continues, so e.g. turn, year and data10x become one
+// run of 17 words, PlayerRecord's wage and ins_cost one strided run of two, and the three back-to-back cup result
+// tables share one strided run.
+std::vector<SwapRun> finish(std::vector<SwapRun> runs) {
+    std::sort(runs.begin(), runs.end(), [](const SwapRun &a, const SwapRun &b) { return a.offset < b.offset; });
+    std::vector<SwapRun> merged;
+    for (const SwapRun &run : runs) {
+        bool widens = false;
+        auto continued = std::find_if(merged.begin(), merged.end(), [&](const SwapRun &prev) {
+            if (prev.width != run.width) {
+                return false;
+            }
+            bool adjacent = prev.offset + prev.count * prev.width == run.offset;
+            if (prev.repeat == 1 && run.repeat == 1) {
+                return widens = adjacent;
+            }
+            if (prev.repeat == run.repeat && prev.stride == run.stride && adjacent) {
+                return widens = true;
+            }
+            return prev.repeat > 1 && run.repeat > 1 && prev.count == run.count && prev.stride == run.stride &&
+                   prev.offset + prev.repeat * prev.stride == run.offset;
+        });
+        if (continued == merged.end()) {
+            merged.push_back(run);
+        } else if (widens) {
+            continued->count += run.count;
+            if (continued->repeat == 1 || continued->stride == continued->count * continued->width) {
+                continued->count *= continued->repeat;
+                continued->repeat = 1;
+                continued->stride = continued->count * continued->width;
+            }
+        } else {
+            continued->repeat += run.repeat;
+        }
+    }
+    return merged;
+}
+
+// Emits a run for every multi-byte field under `record`, which sits at `base` and repeats `repeat` times every
+// `stride` bytes. Only the innermost repetition becomes a strided run; outer ones are unrolled.
+void addFields(std::vector<SwapRun> &runs, const pm3_schema::Record &record, std::size_t base, std::size_t repeat,
+               std::size_t stride) {
+    for (const pm3_schema::Field &field : record) {
+        switch (field.kind) {
+        case pm3_schema::Kind::Integer:
+            if (field.width > 1) {
+                add(runs, base + field.offset, static_cast<uint8_t>(field.width), field.count, repeat, stride);
+            }
+            break;
+        case pm3_schema::Kind::Bits:
+            // Bitfields sharing a unit are swapped once, as the whole word.
+            if (field.width > 1 && field.shift == 0) {
+                add(runs, base + field.offset, static_cast<uint8_t>(field.width), 1, repeat, stride);
+            }
+            break;
+        case pm3_schema::Kind::Record:
+            if (repeat == 1) {
+                addFields(runs, *field.record, base + field.offset, field.count, field.width);
+            } else {
+                for (std::size_t r = 0; r < repeat; ++r) {
+                    addFields(runs, *field.record, base + r * stride + field.offset, field.count, field.width);
+                }
+            }
+            break;
+        case pm3_schema::Kind::Text:
+        case pm3_schema::Kind::Bytes:
+            break;
+        }
+    }
+}
+
+std::vector<SwapRun> runsFor(const pm3_schema::Record &record) {
+    std::vector<SwapRun> runs;
+    addFields(runs, record, 0, 1, record.size);
+    // A group that fills its stride only becomes contiguous once all its fields are in, so merge until stable.
+    std::size_t before;
+    do {
+        before = runs.size();
+        runs = finish(std::move(runs));
+    } while (runs.size() < before);
+    return runs;
+}
+
+uint16_t load16(const uint8_t *p) {
+    uint16_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint32_t load32(const uint8_t *p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+void store16(uint8_t *p, uint16_t value) {
+    std::memcpy(p, &value, sizeof(value));
+}
+
+void store32(uint8_t *p, uint32_t value) {
+    std::memcpy(p, &value, sizeof(value));
+}
+
+} // namespace
+
+template <>
+const std::vector<SwapRun> &schema<gamea>() {
+    static const std::vector<SwapRun> kRuns = runsFor(pm3_schema::kGameA);
+    return kRuns;
+}
+
+template <>
+const std::vector<SwapRun> &schema<gameb>() {
+    static const std::vector<SwapRun> kRuns = runsFor(pm3_schema::kGameB);
+    return kRuns;
+}
+
+template <>
+const std::vector<SwapRun> &schema<gamec>() {
+    static const std::vector<SwapRun> kRuns = runsFor(pm3_schema::kGameC);
+    return kRuns;
+}
+
+template <>
+const std::vector<SwapRun> &schema<saves>() {
+    static const std::vector<SwapRun> kRuns = runsFor(pm3_schema::kSaves);
+    return kRuns;
+}
+
+template <>
+const std::vector<SwapRun> &schema<prefs>() {
+    static const std::vector<SwapRun> kRuns = runsFor(pm3_schema::kPrefs);
+    return kRuns;
+}
+
+void swap16Portable(void *data, std::size_t count) {
+    auto *p = static_cast<uint8_t *>(data);
+    for (std::size_t i = 0; i < count; ++i, p += 2) {
+        uint16_t v = load16(p);
+        store16(p, static_cast<uint16_t>((v >> 8) | (v << 8)));
+    }
+}
+
+void swap32Portable(void *data, std::size_t count) {
+    auto *p = static_cast<uint8_t *>(data);
+    for (std::size_t i = 0; i < count; ++i, p += 4) {
+        uint32_t v = load32(p);
+        store32(p, (v >> 24) | ((v >> 8) & 0xFF00u) | ((v << 8) & 0xFF0000u) | (v << 24));
+    }
+}
+
+void swap16(void *data, std::size_t count) {
+    auto *p = static_cast<uint8_t *>(data);
+#if defined(PM3_CODEC_SSE2)
+    for (; count >= 8; count -= 8, p += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v);
+    }
+#elif defined(PM3_CODEC_NEON)
+    for (; count >= 8; count -= 8, p += 16) {
+        vst1q_u8(p, vrev16q_u8(vld1q_u8(p)));
+    }
+#endif
+    swap16Portable(p, count);
+}
+
+void swap32(void *data, std::size_t count) {
+    auto *p = static_cast<uint8_t *>(data);
+#if defined(PM3_CODEC_SSE2)
+    for (; count >= 4; count -= 4, p += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        // Swap the 16-bit halves of each word, then the bytes within each half.
+        v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v);
+    }
+#elif defined(PM3_CODEC_NEON)
+    for (; count >= 4; count -= 4, p += 16) {
+        vst1q_u8(p, vrev32q_u8(vld1q_u8(p)));
+    }
+#endif
+    swap32Portable(p, count);
+}
+
+void swapRuns(void *data, const std::vector<SwapRun> &runs) {
+    auto *bytes = static_cast<uint8_t *>(data);
+    for (const SwapRun &run : runs) {
+        uint8_t *group = bytes + run.offset;
+        for (uint32_t r = 0; r < run.repeat; ++r, group += run.stride) {
+            if (run.width == 2) {
+                swap16(group, run.count);
+            } else {
+                swap32(group, run.count);
+            }
+        }
+    }
+}
+
+} // namespace pm3_codec
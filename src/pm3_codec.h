@@ -0,0 +1,76 @@
+// Byte-order codec for the save structs, driven by a table of their multi-byte fields.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "pm3_defs.hh"
+
+namespace pm3_codec {
+
+enum class Endian {
+    Little, // DOS
+    Big,    // Amiga
+};
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+inline constexpr Endian kNativeEndian = Endian::Big;
+#else
+inline constexpr Endian kNativeEndian = Endian::Little;
+#endif
+
+// `count` contiguous fields of `width` bytes at `offset`, repeated `repeat` times every `stride` bytes.
+struct SwapRun {
+    uint32_t offset;
+    uint8_t width;
+    uint32_t count;
+    uint32_t repeat;
+    uint32_t stride;
+};
+
+// The multi-byte fields of each save struct, generated from its pm3_schema descriptors, sorted by offset, with
+// adjacent runs merged. Bitfield words are swapped as whole words; text and byte fields are left alone.
+template <typename T>
+const std::vector<SwapRun> &schema();
+template <>
+const std::vector<SwapRun> &schema<gamea>();
+template <>
+const std::vector<SwapRun> &schema<gameb>();
+template <>
+const std::vector<SwapRun> &schema<gamec>();
+template <>
+const std::vector<SwapRun> &schema<saves>();
+template <>
+const std::vector<SwapRun> &schema<prefs>();
+
+// Reverses every field named by `runs` in one pass over `data`.
+void swapRuns(void *data, const std::vector<SwapRun> &runs);
+
+// In-place byte reversal of `count` 16- or 32-bit values, vectorized with SSE2 or NEON where available.
+void swap16(void *data, std::size_t count);
+void swap32(void *data, std::size_t count);
+// The scalar loops, exposed for tests.
+void swap16Portable(void *data, std::size_t count);
+void swap32Portable(void *data, std::size_t count);
+
+inline int16_t byteSwap16(int16_t value) {
+    auto u = static_cast<uint16_t>(value);
+    return static_cast<int16_t>(static_cast<uint16_t>((u >> 8) | (u << 8)));
+}
+
+// Converts a struct just read from a file in `fileEndian` order to native order, and back before it is written.
+// Swapping is its own inverse, so both are no-ops when the file already matches the host.
+template <typename T>
+void decode(T &data, Endian fileEndian) {
+    if (fileEndian != kNativeEndian) {
+        swapRuns(&data, schema<T>());
+    }
+}
+
+template <typename T>
+void encode(T &data, Endian fileEndian) {
+    decode(data, fileEndian);
+}
+
+} // namespace pm3_codec
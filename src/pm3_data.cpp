@@ -1,15 +1,133 @@
 #include "pm3_data.h"
 
-gamea gameData;
-gameb clubData;
-gamec playerData;
+#include <iostream>
+#include <type_traits>
+
+GameState defaultGameState;
+gamea &gameData = defaultGameState.game;
+gameb &clubData = defaultGameState.clubs;
+gamec &playerData = defaultGameState.players;
 saves savesDir;
 prefs preferences;
 
 ClubRecord& getClub(int idx) {
-    return clubData.club[idx];
+    return defaultGameState.club(idx);
 }
 
 PlayerRecord& getPlayer(int16_t idx) {
-    return playerData.player[idx];
+    return defaultGameState.player(idx);
+}
+
+ClubRecord& getClub(GameState &state, int idx) {
+    return state.club(idx);
+}
+
+PlayerRecord& getPlayer(GameState &state, int16_t idx) {
+    return state.player(idx);
+}
+
+namespace {
+
+constexpr int kSquadClubs = static_cast<int>(std::extent_v<decltype(gameb::club)>);
+constexpr int kSquadSlots = static_cast<int>(std::extent_v<decltype(ClubRecord::player_index)>);
+constexpr int kSquadPlayers = static_cast<int>(std::extent_v<decltype(gamec::player)>);
+// An index entry whose player left the slot it pointed at; the next lookup scans for him.
+constexpr int16_t kPlaceUnknown = -2;
+
+bool isPlayer(int16_t playerIdx) {
+    return playerIdx >= 0 && playerIdx < kSquadPlayers;
+}
+
+bool listedBefore(const SquadPlace &a, int clubIdx, int slot) {
+    return a.clubIdx < clubIdx || (a.clubIdx == clubIdx && a.slot < slot);
+}
+
+// Counts a listing at (clubIdx, slot). Squads are walked backwards, so the last listing counted is the first.
+void addListing(SquadPlace &place, int clubIdx, int slot) {
+    place.clubIdx = static_cast<int16_t>(clubIdx);
+    place.slot = static_cast<int8_t>(slot);
+    ++place.listings;
+}
+
+SquadPlace scanSquads(const GameState &state, int16_t playerIdx) {
+    SquadPlace place;
+    for (int clubIdx = kSquadClubs - 1; clubIdx >= 0; --clubIdx) {
+        const ClubRecord &club = state.club(clubIdx);
+        for (int slot = kSquadSlots - 1; slot >= 0; --slot) {
+            if (club.player_index[slot] == playerIdx) {
+                addListing(place, clubIdx, slot);
+            }
+        }
+    }
+    return place;
+}
+
+void buildSquadIndex(const GameState &state) {
+    state.squadIndex.assign(kSquadPlayers, SquadPlace{});
+    for (int clubIdx = kSquadClubs - 1; clubIdx >= 0; --clubIdx) {
+        const ClubRecord &club = state.club(clubIdx);
+        for (int slot = kSquadSlots - 1; slot >= 0; --slot) {
+            int16_t playerIdx = club.player_index[slot];
+            if (isPlayer(playerIdx)) {
+                addListing(state.squadIndex[playerIdx], clubIdx, slot);
+            }
+        }
+    }
+}
+
+} // namespace
+
+SquadPlace GameState::squadPlace(int16_t playerIdx) const {
+    if (!isPlayer(playerIdx)) {
+        return {};
+    }
+    if (squadIndex.empty()) {
+        buildSquadIndex(*this);
+    }
+    SquadPlace &place = squadIndex[playerIdx];
+    if (place.clubIdx == kPlaceUnknown) {
+        place = scanSquads(*this, playerIdx);
+    }
+#ifndef NDEBUG
+    // Debug builds compare against the scan so a squad edit that bypassed setSquadSlot() shows up as a warning
+    // rather than a player filed under the wrong club.
+    SquadPlace scanned = scanSquads(*this, playerIdx);
+    if (scanned.clubIdx != place.clubIdx || scanned.slot != place.slot || scanned.listings != place.listings) {
+        std::cerr << "Squad index out of date for player " << playerIdx << ": club " << place.clubIdx
+                  << ", the squads say " << scanned.clubIdx << std::endl;
+        buildSquadIndex(*this);
+        return scanned;
+    }
+#endif
+    return place;
+}
+
+void GameState::setSquadSlot(int clubIdx, int slot, int16_t playerIdx) {
+    int16_t previous = club(clubIdx).player_index[slot];
+    club(clubIdx).player_index[slot] = playerIdx;
+    if (squadIndex.empty() || previous == playerIdx) {
+        return;
+    }
+    if (isPlayer(previous)) {
+        SquadPlace &place = squadIndex[previous];
+        if (place.listings <= 1) {
+            place = {};
+        } else {
+            // Listed twice: which listing comes first now is only known by looking.
+            place.clubIdx = kPlaceUnknown;
+            --place.listings;
+        }
+    }
+    if (isPlayer(playerIdx)) {
+        SquadPlace &place = squadIndex[playerIdx];
+        if (place.listings == 0) {
+            place = {static_cast<int16_t>(clubIdx), static_cast<int8_t>(slot), 1};
+        } else {
+            if (place.clubIdx != kPlaceUnknown && !listedBefore(place, clubIdx, slot)) {
+                place.clubIdx = static_cast<int16_t>(clubIdx);
+                place.slot = static_cast<int8_t>(slot);
+            }
+            ++place.listings;
+        }
+    }
 }
@@ -3,12 +3,66 @@
 
 #include <cstdint>
 #include <cstdio>
+#include <vector>
 
 #include "pm3_defs.hh"
 
-extern gamea gameData;
-extern gameb clubData;
-extern gamec playerData;
+// Where a player is in the squads: the first club, in club order, whose squad lists him, and the slot there.
+// clubIdx is -1 for a player in no squad.
+struct SquadPlace {
+    int16_t clubIdx = -1;
+    int8_t slot = -1;
+    // Squad slots that list him; more than one only in a damaged save.
+    uint16_t listings = 0;
+};
+
+// One open save: the three files of a slot, or of the base data. Instances share nothing, so several slots can be
+// open at once and tools can work on many saves from different threads.
+struct GameState {
+    gamea game;
+    gameb clubs;
+    gamec players;
+    // What followed the gamea record in GAMEDATA.DAT when the base data was loaded, written back with it.
+    std::vector<uint8_t> gameaTail;
+
+    ClubRecord &club(int idx) { return clubs.club[idx]; }
+    const ClubRecord &club(int idx) const { return clubs.club[idx]; }
+    PlayerRecord &player(int16_t idx) { return players.player[idx]; }
+    const PlayerRecord &player(int16_t idx) const { return players.player[idx]; }
+    ClubRecord &club(const PlayerHandle &handle) { return club(handle.clubIdx); }
+    const ClubRecord &club(const PlayerHandle &handle) const { return club(handle.clubIdx); }
+    PlayerRecord &player(const PlayerHandle &handle) { return player(handle.playerIdx); }
+    const PlayerRecord &player(const PlayerHandle &handle) const { return player(handle.playerIdx); }
+    // Whether the handle's squad slot still lists its player.
+    bool isCurrent(const PlayerHandle &handle) const {
+        return handle.clubIdx >= 0 && handle.slot >= 0 &&
+               club(handle.clubIdx).player_index[handle.slot] == handle.playerIdx;
+    }
+    // A handle at the player's squadPlace(); clubIdx is -1 for a player in no squad.
+    PlayerHandle handleFor(int16_t playerIdx) const {
+        SquadPlace place = squadPlace(playerIdx);
+        return {playerIdx, place.clubIdx, place.slot};
+    }
+
+    // Player -> squad place, from an index built in one pass over the squads on the first call. Squad edits go
+    // through setSquadSlot(), which keeps the index current; code that loads or copies over whole blocks calls
+    // squadsReplaced(). Debug builds check every answer against a scan of the squads. Lookups fill the index, so
+    // one GameState must not be read from several threads at once.
+    SquadPlace squadPlace(int16_t playerIdx) const;
+    // Puts `playerIdx` (-1 to empty it) into a squad slot.
+    void setSquadSlot(int clubIdx, int slot, int16_t playerIdx);
+    void squadsReplaced() { squadIndex.clear(); }
+
+    // The index behind squadPlace(), empty until it is built.
+    mutable std::vector<SquadPlace> squadIndex;
+};
+
+// The state the editor works on. Loads, saves and dirty tracking (dirty_tracker.h) apply to this instance, and
+// gameData/clubData/playerData name its members for code written before GameState.
+extern GameState defaultGameState;
+extern gamea &gameData;
+extern gameb &clubData;
+extern gamec &playerData;
 extern saves savesDir;
 extern prefs preferences;
 
@@ -26,3 +80,5 @@ extern FILE *prefsFile;
 
 ClubRecord& getClub(int idx);
 PlayerRecord& getPlayer(int16_t idx);
+ClubRecord& getClub(GameState &state, int idx);
+PlayerRecord& getPlayer(GameState &state, int16_t idx);
@@ -793,9 +793,13 @@ struct prefs {
     } __attribute__ ((packed)) audio;
 } __attribute__ ((packed));
 
-struct club_player {
-    ClubRecord club;
-    PlayerRecord player;
+// A player as a list shows him: which player, and the club and squad slot he was listed at. The records are read
+// through the GameState the list was made from (GameState::player(handle) and club(handle)), so a row always shows
+// the save as it is now.
+struct PlayerHandle {
+    int16_t playerIdx = -1;
+    int16_t clubIdx = -1;
+    int8_t slot = -1;
 };
 
 #endif // PM3000_PM3_DEFS_HH
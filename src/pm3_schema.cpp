@@ -0,0 +1,138 @@
+// Compile-time field descriptors for the packed save structs in pm3_defs.hh.
+#include "pm3_schema.h"
+
+namespace pm3_schema {
+
+namespace {
+
+uint32_t loadUnit(const uint8_t *p, uint32_t width) {
+    uint32_t unit = 0;
+    for (uint32_t i = 0; i < width; ++i) {
+        unit |= static_cast<uint32_t>(p[i]) << (8 * i);
+    }
+    return unit;
+}
+
+void storeUnit(uint8_t *p, uint32_t width, uint32_t unit) {
+    for (uint32_t i = 0; i < width; ++i) {
+        p[i] = static_cast<uint8_t>(unit >> (8 * i));
+    }
+}
+
+void visitFields(const Record &record, const uint8_t *base, std::string &path, const Visitor &visitor) {
+    for (const Field &field : record) {
+        std::size_t mark = path.size();
+        if (!path.empty()) {
+            path += '.';
+        }
+        path += field.name;
+        const uint8_t *element = base + field.offset;
+        if (field.kind == Kind::Text || field.kind == Kind::Bytes) {
+            visitor(path, field, element);
+        } else if (field.count == 1) {
+            if (field.kind == Kind::Record) {
+                visitFields(*field.record, element, path, visitor);
+            } else {
+                visitor(path, field, element);
+            }
+        } else {
+            std::size_t arrayMark = path.size();
+            for (uint32_t i = 0; i < field.count; ++i, element += field.width) {
+                path += '[';
+                path += std::to_string(i);
+                path += ']';
+                if (field.kind == Kind::Record) {
+                    visitFields(*field.record, element, path, visitor);
+                } else {
+                    visitor(path, field, element);
+                }
+                path.resize(arrayMark);
+            }
+        }
+        path.resize(mark);
+    }
+}
+
+} // namespace
+
+int64_t readValue(const Field &field, const void *element) {
+    uint32_t unit = loadUnit(static_cast<const uint8_t *>(element), field.width);
+    uint32_t raw = (unit >> field.shift) & field.mask;
+    if (field.isSigned && field.kind == Kind::Integer) {
+        uint32_t signBit = (field.mask >> 1) + 1;
+        return static_cast<int64_t>(raw ^ signBit) - static_cast<int64_t>(signBit);
+    }
+    return raw;
+}
+
+void writeValue(const Field &field, void *element, int64_t value) {
+    auto *p = static_cast<uint8_t *>(element);
+    uint32_t unit = loadUnit(p, field.width);
+    uint32_t mask = field.mask << field.shift;
+    unit = (unit & ~mask) | ((static_cast<uint32_t>(value) << field.shift) & mask);
+    storeUnit(p, field.width, unit);
+}
+
+bool inRange(const Field &field, int64_t value) {
+    return value >= field.min && value <= field.max;
+}
+
+void visit(const Record &record, const void *data, const Visitor &visitor) {
+    std::string path;
+    visitFields(record, static_cast<const uint8_t *>(data), path, visitor);
+}
+
+std::optional<Location> lookup(const Record &record, const std::string &path) {
+    const Record *current = &record;
+    std::size_t offset = 0;
+    std::size_t pos = 0;
+    while (pos <= path.size()) {
+        std::size_t end = path.find('.', pos);
+        std::string segment = path.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+        std::size_t bracket = segment.find('[');
+        std::string name = segment.substr(0, bracket);
+
+        const Field *match = nullptr;
+        for (const Field &field : *current) {
+            if (name == field.name) {
+                match = &field;
+                break;
+            }
+        }
+        if (!match) {
+            return std::nullopt;
+        }
+        // Text and Bytes fields are addressed as a whole, like visit() reports them.
+        bool indexed = match->count > 1 && match->kind != Kind::Text && match->kind != Kind::Bytes;
+        uint32_t index = 0;
+        if (indexed) {
+            if (bracket == std::string::npos || segment.back() != ']') {
+                return std::nullopt;
+            }
+            std::string digits = segment.substr(bracket + 1, segment.size() - bracket - 2);
+            if (digits.empty() || digits.size() > 9 || digits.find_first_not_of("0123456789") != std::string::npos ||
+                std::stoul(digits) >= match->count) {
+                return std::nullopt;
+            }
+            index = static_cast<uint32_t>(std::stoul(digits));
+        } else if (bracket != std::string::npos) {
+            return std::nullopt;
+        }
+        offset += match->offset + static_cast<std::size_t>(index) * match->width;
+
+        if (end == std::string::npos) {
+            if (match->kind == Kind::Record) {
+                return std::nullopt;
+            }
+            return Location{match, offset};
+        }
+        if (match->kind != Kind::Record) {
+            return std::nullopt;
+        }
+        current = match->record;
+        pos = end + 1;
+    }
+    return std::nullopt;
+}
+
+} // namespace pm3_schema
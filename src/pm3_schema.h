@@ -0,0 +1,922 @@
+// Compile-time field descriptors for the packed save structs in pm3_defs.hh.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <string>
+#include <type_traits>
+
+#include "pm3_defs.hh"
+
+namespace pm3_schema {
+
+// Sizes of GAMEnA/B/C, SAVES.DIR and PREFS as PM3 writes them.
+inline constexpr uint32_t kGameAFileSize = 29554;
+inline constexpr uint32_t kGameBFileSize = 139080;
+inline constexpr uint32_t kGameCFileSize = 157280;
+inline constexpr uint32_t kSavesDirFileSize = 1600;
+inline constexpr uint32_t kPrefsFileSize = 46;
+
+inline constexpr int64_t kPlayerCount = sizeof(gamec) / sizeof(PlayerRecord);
+
+enum class Kind : uint8_t {
+    Integer, // little-endian integer of `width` bytes
+    Bits,    // `mask << shift` within a `width`-byte unit shared with its neighbours
+    Text,    // `width` characters, space or NUL padded
+    Bytes,   // `width` bytes not yet understood
+    Record,  // nested struct described by `record`
+};
+
+struct Record;
+
+// One member of a packed struct. Arrays are a single field with `count` elements `width` bytes apart.
+struct Field {
+    const char *name;
+    uint32_t offset;
+    uint32_t width;
+    uint32_t count;
+    Kind kind;
+    bool isSigned;
+    uint32_t mask;
+    uint8_t shift;
+    int64_t min;
+    int64_t max;
+    const Record *record;
+    // For a club or player reference: whether save_validator may set it to -1 when it is out of range. Off for
+    // references whose meaning is not confirmed, which are only reported.
+    bool repairable = true;
+
+    constexpr uint32_t size() const {
+        return width * count;
+    }
+    constexpr bool isNumeric() const {
+        return kind == Kind::Integer || kind == Kind::Bits;
+    }
+};
+
+struct Record {
+    const char *name;
+    uint32_t size;
+    const Field *fields;
+    std::size_t fieldCount;
+
+    constexpr const Field *begin() const {
+        return fields;
+    }
+    constexpr const Field *end() const {
+        return fields + fieldCount;
+    }
+};
+
+struct Range {
+    int64_t min;
+    int64_t max;
+    bool repairable = true;
+};
+
+inline constexpr Range kClubRange{-1, kClubIdxMax - 1};
+inline constexpr Range kPlayerRange{-1, kPlayerCount - 1};
+// The same ranges for fields that look like references but have not been confirmed to be one in every record.
+inline constexpr Range kUnconfirmedClubRange{kClubRange.min, kClubRange.max, false};
+inline constexpr Range kUnconfirmedPlayerRange{kPlayerRange.min, kPlayerRange.max, false};
+
+namespace detail {
+
+// M may be a reference when it comes from decltype of a subscript or member access.
+template <typename M>
+using Element = std::remove_all_extents_t<std::remove_reference_t<M>>;
+
+template <typename M>
+inline constexpr uint32_t kCountOf = sizeof(std::remove_reference_t<M>) / sizeof(Element<M>);
+
+template <typename M>
+constexpr Field integer(const char *name, std::size_t offset, Range range) {
+    using T = Element<M>;
+    static_assert(std::is_integral_v<T> && sizeof(T) <= 4, "integer fields are 1, 2 or 4 bytes");
+    return {name, static_cast<uint32_t>(offset), sizeof(T), kCountOf<M>, Kind::Integer, std::is_signed_v<T>,
+            static_cast<uint32_t>(std::numeric_limits<std::make_unsigned_t<T>>::max()), 0, range.min, range.max,
+            nullptr, range.repairable};
+}
+
+template <typename M>
+constexpr Field integer(const char *name, std::size_t offset) {
+    using T = Element<M>;
+    return integer<M>(name, offset, Range{std::numeric_limits<T>::min(), std::numeric_limits<T>::max()});
+}
+
+template <typename Unit>
+constexpr Field bits(const char *name, std::size_t offset, uint8_t shift, uint8_t bitCount) {
+    uint32_t mask = static_cast<uint32_t>((uint64_t{1} << bitCount) - 1);
+    return {name, static_cast<uint32_t>(offset), sizeof(Unit), 1, Kind::Bits, false, mask, shift, 0, mask, nullptr};
+}
+
+template <typename M>
+constexpr Field text(const char *name, std::size_t offset) {
+    return {name, static_cast<uint32_t>(offset), sizeof(M), 1, Kind::Text, false, 0, 0, 0, 0, nullptr};
+}
+
+template <typename M>
+constexpr Field bytes(const char *name, std::size_t offset) {
+    return {name, static_cast<uint32_t>(offset), sizeof(M), 1, Kind::Bytes, false, 0, 0, 0, 0, nullptr};
+}
+
+template <typename M>
+constexpr Field record(const char *name, std::size_t offset, const Record &nested) {
+    return {name, static_cast<uint32_t>(offset), sizeof(Element<M>), kCountOf<M>, Kind::Record, false, 0, 0, 0, 0,
+            &nested};
+}
+
+template <typename T, std::size_t N>
+constexpr Record describe(const char *name, const Field (&fields)[N]) {
+    return {name, sizeof(T), fields, N};
+}
+
+} // namespace detail
+
+#define PM3_INT(R, m) detail::integer<decltype(R::m)>(#m, offsetof(R, m))
+#define PM3_CLUB(R, m) detail::integer<decltype(R::m)>(#m, offsetof(R, m), kClubRange)
+#define PM3_PLAYER(R, m) detail::integer<decltype(R::m)>(#m, offsetof(R, m), kPlayerRange)
+#define PM3_CLUB_UNCONFIRMED(R, m) detail::integer<decltype(R::m)>(#m, offsetof(R, m), kUnconfirmedClubRange)
+#define PM3_PLAYER_UNCONFIRMED(R, m) detail::integer<decltype(R::m)>(#m, offsetof(R, m), kUnconfirmedPlayerRange)
+#define PM3_TEXT(R, m) detail::text<decltype(R::m)>(#m, offsetof(R, m))
+#define PM3_BYTES(R, m) detail::bytes<decltype(R::m)>(#m, offsetof(R, m))
+#define PM3_RECORD(R, m, nested) detail::record<decltype(R::m)>(#m, offsetof(R, m), nested)
+// Bitfields have no offsetof; `after` is the member that precedes the unit they share.
+#define PM3_BITS(R, after, Unit, name, shift, count) \
+    detail::bits<Unit>(name, offsetof(R, after) + sizeof(R::after), shift, count)
+
+// Bitfields are described as GCC and Clang lay them out on little-endian targets: first member in the low bits.
+
+// ---- gamea ----------------------------------------------------------------------------------------------------
+
+using ClubIndexLeagues = gamea::ClubIndexLeagues;
+inline constexpr Field kClubIndexLeaguesFields[] = {
+        PM3_CLUB(ClubIndexLeagues, premier_league),
+        PM3_CLUB(ClubIndexLeagues, division_one),
+        PM3_CLUB(ClubIndexLeagues, division_two),
+        PM3_CLUB(ClubIndexLeagues, division_three),
+        PM3_CLUB(ClubIndexLeagues, conference_league),
+        PM3_INT(ClubIndexLeagues, misc),
+};
+inline constexpr Record kClubIndexLeagues = detail::describe<ClubIndexLeagues>("club_index", kClubIndexLeaguesFields);
+
+// Slots per division in club_index and the league table, in divisionNames order.
+inline constexpr std::array<int, 5> kDivisionSlots{
+        static_cast<int>(kClubIndexLeaguesFields[0].count), static_cast<int>(kClubIndexLeaguesFields[1].count),
+        static_cast<int>(kClubIndexLeaguesFields[2].count), static_cast<int>(kClubIndexLeaguesFields[3].count),
+        static_cast<int>(kClubIndexLeaguesFields[4].count)};
+
+using TableDivision = gamea::TableDivision;
+inline constexpr Field kTableDivisionFields[] = {
+        PM3_CLUB(TableDivision, club_idx), PM3_INT(TableDivision, hx), PM3_INT(TableDivision, hw),
+        PM3_INT(TableDivision, hd),        PM3_INT(TableDivision, hl), PM3_INT(TableDivision, hf),
+        PM3_INT(TableDivision, ha),        PM3_INT(TableDivision, ax), PM3_INT(TableDivision, aw),
+        PM3_INT(TableDivision, ad),        PM3_INT(TableDivision, al), PM3_INT(TableDivision, af),
+        PM3_INT(TableDivision, aa),        PM3_INT(TableDivision, xx),
+};
+inline constexpr Record kTableDivision = detail::describe<TableDivision>("TableDivision", kTableDivisionFields);
+
+using TableByLeague = gamea::TableByLeague;
+inline constexpr Field kTableByLeagueFields[] = {
+        PM3_RECORD(TableByLeague, premier_league, kTableDivision),
+        PM3_RECORD(TableByLeague, division_one, kTableDivision),
+        PM3_RECORD(TableByLeague, division_two, kTableDivision),
+        PM3_RECORD(TableByLeague, division_three, kTableDivision),
+        PM3_RECORD(TableByLeague, conference_league, kTableDivision),
+};
+inline constexpr Record kTableByLeague = detail::describe<TableByLeague>("table", kTableByLeagueFields);
+
+// Points for a league table row: three for a win, one for a draw.
+inline int tablePoints(const TableDivision &row) {
+    return 3 * (row.hw + row.aw) + row.hd + row.ad;
+}
+
+// 1-based position of `division[slot]` among the `count` rows of its division, by points, goal difference, then
+// goals scored. Rows without a club are not counted, and level rows share a position.
+inline int leaguePosition(const TableDivision *division, int count, int slot) {
+    auto standing = [](const TableDivision &row) {
+        int goalsFor = row.hf + row.af;
+        return std::array<int, 3>{tablePoints(row), goalsFor - row.ha - row.aa, goalsFor};
+    };
+    const std::array<int, 3> own = standing(division[slot]);
+    int position = 1;
+    for (int other = 0; other < count; ++other) {
+        if (other != slot && division[other].club_idx >= 0 && standing(division[other]) > own) {
+            ++position;
+        }
+    }
+    return position;
+}
+
+using TopScorerEntry = gamea::TopScorerEntry;
+inline constexpr Field kTopScorerEntryFields[] = {
+        PM3_PLAYER(TopScorerEntry, player_idx),
+        PM3_CLUB(TopScorerEntry, club_idx),
+        PM3_INT(TopScorerEntry, pl),
+        PM3_INT(TopScorerEntry, sc),
+};
+inline constexpr Record kTopScorerEntry = detail::describe<TopScorerEntry>("TopScorerEntry", kTopScorerEntryFields);
+
+using TopScorersByLeague = gamea::TopScorersByLeague;
+inline constexpr Field kTopScorersByLeagueFields[] = {
+        PM3_RECORD(TopScorersByLeague, premier_league, kTopScorerEntry),
+        PM3_RECORD(TopScorersByLeague, division_one, kTopScorerEntry),
+        PM3_RECORD(TopScorersByLeague, division_two, kTopScorerEntry),
+        PM3_RECORD(TopScorersByLeague, division_three, kTopScorerEntry),
+        PM3_RECORD(TopScorersByLeague, conference_league, kTopScorerEntry),
+};
+inline constexpr Record kTopScorersByLeague =
+        detail::describe<TopScorersByLeague>("top_scorers", kTopScorersByLeagueFields);
+
+using Referee = detail::Element<decltype(gamea::referee)>;
+inline constexpr Field kRefereeFields[] = {
+        PM3_TEXT(Referee, name),
+        PM3_BITS(Referee, name, uint8_t, "magic", 0, 3),
+        PM3_BITS(Referee, name, uint8_t, "age", 3, 5),
+        PM3_BYTES(Referee, var),
+};
+inline constexpr Record kReferee = detail::describe<Referee>("referee", kRefereeFields);
+
+using CupClub = detail::Element<decltype(gamea::CupEntry::club)>;
+inline constexpr Field kCupClubFields[] = {
+        PM3_CLUB(CupClub, idx),
+        PM3_INT(CupClub, goals),
+        PM3_INT(CupClub, audience),
+};
+inline constexpr Record kCupClub = detail::describe<CupClub>("club", kCupClubFields);
+
+using CupEntry = gamea::CupEntry;
+inline constexpr Field kCupEntryFields[] = {
+        PM3_RECORD(CupEntry, club, kCupClub),
+};
+inline constexpr Record kCupEntry = detail::describe<CupEntry>("CupEntry", kCupEntryFields);
+
+using CupCompetitions = gamea::CupCompetitions;
+inline constexpr Field kCupCompetitionsFields[] = {
+        PM3_RECORD(CupCompetitions, the_fa_cup, kCupEntry),
+        PM3_RECORD(CupCompetitions, the_league_cup, kCupEntry),
+        PM3_RECORD(CupCompetitions, data090, kCupEntry),
+        PM3_RECORD(CupCompetitions, the_champions_cup, kCupEntry),
+        PM3_RECORD(CupCompetitions, data091, kCupEntry),
+        PM3_RECORD(CupCompetitions, the_cup_winners_cup, kCupEntry),
+        PM3_RECORD(CupCompetitions, the_uefa_cup, kCupEntry),
+        PM3_RECORD(CupCompetitions, the_charity_shield, kCupEntry),
+};
+inline constexpr Record kCupCompetitions = detail::describe<CupCompetitions>("cuppy", kCupCompetitionsFields);
+
+using SomeTableEntry = detail::Element<decltype(gamea::some_table)>;
+inline constexpr Field kSomeTableEntryFields[] = {
+        PM3_CLUB(SomeTableEntry, club1_idx), PM3_INT(SomeTableEntry, club1_goals),
+        PM3_INT(SomeTableEntry, club1_audience), PM3_CLUB(SomeTableEntry, club2_idx),
+        PM3_INT(SomeTableEntry, club2_goals), PM3_INT(SomeTableEntry, club2_audience),
+};
+inline constexpr Record kSomeTableEntry = detail::describe<SomeTableEntry>("some_table", kSomeTableEntryFields);
+
+using LeagueHistoryEntry = detail::Element<decltype(gamea::league[0].history)>;
+inline constexpr Field kLeagueHistoryEntryFields[] = {
+        PM3_INT(LeagueHistoryEntry, year),
+        PM3_CLUB(LeagueHistoryEntry, club_idx),
+        PM3_BYTES(LeagueHistoryEntry, data),
+};
+inline constexpr Record kLeagueHistoryEntry =
+        detail::describe<LeagueHistoryEntry>("history", kLeagueHistoryEntryFields);
+
+using LeagueHistory = detail::Element<decltype(gamea::league)>;
+inline constexpr Field kLeagueHistoryFields[] = {
+        PM3_RECORD(LeagueHistory, history, kLeagueHistoryEntry),
+};
+inline constexpr Record kLeagueHistory = detail::describe<LeagueHistory>("league", kLeagueHistoryFields);
+
+using CupHistoryEntry = detail::Element<decltype(gamea::cup[0].history)>;
+inline constexpr Field kCupHistoryEntryFields[] = {
+        PM3_INT(CupHistoryEntry, year),
+        PM3_CLUB(CupHistoryEntry, club_idx_winner),
+        PM3_CLUB(CupHistoryEntry, club_idx_runner_up),
+        PM3_INT(CupHistoryEntry, type_winner),
+        PM3_INT(CupHistoryEntry, type_runner_up),
+};
+inline constexpr Record kCupHistoryEntry = detail::describe<CupHistoryEntry>("history", kCupHistoryEntryFields);
+
+using CupHistory = detail::Element<decltype(gamea::cup)>;
+inline constexpr Field kCupHistoryFields[] = {
+        PM3_RECORD(CupHistory, history, kCupHistoryEntry),
+};
+inline constexpr Record kCupHistory = detail::describe<CupHistory>("cup", kCupHistoryFields);
+
+using Fixture = detail::Element<decltype(gamea::fixture)>;
+inline constexpr Field kFixtureFields[] = {
+        PM3_CLUB(Fixture, club_idx1),
+        PM3_CLUB(Fixture, club_idx2),
+};
+inline constexpr Record kFixture = detail::describe<Fixture>("fixture", kFixtureFields);
+
+using TransferListing = detail::Element<decltype(gamea::transfer_market)>;
+inline constexpr Field kTransferListingFields[] = {
+        PM3_PLAYER(TransferListing, player_idx),
+        PM3_CLUB(TransferListing, club_idx),
+};
+inline constexpr Record kTransferListing = detail::describe<TransferListing>("transfer_market", kTransferListingFields);
+
+using Transfer = detail::Element<decltype(gamea::transfer)>;
+inline constexpr Field kTransferFields[] = {
+        PM3_PLAYER(Transfer, player_idx),
+        PM3_CLUB(Transfer, from_club_idx),
+        PM3_CLUB(Transfer, to_club_idx),
+        PM3_INT(Transfer, fee),
+};
+inline constexpr Record kTransfer = detail::describe<Transfer>("transfer", kTransferFields);
+
+// ---- gamea::ManagerRecord ---------------------------------------------------------------------------------------
+
+using Manager = gamea::ManagerRecord;
+
+using Price = decltype(Manager::price);
+inline constexpr Field kPriceFields[] = {
+        PM3_INT(Price, league_match_seating),
+        PM3_INT(Price, league_match_terrace),
+        PM3_INT(Price, cup_match_seating),
+        PM3_INT(Price, cup_match_terrace),
+};
+inline constexpr Record kPrice = detail::describe<Price>("price", kPriceFields);
+
+using BankStatement = detail::Element<decltype(Manager::bank_statement)>;
+inline constexpr Field kBankStatementFields[] = {
+        PM3_INT(BankStatement, gate_receipts),       PM3_INT(BankStatement, club_wages),
+        PM3_INT(BankStatement, transfer_fees),       PM3_INT(BankStatement, club_fines),
+        PM3_INT(BankStatement, grants_for_club),     PM3_INT(BankStatement, club_bills),
+        PM3_INT(BankStatement, miscellaneous_sales), PM3_INT(BankStatement, bank_loan_payments),
+        PM3_INT(BankStatement, ground_improvements), PM3_INT(BankStatement, advertising_boards),
+        PM3_INT(BankStatement, other_items),         PM3_INT(BankStatement, account_interest),
+};
+inline constexpr Record kBankStatement = detail::describe<BankStatement>("bank_statement", kBankStatementFields);
+
+using Loan = detail::Element<decltype(Manager::loan)>;
+inline constexpr Field kLoanFields[] = {
+        PM3_INT(Loan, amount),
+        PM3_INT(Loan, turn),
+        PM3_INT(Loan, year),
+};
+inline constexpr Record kLoan = detail::describe<Loan>("loan", kLoanFields);
+
+using Employee = detail::Element<decltype(Manager::employee)>;
+inline constexpr Field kEmployeeFields[] = {
+        PM3_TEXT(Employee, name),
+        PM3_INT(Employee, skill),
+        PM3_BITS(Employee, skill, uint8_t, "type", 0, 4),
+        PM3_BITS(Employee, skill, uint8_t, "age", 4, 4),
+};
+inline constexpr Record kEmployee = detail::describe<Employee>("employee", kEmployeeFields);
+
+using AssistantManager = decltype(Manager::assistant_manager);
+inline constexpr Field kAssistantManagerFields[] = {
+        PM3_INT(AssistantManager, do_training_schedules),
+        PM3_INT(AssistantManager, treat_injured_players),
+        PM3_INT(AssistantManager, check_sponsors_boards),
+        PM3_INT(AssistantManager, hire_and_fire_employees),
+        PM3_INT(AssistantManager, negotiate_player_contracts),
+};
+inline constexpr Record kAssistantManager =
+        detail::describe<AssistantManager>("assistant_manager", kAssistantManagerFields);
+
+using ScoutResult = detail::Element<decltype(Manager::scout[0].results)>;
+inline constexpr Field kScoutResultFields[] = {
+        PM3_PLAYER_UNCONFIRMED(ScoutResult, ix1),
+        PM3_PLAYER_UNCONFIRMED(ScoutResult, ix2),
+};
+inline constexpr Record kScoutResult = detail::describe<ScoutResult>("results", kScoutResultFields);
+
+using Scout = detail::Element<decltype(Manager::scout)>;
+inline constexpr Field kScoutFields[] = {
+        PM3_INT(Scout, size),
+        PM3_INT(Scout, skill),
+        PM3_INT(Scout, rating),
+        PM3_BITS(Scout, rating, uint8_t, "division", 0, 3),
+        PM3_BITS(Scout, rating, uint8_t, "foot", 3, 5),
+        PM3_INT(Scout, club),
+        PM3_RECORD(Scout, results, kScoutResult),
+        PM3_BYTES(Scout, other),
+};
+inline constexpr Record kScout = detail::describe<Scout>("scout", kScoutFields);
+
+// ix1..ix3 hold a club or a player depending on `type`, so only the type's own range is known.
+using News = detail::Element<decltype(Manager::news)>;
+inline constexpr Field kNewsFields[] = {
+        PM3_INT(News, type), PM3_INT(News, amount), PM3_INT(News, ix1), PM3_INT(News, ix2), PM3_INT(News, ix3),
+};
+inline constexpr Record kNews = detail::describe<News>("news", kNewsFields);
+
+using Stadium = decltype(Manager::stadium);
+
+using Stand = detail::Element<decltype(Stadium::stand)>;
+inline constexpr Field kStandFields[] = {
+        PM3_TEXT(Stand, name),
+};
+inline constexpr Record kStand = detail::describe<Stand>("stand", kStandFields);
+
+// seating_build, conversion and area_covering are distinct anonymous structs with this one-byte layout.
+using Build = detail::Element<decltype(Stadium::seating_build)>;
+inline constexpr Field kBuildFields[] = {
+        detail::bits<uint8_t>("level", 0, 0, 3),
+        detail::bits<uint8_t>("time", 0, 3, 5),
+};
+inline constexpr Record kBuild = detail::describe<Build>("build", kBuildFields);
+
+// ground_facilities..car_park share this 32-bit layout.
+using Facility = decltype(Stadium::ground_facilities);
+inline constexpr Field kFacilityFields[] = {
+        detail::bits<uint32_t>("level", 0, 0, 3),
+        detail::bits<uint32_t>("time", 0, 3, 29),
+};
+inline constexpr Record kFacility = detail::describe<Facility>("facility", kFacilityFields);
+
+using Capacity = detail::Element<decltype(Stadium::capacity)>;
+inline constexpr Field kCapacityFields[] = {
+        detail::bits<uint16_t>("seating", 0, 0, 15),
+        detail::bits<uint16_t>("terraces", 0, 15, 1),
+};
+inline constexpr Record kCapacity = detail::describe<Capacity>("capacity", kCapacityFields);
+
+inline constexpr Field kStadiumFields[] = {
+        PM3_RECORD(Stadium, stand, kStand),
+        PM3_RECORD(Stadium, seating_build, kBuild),
+        PM3_RECORD(Stadium, conversion, kBuild),
+        PM3_RECORD(Stadium, area_covering, kBuild),
+        PM3_RECORD(Stadium, ground_facilities, kFacility),
+        PM3_RECORD(Stadium, supporters_club, kFacility),
+        PM3_RECORD(Stadium, flood_lights, kFacility),
+        PM3_RECORD(Stadium, scoreboard, kFacility),
+        PM3_RECORD(Stadium, undersoil_heating, kFacility),
+        PM3_RECORD(Stadium, changing_rooms, kFacility),
+        PM3_RECORD(Stadium, gymnasium, kFacility),
+        PM3_RECORD(Stadium, car_park, kFacility),
+        PM3_INT(Stadium, safety_rating),
+        PM3_RECORD(Stadium, capacity, kCapacity),
+};
+inline constexpr Record kStadium = detail::describe<Stadium>("stadium", kStadiumFields);
+
+using MatchSummary = decltype(Manager::match_summary);
+using MatchClub = detail::Element<decltype(MatchSummary::club)>;
+
+using Lineup = detail::Element<decltype(MatchClub::lineup)>;
+inline constexpr Field kLineupFields[] = {
+        PM3_PLAYER_UNCONFIRMED(Lineup, player_idx),
+        PM3_BYTES(Lineup, data5),           PM3_INT(Lineup, fitness),
+        PM3_INT(Lineup, card),              PM3_INT(Lineup, shots_attempted), PM3_INT(Lineup, shots_missed),
+        PM3_INT(Lineup, something),         PM3_INT(Lineup, tackles_attempted),
+        PM3_INT(Lineup, tackles_won),       PM3_INT(Lineup, passes_attempted),
+        PM3_INT(Lineup, passes_bad),        PM3_INT(Lineup, shots_saved),     PM3_BYTES(Lineup, x),
+};
+inline constexpr Record kLineup = detail::describe<Lineup>("lineup", kLineupFields);
+
+using Goal = detail::Element<decltype(MatchClub::goal)>;
+inline constexpr Field kGoalFields[] = {
+        PM3_PLAYER_UNCONFIRMED(Goal, player_idx),
+        PM3_INT(Goal, time),
+};
+inline constexpr Record kGoal = detail::describe<Goal>("goal", kGoalFields);
+
+inline constexpr Field kMatchClubFields[] = {
+        PM3_INT(MatchClub, club_idx),
+        PM3_INT(MatchClub, total_goals),
+        PM3_INT(MatchClub, first_half_goals),
+        PM3_BYTES(MatchClub, pattern6),
+        PM3_BYTES(MatchClub, match_data),
+        PM3_INT(MatchClub, corners),
+        PM3_INT(MatchClub, throw_ins),
+        PM3_INT(MatchClub, free_kicks),
+        PM3_INT(MatchClub, penalties),
+        PM3_RECORD(MatchClub, lineup, kLineup),
+        PM3_RECORD(MatchClub, goal, kGoal),
+        PM3_INT(MatchClub, always_null),
+        PM3_INT(MatchClub, substitutions_remaining),
+        PM3_INT(MatchClub, other),
+        PM3_INT(MatchClub, home_away_data),
+};
+inline constexpr Record kMatchClub = detail::describe<MatchClub>("club", kMatchClubFields);
+
+inline constexpr Field kMatchSummaryFields[] = {
+        PM3_RECORD(MatchSummary, club, kMatchClub),
+        PM3_INT(MatchSummary, weather),
+        PM3_INT(MatchSummary, referee_idx),
+        PM3_BYTES(MatchSummary, data156),
+        PM3_INT(MatchSummary, match_type),
+        PM3_BYTES(MatchSummary, data157),
+        PM3_INT(MatchSummary, audience),
+        PM3_BYTES(MatchSummary, data158),
+};
+inline constexpr Record kMatchSummary = detail::describe<MatchSummary>("match_summary", kMatchSummaryFields);
+
+using ManagerLeagueHistory = detail::Element<decltype(Manager::league_history)>;
+inline constexpr Field kManagerLeagueHistoryFields[] = {
+        PM3_INT(ManagerLeagueHistory, year),  PM3_INT(ManagerLeagueHistory, div),   PM3_INT(ManagerLeagueHistory, club_idx),
+        PM3_INT(ManagerLeagueHistory, ps),    PM3_INT(ManagerLeagueHistory, p),     PM3_INT(ManagerLeagueHistory, w),
+        PM3_INT(ManagerLeagueHistory, d),     PM3_INT(ManagerLeagueHistory, l),     PM3_INT(ManagerLeagueHistory, gd),
+        PM3_INT(ManagerLeagueHistory, pts),   PM3_INT(ManagerLeagueHistory, unk21), PM3_INT(ManagerLeagueHistory, unk22),
+        PM3_INT(ManagerLeagueHistory, unk23), PM3_INT(ManagerLeagueHistory, unk24), PM3_INT(ManagerLeagueHistory, unk25),
+        PM3_INT(ManagerLeagueHistory, unk26), PM3_INT(ManagerLeagueHistory, unk27), PM3_INT(ManagerLeagueHistory, unk28),
+        PM3_INT(ManagerLeagueHistory, unk29), PM3_INT(ManagerLeagueHistory, unk30), PM3_INT(ManagerLeagueHistory, unk31),
+        PM3_INT(ManagerLeagueHistory, unk32),
+};
+inline constexpr Record kManagerLeagueHistory =
+        detail::describe<ManagerLeagueHistory>("league_history", kManagerLeagueHistoryFields);
+
+using Title = detail::Element<decltype(Manager::titles)>;
+inline constexpr Field kTitleFields[] = {
+        PM3_INT(Title, won),
+        PM3_INT(Title, yrs),
+};
+inline constexpr Record kTitle = detail::describe<Title>("titles", kTitleFields);
+
+using ManagerHistory = detail::Element<decltype(Manager::manager_history)>;
+inline constexpr Field kManagerHistoryFields[] = {
+        PM3_INT(ManagerHistory, play), PM3_INT(ManagerHistory, won),  PM3_INT(ManagerHistory, drew),
+        PM3_INT(ManagerHistory, lost), PM3_INT(ManagerHistory, forx), PM3_INT(ManagerHistory, agn),
+};
+inline constexpr Record kManagerHistory = detail::describe<ManagerHistory>("manager_history", kManagerHistoryFields);
+
+using PreviousClub = detail::Element<decltype(Manager::previous_clubs)>;
+inline constexpr Field kPreviousClubFields[] = {
+        PM3_INT(PreviousClub, year_from), PM3_INT(PreviousClub, year_to), PM3_INT(PreviousClub, club_idx),
+        PM3_INT(PreviousClub, mngr),      PM3_INT(PreviousClub, drct),    PM3_INT(PreviousClub, sprt),
+};
+inline constexpr Record kPreviousClub = detail::describe<PreviousClub>("previous_clubs", kPreviousClubFields);
+
+using MatchHistory = detail::Element<decltype(Manager::match_history)>;
+inline constexpr Field kMatchHistoryFields[] = {
+        PM3_INT(MatchHistory, club_idx), PM3_INT(MatchHistory, played),  PM3_INT(MatchHistory, won),
+        PM3_INT(MatchHistory, draw),     PM3_INT(MatchHistory, goals_f), PM3_INT(MatchHistory, goals_a),
+};
+inline constexpr Record kMatchHistory = detail::describe<MatchHistory>("match_history", kMatchHistoryFields);
+
+using Tactic = detail::Element<decltype(Manager::tactic)>;
+inline constexpr Field kTacticFields[] = {
+        PM3_TEXT(Tactic, name),
+};
+inline constexpr Record kTactic = detail::describe<Tactic>("tactic", kTacticFields);
+
+inline constexpr Field kManagerFields[] = {
+        PM3_TEXT(Manager, name),
+        PM3_CLUB_UNCONFIRMED(Manager, club_idx),
+        PM3_INT(Manager, division),
+        PM3_INT(Manager, contract_length),
+        PM3_RECORD(Manager, price, kPrice),
+        PM3_INT(Manager, seating_history),
+        PM3_INT(Manager, terrace_history),
+        PM3_RECORD(Manager, bank_statement, kBankStatement),
+        PM3_RECORD(Manager, loan, kLoan),
+        PM3_RECORD(Manager, employee, kEmployee),
+        PM3_RECORD(Manager, assistant_manager, kAssistantManager),
+        PM3_INT(Manager, data120),
+        PM3_INT(Manager, youth_player_type),
+        PM3_INT(Manager, data121),
+        PM3_INT(Manager, youth_player),
+        PM3_BYTES(Manager, data147),
+        PM3_RECORD(Manager, scout, kScout),
+        PM3_INT(Manager, smnthn),
+        PM3_INT(Manager, number1),
+        PM3_INT(Manager, number2),
+        PM3_INT(Manager, number3),
+        PM3_INT(Manager, money_from_directors),
+        PM3_BYTES(Manager, data149),
+        PM3_RECORD(Manager, news, kNews),
+        PM3_INT(Manager, minus_one),
+        PM3_PLAYER_UNCONFIRMED(Manager, unknown_player_idx),
+        PM3_BYTES(Manager, data150),
+        PM3_RECORD(Manager, stadium, kStadium),
+        PM3_INT(Manager, numb01),
+        PM3_INT(Manager, numb02),
+        PM3_INT(Manager, numb03),
+        PM3_INT(Manager, numb04),
+        PM3_INT(Manager, managerial_rating_current),
+        PM3_INT(Manager, managerial_rating_start),
+        PM3_INT(Manager, directors_confidence_current),
+        PM3_INT(Manager, directors_confidence_start),
+        PM3_INT(Manager, supporters_confidence_current),
+        PM3_INT(Manager, supporters_confidence_start),
+        PM3_BYTES(Manager, head6),
+        PM3_PLAYER_UNCONFIRMED(Manager, player3_idx),
+        PM3_BYTES(Manager, magic4),
+        PM3_PLAYER_UNCONFIRMED(Manager, player4_idx),
+        PM3_BYTES(Manager, foot6),
+        PM3_RECORD(Manager, match_summary, kMatchSummary),
+        PM3_RECORD(Manager, league_history, kManagerLeagueHistory),
+        PM3_RECORD(Manager, titles, kTitle),
+        PM3_RECORD(Manager, manager_history, kManagerHistory),
+        PM3_BYTES(Manager, data159),
+        PM3_RECORD(Manager, previous_clubs, kPreviousClub),
+        PM3_INT(Manager, year_start_cur_club),
+        PM3_INT(Manager, manager_of_the_month_awards),
+        PM3_INT(Manager, manager_of_the_year_awards),
+        PM3_RECORD(Manager, match_history, kMatchHistory),
+        PM3_BYTES(Manager, data160),
+        PM3_RECORD(Manager, tactic, kTactic),
+};
+inline constexpr Record kManager = detail::describe<Manager>("manager", kManagerFields);
+
+// Unions are described through one view: the named leagues for club_index/table/top_scorers/cuppy, `all` for
+// last_results.
+inline constexpr Field kGameAFields[] = {
+        PM3_RECORD(gamea, club_index, kClubIndexLeagues),
+        PM3_RECORD(gamea, table, kTableByLeague),
+        PM3_INT(gamea, data000),
+        PM3_INT(gamea, data001),
+        PM3_INT(gamea, data002),
+        PM3_RECORD(gamea, top_scorers, kTopScorersByLeague),
+        PM3_INT(gamea, sorted_numbers),
+        PM3_RECORD(gamea, referee, kReferee),
+        PM3_RECORD(gamea, cuppy, kCupCompetitions),
+        PM3_BYTES(gamea, data095),
+        PM3_RECORD(gamea, the_charity_shield_history, kCupEntry),
+        PM3_RECORD(gamea, some_table, kSomeTableEntry),
+        detail::record<decltype(gamea::last_results.all)>("last_results", offsetof(gamea, last_results), kCupEntry),
+        PM3_RECORD(gamea, league, kLeagueHistory),
+        PM3_RECORD(gamea, cup, kCupHistory),
+        PM3_RECORD(gamea, fixture, kFixture),
+        PM3_BYTES(gamea, data100),
+        PM3_RECORD(gamea, transfer_market, kTransferListing),
+        PM3_BYTES(gamea, data10z),
+        PM3_RECORD(gamea, transfer, kTransfer),
+        PM3_BYTES(gamea, data101),
+        PM3_CLUB(gamea, retired_manager_club_idx),
+        PM3_CLUB(gamea, new_manager_club_idx),
+        PM3_TEXT(gamea, manager_name),
+        PM3_BYTES(gamea, data10w),
+        PM3_INT(gamea, turn),
+        PM3_INT(gamea, year),
+        PM3_INT(gamea, data10x),
+        PM3_RECORD(gamea, manager, kManager),
+        PM3_BYTES(gamea, data200),
+        PM3_INT(gamea, inc_number1),
+        PM3_INT(gamea, inc_number2),
+        PM3_INT(gamea, inc_number3),
+};
+inline constexpr Record kGameA = detail::describe<gamea>("gamea", kGameAFields);
+
+// ---- gameb ------------------------------------------------------------------------------------------------------
+
+using Kit = detail::Element<decltype(ClubRecord::kit)>;
+inline constexpr Field kKitFields[] = {
+        PM3_INT(Kit, shirt_design),
+        PM3_BITS(Kit, shirt_design, uint8_t, "shirt_primary_color_r", 0, 4),
+        PM3_BITS(Kit, shirt_design, uint8_t, "shirt_primary_color_g", 4, 4),
+        detail::bits<uint8_t>("shirt_primary_color_b", 2, 0, 4),
+        detail::bits<uint8_t>("shirt_secondary_color_r", 2, 4, 4),
+        detail::bits<uint8_t>("shirt_secondary_color_g", 3, 0, 4),
+        detail::bits<uint8_t>("shirt_secondary_color_b", 3, 4, 4),
+        detail::bits<uint8_t>("shorts_color_r", 4, 0, 4),
+        detail::bits<uint8_t>("shorts_color_g", 4, 4, 4),
+        detail::bits<uint8_t>("shorts_color_b", 5, 0, 4),
+        detail::bits<uint8_t>("socks_color_r", 5, 4, 4),
+        detail::bits<uint8_t>("socks_color_g", 6, 0, 4),
+        detail::bits<uint8_t>("socks_color_b", 6, 4, 4),
+};
+inline constexpr Record kKit = detail::describe<Kit>("kit", kKitFields);
+
+// Each timetable day is opponent, result (or packed score), and a type:5/game:3 byte.
+using TimetableDay = ClubRecord::TimetableDay;
+inline constexpr Field kTimetableDayFields[] = {
+        PM3_INT(TimetableDay, opponent_idx),
+        detail::integer<decltype(TimetableDay::outcome.result)>("result", offsetof(TimetableDay, outcome)),
+        detail::bits<uint8_t>("type", offsetof(TimetableDay, meta), 0, 5),
+        detail::bits<uint8_t>("game", offsetof(TimetableDay, meta), 5, 3),
+};
+inline constexpr Record kTimetableDay = detail::describe<TimetableDay>("day", kTimetableDayFields);
+
+using TimetableWeek = ClubRecord::TimetableWeek;
+inline constexpr Field kTimetableWeekFields[] = {
+        PM3_RECORD(TimetableWeek, day, kTimetableDay),
+};
+inline constexpr Record kTimetableWeek = detail::describe<TimetableWeek>("week", kTimetableWeekFields);
+
+using Timetable = ClubRecord::Timetable;
+inline constexpr Field kTimetableFields[] = {
+        PM3_RECORD(Timetable, week, kTimetableWeek),
+        PM3_INT(Timetable, end),
+};
+inline constexpr Record kTimetable = detail::describe<Timetable>("timetable", kTimetableFields);
+
+inline constexpr Field kClubFields[] = {
+        PM3_TEXT(ClubRecord, name),
+        PM3_TEXT(ClubRecord, manager),
+        PM3_INT(ClubRecord, bank_account),
+        PM3_TEXT(ClubRecord, stadium),
+        PM3_INT(ClubRecord, seating_avg),
+        PM3_INT(ClubRecord, seating_max),
+        PM3_BYTES(ClubRecord, padding),
+        PM3_PLAYER(ClubRecord, player_index),
+        PM3_BYTES(ClubRecord, misc000),
+        PM3_RECORD(ClubRecord, kit, kKit),
+        PM3_INT(ClubRecord, player_image),
+        PM3_INT(ClubRecord, weekly_league_position),
+        PM3_BYTES(ClubRecord, misc005),
+        PM3_INT(ClubRecord, league),
+        PM3_RECORD(ClubRecord, timetable, kTimetable),
+};
+inline constexpr Record kClub = detail::describe<ClubRecord>("club", kClubFields);
+
+inline constexpr Field kGameBFields[] = {
+        PM3_RECORD(gameb, club, kClub),
+};
+inline constexpr Record kGameB = detail::describe<gameb>("gameb", kGameBFields);
+
+// ---- gamec ------------------------------------------------------------------------------------------------------
+
+inline constexpr Field kPlayerFields[] = {
+        PM3_TEXT(PlayerRecord, name),
+        PM3_INT(PlayerRecord, u13),
+        PM3_INT(PlayerRecord, hn),
+        PM3_INT(PlayerRecord, u15),
+        PM3_INT(PlayerRecord, tk),
+        PM3_INT(PlayerRecord, u17),
+        PM3_INT(PlayerRecord, ps),
+        PM3_INT(PlayerRecord, u19),
+        PM3_INT(PlayerRecord, sh),
+        PM3_INT(PlayerRecord, u21),
+        PM3_INT(PlayerRecord, hd),
+        PM3_INT(PlayerRecord, u23),
+        PM3_INT(PlayerRecord, cr),
+        PM3_INT(PlayerRecord, u25),
+        PM3_INT(PlayerRecord, ft),
+        PM3_BITS(PlayerRecord, ft, uint8_t, "morl", 0, 4),
+        PM3_BITS(PlayerRecord, ft, uint8_t, "aggr", 4, 4),
+        detail::bits<uint8_t>("ins", offsetof(PlayerRecord, ft) + 2, 0, 2),
+        detail::bits<uint8_t>("age", offsetof(PlayerRecord, ft) + 2, 2, 6),
+        detail::bits<uint8_t>("foot", offsetof(PlayerRecord, ft) + 3, 0, 2),
+        detail::bits<uint8_t>("dpts", offsetof(PlayerRecord, ft) + 3, 2, 6),
+        PM3_INT(PlayerRecord, played),
+        PM3_INT(PlayerRecord, scored),
+        PM3_INT(PlayerRecord, unk2),
+        PM3_INT(PlayerRecord, wage),
+        PM3_INT(PlayerRecord, ins_cost),
+        PM3_INT(PlayerRecord, period),
+        PM3_BITS(PlayerRecord, period, uint8_t, "period_type", 0, 5),
+        PM3_BITS(PlayerRecord, period, uint8_t, "contract", 5, 3),
+        PM3_INT(PlayerRecord, unk5),
+        PM3_BITS(PlayerRecord, unk5, uint8_t, "train", 0, 4),
+        PM3_BITS(PlayerRecord, unk5, uint8_t, "intense", 4, 4),
+};
+inline constexpr Record kPlayer = detail::describe<PlayerRecord>("player", kPlayerFields);
+
+inline constexpr Field kGameCFields[] = {
+        PM3_RECORD(gamec, player, kPlayer),
+};
+inline constexpr Record kGameC = detail::describe<gamec>("gamec", kGameCFields);
+
+// ---- SAVES.DIR and PREFS ----------------------------------------------------------------------------------------
+
+using SavedGame = detail::Element<decltype(saves::game)>;
+using SavedManager = SavedGame::ManagerRecord;
+inline constexpr Field kSavedManagerFields[] = {
+        PM3_TEXT(SavedManager, name),
+        PM3_INT(SavedManager, club_idx),
+};
+inline constexpr Record kSavedManager = detail::describe<SavedManager>("manager", kSavedManagerFields);
+
+inline constexpr Field kSavedGameFields[] = {
+        PM3_INT(SavedGame, year),
+        PM3_INT(SavedGame, turn),
+        PM3_RECORD(SavedGame, manager, kSavedManager),
+        PM3_BYTES(SavedGame, misc000),
+};
+inline constexpr Record kSavedGame = detail::describe<SavedGame>("game", kSavedGameFields);
+
+inline constexpr Field kSavesFields[] = {
+        PM3_RECORD(saves, game, kSavedGame),
+};
+inline constexpr Record kSaves = detail::describe<saves>("saves", kSavesFields);
+
+using LeagueReports = decltype(prefs::league_reports);
+inline constexpr Field kLeagueReportsFields[] = {
+        PM3_INT(LeagueReports, hide_premier_league),   PM3_INT(LeagueReports, hide_division_one),
+        PM3_INT(LeagueReports, hide_division_two),     PM3_INT(LeagueReports, hide_division_three),
+        PM3_INT(LeagueReports, hide_conference_league),
+};
+inline constexpr Record kLeagueReports = detail::describe<LeagueReports>("league_reports", kLeagueReportsFields);
+
+using CupReports = decltype(prefs::cup_reports);
+inline constexpr Field kCupReportsFields[] = {
+        PM3_INT(CupReports, hide_fa_cup),          PM3_INT(CupReports, hide_league_cup),
+        PM3_INT(CupReports, hide_champions_cup),   PM3_INT(CupReports, hide_cup_winners_cup),
+        PM3_INT(CupReports, hide_uefa_cup),        PM3_INT(CupReports, hide_charity_shield),
+};
+inline constexpr Record kCupReports = detail::describe<CupReports>("cup_reports", kCupReportsFields);
+
+using ViewScreens = decltype(prefs::view_screens);
+inline constexpr Field kViewScreensFields[] = {
+        PM3_INT(ViewScreens, hide_results_monitor),
+        PM3_INT(ViewScreens, hide_next_matches),
+        PM3_INT(ViewScreens, hide_manager_of_the_month),
+};
+inline constexpr Record kViewScreens = detail::describe<ViewScreens>("view_screens", kViewScreensFields);
+
+using InteractiveMatches = decltype(prefs::interactive_matches);
+inline constexpr Field kInteractiveMatchesFields[] = {
+        PM3_INT(InteractiveMatches, match_graphics), PM3_INT(InteractiveMatches, unused1),
+        PM3_INT(InteractiveMatches, show_match_pictures), PM3_INT(InteractiveMatches, speed),
+        PM3_INT(InteractiveMatches, unk1),           PM3_INT(InteractiveMatches, unused3),
+};
+inline constexpr Record kInteractiveMatches =
+        detail::describe<InteractiveMatches>("interactive_matches", kInteractiveMatchesFields);
+
+using Audio = decltype(prefs::audio);
+inline constexpr Field kAudioFields[] = {
+        PM3_INT(Audio, mute_sound_effects),
+        PM3_INT(Audio, mute_music),
+};
+inline constexpr Record kAudio = detail::describe<Audio>("audio", kAudioFields);
+
+inline constexpr Field kPrefsFields[] = {
+        PM3_RECORD(prefs, league_reports, kLeagueReports),
+        PM3_RECORD(prefs, cup_reports, kCupReports),
+        PM3_INT(prefs, hide_friendlies),
+        PM3_RECORD(prefs, view_screens, kViewScreens),
+        PM3_RECORD(prefs, interactive_matches, kInteractiveMatches),
+        PM3_RECORD(prefs, audio, kAudio),
+};
+inline constexpr Record kPrefs = detail::describe<prefs>("prefs", kPrefsFields);
+
+#undef PM3_INT
+#undef PM3_CLUB
+#undef PM3_PLAYER
+#undef PM3_CLUB_UNCONFIRMED
+#undef PM3_PLAYER_UNCONFIRMED
+#undef PM3_TEXT
+#undef PM3_BYTES
+#undef PM3_RECORD
+#undef PM3_BITS
+
+// ---- Verification -----------------------------------------------------------------------------------------------
+
+// True if `record`'s fields cover every byte of it exactly once, in order, and so do all nested records.
+// Bitfields sharing a unit repeat its offset and must not overlap each other's bits.
+constexpr bool tiles(const Record &record) {
+    uint32_t end = 0;
+    uint64_t unitBits = 0;
+    const Field *previous = nullptr;
+    for (const Field &field : record) {
+        bool sharesUnit = field.kind == Kind::Bits && previous && previous->kind == Kind::Bits &&
+                          previous->offset == field.offset && previous->width == field.width;
+        if (sharesUnit) {
+            if ((unitBits & (uint64_t{field.mask} << field.shift)) != 0) {
+                return false;
+            }
+        } else {
+            if (field.offset != end) {
+                return false;
+            }
+            unitBits = 0;
+            end = field.offset + field.size();
+        }
+        if (field.kind == Kind::Bits) {
+            if (((uint64_t{field.mask} << field.shift) >> (field.width * 8)) != 0) {
+                return false;
+            }
+            unitBits |= uint64_t{field.mask} << field.shift;
+        }
+        if (field.kind == Kind::Record && (field.record->size != field.width || !tiles(*field.record))) {
+            return false;
+        }
+        previous = &field;
+    }
+    return end == record.size;
+}
+
+static_assert(sizeof(gamea) == kGameAFileSize && kGameA.size == kGameAFileSize && tiles(kGameA),
+              "gamea schema must cover the GAMEnA layout");
+static_assert(sizeof(gameb) == kGameBFileSize && kGameB.size == kGameBFileSize && tiles(kGameB),
+              "gameb schema must cover the GAMEnB layout");
+static_assert(sizeof(gamec) == kGameCFileSize && kGameC.size == kGameCFileSize && tiles(kGameC),
+              "gamec schema must cover the GAMEnC layout");
+static_assert(sizeof(saves) == kSavesDirFileSize && tiles(kSaves), "saves schema must cover SAVES.DIR");
+static_assert(sizeof(prefs) == kPrefsFileSize && tiles(kPrefs), "prefs schema must cover PREFS");
+static_assert(kDivisionSlots[0] == 22 && kDivisionSlots[1] == 24 && kDivisionSlots[2] == 24 &&
+                      kDivisionSlots[3] == 22 && kDivisionSlots[4] == 22,
+              "club_index division sizes");
+
+// ---- Runtime access ---------------------------------------------------------------------------------------------
+
+// Reads or writes one element of an Integer or Bits field; `element` points at its unit.
+int64_t readValue(const Field &field, const void *element);
+void writeValue(const Field &field, void *element, int64_t value);
+bool inRange(const Field &field, int64_t value);
+
+// Calls `visitor` for every leaf element under `record`, with a path such as "manager[1].news[3].amount".
+// Text and Bytes fields are visited once as a whole; Integer and Bits fields once per array element.
+using Visitor = std::function<void(const std::string &path, const Field &field, const uint8_t *element)>;
+void visit(const Record &record, const void *data, const Visitor &visitor);
+
+// A leaf element found by path; `offset` is where its unit starts within the record.
+struct Location {
+    const Field *field;
+    std::size_t offset;
+};
+
+// Resolves a path in visit()'s format, e.g. "club[17].bank_account". Empty if a name is unknown, an index is out
+// of range or missing, or the path ends at a nested record.
+std::optional<Location> lookup(const Record &record, const std::string &path);
+
+} // namespace pm3_schema
@@ -0,0 +1,209 @@
+// Field-level differences between two copies of a save struct, named through pm3_schema.
+#include "save_diff.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace save_diff {
+
+namespace {
+
+// Equal blocks are skipped with memcmp; only blocks that differ are scanned a word, then a byte, at a time.
+constexpr std::size_t kBlockSize = 256;
+
+uint64_t load64(const uint8_t *p) {
+    uint64_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+void addRange(std::vector<Range> &ranges, std::size_t offset, std::size_t length) {
+    if (!ranges.empty() && ranges.back().offset + ranges.back().length == offset) {
+        ranges.back().length += length;
+    } else {
+        ranges.push_back({offset, length});
+    }
+}
+
+std::string text(const uint8_t *p, std::size_t size) {
+    std::string value(reinterpret_cast<const char *>(p), strnlen(reinterpret_cast<const char *>(p), size));
+    value.erase(value.find_last_not_of(' ') + 1);
+    return value;
+}
+
+std::string hex(const uint8_t *p, std::size_t size) {
+    std::string value;
+    value.reserve(size * 2);
+    char digits[3];
+    for (std::size_t i = 0; i < size; ++i) {
+        std::snprintf(digits, sizeof(digits), "%02x", p[i]);
+        value += digits;
+    }
+    return value;
+}
+
+struct Walk {
+    const uint8_t *before;
+    const uint8_t *after;
+    std::size_t begin;
+    std::size_t end;
+    std::string path;
+    std::vector<Change> &out;
+};
+
+// An earlier range may already have reported this leaf: ranges are disjoint but one leaf can span two of them.
+bool reported(const std::vector<Change> &out, const pm3_schema::Field &field, std::size_t offset) {
+    for (auto it = out.rbegin(); it != out.rend() && it->offset == offset; ++it) {
+        if (it->field == &field) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void addLeaf(Walk &walk, const pm3_schema::Field &field, std::size_t start) {
+    if (field.kind == pm3_schema::Kind::Bytes) {
+        // Opaque blocks report each differing run on its own rather than the whole block.
+        std::size_t from = std::max(walk.begin, start);
+        std::size_t to = std::min(walk.end, start + field.width);
+        Change change;
+        change.path = walk.path;
+        change.field = &field;
+        change.offset = start;
+        change.byteOffset = from - start;
+        change.beforeText = hex(walk.before + from, to - from);
+        change.afterText = hex(walk.after + from, to - from);
+        walk.out.push_back(std::move(change));
+        return;
+    }
+    if (reported(walk.out, field, start)) {
+        return;
+    }
+
+    Change change;
+    change.path = walk.path;
+    change.field = &field;
+    change.offset = start;
+    if (field.kind == pm3_schema::Kind::Text) {
+        if (std::memcmp(walk.before + start, walk.after + start, field.width) == 0) {
+            return;
+        }
+        change.beforeText = text(walk.before + start, field.width);
+        change.afterText = text(walk.after + start, field.width);
+    } else {
+        change.before = pm3_schema::readValue(field, walk.before + start);
+        change.after = pm3_schema::readValue(field, walk.after + start);
+        if (change.before == change.after) {
+            return;
+        }
+    }
+    walk.out.push_back(std::move(change));
+}
+
+void collect(Walk &walk, const pm3_schema::Record &record, std::size_t base) {
+    for (const pm3_schema::Field &field : record) {
+        std::size_t fieldStart = base + field.offset;
+        std::size_t fieldEnd = fieldStart + field.size();
+        if (fieldEnd <= walk.begin || fieldStart >= walk.end) {
+            continue;
+        }
+        std::size_t mark = walk.path.size();
+        if (!walk.path.empty()) {
+            walk.path += '.';
+        }
+        walk.path += field.name;
+
+        std::size_t first = (std::max(walk.begin, fieldStart) - fieldStart) / field.width;
+        std::size_t last = (std::min(walk.end, fieldEnd) - 1 - fieldStart) / field.width;
+        std::size_t elementMark = walk.path.size();
+        for (std::size_t i = first; i <= last; ++i) {
+            if (field.count > 1) {
+                walk.path += '[';
+                walk.path += std::to_string(i);
+                walk.path += ']';
+            }
+            std::size_t start = fieldStart + i * field.width;
+            if (field.kind == pm3_schema::Kind::Record) {
+                collect(walk, *field.record, start);
+            } else {
+                addLeaf(walk, field, start);
+            }
+            walk.path.resize(elementMark);
+        }
+        walk.path.resize(mark);
+    }
+}
+
+} // namespace
+
+std::vector<Range> differingRanges(const void *before, const void *after, std::size_t size) {
+    const auto *a = static_cast<const uint8_t *>(before);
+    const auto *b = static_cast<const uint8_t *>(after);
+    std::vector<Range> ranges;
+    for (std::size_t block = 0; block < size; block += kBlockSize) {
+        std::size_t blockEnd = std::min(size, block + kBlockSize);
+        if (std::memcmp(a + block, b + block, blockEnd - block) == 0) {
+            continue;
+        }
+        std::size_t i = block;
+        while (i < blockEnd) {
+            if (i + 8 <= blockEnd && load64(a + i) == load64(b + i)) {
+                i += 8;
+            } else if (a[i] == b[i]) {
+                ++i;
+            } else {
+                std::size_t start = i;
+                while (i < blockEnd && a[i] != b[i]) {
+                    ++i;
+                }
+                addRange(ranges, start, i - start);
+            }
+        }
+    }
+    return ranges;
+}
+
+std::vector<Change> diff(const pm3_schema::Record &record, const void *before, const void *after) {
+    std::vector<Change> changes;
+    Walk walk{static_cast<const uint8_t *>(before), static_cast<const uint8_t *>(after), 0, 0, {}, changes};
+    for (const Range &range : differingRanges(before, after, record.size)) {
+        walk.begin = range.offset;
+        walk.end = range.offset + range.length;
+        collect(walk, record, 0);
+    }
+    return changes;
+}
+
+std::vector<Group> group(const std::vector<Change> &changes, const pm3_schema::Record &record, const void *after) {
+    std::vector<Group> groups;
+    for (const Change &change : changes) {
+        std::size_t dot = change.path.find('.');
+        std::string name = change.path.substr(0, dot);
+        if (groups.empty() || groups.back().name != name) {
+            Group next;
+            next.name = name;
+            // Label the group with the element's own name, e.g. the club or player name.
+            std::string member = name.substr(0, name.find('['));
+            for (const pm3_schema::Field &field : record) {
+                if (field.kind != pm3_schema::Kind::Record || member != field.name) {
+                    continue;
+                }
+                std::size_t index = (change.offset - field.offset) / field.width;
+                for (const pm3_schema::Field &inner : *field.record) {
+                    if (inner.kind == pm3_schema::Kind::Text && std::strcmp(inner.name, "name") == 0) {
+                        const auto *element = static_cast<const uint8_t *>(after) + field.offset + index * field.width;
+                        next.label = text(element + inner.offset, inner.width);
+                    }
+                }
+            }
+            groups.push_back(std::move(next));
+        }
+        Change relative = change;
+        relative.path = dot == std::string::npos ? std::string{} : change.path.substr(dot + 1);
+        groups.back().changes.push_back(std::move(relative));
+    }
+    return groups;
+}
+
+} // namespace save_diff
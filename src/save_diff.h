@@ -0,0 +1,47 @@
+// Field-level differences between two copies of a save struct, named through pm3_schema.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "pm3_schema.h"
+
+namespace save_diff {
+
+struct Range {
+    std::size_t offset;
+    std::size_t length;
+};
+
+// Byte ranges where `before` and `after` differ, found a machine word at a time.
+std::vector<Range> differingRanges(const void *before, const void *after, std::size_t size);
+
+// One changed leaf. Numeric fields fill before/after; Text fields fill the texts; Bytes fields give one run of
+// changed bytes as hex, starting `byteOffset` bytes into the field.
+struct Change {
+    std::string path;
+    const pm3_schema::Field *field = nullptr;
+    std::size_t offset = 0;
+    int64_t before = 0;
+    int64_t after = 0;
+    std::string beforeText;
+    std::string afterText;
+    std::size_t byteOffset = 0;
+};
+
+// Every leaf of `record` whose value differs, in offset order, with paths such as "club[17].bank_account".
+std::vector<Change> diff(const pm3_schema::Record &record, const void *before, const void *after);
+
+// Changes under one top-level element, e.g. "club[17]" or "player[2011]", with paths relative to it.
+// `label` is the element's `name` text field in the newer copy, when it has one.
+struct Group {
+    std::string name;
+    std::string label;
+    std::vector<Change> changes;
+};
+
+std::vector<Group> group(const std::vector<Change> &changes, const pm3_schema::Record &record, const void *after);
+
+} // namespace save_diff
@@ -0,0 +1,530 @@
+// Tabular export of a save (players, clubs, league tables, top scorers, history) as CSV, JSON Lines or columns.
+#include "save_export.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+#include "pm3_schema.h"
+
+namespace save_export {
+
+namespace {
+
+constexpr char kColumnsMagic[8] = {'P', 'M', '3', 'C', 'O', 'L', 'S', '1'};
+
+// Fixed-width PM3 text up to the first NUL, without the space padding.
+std::string_view trimmed(const uint8_t *text, std::size_t width) {
+    const char *chars = reinterpret_cast<const char *>(text);
+    std::size_t length = 0;
+    while (length < width && chars[length] != '\0') {
+        ++length;
+    }
+    while (length > 0 && chars[length - 1] == ' ') {
+        --length;
+    }
+    return {chars, length};
+}
+
+class CsvWriter : public TableWriter {
+public:
+    CsvWriter(const std::filesystem::path &path, const std::vector<Column> &columns) : out(path) {
+        for (std::size_t i = 0; i < columns.size(); ++i) {
+            if (i > 0) {
+                out.put(',');
+            }
+            out.write(columns[i].name.data(), columns[i].name.size());
+        }
+        out.put('\n');
+    }
+
+    void integer(int64_t value) override {
+        separate();
+        out.integer(value);
+    }
+
+    void text(std::string_view value) override {
+        separate();
+        if (value.find_first_of(",\"\r\n") == std::string_view::npos) {
+            out.write(value.data(), value.size());
+            return;
+        }
+        out.put('"');
+        for (char c : value) {
+            if (c == '"') {
+                out.put('"');
+            }
+            out.put(c);
+        }
+        out.put('"');
+    }
+
+    void endRow() override {
+        out.put('\n');
+        first = true;
+    }
+
+    void finish() override {
+        out.close();
+    }
+
+private:
+    void separate() {
+        if (!first) {
+            out.put(',');
+        }
+        first = false;
+    }
+
+    Output out;
+    bool first = true;
+};
+
+class JsonLinesWriter : public TableWriter {
+public:
+    JsonLinesWriter(const std::filesystem::path &path, const std::vector<Column> &columns) : out(path) {
+        for (std::size_t i = 0; i < columns.size(); ++i) {
+            keys.push_back((i == 0 ? "{\"" : ",\"") + columns[i].name + "\":");
+        }
+    }
+
+    void integer(int64_t value) override {
+        key();
+        out.integer(value);
+    }
+
+    // PM3 text is single-byte; bytes above 0x7F are written as Latin-1 escapes so every line is valid UTF-8.
+    void text(std::string_view value) override {
+        static constexpr char kHex[] = "0123456789abcdef";
+        key();
+        out.put('"');
+        for (char c : value) {
+            auto byte = static_cast<unsigned char>(c);
+            if (byte == '"' || byte == '\\') {
+                out.put('\\');
+                out.put(c);
+            } else if (byte < 0x20 || byte >= 0x7F) {
+                char escape[6] = {'\\', 'u', '0', '0', kHex[byte >> 4], kHex[byte & 0xF]};
+                out.write(escape, sizeof(escape));
+            } else {
+                out.put(c);
+            }
+        }
+        out.put('"');
+    }
+
+    void endRow() override {
+        out.write("}\n", 2);
+        column = 0;
+    }
+
+    void finish() override {
+        out.close();
+    }
+
+private:
+    void key() {
+        const std::string &prefix = keys[column++];
+        out.write(prefix.data(), prefix.size());
+    }
+
+    Output out;
+    std::vector<std::string> keys;
+    std::size_t column = 0;
+};
+
+// Columns are only known to be complete at the end, so rows are collected per column and written by finish().
+class ColumnsWriter : public TableWriter {
+public:
+    ColumnsWriter(std::filesystem::path path, std::vector<Column> columns)
+        : path(std::move(path)), columns(std::move(columns)), integers(this->columns.size()),
+          texts(this->columns.size()) {}
+
+    void integer(int64_t value) override {
+        integers[column++].push_back(value);
+    }
+
+    void text(std::string_view value) override {
+        texts[column++].emplace_back(value);
+    }
+
+    void endRow() override {
+        column = 0;
+        ++rows;
+    }
+
+    void finish() override {
+        Output out(path);
+        out.write(kColumnsMagic, sizeof(kColumnsMagic));
+        putLe(out, static_cast<uint32_t>(rows));
+        putLe(out, static_cast<uint16_t>(columns.size()));
+        std::vector<std::size_t> widths(columns.size(), sizeof(int64_t));
+        for (std::size_t i = 0; i < columns.size(); ++i) {
+            if (columns[i].type == ColumnType::Text) {
+                widths[i] = 1;
+                for (const std::string &value : texts[i]) {
+                    widths[i] = std::max(widths[i], value.size());
+                }
+            }
+            out.put(static_cast<char>(columns[i].type));
+            putLe(out, static_cast<uint16_t>(widths[i]));
+            out.put(static_cast<char>(columns[i].name.size()));
+            out.write(columns[i].name.data(), columns[i].name.size());
+        }
+        for (std::size_t i = 0; i < columns.size(); ++i) {
+            if (columns[i].type == ColumnType::Integer) {
+                for (int64_t value : integers[i]) {
+                    putLe(out, value);
+                }
+                continue;
+            }
+            for (const std::string &value : texts[i]) {
+                out.write(value.data(), value.size());
+                for (std::size_t pad = value.size(); pad < widths[i]; ++pad) {
+                    out.put('\0');
+                }
+            }
+        }
+        out.close();
+    }
+
+private:
+    template <typename T>
+    static void putLe(Output &out, T value) {
+        char bytes[sizeof(T)];
+        for (std::size_t i = 0; i < sizeof(T); ++i) {
+            bytes[i] = static_cast<char>(static_cast<uint64_t>(value) >> (8 * i));
+        }
+        out.write(bytes, sizeof(T));
+    }
+
+    std::filesystem::path path;
+    std::vector<Column> columns;
+    std::vector<std::vector<int64_t>> integers;
+    std::vector<std::vector<std::string>> texts;
+    std::size_t column = 0;
+    std::size_t rows = 0;
+};
+
+// The single-valued Integer, Bits and Text fields of `record`, in schema order. Bitfields such as morl/aggr get a
+// column each; arrays and bytes not yet understood are left out.
+bool exported(const pm3_schema::Field &field) {
+    return field.count == 1 && (field.isNumeric() || field.kind == pm3_schema::Kind::Text);
+}
+
+void addColumns(std::vector<Column> &columns, const pm3_schema::Record &record) {
+    for (const pm3_schema::Field &field : record) {
+        if (exported(field)) {
+            columns.push_back({field.name, field.isNumeric() ? ColumnType::Integer : ColumnType::Text});
+        }
+    }
+}
+
+void writeValues(TableWriter &out, const pm3_schema::Record &record, const uint8_t *element) {
+    for (const pm3_schema::Field &field : record) {
+        if (!exported(field)) {
+            continue;
+        }
+        if (field.isNumeric()) {
+            out.integer(pm3_schema::readValue(field, element + field.offset));
+        } else {
+            out.text(trimmed(element + field.offset, field.width));
+        }
+    }
+}
+
+class Exporter {
+public:
+    Exporter(const GameState &state, const std::filesystem::path &dir, Format format)
+        : state(state), dir(dir), format(format) {}
+
+    void players() {
+        std::vector<Column> columns = {{"idx", ColumnType::Integer},
+                                       {"club_idx", ColumnType::Integer},
+                                       {"club", ColumnType::Text}};
+        addColumns(columns, pm3_schema::kPlayer);
+        auto out = open("players", std::move(columns));
+        for (int16_t idx = 0; idx < pm3_schema::kPlayerCount; ++idx) {
+            out->integer(idx);
+            club(*out, state.squadPlace(idx).clubIdx);
+            writeValues(*out, pm3_schema::kPlayer, reinterpret_cast<const uint8_t *>(&state.player(idx)));
+            row(*out);
+        }
+        done(*out);
+    }
+
+    void clubs() {
+        std::vector<Column> columns = {{"idx", ColumnType::Integer},
+                                       {"division", ColumnType::Text},
+                                       {"squad_size", ColumnType::Integer}};
+        addColumns(columns, pm3_schema::kClub);
+        auto out = open("clubs", std::move(columns));
+        for (int idx = 0; idx < kClubIdxMax; ++idx) {
+            const ClubRecord &record = state.club(idx);
+            out->integer(idx);
+            out->text(divisionOf(record));
+            int squad = 0;
+            for (int16_t player : record.player_index) {
+                squad += player >= 0 ? 1 : 0;
+            }
+            out->integer(squad);
+            writeValues(*out, pm3_schema::kClub, reinterpret_cast<const uint8_t *>(&record));
+            row(*out);
+        }
+        done(*out);
+    }
+
+    // table and top_scorers hold one array per division, in divisionNames order. PM3 keeps the table rows in its
+    // own order, so they are written by position as the Load screen ranks them.
+    void leagueTable() {
+        std::vector<Column> columns = {{"division", ColumnType::Text},
+                                       {"position", ColumnType::Integer},
+                                       {"club", ColumnType::Text}};
+        addColumns(columns, pm3_schema::kTableDivision);
+        auto out = open("league_table", std::move(columns));
+        const auto *table = reinterpret_cast<const uint8_t *>(&state.game.table);
+        for (std::size_t d = 0; d < pm3_schema::kTableByLeague.fieldCount; ++d) {
+            const pm3_schema::Field &division = pm3_schema::kTableByLeague.fields[d];
+            const auto *rows = reinterpret_cast<const gamea::TableDivision *>(table + division.offset);
+            std::vector<std::pair<int, int>> ranked; // position, slot
+            for (int slot = 0; slot < static_cast<int>(division.count); ++slot) {
+                if (rows[slot].club_idx >= 0 && rows[slot].club_idx < kClubIdxMax) {
+                    ranked.emplace_back(pm3_schema::leaguePosition(rows, static_cast<int>(division.count), slot),
+                                        slot);
+                }
+            }
+            std::sort(ranked.begin(), ranked.end());
+            for (const auto &[position, slot] : ranked) {
+                const gamea::TableDivision &entry = rows[slot];
+                out->text(divisionNames[d]);
+                out->integer(position);
+                out->text(clubName(entry.club_idx));
+                writeValues(*out, pm3_schema::kTableDivision, reinterpret_cast<const uint8_t *>(&entry));
+                row(*out);
+            }
+        }
+        done(*out);
+    }
+
+    void topScorers() {
+        std::vector<Column> columns = {{"division", ColumnType::Text},
+                                       {"rank", ColumnType::Integer},
+                                       {"player", ColumnType::Text},
+                                       {"club", ColumnType::Text}};
+        addColumns(columns, pm3_schema::kTopScorerEntry);
+        auto out = open("top_scorers", std::move(columns));
+        const auto *scorers = reinterpret_cast<const uint8_t *>(&state.game.top_scorers);
+        for (std::size_t d = 0; d < pm3_schema::kTopScorersByLeague.fieldCount; ++d) {
+            const pm3_schema::Field &division = pm3_schema::kTopScorersByLeague.fields[d];
+            for (uint32_t rank = 0; rank < division.count; ++rank) {
+                const auto &entry = *reinterpret_cast<const gamea::TopScorerEntry *>(
+                        scorers + division.offset + rank * division.width);
+                if (entry.player_idx < 0 || entry.player_idx >= pm3_schema::kPlayerCount) {
+                    continue;
+                }
+                out->text(divisionNames[d]);
+                out->integer(rank + 1);
+                out->text(playerName(entry.player_idx));
+                out->text(clubName(entry.club_idx));
+                writeValues(*out, pm3_schema::kTopScorerEntry, reinterpret_cast<const uint8_t *>(&entry));
+                row(*out);
+            }
+        }
+        done(*out);
+    }
+
+    void leagueHistory() {
+        auto out = open("league_history", {{"division", ColumnType::Text},
+                                           {"year", ColumnType::Integer},
+                                           {"club_idx", ColumnType::Integer},
+                                           {"club", ColumnType::Text}});
+        for (std::size_t d = 0; d < std::size(state.game.league); ++d) {
+            for (const auto &entry : state.game.league[d].history) {
+                if (entry.year == 0) {
+                    continue;
+                }
+                out->text(d < divisionNames.size() ? divisionNames[d] : "");
+                out->integer(entry.year);
+                club(*out, entry.club_idx);
+                row(*out);
+            }
+        }
+        done(*out);
+    }
+
+    void cupHistory() {
+        std::vector<Column> columns = {{"cup", ColumnType::Integer},
+                                       {"winner", ColumnType::Text},
+                                       {"runner_up", ColumnType::Text}};
+        addColumns(columns, pm3_schema::kCupHistoryEntry);
+        auto out = open("cup_history", std::move(columns));
+        for (std::size_t c = 0; c < std::size(state.game.cup); ++c) {
+            for (const auto &entry : state.game.cup[c].history) {
+                if (entry.year == 0) {
+                    continue;
+                }
+                out->integer(static_cast<int64_t>(c));
+                out->text(clubName(entry.club_idx_winner));
+                out->text(clubName(entry.club_idx_runner_up));
+                writeValues(*out, pm3_schema::kCupHistoryEntry, reinterpret_cast<const uint8_t *>(&entry));
+                row(*out);
+            }
+        }
+        done(*out);
+    }
+
+    Summary summary;
+
+private:
+    std::unique_ptr<TableWriter> open(const std::string &table, std::vector<Column> columns) {
+        return openTable(format, dir, table, std::move(columns));
+    }
+
+    void row(TableWriter &out) {
+        out.endRow();
+        ++summary.rows;
+    }
+
+    void done(TableWriter &out) {
+        out.finish();
+        ++summary.tables;
+    }
+
+    std::string_view clubName(int idx) const {
+        if (idx < 0 || idx >= kClubIdxMax) {
+            return {};
+        }
+        const ClubRecord &record = state.club(idx);
+        return trimmed(reinterpret_cast<const uint8_t *>(record.name), sizeof(record.name));
+    }
+
+    std::string_view playerName(int idx) const {
+        const PlayerRecord &record = state.player(static_cast<int16_t>(idx));
+        return trimmed(reinterpret_cast<const uint8_t *>(record.name), sizeof(record.name));
+    }
+
+    void club(TableWriter &out, int idx) const {
+        out.integer(idx);
+        out.text(clubName(idx));
+    }
+
+    static std::string_view divisionOf(const ClubRecord &record) {
+        for (std::size_t d = 0; d < divisionHex.size(); ++d) {
+            if (record.league == divisionHex[d]) {
+                return divisionNames[d];
+            }
+        }
+        return {};
+    }
+
+    const GameState &state;
+    const std::filesystem::path &dir;
+    Format format;
+};
+
+} // namespace
+
+const char *extension(Format format) {
+    switch (format) {
+        case Format::Csv:
+            return "csv";
+        case Format::JsonLines:
+            return "jsonl";
+        default:
+            return "pm3c";
+    }
+}
+
+bool parseFormat(const std::string &name, Format &format) {
+    if (name == "csv") {
+        format = Format::Csv;
+    } else if (name == "jsonl" || name == "json") {
+        format = Format::JsonLines;
+    } else if (name == "columns" || name == "pm3c") {
+        format = Format::Columns;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+Output::Output(const std::filesystem::path &path) : path(path) {
+    file = std::fopen(path.string().c_str(), "wb");
+    if (!file) {
+        throw std::runtime_error("Could not create " + path.string());
+    }
+}
+
+Output::~Output() {
+    if (file) {
+        std::fwrite(buffer, 1, used, file);
+        std::fclose(file);
+    }
+}
+
+void Output::write(const void *data, std::size_t size) {
+    if (size > sizeof(buffer) - used) {
+        drain();
+        if (size > sizeof(buffer)) {
+            if (std::fwrite(data, 1, size, file) != size) {
+                throw std::runtime_error("Could not write " + path.string());
+            }
+            return;
+        }
+    }
+    std::memcpy(buffer + used, data, size);
+    used += size;
+}
+
+void Output::integer(int64_t value) {
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    write(digits, static_cast<std::size_t>(result.ptr - digits));
+}
+
+void Output::close() {
+    drain();
+    std::FILE *closing = file;
+    file = nullptr;
+    if (std::fclose(closing) != 0) {
+        throw std::runtime_error("Could not write " + path.string());
+    }
+}
+
+void Output::drain() {
+    if (used > 0 && std::fwrite(buffer, 1, used, file) != used) {
+        used = 0;
+        throw std::runtime_error("Could not write " + path.string());
+    }
+    used = 0;
+}
+
+std::unique_ptr<TableWriter> openTable(Format format, const std::filesystem::path &dir, const std::string &table,
+                                       std::vector<Column> columns) {
+    std::filesystem::path path = dir / (table + "." + extension(format));
+    switch (format) {
+        case Format::Csv:
+            return std::make_unique<CsvWriter>(path, columns);
+        case Format::JsonLines:
+            return std::make_unique<JsonLinesWriter>(path, columns);
+        default:
+            return std::make_unique<ColumnsWriter>(path, std::move(columns));
+    }
+}
+
+Summary exportGame(const GameState &state, const std::filesystem::path &dir, Format format) {
+    std::filesystem::create_directories(dir);
+    Exporter exporter(state, dir, format);
+    exporter.players();
+    exporter.clubs();
+    exporter.leagueTable();
+    exporter.topScorers();
+    exporter.leagueHistory();
+    exporter.cupHistory();
+    return exporter.summary;
+}
+
+} // namespace save_export
@@ -0,0 +1,93 @@
+// Tabular export of a save (players, clubs, league tables, top scorers, history) as CSV, JSON Lines or columns.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "pm3_data.h"
+
+namespace save_export {
+
+enum class Format {
+    Csv,
+    JsonLines,
+    // One contiguous array per column, so a column can be read without touching the others:
+    //   "PM3COLS1", u32 rows, u16 columns,
+    //   per column: u8 type (1 = int64, 2 = text), u16 width, u8 name length, name,
+    //   then per column, in the same order, rows * width bytes (little-endian int64s, or NUL-padded text).
+    Columns,
+};
+
+enum class ColumnType : uint8_t {
+    Integer = 1,
+    Text = 2,
+};
+
+struct Column {
+    std::string name;
+    ColumnType type;
+};
+
+// "csv", "jsonl", "pm3c"
+const char *extension(Format format);
+bool parseFormat(const std::string &name, Format &format);
+
+// Writes through a 64 KB buffer with no iostream formatting. Throws std::runtime_error if the file cannot be
+// written.
+class Output {
+public:
+    explicit Output(const std::filesystem::path &path);
+    ~Output();
+    Output(const Output &) = delete;
+    Output &operator=(const Output &) = delete;
+
+    void write(const void *data, std::size_t size);
+    void put(char c) {
+        if (used == sizeof(buffer)) {
+            drain();
+        }
+        buffer[used++] = c;
+    }
+    void integer(int64_t value);
+    // Flushes and closes; the destructor does the same but cannot report errors.
+    void close();
+
+private:
+    void drain();
+
+    std::filesystem::path path;
+    std::FILE *file = nullptr;
+    char buffer[64 * 1024];
+    std::size_t used = 0;
+};
+
+// Takes one row at a time, values in column order.
+class TableWriter {
+public:
+    virtual ~TableWriter() = default;
+    virtual void integer(int64_t value) = 0;
+    virtual void text(std::string_view value) = 0;
+    virtual void endRow() = 0;
+    virtual void finish() = 0;
+};
+
+// Opens `<dir>/<table>.<extension>`.
+std::unique_ptr<TableWriter> openTable(Format format, const std::filesystem::path &dir, const std::string &table,
+                                       std::vector<Column> columns);
+
+struct Summary {
+    std::size_t tables = 0;
+    std::size_t rows = 0;
+};
+
+// Writes players, clubs, league_table, top_scorers, league_history and cup_history for one save into `dir`.
+// Bitfields are split into their own columns and club and player indices come with their names.
+Summary exportGame(const GameState &state, const std::filesystem::path &dir, Format format);
+
+} // namespace save_export
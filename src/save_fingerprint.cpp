@@ -0,0 +1,139 @@
+// CRC32C fingerprints of save slot files, cached in a sidecar next to the backups.
+#include "save_fingerprint.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <system_error>
+
+#include "crc32c.h"
+#include "pm3_defs.hh"
+#include "save_journal.h"
+
+namespace save_fingerprint {
+
+namespace {
+constexpr const char *kSidecarHeader = "PM3000-CRC 1";
+
+std::string hex32(uint32_t value) {
+    char buffer[9];
+    std::snprintf(buffer, sizeof(buffer), "%08x", value);
+    return buffer;
+}
+} // namespace
+
+FileFingerprint compute(const void *data, std::size_t size) {
+    FileFingerprint fingerprint;
+    fingerprint.size = size;
+    const auto *bytes = static_cast<const uint8_t *>(data);
+    fingerprint.chunks.reserve((size + kChunkSize - 1) / kChunkSize);
+    for (std::size_t offset = 0; offset < size; offset += kChunkSize) {
+        std::size_t length = std::min(kChunkSize, size - offset);
+        fingerprint.chunks.push_back(crc32c::compute(bytes + offset, length));
+        fingerprint.crc = crc32c::extend(fingerprint.crc, bytes + offset, length);
+    }
+    return fingerprint;
+}
+
+std::vector<Region> changedRegions(const FileFingerprint &before, const FileFingerprint &after) {
+    std::vector<Region> regions;
+    if (before.size == after.size && before.crc == after.crc) {
+        return regions;
+    }
+
+    std::size_t common = std::min(before.chunks.size(), after.chunks.size());
+    for (std::size_t i = 0; i < after.chunks.size(); ++i) {
+        if (i < common && before.chunks[i] == after.chunks[i]) {
+            continue;
+        }
+        std::size_t offset = i * kChunkSize;
+        std::size_t length = std::min<std::size_t>(kChunkSize, after.size - offset);
+        if (!regions.empty() && regions.back().offset + regions.back().length == offset) {
+            regions.back().length += length;
+        } else {
+            regions.push_back({offset, length});
+        }
+    }
+    return regions;
+}
+
+int64_t writeTimeOf(const std::filesystem::path &path) {
+    std::error_code ec;
+    auto time = std::filesystem::last_write_time(path, ec);
+    return ec ? 0 : static_cast<int64_t>(time.time_since_epoch().count());
+}
+
+bool matchesDisk(const FileFingerprint &fingerprint, const std::filesystem::path &path) {
+    std::error_code ec;
+    auto size = std::filesystem::file_size(path, ec);
+    return !ec && size == fingerprint.size && fingerprint.writeTime != 0 && writeTimeOf(path) == fingerprint.writeTime;
+}
+
+std::filesystem::path sidecarPath(const std::filesystem::path &backupDir, int gameNumber) {
+    return backupDir / (std::string{kGameFilePrefix} + std::to_string(gameNumber) + kSidecarSuffix);
+}
+
+bool read(const std::filesystem::path &sidecar, SlotFingerprint &slot) {
+    std::ifstream in(sidecar);
+    std::string line;
+    if (!std::getline(in, line) || line != kSidecarHeader) {
+        return false;
+    }
+
+    SlotFingerprint parsed;
+    int file = -1;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string tag;
+        fields >> tag;
+        if (tag == "file" && file + 1 < kSlotFileCount) {
+            FileFingerprint &fingerprint = parsed.files[++file];
+            long long writeTime = 0;
+            std::string crc;
+            fields >> fingerprint.size >> writeTime >> crc;
+            fingerprint.writeTime = writeTime;
+            fingerprint.crc = static_cast<uint32_t>(std::strtoul(crc.c_str(), nullptr, 16));
+        } else if (tag == "chunks" && file >= 0) {
+            std::string crc;
+            while (fields >> crc) {
+                parsed.files[file].chunks.push_back(static_cast<uint32_t>(std::strtoul(crc.c_str(), nullptr, 16)));
+            }
+        } else if (tag == "backed-up") {
+            parsed.backedUp = true;
+        } else if (tag == "end") {
+            if (file + 1 != kSlotFileCount) {
+                return false;
+            }
+            slot = std::move(parsed);
+            return true;
+        } else {
+            return false;
+        }
+    }
+    return false;
+}
+
+void write(const std::filesystem::path &sidecar, const SlotFingerprint &slot) {
+    std::ostringstream text;
+    text << kSidecarHeader << "\n";
+    for (const auto &fingerprint : slot.files) {
+        text << "file " << fingerprint.size << " " << static_cast<long long>(fingerprint.writeTime) << " "
+             << hex32(fingerprint.crc) << "\nchunks";
+        for (uint32_t crc : fingerprint.chunks) {
+            text << " " << hex32(crc);
+        }
+        text << "\n";
+    }
+    if (slot.backedUp) {
+        text << "backed-up\n";
+    }
+    text << "end\n";
+
+    std::filesystem::create_directories(sidecar.parent_path());
+    std::string body = text.str();
+    save_journal::replaceFileDurably(sidecar, body.data(), body.size());
+}
+
+} // namespace save_fingerprint
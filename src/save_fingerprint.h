@@ -0,0 +1,51 @@
+// CRC32C fingerprints of save slot files, cached in a sidecar next to the backups.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace save_fingerprint {
+
+inline constexpr std::size_t kChunkSize = 4096;
+inline constexpr int kSlotFileCount = 3;
+inline constexpr const char *kSidecarSuffix = ".CRC";
+
+struct Region {
+    std::size_t offset;
+    std::size_t length;
+};
+
+// Whole-file and per-4 KB-chunk CRC32C. `size` and `writeTime` describe the file on disk when the fingerprint
+// was recorded, so a later stat() is enough to tell whether it still applies.
+struct FileFingerprint {
+    uint64_t size = 0;
+    int64_t writeTime = 0;
+    uint32_t crc = 0;
+    std::vector<uint32_t> chunks;
+};
+
+struct SlotFingerprint {
+    FileFingerprint files[kSlotFileCount];
+    // Set once the backup store holds exactly these contents; a backup of an unchanged slot is then skipped.
+    bool backedUp = false;
+};
+
+FileFingerprint compute(const void *data, std::size_t size);
+
+// Chunks whose CRCs differ, merged into contiguous regions. A size change reports the whole tail.
+std::vector<Region> changedRegions(const FileFingerprint &before, const FileFingerprint &after);
+
+int64_t writeTimeOf(const std::filesystem::path &path);
+// True if `path` still has the size and modification time recorded in `fingerprint`.
+bool matchesDisk(const FileFingerprint &fingerprint, const std::filesystem::path &path);
+
+// <saves>/PM3000/GAMEn.CRC
+std::filesystem::path sidecarPath(const std::filesystem::path &backupDir, int gameNumber);
+bool read(const std::filesystem::path &sidecar, SlotFingerprint &slot);
+// Replaces the sidecar atomically. The sidecar is only a cache, so its directory is not synced.
+void write(const std::filesystem::path &sidecar, const SlotFingerprint &slot);
+
+} // namespace save_fingerprint
@@ -0,0 +1,487 @@
+// Crash-consistent multi-file commits for save slots (temp files + fsync + rename, with an intent journal).
+#include "save_journal.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#endif
+#endif
+
+namespace save_journal {
+
+namespace {
+constexpr const char *kJournalHeader = "PM3000-JOURNAL 1";
+
+std::filesystem::path tempPathFor(const std::filesystem::path &target) {
+    std::filesystem::path temp = target;
+    temp += kTempSuffix;
+    return temp;
+}
+
+// Flushes `directory` and every subdirectory the transaction's files live in, so each rename is on disk.
+template <typename Lines> void syncDirectories(const std::filesystem::path &directory, const Lines &lines) {
+    std::vector<std::filesystem::path> parents{directory};
+    for (const auto &line : lines) {
+        std::filesystem::path parent = (directory / line.fileName).parent_path();
+        if (std::find(parents.begin(), parents.end(), parent) == parents.end()) {
+            parents.push_back(parent);
+        }
+    }
+    for (const auto &parent : parents) {
+        syncDirectory(parent);
+    }
+}
+
+bool isTempFile(const std::filesystem::path &path) {
+    const std::string name = path.filename().string();
+    const std::string suffix = kTempSuffix;
+    return name.size() > suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+struct JournalLine {
+    bool patch = false;
+    bool removal = false;
+    std::string fileName;
+    std::size_t offset = 0;
+    std::size_t length = 0;
+};
+
+std::vector<JournalLine> readJournal(const std::filesystem::path &journalPath, bool &complete) {
+    std::vector<JournalLine> lines;
+    complete = false;
+
+    std::ifstream in(journalPath);
+    std::string line;
+    if (!std::getline(in, line) || line != kJournalHeader) {
+        return lines;
+    }
+
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string tag;
+        fields >> tag;
+        JournalLine entry;
+        if (tag == "R" && (fields >> entry.fileName)) {
+            lines.push_back(entry);
+        } else if (tag == "D" && (fields >> entry.fileName)) {
+            entry.removal = true;
+            lines.push_back(entry);
+        } else if (tag == "P" && (fields >> entry.fileName >> entry.offset >> entry.length)) {
+            entry.patch = true;
+            lines.push_back(entry);
+        } else if (tag == "END") {
+            std::size_t count = 0;
+            complete = (fields >> count) && count == lines.size();
+            break;
+        } else {
+            break;
+        }
+    }
+    return lines;
+}
+
+std::vector<uint8_t> readFile(const std::filesystem::path &path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<uint8_t>((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+// Writes each range of `data` (laid out back to back) at its offset in an existing file, then flushes it.
+template <typename Ranges>
+void patchFileDurably(const std::filesystem::path &path, const Ranges &ranges, const uint8_t *data) {
+#if defined(_WIN32)
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Could not open file for patching: " + path.string());
+    }
+    bool ok = true;
+    for (const auto &range : ranges) {
+        LARGE_INTEGER position;
+        position.QuadPart = static_cast<LONGLONG>(range.offset);
+        DWORD put = 0;
+        ok = ok && SetFilePointerEx(file, position, nullptr, FILE_BEGIN) &&
+             WriteFile(file, data, static_cast<DWORD>(range.length), &put, nullptr) && put == range.length;
+        data += range.length;
+    }
+    ok = ok && FlushFileBuffers(file);
+    CloseHandle(file);
+    if (!ok) {
+        throw std::runtime_error("Could not patch file: " + path.string());
+    }
+#else
+    int fd = ::open(path.c_str(), O_WRONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Could not open file for patching: " + path.string());
+    }
+    for (const auto &range : ranges) {
+        std::size_t done = 0;
+        while (done < range.length) {
+            ssize_t put = ::pwrite(fd, data + done, range.length - done, static_cast<off_t>(range.offset + done));
+            if (put <= 0) {
+                ::close(fd);
+                throw std::runtime_error("Could not patch file: " + path.string());
+            }
+            done += static_cast<std::size_t>(put);
+        }
+        data += range.length;
+    }
+    if (::fsync(fd) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Could not flush file: " + path.string());
+    }
+    ::close(fd);
+#endif
+}
+} // namespace
+
+void writeFileDurably(const std::filesystem::path &path, const void *data, std::size_t size) {
+#if defined(_WIN32)
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Could not open file for writing: " + path.string());
+    }
+    DWORD put = 0;
+    bool ok = WriteFile(file, data, static_cast<DWORD>(size), &put, nullptr) && put == size && FlushFileBuffers(file);
+    CloseHandle(file);
+    if (!ok) {
+        throw std::runtime_error("Could not write file: " + path.string());
+    }
+#else
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Could not open file for writing: " + path.string());
+    }
+    const auto *src = static_cast<const uint8_t *>(data);
+    std::size_t remaining = size;
+    while (remaining > 0) {
+        ssize_t put = ::write(fd, src, remaining);
+        if (put <= 0) {
+            ::close(fd);
+            throw std::runtime_error("Could not write file: " + path.string());
+        }
+        src += put;
+        remaining -= static_cast<std::size_t>(put);
+    }
+    if (::fsync(fd) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Could not flush file: " + path.string());
+    }
+    ::close(fd);
+#endif
+}
+
+void replaceFileDurably(const std::filesystem::path &path, const void *data, std::size_t size) {
+    std::filesystem::path temp = tempPathFor(path);
+    writeFileDurably(temp, data, size);
+    std::filesystem::rename(temp, path);
+}
+
+CopyMethod copyFileDurably(const std::filesystem::path &from, const std::filesystem::path &to) {
+#if defined(_WIN32)
+    std::filesystem::copy_file(from, to, std::filesystem::copy_options::overwrite_existing);
+    HANDLE file = CreateFileW(to.c_str(), GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    bool ok = file != INVALID_HANDLE_VALUE && FlushFileBuffers(file);
+    if (file != INVALID_HANDLE_VALUE) {
+        CloseHandle(file);
+    }
+    if (!ok) {
+        throw std::runtime_error("Could not flush file: " + to.string());
+    }
+    return CopyMethod::Bytes;
+#else
+    int in = ::open(from.c_str(), O_RDONLY);
+    if (in < 0) {
+        throw std::runtime_error("Could not open file for copying: " + from.string());
+    }
+    int out = ::open(to.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out < 0) {
+        ::close(in);
+        throw std::runtime_error("Could not open file for writing: " + to.string());
+    }
+    auto fail = [&](const std::string &message) {
+        ::close(in);
+        ::close(out);
+        throw std::runtime_error(message + to.string());
+    };
+
+    CopyMethod method = CopyMethod::Bytes;
+#if defined(__linux__)
+    // Reflinks need a filesystem such as Btrfs or XFS; copy_file_range works almost anywhere since Linux 5.3.
+    // Either may be refused (EXDEV, EOPNOTSUPP, ENOSYS), in which case the next method starts over.
+    if (::ioctl(out, FICLONE, in) == 0) {
+        method = CopyMethod::Reflink;
+    } else {
+        bool copied = true;
+        for (;;) {
+            ssize_t n = ::copy_file_range(in, nullptr, out, nullptr, 1 << 20, 0);
+            if (n == 0) {
+                break;
+            }
+            if (n < 0) {
+                copied = false;
+                break;
+            }
+        }
+        if (copied) {
+            method = CopyMethod::CopyFileRange;
+        } else if (::lseek(in, 0, SEEK_SET) != 0 || ::ftruncate(out, 0) != 0 || ::lseek(out, 0, SEEK_SET) != 0) {
+            fail("Could not copy file: ");
+        }
+    }
+#endif
+    if (method == CopyMethod::Bytes) {
+        char buffer[64 * 1024];
+        for (;;) {
+            ssize_t got = ::read(in, buffer, sizeof(buffer));
+            if (got < 0) {
+                fail("Could not copy file: ");
+            }
+            if (got == 0) {
+                break;
+            }
+            for (ssize_t done = 0; done < got;) {
+                ssize_t put = ::write(out, buffer + done, static_cast<std::size_t>(got - done));
+                if (put <= 0) {
+                    fail("Could not copy file: ");
+                }
+                done += put;
+            }
+        }
+    }
+    if (::fsync(out) != 0) {
+        fail("Could not flush file: ");
+    }
+    ::close(in);
+    ::close(out);
+    return method;
+#endif
+}
+
+void syncDirectory(const std::filesystem::path &directory) {
+#if !defined(_WIN32)
+    int fd = ::open(directory.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        ::fsync(fd);
+        ::close(fd);
+    }
+#else
+    (void) directory;
+#endif
+}
+
+Transaction::Transaction(std::filesystem::path directory) : dir(std::move(directory)) {}
+
+Transaction::Entry &Transaction::entryFor(const std::string &fileName, bool patch) {
+    for (auto &entry : entries) {
+        if (entry.fileName == fileName) {
+            if (entry.patch != patch) {
+                throw std::logic_error("save_journal: " + fileName + " cannot be both replaced and patched");
+            }
+            return entry;
+        }
+    }
+    Entry &entry = entries.emplace_back();
+    entry.fileName = fileName;
+    entry.patch = patch;
+    return entry;
+}
+
+void Transaction::replace(const std::string &fileName, const void *data, std::size_t size) {
+    const auto *bytes = static_cast<const uint8_t *>(data);
+    Entry &entry = entryFor(fileName, false);
+    entry.contents.assign(bytes, bytes + size);
+    entry.source.clear();
+    entry.removal = false;
+}
+
+void Transaction::replaceWithCopy(const std::string &fileName, const std::filesystem::path &source) {
+    Entry &entry = entryFor(fileName, false);
+    entry.contents.clear();
+    entry.source = source;
+    entry.removal = false;
+}
+
+void Transaction::remove(const std::string &fileName) {
+    Entry &entry = entryFor(fileName, false);
+    entry.contents.clear();
+    entry.source.clear();
+    entry.removal = true;
+}
+
+void Transaction::patch(const std::string &fileName, std::size_t offset, const void *data, std::size_t size) {
+    const auto *bytes = static_cast<const uint8_t *>(data);
+    Entry &entry = entryFor(fileName, true);
+    entry.contents.insert(entry.contents.end(), bytes, bytes + size);
+    entry.ranges.push_back({offset, size});
+}
+
+void Transaction::prepare() {
+    slowestCopy = CopyMethod::Reflink;
+    for (const auto &entry : entries) {
+        if (entry.removal) {
+            continue;
+        }
+        if (entry.source.empty()) {
+            writeFileDurably(tempPathFor(dir / entry.fileName), entry.contents.data(), entry.contents.size());
+        } else {
+            slowestCopy = std::max(slowestCopy, copyFileDurably(entry.source, tempPathFor(dir / entry.fileName)));
+        }
+    }
+
+    // The temps must be found after a crash once the journal decides the commit.
+    syncDirectories(dir, entries);
+
+    std::ostringstream journal;
+    journal << kJournalHeader << "\n";
+    std::size_t lineCount = 0;
+    for (const auto &entry : entries) {
+        if (entry.removal) {
+            journal << "D " << entry.fileName << "\n";
+            ++lineCount;
+            continue;
+        }
+        if (!entry.patch) {
+            journal << "R " << entry.fileName << "\n";
+            ++lineCount;
+            continue;
+        }
+        for (const auto &range : entry.ranges) {
+            journal << "P " << entry.fileName << " " << range.offset << " " << range.length << "\n";
+            ++lineCount;
+        }
+    }
+    journal << "END " << lineCount << "\n";
+    std::string text = journal.str();
+
+    std::filesystem::path journalPath = dir / kJournalFile;
+    std::filesystem::path journalTemp = tempPathFor(journalPath);
+    writeFileDurably(journalTemp, text.data(), text.size());
+    std::filesystem::rename(journalTemp, journalPath);
+    syncDirectory(dir);
+    prepared = true;
+}
+
+void Transaction::apply() {
+    if (!prepared) {
+        throw std::logic_error("save_journal::Transaction::apply called before prepare");
+    }
+
+    std::error_code ec;
+    for (const auto &entry : entries) {
+        std::filesystem::path target = dir / entry.fileName;
+        if (entry.removal) {
+            std::filesystem::remove(target, ec);
+        } else if (entry.patch) {
+            patchFileDurably(target, entry.ranges, entry.contents.data());
+            std::filesystem::remove(tempPathFor(target), ec);
+        } else {
+            std::filesystem::rename(tempPathFor(target), target);
+        }
+    }
+    syncDirectories(dir, entries);
+
+    std::filesystem::remove(dir / kJournalFile, ec);
+    syncDirectory(dir);
+    entries.clear();
+    prepared = false;
+}
+
+void Transaction::commit() {
+    prepare();
+    apply();
+}
+
+Recovery recover(const std::filesystem::path &directory) {
+    std::error_code ec;
+    if (directory.empty() || !std::filesystem::is_directory(directory, ec)) {
+        return Recovery::Clean;
+    }
+
+    std::filesystem::path journalPath = directory / kJournalFile;
+    if (std::filesystem::exists(journalPath, ec)) {
+        bool complete = false;
+        std::vector<JournalLine> lines = readJournal(journalPath, complete);
+        if (complete) {
+            std::map<std::string, std::vector<JournalLine>> patches;
+            for (const auto &line : lines) {
+                std::filesystem::path target = directory / line.fileName;
+                std::filesystem::path temp = tempPathFor(target);
+                if (line.removal) {
+                    std::filesystem::remove(target, ec);
+                } else if (line.patch) {
+                    patches[line.fileName].push_back(line);
+                } else if (std::filesystem::exists(temp, ec)) {
+                    std::filesystem::rename(temp, target);
+                }
+            }
+            // Patch temps are only removed after the target is flushed, so replaying them is always safe.
+            for (const auto &[fileName, ranges] : patches) {
+                std::filesystem::path target = directory / fileName;
+                std::filesystem::path temp = tempPathFor(target);
+                if (!std::filesystem::exists(temp, ec)) {
+                    continue;
+                }
+                std::vector<uint8_t> staged = readFile(temp);
+                std::size_t needed = 0;
+                for (const auto &range : ranges) {
+                    needed += range.length;
+                }
+                if (staged.size() == needed) {
+                    patchFileDurably(target, ranges, staged.data());
+                }
+                std::filesystem::remove(temp, ec);
+            }
+            syncDirectories(directory, lines);
+            std::filesystem::remove(journalPath, ec);
+            syncDirectory(directory);
+            return Recovery::RolledForward;
+        }
+    }
+
+    // No decided journal: anything half-written belongs to a commit that never happened, including temps staged
+    // one directory down.
+    bool removedAny = std::filesystem::remove(journalPath, ec);
+    std::vector<std::filesystem::path> staleTemps;
+    std::vector<std::filesystem::path> touched;
+    for (const auto &dirEntry : std::filesystem::directory_iterator(directory, ec)) {
+        if (isTempFile(dirEntry.path())) {
+            staleTemps.push_back(dirEntry.path());
+        } else if (dirEntry.is_directory(ec)) {
+            for (const auto &subEntry : std::filesystem::directory_iterator(dirEntry.path(), ec)) {
+                if (isTempFile(subEntry.path())) {
+                    staleTemps.push_back(subEntry.path());
+                }
+            }
+        }
+    }
+    for (const auto &temp : staleTemps) {
+        if (std::filesystem::remove(temp, ec)) {
+            removedAny = true;
+            touched.push_back(temp.parent_path());
+        }
+    }
+    if (removedAny) {
+        syncDirectory(directory);
+        for (const auto &parent : touched) {
+            if (parent != directory) {
+                syncDirectory(parent);
+            }
+        }
+    }
+    return removedAny ? Recovery::RolledBack : Recovery::Clean;
+}
+
+} // namespace save_journal
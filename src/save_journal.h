@@ -0,0 +1,87 @@
+// Crash-consistent multi-file commits for save slots (temp files + fsync + rename, with an intent journal).
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace save_journal {
+
+inline constexpr const char *kJournalFile = "PM3000.JNL";
+inline constexpr const char *kTempSuffix = ".PM3TMP";
+
+// How copyFileDurably() produced the copy, fastest first.
+enum class CopyMethod {
+    Reflink,       // FICLONE: the copy shares the source's blocks until either is written
+    CopyFileRange, // copy_file_range: the kernel copies without a round trip through user space
+    Bytes,         // plain read and write
+};
+
+enum class Recovery {
+    Clean,
+    RolledForward,
+    RolledBack,
+};
+
+// Collects the new contents of several files that live in one directory and publishes them together.
+// Once prepare() has written the journal the commit is decided: a crash after that point is rolled
+// forward by recover(); a crash before it leaves the old files untouched and is rolled back.
+//
+// A file is either replaced whole (temp file renamed over it), patched in place, or removed. Patch bytes are
+// staged in the temp file first, so writing them into the target can be replayed after a crash. File names are
+// relative to the directory and may lead one level down ("PM3000/GAME1.HST"); they may not contain spaces.
+class Transaction {
+public:
+    explicit Transaction(std::filesystem::path directory);
+
+    void replace(const std::string &fileName, const void *data, std::size_t size);
+    // Stages a copy of `source` (which may be another file of this directory) without reading it into memory.
+    void replaceWithCopy(const std::string &fileName, const std::filesystem::path &source);
+    void patch(const std::string &fileName, std::size_t offset, const void *data, std::size_t size);
+    void remove(const std::string &fileName);
+
+    bool empty() const { return entries.empty(); }
+
+    void prepare();
+    void apply();
+    void commit();
+
+    // The slowest method any replaceWithCopy() needed in prepare(); Reflink if there were none.
+    CopyMethod copyMethod() const { return slowestCopy; }
+
+private:
+    struct Range {
+        std::size_t offset;
+        std::size_t length;
+    };
+
+    struct Entry {
+        std::string fileName;
+        std::vector<uint8_t> contents;
+        bool patch = false;
+        bool removal = false;
+        std::filesystem::path source;
+        std::vector<Range> ranges;
+    };
+
+    Entry &entryFor(const std::string &fileName, bool patch);
+
+    std::filesystem::path dir;
+    std::vector<Entry> entries;
+    bool prepared = false;
+    CopyMethod slowestCopy = CopyMethod::Reflink;
+};
+
+Recovery recover(const std::filesystem::path &directory);
+
+void writeFileDurably(const std::filesystem::path &path, const void *data, std::size_t size);
+// Replaces the single file at `path` through a flushed temp file and a rename, so readers see the old contents or
+// the new ones. The directory itself is not synced; callers that need the rename on disk call syncDirectory().
+void replaceFileDurably(const std::filesystem::path &path, const void *data, std::size_t size);
+// Copies `from` over `to` and flushes it, cloning or copying in the kernel where the filesystem allows.
+CopyMethod copyFileDurably(const std::filesystem::path &from, const std::filesystem::path &to);
+void syncDirectory(const std::filesystem::path &directory);
+
+} // namespace save_journal
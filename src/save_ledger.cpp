@@ -0,0 +1,379 @@
+// Loans, transfers and coach conversions made in PM3000, kept beside each slot because the save has no room for them.
+#include "save_ledger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <unordered_map>
+
+#include "byte_io.h"
+#include "crc32c.h"
+#include "mapped_save.h"
+#include "pm3_defs.hh"
+
+namespace save_ledger {
+
+namespace {
+
+constexpr char kMagic[8] = {'P', 'M', '3', 'L', 'E', 'D', 'G', 'R'};
+constexpr uint16_t kVersion = 1;
+constexpr std::size_t kHeaderSize = sizeof(kMagic) + sizeof(uint16_t) + 2 * sizeof(uint8_t);
+// Every record has the same size, so the file is a header and an array of records, each with its own CRC32C.
+constexpr std::size_t kPayloadSize = 30;
+constexpr std::size_t kRecordSize = kPayloadSize + sizeof(uint32_t);
+// A record of this kind follows the entries that were saved with the slot.
+constexpr uint8_t kSavedMarker = 'S';
+
+std::vector<Entry> gEntries;
+std::unordered_map<int16_t, std::vector<uint32_t>> gByPlayer;
+std::unordered_map<int, std::vector<uint32_t>> gByClub;
+std::unordered_map<int16_t, uint32_t> gActiveLoans;
+bool gUnsaved = false;
+// The file being appended to; empty when there is none.
+std::filesystem::path gPath;
+// The slot the ledger was opened for. Actions on any other GameState, such as a copy being compared or previewed,
+// are not the loaded slot's history and are not recorded.
+const GameState *gState = nullptr;
+
+using byte_io::get;
+using byte_io::put;
+
+std::vector<uint8_t> header(int gameNumber) {
+    std::vector<uint8_t> out(kMagic, kMagic + sizeof(kMagic));
+    put<uint16_t>(out, kVersion);
+    put<uint8_t>(out, static_cast<uint8_t>(gameNumber));
+    put<uint8_t>(out, 0);
+    return out;
+}
+
+std::vector<uint8_t> encode(uint8_t kind, const Entry &entry) {
+    std::vector<uint8_t> out;
+    out.reserve(kRecordSize);
+    put<uint8_t>(out, kind);
+    put<uint8_t>(out, static_cast<uint8_t>(entry.loanEnd));
+    put<uint16_t>(out, entry.year);
+    put<uint16_t>(out, entry.turn);
+    put<int16_t>(out, entry.playerIdx);
+    put<int16_t>(out, entry.fromClubIdx);
+    put<int16_t>(out, entry.toClubIdx);
+    put<int32_t>(out, entry.fee);
+    put<uint16_t>(out, entry.weeks);
+    out.insert(out.end(), entry.playerName, entry.playerName + sizeof(entry.playerName));
+    put<uint32_t>(out, crc32c::compute(out.data(), out.size()));
+    return out;
+}
+
+Entry decode(const uint8_t *p) {
+    Entry entry;
+    entry.kind = static_cast<Kind>(get<uint8_t>(p));
+    entry.loanEnd = static_cast<LoanEnd>(get<uint8_t>(p));
+    entry.year = get<uint16_t>(p);
+    entry.turn = get<uint16_t>(p);
+    entry.playerIdx = get<int16_t>(p);
+    entry.fromClubIdx = get<int16_t>(p);
+    entry.toClubIdx = get<int16_t>(p);
+    entry.fee = get<int32_t>(p);
+    entry.weeks = get<uint16_t>(p);
+    std::memcpy(entry.playerName, p, sizeof(entry.playerName));
+    return entry;
+}
+
+bool validRecord(const uint8_t *record) {
+    uint32_t crc;
+    std::memcpy(&crc, record + kPayloadSize, sizeof(crc));
+    if (crc != crc32c::compute(record, kPayloadSize)) {
+        return false;
+    }
+    switch (record[0]) {
+        case static_cast<uint8_t>(Kind::Loan):
+        case static_cast<uint8_t>(Kind::LoanEnded):
+        case static_cast<uint8_t>(Kind::Transfer):
+        case static_cast<uint8_t>(Kind::CoachConversion):
+        case kSavedMarker:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// The ledger is a convenience next to the save, so failures are logged and the file is given up on.
+void append(const std::vector<uint8_t> &bytes) {
+    if (gPath.empty()) {
+        return;
+    }
+    std::ofstream out(gPath, std::ios::binary | std::ios::app);
+    if (!out.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size())) ||
+        !out.flush()) {
+        std::cerr << "Could not write the ledger " << gPath.string() << std::endl;
+        gPath.clear();
+    }
+}
+
+void addToIndex(uint32_t at) {
+    const Entry &entry = gEntries[at];
+    gByPlayer[entry.playerIdx].push_back(at);
+    if (entry.fromClubIdx >= 0) {
+        gByClub[entry.fromClubIdx].push_back(at);
+    }
+    if (entry.toClubIdx >= 0 && entry.toClubIdx != entry.fromClubIdx) {
+        gByClub[entry.toClubIdx].push_back(at);
+    }
+    if (entry.kind == Kind::Loan) {
+        gActiveLoans[entry.playerIdx] = at;
+    } else {
+        gActiveLoans.erase(entry.playerIdx);
+    }
+}
+
+void record(Entry entry) {
+    gEntries.push_back(entry);
+    addToIndex(static_cast<uint32_t>(gEntries.size() - 1));
+    gUnsaved = true;
+    append(encode(static_cast<uint8_t>(entry.kind), entry));
+}
+
+Entry dated(const GameState &state, Kind kind, int16_t playerIdx) {
+    Entry entry;
+    entry.kind = kind;
+    entry.year = state.game.year;
+    entry.turn = state.game.turn;
+    entry.playerIdx = playerIdx;
+    std::memcpy(entry.playerName, state.player(playerIdx).name, sizeof(entry.playerName));
+    return entry;
+}
+
+void reset() {
+    gEntries.clear();
+    gByPlayer.clear();
+    gByClub.clear();
+    gActiveLoans.clear();
+    gUnsaved = false;
+    gPath.clear();
+}
+
+// Starts an empty file, returning false if it cannot be written.
+bool start(const std::filesystem::path &path, int gameNumber) {
+    std::vector<uint8_t> bytes = header(gameNumber);
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()))) {
+        std::cerr << "Could not start the ledger " << path.string() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Reads the entries of an existing file up to the first damaged record. Returns false if `path` is not the
+// ledger of `gameNumber`.
+bool load(const std::filesystem::path &path, int gameNumber, bool keepUnsaved) {
+    std::error_code ec;
+    std::uintmax_t size = std::filesystem::file_size(path, ec);
+    io::MappedFile file;
+    if (ec || size < kHeaderSize || !file.open(path, static_cast<std::size_t>(size), false)) {
+        return false;
+    }
+    std::vector<uint8_t> expected = header(gameNumber);
+    if (!std::equal(expected.begin(), expected.end(), file.data())) {
+        return false;
+    }
+
+    std::size_t saved = 0;
+    std::size_t savedEnd = kHeaderSize;
+    std::size_t end = kHeaderSize;
+    while (end + kRecordSize <= file.size() && validRecord(file.data() + end)) {
+        if (file.data()[end] == kSavedMarker) {
+            saved = gEntries.size();
+            savedEnd = end + kRecordSize;
+        } else {
+            gEntries.push_back(decode(file.data() + end));
+        }
+        end += kRecordSize;
+    }
+    if (!keepUnsaved) {
+        gEntries.resize(saved);
+        end = savedEnd;
+    }
+    gUnsaved = gEntries.size() > saved;
+    file.close();
+    if (end < size) {
+        std::filesystem::resize_file(path, end, ec);
+    }
+    return !ec;
+}
+
+} // namespace
+
+std::size_t open(const std::filesystem::path &path, int gameNumber, const GameState &state, bool keepUnsaved) {
+    reset();
+    if (!path.empty()) {
+        if (load(path, gameNumber, keepUnsaved)) {
+            gPath = path;
+        } else {
+            reset();
+            if (start(path, gameNumber)) {
+                gPath = path;
+            }
+        }
+    }
+    for (uint32_t at = 0; at < gEntries.size(); ++at) {
+        addToIndex(at);
+    }
+    gState = &state;
+    return reconcile(state);
+}
+
+// The save wins: a loan it no longer shows was ended by the game, by a reload or by an undo. A player it shows on
+// loan with no entries at all was loaned before the ledger existed, and gets a loan with an unknown owner.
+std::size_t reconcile(const GameState &state) {
+    constexpr int kPlayers = static_cast<int>(std::extent_v<decltype(gamec::player)>);
+    if (&state != gState) {
+        return 0;
+    }
+
+    std::vector<Entry> found;
+    for (const auto &[playerIdx, at] : gActiveLoans) {
+        const Entry &loan = gEntries[at];
+        if (playerIdx < 0 || playerIdx >= kPlayers) {
+            continue;
+        }
+        Entry end = dated(state, Kind::LoanEnded, playerIdx);
+        end.fromClubIdx = loan.fromClubIdx;
+        end.toClubIdx = loan.toClubIdx;
+        const PlayerRecord &player = state.player(playerIdx);
+        if (state.squadPlace(playerIdx).clubIdx != loan.toClubIdx) {
+            end.loanEnd = LoanEnd::Moved;
+        } else if (player.period_type != kLoanPeriodType || player.period == 0) {
+            end.loanEnd = LoanEnd::Expired;
+        } else {
+            continue;
+        }
+        found.push_back(end);
+    }
+    for (int16_t playerIdx = 0; playerIdx < kPlayers; ++playerIdx) {
+        const PlayerRecord &player = state.player(playerIdx);
+        if (player.period_type != kLoanPeriodType || player.period == 0 || gByPlayer.count(playerIdx) != 0) {
+            continue;
+        }
+        int16_t clubIdx = state.squadPlace(playerIdx).clubIdx;
+        if (clubIdx >= 0) {
+            Entry loan = dated(state, Kind::Loan, playerIdx);
+            loan.toClubIdx = clubIdx;
+            loan.weeks = static_cast<uint16_t>((player.period + kTurnsPerWeek - 1) / kTurnsPerWeek);
+            found.push_back(loan);
+        }
+    }
+    std::sort(found.begin(), found.end(), [](const Entry &a, const Entry &b) { return a.playerIdx < b.playerIdx; });
+    for (const Entry &entry : found) {
+        record(entry);
+    }
+    return found.size();
+}
+
+void markSaved(const std::filesystem::path &path, int gameNumber) {
+    if (path != gPath) {
+        gPath.clear();
+        if (path.empty() || !start(path, gameNumber)) {
+            gUnsaved = false;
+            return;
+        }
+        gPath = path;
+        std::vector<uint8_t> bytes;
+        bytes.reserve((gEntries.size() + 1) * kRecordSize);
+        for (const Entry &entry : gEntries) {
+            std::vector<uint8_t> encoded = encode(static_cast<uint8_t>(entry.kind), entry);
+            bytes.insert(bytes.end(), encoded.begin(), encoded.end());
+        }
+        std::vector<uint8_t> marker = encode(kSavedMarker, Entry{});
+        bytes.insert(bytes.end(), marker.begin(), marker.end());
+        append(bytes);
+    } else if (gUnsaved) {
+        append(encode(kSavedMarker, Entry{}));
+    }
+    gUnsaved = false;
+}
+
+bool renumber(std::vector<uint8_t> &ledger, int gameNumber) {
+    std::vector<uint8_t> expected = header(gameNumber);
+    constexpr std::size_t kNumberAt = sizeof(kMagic) + sizeof(uint16_t);
+    if (ledger.size() < kHeaderSize || !std::equal(expected.begin(), expected.begin() + kNumberAt, ledger.begin())) {
+        return false;
+    }
+    ledger[kNumberAt] = expected[kNumberAt];
+    return true;
+}
+
+void recordTransfer(const GameState &state, int16_t playerIdx, int fromClubIdx, int toClubIdx, int32_t fee) {
+    if (&state != gState) {
+        return;
+    }
+    Entry entry = dated(state, Kind::Transfer, playerIdx);
+    entry.fromClubIdx = static_cast<int16_t>(fromClubIdx);
+    entry.toClubIdx = static_cast<int16_t>(toClubIdx);
+    entry.fee = fee;
+    record(entry);
+}
+
+void recordLoan(const GameState &state, int16_t playerIdx, int ownerClubIdx, int borrowerClubIdx, int32_t fee,
+                int weeks) {
+    if (&state != gState) {
+        return;
+    }
+    Entry entry = dated(state, Kind::Loan, playerIdx);
+    entry.fromClubIdx = static_cast<int16_t>(ownerClubIdx);
+    entry.toClubIdx = static_cast<int16_t>(borrowerClubIdx);
+    entry.fee = fee;
+    entry.weeks = static_cast<uint16_t>(weeks);
+    record(entry);
+}
+
+void recordCoachConversion(const GameState &state, int16_t playerIdx, int clubIdx, int youthClubIdx) {
+    if (&state != gState) {
+        return;
+    }
+    Entry entry = dated(state, Kind::CoachConversion, playerIdx);
+    entry.fromClubIdx = static_cast<int16_t>(clubIdx);
+    entry.toClubIdx = static_cast<int16_t>(youthClubIdx);
+    record(entry);
+}
+
+const std::vector<Entry> &entries() {
+    return gEntries;
+}
+
+const Entry *activeLoan(int16_t playerIdx) {
+    auto it = gActiveLoans.find(playerIdx);
+    return it == gActiveLoans.end() ? nullptr : &gEntries[it->second];
+}
+
+std::vector<const Entry *> playerHistory(int16_t playerIdx) {
+    std::vector<const Entry *> out;
+    auto it = gByPlayer.find(playerIdx);
+    if (it != gByPlayer.end()) {
+        for (uint32_t at : it->second) {
+            out.push_back(&gEntries[at]);
+        }
+    }
+    return out;
+}
+
+std::vector<const Entry *> clubHistory(int clubIdx) {
+    std::vector<const Entry *> out;
+    auto it = gByClub.find(clubIdx);
+    if (it != gByClub.end()) {
+        for (uint32_t at : it->second) {
+            out.push_back(&gEntries[at]);
+        }
+    }
+    return out;
+}
+
+std::filesystem::path ledgerPath(const std::filesystem::path &backupDir, int gameNumber) {
+    return backupDir / (std::string{kGameFilePrefix} + std::to_string(gameNumber) + kFileSuffix);
+}
+
+} // namespace save_ledger
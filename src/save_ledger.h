@@ -0,0 +1,78 @@
+// Loans, transfers and coach conversions made in PM3000, kept beside each slot because the save has no room for them.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include "pm3_data.h"
+
+namespace save_ledger {
+
+inline constexpr const char *kFileSuffix = ".LDG";
+// PM3 has no loans. A loaned player gets this period type, with the loan's length in turns as the period.
+inline constexpr uint8_t kLoanPeriodType = 20;
+inline constexpr int kTurnsPerWeek = 3;
+
+enum class Kind : uint8_t {
+    Loan = 'L',
+    LoanEnded = 'E',
+    Transfer = 'T',
+    CoachConversion = 'C',
+};
+
+enum class LoanEnd : uint8_t {
+    None = 0,
+    Expired = 1, // the player is still at the borrowing club but no longer marked as loaned
+    Moved = 2,   // the player left the borrowing club
+};
+
+struct Entry {
+    Kind kind = Kind::Transfer;
+    LoanEnd loanEnd = LoanEnd::None;
+    uint16_t year = 0; // game date it happened on
+    uint16_t turn = 0;
+    int16_t playerIdx = -1;
+    // Loans: the owning and the borrowing club. Conversions: the player's club, and the club the youngster who
+    // takes over the player record joins.
+    int16_t fromClubIdx = -1;
+    int16_t toClubIdx = -1;
+    int32_t fee = 0;
+    uint16_t weeks = 0; // loans only
+    // As it was; a converted player's record is reused for a youngster.
+    char playerName[12]{};
+};
+
+// Opens the ledger of `gameNumber` at `path` for the slot now in `state`. Entries recorded since the slot was
+// last saved are dropped, unless `keepUnsaved` because the edit journal brought those edits back. Then reconciles,
+// returning how many entries that added. An empty `path` keeps the ledger in memory only. Until the next open(),
+// reconcile() and the record functions ignore any GameState other than `state`.
+std::size_t open(const std::filesystem::path &path, int gameNumber, const GameState &state, bool keepUnsaved);
+// Brings the ledger in line with the save in `state`, e.g. after PM3 rewrote the slot: loans the save no longer
+// shows are closed, and players it shows on loan without any entry get one. Returns how many entries that added.
+std::size_t reconcile(const GameState &state);
+// Everything recorded so far was saved with slot `gameNumber`, whose ledger is at `path`. Saving into another slot
+// copies the ledger there and goes on with that copy.
+void markSaved(const std::filesystem::path &path, int gameNumber);
+// Rewrites the slot number in the header of `ledger`, the bytes of a ledger file that slot management copies or
+// moves to slot `gameNumber`. False if they are not a ledger.
+bool renumber(std::vector<uint8_t> &ledger, int gameNumber);
+
+void recordTransfer(const GameState &state, int16_t playerIdx, int fromClubIdx, int toClubIdx, int32_t fee);
+void recordLoan(const GameState &state, int16_t playerIdx, int ownerClubIdx, int borrowerClubIdx, int32_t fee,
+                int weeks);
+void recordCoachConversion(const GameState &state, int16_t playerIdx, int clubIdx, int youthClubIdx);
+
+// Oldest first. Pointers into it, including those the queries below return, last until the next record or open().
+const std::vector<Entry> &entries();
+// The loan a player is on, or nullptr.
+const Entry *activeLoan(int16_t playerIdx);
+// Every entry about a player or a club, oldest first.
+std::vector<const Entry *> playerHistory(int16_t playerIdx);
+std::vector<const Entry *> clubHistory(int clubIdx);
+
+// <backup dir>/GAMEn.LDG
+std::filesystem::path ledgerPath(const std::filesystem::path &backupDir, int gameNumber);
+
+} // namespace save_ledger
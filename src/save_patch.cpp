@@ -0,0 +1,211 @@
+// Record-level binary patches between two copies of a save file.
+#include "save_patch.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "byte_io.h"
+#include "crc32c.h"
+#include "save_diff.h"
+
+namespace save_patch {
+
+namespace {
+
+constexpr char kMagic[8] = {'P', 'M', '3', 'P', 'A', 'T', 'C', 'H'};
+constexpr uint16_t kVersion = 1;
+// file, field, element, offset and length
+constexpr std::size_t kHunkHeaderSize = 1 + 2 + 4 + 4 + 4;
+
+using byte_io::get;
+using byte_io::put;
+
+void addSpan(std::vector<dirty_tracker::Span> &spans, std::size_t offset, std::size_t length) {
+    if (!spans.empty() && offset <= spans.back().offset + spans.back().length + dirty_tracker::kMergeGap) {
+        std::size_t end = std::max(spans.back().offset + spans.back().length, offset + length);
+        spans.back().length = end - spans.back().offset;
+    } else {
+        spans.push_back({offset, length});
+    }
+}
+
+} // namespace
+
+const pm3_schema::Record &recordFor(int file) {
+    switch (file) {
+    case 0:
+        return pm3_schema::kGameA;
+    case 1:
+        return pm3_schema::kGameB;
+    default:
+        return pm3_schema::kGameC;
+    }
+}
+
+std::size_t absoluteOffset(const Hunk &hunk) {
+    const pm3_schema::Field &field = recordFor(hunk.file).fields[hunk.field];
+    return field.offset + std::size_t{hunk.element} * field.width + hunk.offset;
+}
+
+std::string describe(const Hunk &hunk) {
+    const pm3_schema::Field &field = recordFor(hunk.file).fields[hunk.field];
+    std::string text = field.name;
+    if (field.count > 1) {
+        text += "[" + std::to_string(hunk.element) + "]";
+    }
+    if (hunk.offset != 0) {
+        text += "+" + std::to_string(hunk.offset);
+    }
+    return text;
+}
+
+void append(Patch &patch, int file, const void *before, const void *after) {
+    const pm3_schema::Record &record = recordFor(file);
+    const auto *a = static_cast<const uint8_t *>(before);
+    const auto *b = static_cast<const uint8_t *>(after);
+    const std::size_t firstHunk = patch.hunks.size();
+    std::size_t fieldIdx = 0;
+    for (const save_diff::Range &range : save_diff::differingRanges(before, after, record.size)) {
+        std::size_t pos = range.offset;
+        std::size_t end = range.offset + range.length;
+        while (pos < end) {
+            // Ranges come in offset order, so the field only ever moves forward.
+            while (pos >= record.fields[fieldIdx].offset + record.fields[fieldIdx].size()) {
+                ++fieldIdx;
+            }
+            const pm3_schema::Field &field = record.fields[fieldIdx];
+            auto element = static_cast<uint32_t>((pos - field.offset) / field.width);
+            std::size_t elementStart = field.offset + std::size_t{element} * field.width;
+            std::size_t chunkEnd = std::min(end, elementStart + field.width);
+
+            Hunk *last = patch.hunks.size() > firstHunk ? &patch.hunks.back() : nullptr;
+            std::size_t lastEnd = last ? absoluteOffset(*last) + last->after.size() : 0;
+            if (last && last->field == fieldIdx && last->element == element && pos - lastEnd <= kHunkMergeGap) {
+                // The unchanged bytes in between go along; they are checked like the rest.
+                last->before.insert(last->before.end(), a + lastEnd, a + chunkEnd);
+                last->after.insert(last->after.end(), b + lastEnd, b + chunkEnd);
+            } else {
+                Hunk hunk;
+                hunk.file = file;
+                hunk.field = static_cast<uint16_t>(fieldIdx);
+                hunk.element = element;
+                hunk.offset = static_cast<uint32_t>(pos - elementStart);
+                hunk.before.assign(a + pos, a + chunkEnd);
+                hunk.after.assign(b + pos, b + chunkEnd);
+                patch.hunks.push_back(std::move(hunk));
+            }
+            pos = chunkEnd;
+        }
+    }
+}
+
+std::vector<uint8_t> encode(const Patch &patch) {
+    std::vector<uint8_t> out(kMagic, kMagic + sizeof(kMagic));
+    put<uint16_t>(out, kVersion);
+    put<uint32_t>(out, static_cast<uint32_t>(patch.hunks.size()));
+    for (const Hunk &hunk : patch.hunks) {
+        put<uint8_t>(out, static_cast<uint8_t>(hunk.file));
+        put<uint16_t>(out, hunk.field);
+        put<uint32_t>(out, hunk.element);
+        put<uint32_t>(out, hunk.offset);
+        put<uint32_t>(out, static_cast<uint32_t>(hunk.after.size()));
+        out.insert(out.end(), hunk.before.begin(), hunk.before.end());
+        out.insert(out.end(), hunk.after.begin(), hunk.after.end());
+    }
+    put<uint32_t>(out, crc32c::compute(out.data(), out.size()));
+    return out;
+}
+
+bool decode(const uint8_t *data, std::size_t size, Patch &patch, std::string &error) {
+    constexpr std::size_t kFixedSize = sizeof(kMagic) + sizeof(uint16_t) + sizeof(uint32_t) + sizeof(uint32_t);
+    if (size < kFixedSize || std::memcmp(data, kMagic, sizeof(kMagic)) != 0) {
+        error = "not a PM3 patch";
+        return false;
+    }
+    const uint8_t *trailer = data + size - sizeof(uint32_t);
+    if (get<uint32_t>(trailer) != crc32c::compute(data, size - sizeof(uint32_t))) {
+        error = "patch is damaged (checksum mismatch)";
+        return false;
+    }
+    const uint8_t *p = data + sizeof(kMagic);
+    const uint8_t *end = data + size - sizeof(uint32_t);
+    if (get<uint16_t>(p) != kVersion) {
+        error = "unsupported patch version";
+        return false;
+    }
+
+    Patch parsed;
+    uint32_t count = get<uint32_t>(p);
+    for (uint32_t i = 0; i < count; ++i) {
+        if (static_cast<std::size_t>(end - p) < kHunkHeaderSize) {
+            error = "patch is truncated";
+            return false;
+        }
+        Hunk hunk;
+        hunk.file = get<uint8_t>(p);
+        hunk.field = get<uint16_t>(p);
+        hunk.element = get<uint32_t>(p);
+        hunk.offset = get<uint32_t>(p);
+        uint32_t length = get<uint32_t>(p);
+        if (hunk.file >= kFileCount || hunk.field >= recordFor(hunk.file).fieldCount) {
+            error = "hunk " + std::to_string(i) + " names an unknown field";
+            return false;
+        }
+        const pm3_schema::Field &field = recordFor(hunk.file).fields[hunk.field];
+        if (length == 0 || hunk.element >= field.count || hunk.offset > field.width ||
+            length > field.width - hunk.offset) {
+            error = "hunk " + std::to_string(i) + " is out of range for " + field.name;
+            return false;
+        }
+        if (static_cast<std::size_t>(end - p) < 2 * std::size_t{length}) {
+            error = "patch is truncated";
+            return false;
+        }
+        hunk.before.assign(p, p + length);
+        hunk.after.assign(p + length, p + 2 * std::size_t{length});
+        p += 2 * std::size_t{length};
+        parsed.hunks.push_back(std::move(hunk));
+    }
+    if (p != end) {
+        error = "unexpected bytes after the last hunk";
+        return false;
+    }
+    patch = std::move(parsed);
+    return true;
+}
+
+Outcome apply(const Patch &patch, void *const (&files)[kFileCount]) {
+    Outcome outcome;
+    std::vector<const Hunk *> pending;
+    for (const Hunk &hunk : patch.hunks) {
+        if (!files[hunk.file]) {
+            continue;
+        }
+        const uint8_t *current = static_cast<const uint8_t *>(files[hunk.file]) + absoluteOffset(hunk);
+        if (std::memcmp(current, hunk.before.data(), hunk.before.size()) == 0) {
+            pending.push_back(&hunk);
+        } else if (std::memcmp(current, hunk.after.data(), hunk.after.size()) == 0) {
+            ++outcome.alreadyApplied;
+        } else {
+            outcome.conflicts.push_back(std::string("GAMEn") + static_cast<char>('A' + hunk.file) + " " +
+                                        describe(hunk));
+        }
+    }
+    if (!outcome.conflicts.empty()) {
+        return outcome;
+    }
+
+    // Patches made by append() are in offset order; hand-stacked ones need not be.
+    std::stable_sort(pending.begin(), pending.end(), [](const Hunk *x, const Hunk *y) {
+        return x->file != y->file ? x->file < y->file : absoluteOffset(*x) < absoluteOffset(*y);
+    });
+    for (const Hunk *hunk : pending) {
+        std::size_t offset = absoluteOffset(*hunk);
+        std::memcpy(static_cast<uint8_t *>(files[hunk->file]) + offset, hunk->after.data(), hunk->after.size());
+        addSpan(outcome.spans[hunk->file], offset, hunk->after.size());
+        ++outcome.applied;
+    }
+    return outcome;
+}
+
+} // namespace save_patch
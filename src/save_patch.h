@@ -0,0 +1,60 @@
+// Record-level binary patches between two copies of GAMEnA/B/C (or the base GAMEDATA/CLUBDATA/PLAYDATA.DAT).
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "dirty_tracker.h"
+#include "pm3_schema.h"
+
+namespace save_patch {
+
+inline constexpr int kFileCount = 3;
+
+// Changes this close together inside one record element are stored as one hunk; a hunk header costs more.
+inline constexpr std::size_t kHunkMergeGap = 16;
+
+// One run of changed bytes inside one element of a top-level field, e.g. bytes 40..43 of player[2011]. The old
+// bytes are kept so apply() can tell whether the patch still fits the file it is applied to.
+struct Hunk {
+    int file = 0;       // 0, 1, 2 for GAMEnA/B/C
+    uint16_t field = 0; // index of the top-level field in the file's schema record
+    uint32_t element = 0;
+    uint32_t offset = 0; // bytes into the element
+    std::vector<uint8_t> before;
+    std::vector<uint8_t> after;
+};
+
+struct Patch {
+    std::vector<Hunk> hunks; // by file, then offset
+};
+
+const pm3_schema::Record &recordFor(int file);
+// Where the hunk starts within its file.
+std::size_t absoluteOffset(const Hunk &hunk);
+// "player[2011]+40"
+std::string describe(const Hunk &hunk);
+
+// Adds the hunks that turn `before` into `after`, both copies of file `file`.
+void append(Patch &patch, int file, const void *before, const void *after);
+
+// A compact little-endian encoding with a CRC32C trailer.
+std::vector<uint8_t> encode(const Patch &patch);
+bool decode(const uint8_t *data, std::size_t size, Patch &patch, std::string &error);
+
+struct Outcome {
+    std::size_t applied = 0;
+    std::size_t alreadyApplied = 0; // hunks whose bytes already hold the new value, e.g. a patch applied twice
+    std::vector<std::string> conflicts;
+    // The bytes written, merged with dirty_tracker::kMergeGap, ready for io::commitSaveGame.
+    std::vector<dirty_tracker::Span> spans[kFileCount];
+};
+
+// Checks every hunk against `files` (gamea, gameb and gamec, any of which may be null to skip that file) and, only
+// if none conflicts, writes them. A hunk conflicts when its bytes hold neither the old nor the new value, which is
+// how two stacked mods touching the same field are caught.
+Outcome apply(const Patch &patch, void *const (&files)[kFileCount]);
+
+} // namespace save_patch
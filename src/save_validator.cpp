@@ -0,0 +1,226 @@
+// Structural checks for a loaded save: club and player references in range and every player in one squad.
+#include "save_validator.h"
+
+#include <bitset>
+#include <cstring>
+#include <utility>
+
+#include "pm3_codec.h"
+#include "pm3_schema.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define PM3_VALIDATOR_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace save_validator {
+
+namespace {
+
+constexpr std::size_t kPlayers = static_cast<std::size_t>(pm3_schema::kPlayerCount);
+
+bool isReference(const pm3_schema::Field &field) {
+    return field.kind == pm3_schema::Kind::Integer && field.min == pm3_schema::kClubRange.min &&
+           (field.max == pm3_schema::kClubRange.max || field.max == pm3_schema::kPlayerRange.max);
+}
+
+// Emits a run for every reference field under `record`, which sits at `base` and repeats `repeat` times every
+// `stride` bytes. As in pm3_codec, only the innermost repetition becomes a strided run; outer ones are unrolled.
+// `arrayPath` names the repeated record ("club"); a single record is named by `prefix` ("manager[1].stadium.").
+void addFields(std::vector<RangeRun> &runs, uint8_t file, const pm3_schema::Record &record, std::size_t base,
+               std::size_t repeat, std::size_t stride, const std::string &arrayPath, const std::string &prefix) {
+    for (const pm3_schema::Field &field : record) {
+        if (isReference(field)) {
+            runs.push_back({file, static_cast<uint32_t>(base + field.offset), static_cast<uint8_t>(field.width),
+                            field.isSigned, field.count, static_cast<uint32_t>(repeat),
+                            static_cast<uint32_t>(stride), field.min, field.max, field.repairable,
+                            repeat == 1 ? std::string() : arrayPath,
+                            (repeat == 1 ? prefix : std::string()) + field.name});
+        } else if (field.kind == pm3_schema::Kind::Record) {
+            if (repeat == 1) {
+                addFields(runs, file, *field.record, base + field.offset, field.count, field.width,
+                          prefix + field.name, prefix + field.name + ".");
+                continue;
+            }
+            for (std::size_t r = 0; r < repeat; ++r) {
+                std::string element = arrayPath + "[" + std::to_string(r) + "]." + field.name;
+                addFields(runs, file, *field.record, base + r * stride + field.offset, field.count, field.width,
+                          element, element + ".");
+            }
+        }
+    }
+}
+
+std::vector<RangeRun> buildRuns() {
+    std::vector<RangeRun> runs;
+    const pm3_schema::Record *records[kFileCount] = {&pm3_schema::kGameA, &pm3_schema::kGameB, &pm3_schema::kGameC};
+    for (uint8_t file = 0; file < kFileCount; ++file) {
+        addFields(runs, file, *records[file], 0, 1, records[file]->size, "", "");
+    }
+    return runs;
+}
+
+int64_t load(const uint8_t *p, uint8_t width, bool isSigned) {
+    switch (width) {
+        case 1:
+            return isSigned ? static_cast<int8_t>(*p) : *p;
+        case 2: {
+            uint16_t v;
+            std::memcpy(&v, p, sizeof(v));
+            return isSigned ? static_cast<int16_t>(v) : v;
+        }
+        default: {
+            uint32_t v;
+            std::memcpy(&v, p, sizeof(v));
+            return isSigned ? static_cast<int32_t>(v) : v;
+        }
+    }
+}
+
+void storeNone(uint8_t *p, uint8_t width) {
+    std::memset(p, 0xFF, width); // -1 in every width and byte order
+}
+
+bool isSquadRun(const RangeRun &run) {
+    return run.file == 1 && run.offset == offsetof(ClubRecord, player_index) && run.stride == sizeof(ClubRecord);
+}
+
+// Index of the first out-of-range value among `count` int16s, or `count` if there is none. SSE2 compares eight
+// values per step; a block that has a bad value is narrowed down by the scalar loop.
+uint32_t firstBad16(const uint8_t *p, uint32_t count, int16_t min, int16_t max, bool swapped) {
+    uint32_t i = 0;
+#if defined(PM3_VALIDATOR_SSE2)
+    const __m128i lo = _mm_set1_epi16(min);
+    const __m128i hi = _mm_set1_epi16(max);
+    for (; i + 8 <= count; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i * 2));
+        if (swapped) {
+            v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        }
+        if (_mm_movemask_epi8(_mm_or_si128(_mm_cmplt_epi16(v, lo), _mm_cmpgt_epi16(v, hi))) != 0) {
+            break;
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        int16_t v;
+        std::memcpy(&v, p + i * 2, sizeof(v));
+        if (swapped) {
+            v = pm3_codec::byteSwap16(v);
+        }
+        if (v < min || v > max) {
+            return i;
+        }
+    }
+    return count;
+}
+
+} // namespace
+
+const std::vector<RangeRun> &rangeRuns() {
+    static const std::vector<RangeRun> kRuns = buildRuns();
+    return kRuns;
+}
+
+Report validate(gamea &gameA, gameb &gameB, gamec &gameC, const Options &options) {
+    Report report;
+    uint8_t *files[kFileCount] = {reinterpret_cast<uint8_t *>(&gameA), reinterpret_cast<uint8_t *>(&gameB),
+                                  reinterpret_cast<uint8_t *>(&gameC)};
+    const std::size_t managerStart = offsetof(gamea, manager);
+    const std::size_t managerEnd = managerStart + sizeof(gamea::manager);
+
+    auto flag = [&](IssueKind kind, const RangeRun &run, uint32_t r, uint32_t i, int64_t value, int firstClub) {
+        Issue issue{kind, run.file, run.width, run.offset + r * run.stride + i * run.width, value, &run, r, i,
+                    firstClub};
+        if (options.repair && run.repairable) {
+            storeNone(files[run.file] + issue.offset, run.width);
+            issue.repaired = true;
+            ++report.repaired;
+        }
+        report.issues.push_back(issue);
+    };
+
+    const RangeRun *squads = nullptr;
+    for (const RangeRun &run : rangeRuns()) {
+        if (options.skipManagers && run.file == 0 && run.offset >= managerStart && run.offset < managerEnd) {
+            continue;
+        }
+        bool swapped = false;
+        if (isSquadRun(run)) {
+            squads = &run;
+            swapped = options.swappedSquads;
+        }
+        for (uint32_t r = 0; r < run.repeat; ++r) {
+            const uint8_t *group = files[run.file] + run.offset + r * run.stride;
+            if (run.width == 2 && run.isSigned) {
+                const auto min = static_cast<int16_t>(run.min);
+                const auto max = static_cast<int16_t>(run.max);
+                for (uint32_t i = firstBad16(group, run.count, min, max, swapped); i < run.count;
+                     i += 1 + firstBad16(group + (i + 1) * 2, run.count - i - 1, min, max, swapped)) {
+                    int16_t value = static_cast<int16_t>(load(group + i * 2, 2, true));
+                    flag(IssueKind::BadReference, run, r, i, swapped ? pm3_codec::byteSwap16(value) : value, -1);
+                }
+                continue;
+            }
+            for (uint32_t i = 0; i < run.count; ++i) {
+                int64_t value = load(group + i * run.width, run.width, run.isSigned);
+                if (value < run.min || value > run.max) {
+                    flag(IssueKind::BadReference, run, r, i, value, -1);
+                }
+            }
+        }
+    }
+
+    // Ownership: one bit per player, so a second squad slot naming the same player shows up as an already set bit.
+    if (squads) {
+        auto squadPlayer = [&](uint32_t club, uint32_t slot) {
+            const uint8_t *p = files[1] + squads->offset + club * squads->stride + slot * 2;
+            auto player = static_cast<int16_t>(load(p, 2, true));
+            return options.swappedSquads ? pm3_codec::byteSwap16(player) : player;
+        };
+        std::bitset<kPlayers> owned;
+        for (uint32_t club = 0; club < squads->repeat; ++club) {
+            for (uint32_t slot = 0; slot < squads->count; ++slot) {
+                int16_t player = squadPlayer(club, slot);
+                if (player < 0 || static_cast<std::size_t>(player) >= kPlayers) {
+                    continue;
+                }
+                if (!owned.test(static_cast<std::size_t>(player))) {
+                    owned.set(static_cast<std::size_t>(player));
+                    continue;
+                }
+                // Rare enough that finding the first owner by a second scan beats keeping an owner table.
+                int firstClub = -1;
+                for (uint32_t other = 0; other <= club && firstClub < 0; ++other) {
+                    for (uint32_t s = 0; s < squads->count && (other < club || s < slot); ++s) {
+                        if (squadPlayer(other, s) == player) {
+                            firstClub = static_cast<int>(other);
+                            break;
+                        }
+                    }
+                }
+                flag(IssueKind::DuplicatePlayer, *squads, club, slot, player, firstClub);
+            }
+        }
+        report.unassignedPlayers = kPlayers - owned.count();
+    }
+    return report;
+}
+
+std::string describe(const Issue &issue) {
+    const RangeRun &run = *issue.run;
+    std::string path = run.repeatPath.empty()
+                               ? run.fieldPath
+                               : run.repeatPath + "[" + std::to_string(issue.repeatIndex) + "]." + run.fieldPath;
+    if (run.count > 1) {
+        path += "[" + std::to_string(issue.countIndex) + "]";
+    }
+    if (issue.kind == IssueKind::DuplicatePlayer) {
+        return path + ": player " + std::to_string(issue.value) + " is already in club " +
+               std::to_string(issue.firstClub);
+    }
+    bool club = run.max == pm3_schema::kClubRange.max;
+    return path + " = " + std::to_string(issue.value) + " is not a " + (club ? "club" : "player");
+}
+
+} // namespace save_validator
@@ -0,0 +1,79 @@
+// Structural checks for a loaded save: club and player references in range and every player in one squad.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "pm3_defs.hh"
+
+namespace save_validator {
+
+inline constexpr int kFileCount = 3;
+inline constexpr int kSquadSize = 24;
+
+// `count` reference fields of `width` bytes at `offset` in one save file, repeated `repeat` times every `stride`
+// bytes, each of which must lie in [min, max]. Built from the club and player ranges in pm3_schema; only runs
+// that are `repairable` are ever changed by a repair.
+struct RangeRun {
+    uint8_t file;
+    uint32_t offset;
+    uint8_t width;
+    bool isSigned;
+    uint32_t count;
+    uint32_t repeat;
+    uint32_t stride;
+    int64_t min;
+    int64_t max;
+    bool repairable;
+    std::string repeatPath; // e.g. "club", the record indexed by the repetition; empty if repeat == 1
+    std::string fieldPath;  // e.g. "player_index"
+};
+
+enum class IssueKind : uint8_t {
+    BadReference,    // a club or player index outside its range
+    DuplicatePlayer, // a player listed in a second squad slot
+};
+
+struct Issue {
+    IssueKind kind;
+    uint8_t file;    // 0 = GAMEnA, 1 = GAMEnB, 2 = GAMEnC
+    uint8_t width;
+    uint32_t offset; // of the value within its file
+    int64_t value;
+    const RangeRun *run;
+    uint32_t repeatIndex;
+    uint32_t countIndex;
+    int firstClub = -1; // DuplicatePlayer: the club whose slot keeps the player
+    bool repaired = false;
+};
+
+struct Report {
+    std::vector<Issue> issues;
+    std::size_t unassignedPlayers = 0; // not an error: PM3 keeps free agents outside every squad
+    std::size_t repaired = 0;
+
+    bool clean() const { return issues.empty(); }
+};
+
+struct Options {
+    // Sets bad references, and the later slot of each duplicate, to -1 (no club / empty slot). References whose
+    // meaning is unconfirmed (pm3_schema's kUnconfirmed ranges) are reported but left as they are.
+    bool repair = false;
+    // The squads' player_index values are still byte-swapped, as in base data during the SWOS import.
+    bool swappedSquads = false;
+    // Skip the manager records, which the import never checked.
+    bool skipManagers = false;
+};
+
+// All reference runs of the three save files, in file and offset order.
+const std::vector<RangeRun> &rangeRuns();
+
+// Without Options::repair the structs are only read.
+Report validate(gamea &gameA, gameb &gameB, gamec &gameC, const Options &options = {});
+
+// "club[17].player_index[4] = 5000 is not a player", "club[30].player_index[2]: player 17 is already in club 3".
+std::string describe(const Issue &issue);
+
+} // namespace save_validator
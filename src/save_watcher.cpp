@@ -0,0 +1,178 @@
+// Watches the loaded slot's files in the saves folder so edits made by PM3 itself (e.g. under DOSBox) show up live.
+#include "save_watcher.h"
+
+#include <cctype>
+#include <cstring>
+#include <system_error>
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include "dirty_tracker.h"
+#include "installation.h"
+#include "pm3_defs.hh"
+
+namespace io {
+
+namespace {
+
+bool sameNameIgnoringCase(const char *a, const std::string &b) {
+    std::size_t i = 0;
+    for (; a[i] != '\0' && i < b.size(); ++i) {
+        if (std::toupper(static_cast<unsigned char>(a[i])) != std::toupper(static_cast<unsigned char>(b[i]))) {
+            return false;
+        }
+    }
+    return a[i] == '\0' && i == b.size();
+}
+
+} // namespace
+
+SaveWatcher::~SaveWatcher() {
+    stop();
+}
+
+bool SaveWatcher::watch(const std::filesystem::path &gamePath, int gameNumber) {
+    stop();
+    root = gamePath;
+    slot = gameNumber;
+    folder = installationFor(gamePath)->savesFolder();
+    if (folder.empty()) {
+        return false;
+    }
+
+    for (int file = 0; file < kWatchedFileCount; ++file) {
+        names[file] = file == kWatchSavesDir || slot == 0
+                      ? std::string{kSavesDirFile}
+                      : std::string{kGameFilePrefix} + std::to_string(slot) + static_cast<char>('A' + file);
+        std::error_code ec;
+        seen[file] = std::filesystem::last_write_time(filePath(file), ec);
+    }
+
+#if defined(__linux__)
+    watchFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (watchFd >= 0 &&
+        inotify_add_watch(watchFd, folder.c_str(), IN_MODIFY | IN_CLOSE_WRITE | IN_CREATE | IN_MOVED_TO) < 0) {
+        ::close(watchFd);
+        watchFd = -1;
+    }
+#endif
+    return true;
+}
+
+void SaveWatcher::stop() {
+#if defined(__linux__)
+    if (watchFd >= 0) {
+        ::close(watchFd);
+    }
+#endif
+    watchFd = -1;
+    root.clear();
+    folder.clear();
+    slot = 0;
+    for (auto &entry : pending) {
+        entry = Pending{};
+    }
+}
+
+std::filesystem::path SaveWatcher::filePath(int file) const {
+    return folder / names[file];
+}
+
+uintmax_t SaveWatcher::expectedSize(int file) {
+    return file == kWatchSavesDir ? sizeof(::saves) : dirty_tracker::fileSize(static_cast<dirty_tracker::SaveFile>(file));
+}
+
+void SaveWatcher::markChanged(int file, Clock::time_point now) {
+    if (slot == 0 && file != kWatchSavesDir) {
+        return;
+    }
+    Pending &entry = pending[file];
+    std::error_code ec;
+    entry.waiting = true;
+    entry.settleFrom = now;
+    entry.writeTime = std::filesystem::last_write_time(filePath(file), ec);
+}
+
+void SaveWatcher::drainEvents(Clock::time_point now) {
+#if defined(__linux__)
+    alignas(struct inotify_event) char buffer[4096];
+    for (;;) {
+        ssize_t n = ::read(watchFd, buffer, sizeof(buffer));
+        if (n <= 0) {
+            break;
+        }
+        for (char *p = buffer; p < buffer + n;) {
+            const auto *event = reinterpret_cast<const struct inotify_event *>(p);
+            if (event->len > 0) {
+                for (int file = 0; file < kWatchedFileCount; ++file) {
+                    if (sameNameIgnoringCase(event->name, names[file])) {
+                        markChanged(file, now);
+                    }
+                }
+            }
+            p += sizeof(struct inotify_event) + event->len;
+        }
+    }
+#else
+    (void) now;
+#endif
+}
+
+void SaveWatcher::scanWriteTimes(Clock::time_point now) {
+    if (now - lastScan < kQuietPeriod) {
+        return;
+    }
+    lastScan = now;
+    for (int file = 0; file < kWatchedFileCount; ++file) {
+        std::error_code ec;
+        auto writeTime = std::filesystem::last_write_time(filePath(file), ec);
+        if (!ec && writeTime != seen[file]) {
+            seen[file] = writeTime;
+            markChanged(file, now);
+        }
+    }
+}
+
+WatchedFiles SaveWatcher::poll(Clock::time_point now) {
+    WatchedFiles ready;
+    if (folder.empty()) {
+        return ready;
+    }
+    if (watchFd >= 0) {
+        drainEvents(now);
+    } else {
+        scanWriteTimes(now);
+    }
+
+    for (int file = 0; file < kWatchedFileCount; ++file) {
+        Pending &entry = pending[file];
+        if (!entry.waiting) {
+            continue;
+        }
+        std::error_code ec;
+        std::filesystem::path path = filePath(file);
+        auto writeTime = std::filesystem::last_write_time(path, ec);
+        auto size = ec ? 0 : std::filesystem::file_size(path, ec);
+        if (ec) {
+            // Deleted or renamed away mid-write; a later create/rename re-arms it.
+            entry.waiting = false;
+            continue;
+        }
+        if (writeTime != entry.writeTime) {
+            entry.writeTime = writeTime;
+            entry.settleFrom = now;
+            continue;
+        }
+        if (now - entry.settleFrom >= kQuietPeriod && size == expectedSize(file)) {
+            entry.waiting = false;
+            seen[file] = writeTime;
+            ready.set(file);
+        }
+    }
+    return ready;
+}
+
+} // namespace io
@@ -0,0 +1,69 @@
+// Watches the loaded slot's files in the saves folder so edits made by PM3 itself (e.g. under DOSBox) show up live.
+#pragma once
+
+#include <bitset>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+namespace io {
+
+enum WatchedFile : int {
+    kWatchGameA,
+    kWatchGameB,
+    kWatchGameC,
+    kWatchSavesDir,
+    kWatchedFileCount
+};
+
+using WatchedFiles = std::bitset<kWatchedFileCount>;
+
+// A change is only reported once the file has the size PM3 writes and its mtime has stopped moving for
+// kQuietPeriod, so a reader never sees DOSBox halfway through a write. Uses inotify on Linux and falls back to
+// stat() polling at the same cadence elsewhere. Not thread-safe; poll it from the UI loop.
+class SaveWatcher {
+public:
+    using Clock = std::chrono::steady_clock;
+    static constexpr std::chrono::milliseconds kQuietPeriod{500};
+
+    SaveWatcher() = default;
+    ~SaveWatcher();
+
+    SaveWatcher(const SaveWatcher &) = delete;
+    SaveWatcher &operator=(const SaveWatcher &) = delete;
+
+    // Watches GAMEnA/B/C for `gameNumber` (none when 0) and SAVES.DIR. Returns false if there is no saves folder.
+    bool watch(const std::filesystem::path &gamePath, int gameNumber);
+    void stop();
+
+    const std::filesystem::path &gamePath() const { return root; }
+    int gameNumber() const { return slot; }
+
+    // Files that changed and have settled since the last call.
+    WatchedFiles poll(Clock::time_point now = Clock::now());
+
+private:
+    struct Pending {
+        bool waiting = false;
+        Clock::time_point settleFrom{};
+        std::filesystem::file_time_type writeTime{};
+    };
+
+    void drainEvents(Clock::time_point now);
+    void scanWriteTimes(Clock::time_point now);
+    void markChanged(int file, Clock::time_point now);
+    std::filesystem::path filePath(int file) const;
+    static uintmax_t expectedSize(int file);
+
+    std::filesystem::path root;
+    std::filesystem::path folder;
+    int slot = 0;
+    std::string names[kWatchedFileCount];
+    Pending pending[kWatchedFileCount];
+    std::filesystem::file_time_type seen[kWatchedFileCount]{};
+    Clock::time_point lastScan{};
+    int watchFd = -1;
+};
+
+} // namespace io
@@ -76,7 +76,7 @@ void ChangeTeamScreen::draw(bool attachClickCallbacks) {
             changeApplied = false;
         }
 
-        ClubRecord &club = getClub(selectedClub);
+        ClubRecord &club = context.game().club(selectedClub);
         char clubText[34];
 
         if (!changeApplied) {
@@ -87,7 +87,7 @@ void ChangeTeamScreen::draw(bool attachClickCallbacks) {
                 std::string clubName(club.name, strnlen(club.name, sizeof(club.name)));
                 confirmChangeTeam(context, clubName,
                                   [this, selectedClub]() {
-                                      changeClub(selectedClub, context.gamePath(), 0);
+                                      changeClub(context.game(), selectedClub, context.gamePath(), 0);
                                       changeApplied = true;
                                   },
                                   clearSelection);
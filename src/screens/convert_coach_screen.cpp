@@ -4,6 +4,7 @@
 #include <functional>
 #include <string>
 
+#include "dirty_tracker.h"
 #include "text.h"
 #include "game_utils.h"
 
@@ -33,8 +34,8 @@ void confirmConvert(ScreenContext &context, const std::string &label, const std:
     context.addKeyPressCallback('N', clearPrompt);
 }
 
-void queueConvertCoachFax(int16_t playerIdx) {
-    auto &news = gameData.manager[0].news;
+void queueConvertCoachFax(GameState &state, int16_t playerIdx) {
+    auto &news = state.game.manager[0].news;
     int slot = 0;
     for (; slot < static_cast<int>(std::size(news)); ++slot) {
         if (news[slot].type == 0) {
@@ -45,6 +46,7 @@ void queueConvertCoachFax(int16_t playerIdx) {
         slot = 0;
     }
 
+    dirty_tracker::touch(news[slot]);
     news[slot].type = 20;
     news[slot].amount = 0;
     news[slot].ix1 = 0;
@@ -58,15 +60,15 @@ void ConvertCoachScreen::draw(bool attachClickCallbacks) {
 
     std::map<int8_t, PlayerRecord> validPlayers;
 
-    struct gamea::ManagerRecord &manager = gameData.manager[0];
-    ClubRecord &club = getClub(gameData.manager[0].club_idx);
+    struct gamea::ManagerRecord &manager = context.game().game.manager[0];
+    ClubRecord &club = context.game().club(context.game().game.manager[0].club_idx);
 
     for (int8_t i = 0; i < 24; ++i) {
         if (club.player_index[i] == -1) {
             continue;
         }
 
-        PlayerRecord &p = getPlayer(club.player_index[i]);
+        PlayerRecord &p = context.game().player(club.player_index[i]);
 
         if (p.age >= 29) {
             validPlayers[i] = p;
@@ -101,7 +103,7 @@ void ConvertCoachScreen::draw(bool attachClickCallbacks) {
         auto clickCallback = [&, playerIdx, playerName, globalPlayerIdx]() {
             confirmConvert(context, playerName, [&]() {
                 context.convertPlayerToCoach(manager, club, playerIdx);
-                queueConvertCoachFax(globalPlayerIdx);
+                queueConvertCoachFax(context.game(), globalPlayerIdx);
             });
         };
 
@@ -40,7 +40,7 @@ void FreePlayersScreen::draw(bool attachClickCallbacks) {
     long unsigned int end = pageSize * currentPage;
     end = end < players.size() ? end : players.size();
 
-    std::vector<club_player> displayPlayers(players.begin() + start, players.begin() + end);
+    std::vector<PlayerHandle> displayPlayers(players.begin() + start, players.begin() + end);
 
     context.writePlayers(displayPlayers, textLine, nullptr);
 }
@@ -31,14 +31,16 @@ void LoadGameScreen::draw(bool attachClickCallbacks) {
         context.formatSaveGameLabel(i, gameLabel, sizeof(gameLabel));
 
         SDL_Color rowColor = context.defaultTextColor(i + 2);
-        context.writeText(
-                gameLabel,
-                i + 2,
-                rowColor,
-                TEXT_TYPE_SMALL,
-                attachClickCallbacks ? std::function<void(void)>{[this, i] { context.loadGameConfirm(i); }}
-                                     : nullptr,
-                0
-        );
+        std::function<void(void)> clickCallback;
+        if (attachClickCallbacks) {
+            clickCallback = [this, i] { context.loadGameConfirm(i); };
+        }
+        int y = SLOT_LIST_TOP + (i - 1) * SLOT_ROW_HEIGHT;
+        context.writeTextAt(gameLabel, MARGIN_LEFT, y, rowColor, TEXT_TYPE_SMALL, clickCallback);
+        char summary[96];
+        if (context.formatSlotSummary(i, summary, sizeof(summary))) {
+            context.writeTextAt(summary, MARGIN_LEFT + SLOT_SUMMARY_INDENT, y + SLOT_SUMMARY_OFFSET, rowColor,
+                                TEXT_TYPE_PLAYER, clickCallback);
+        }
     }
 }
@@ -5,7 +5,7 @@
 void MyTeamScreen::draw([[maybe_unused]] bool attachClickCallbacks) {
     context.writeHeader("TEAM SQUAD", 1, nullptr);
 
-    std::vector<club_player> myPlayers = getMyPlayers(0);
+    std::vector<PlayerHandle> myPlayers = getMyPlayers(context.game(), 0);
 
     if (myPlayers.empty()) {
         context.writeText("No players found", 8, Colors::TEXT_1, TEXT_TYPE_SMALL, nullptr, 0);
@@ -14,7 +14,7 @@ void MyTeamScreen::draw([[maybe_unused]] bool attachClickCallbacks) {
 
     int textLine = 4;
 
-    textLine = context.writePlayers(myPlayers, textLine, std::function<void(const club_player &)>{});
+    textLine = context.writePlayers(myPlayers, textLine, std::function<void(const PlayerHandle &)>{});
 
     for (int i = textLine; i <= 27; i++) {
         char playerRow[69] = "................ . ............ .. .. .. .. .. .. .. . . . .. .....";
@@ -4,20 +4,18 @@
 #include <memory>
 #include <string>
 
+#include "dirty_tracker.h"
 #include "text.h"
 #include "game_utils.h"
+#include "save_ledger.h"
 
 namespace {
 constexpr int kMaxLoanWeeks = 36;
-constexpr int kLoanPeriodType = 20;
-constexpr int kTurnsPerWeek = 3;
 
 struct LoanState {
-    club_player playerInfo;
+    PlayerHandle player;
     int weeks = 0;
     int fee = 0;
-    int16_t playerIdx = -1;
-    int fromClubIdx = -1;
 };
 
 void clearInput(ScreenContext &context) {
@@ -39,19 +37,23 @@ void finalizeLoan(ScreenContext &context, const std::shared_ptr<LoanState> &stat
 
     context.resetKeyPressCallbacks();
 
-    if (state->playerIdx < 0 || state->fromClubIdx < 0) {
+    // Something else may have moved him while the weeks were being typed.
+    GameState &game = context.game();
+    if (!game.isCurrent(state->player)) {
         context.setFooterLine("Player not found");
         return;
     }
+    int16_t playerIdx = state->player.playerIdx;
+    int fromClubIdx = state->player.clubIdx;
 
-    int myClubIdx = gameData.manager[0].club_idx;
-    if (state->fromClubIdx == myClubIdx) {
+    int myClubIdx = game.game.manager[0].club_idx;
+    if (fromClubIdx == myClubIdx) {
         context.setFooterLine("Player already in your squad");
         return;
     }
 
-    ClubRecord &myClub = getClub(myClubIdx);
-    ClubRecord &fromClub = getClub(state->fromClubIdx);
+    ClubRecord &myClub = game.club(myClubIdx);
+    ClubRecord &fromClub = game.club(fromClubIdx);
 
     if (game_utils::findEmptySlot(myClub) == -1) {
         context.setFooterLine("No free slot in your squad");
@@ -63,12 +65,10 @@ void finalizeLoan(ScreenContext &context, const std::shared_ptr<LoanState> &stat
         return;
     }
 
-    for (int slot = 0; slot < 24; ++slot) {
-        if (fromClub.player_index[slot] == state->playerIdx) {
-            fromClub.player_index[slot] = -1;
-            break;
-        }
-    }
+    dirty_tracker::touch(myClub);
+    dirty_tracker::touch(fromClub);
+    dirty_tracker::touch(game.player(playerIdx));
+    game.setSquadSlot(fromClubIdx, state->player.slot, -1);
 
     int destSlot = game_utils::findEmptySlot(myClub);
     if (destSlot == -1) {
@@ -76,34 +76,34 @@ void finalizeLoan(ScreenContext &context, const std::shared_ptr<LoanState> &stat
         return;
     }
 
-    myClub.player_index[destSlot] = state->playerIdx;
+    game.setSquadSlot(myClubIdx, destSlot, playerIdx);
     myClub.bank_account -= state->fee;
     fromClub.bank_account += state->fee;
 
-    PlayerRecord &player = getPlayer(state->playerIdx);
-    player.period = static_cast<uint8_t>(state->weeks * kTurnsPerWeek);
-    player.period_type = static_cast<uint8_t>(kLoanPeriodType);
+    PlayerRecord &player = game.player(playerIdx);
+    player.period = static_cast<uint8_t>(state->weeks * save_ledger::kTurnsPerWeek);
+    player.period_type = save_ledger::kLoanPeriodType;
+    save_ledger::recordLoan(game, playerIdx, fromClubIdx, myClubIdx, state->fee, state->weeks);
 
     context.setFooterLine("Player is loaned");
 }
 
-void startLoanFlow(ScreenContext &context, const club_player &playerInfo) {
+void startLoanFlow(ScreenContext &context, const PlayerHandle &handle) {
     if (!context.startReadingTextInput || !context.endReadingTextInput || !context.currentTextInput ||
         !context.addKeyPressCallback || !context.resetKeyPressCallbacks || !context.setFooterLine) {
         return;
     }
 
     auto state = std::make_shared<LoanState>();
-    state->playerInfo = playerInfo;
-    state->playerIdx = game_utils::findPlayerIndex(playerInfo.player);
-    if (state->playerIdx >= 0) {
-        state->fromClubIdx = game_utils::findClubIndexForPlayer(state->playerIdx);
-    }
-
-    if (state->playerIdx < 0 || state->fromClubIdx < 0) {
+    state->player = handle;
+    if (!context.game().isCurrent(handle)) {
         context.setFooterLine("Player not found");
         return;
     }
+    if (save_ledger::activeLoan(handle.playerIdx) != nullptr) {
+        context.setFooterLine("Player is already on loan");
+        return;
+    }
 
     context.resetKeyPressCallbacks();
     context.endReadingTextInput();
@@ -125,7 +125,7 @@ void startLoanFlow(ScreenContext &context, const club_player &playerInfo) {
         }
 
         state->weeks = weeks;
-        state->fee = weeks * state->playerInfo.player.wage;
+        state->fee = weeks * context.game().player(state->player).wage;
 
         context.endReadingTextInput();
         context.resetKeyPressCallbacks();
@@ -148,10 +148,10 @@ void startLoanFlow(ScreenContext &context, const club_player &playerInfo) {
     context.addKeyPressCallback(SDLK_ESCAPE, [&context]() { clearInput(context); });
 }
 
-void startLoanOrBuyFlow(ScreenContext &context, const club_player &playerInfo) {
+void startLoanOrBuyFlow(ScreenContext &context, const PlayerHandle &handle) {
     if (!context.addKeyPressCallback || !context.resetKeyPressCallbacks || !context.setFooterLine) {
         if (context.makeOffer) {
-            context.makeOffer(playerInfo);
+            context.makeOffer(handle);
         }
         return;
     }
@@ -159,18 +159,18 @@ void startLoanOrBuyFlow(ScreenContext &context, const club_player &playerInfo) {
     context.resetKeyPressCallbacks();
     context.setFooterLine("           Loan or buy [L/B]?");
 
-    context.addKeyPressCallback('b', [&context, playerInfo]() {
+    context.addKeyPressCallback('b', [&context, handle]() {
         if (context.makeOffer) {
-            context.makeOffer(playerInfo);
+            context.makeOffer(handle);
         }
     });
-    context.addKeyPressCallback('B', [&context, playerInfo]() {
+    context.addKeyPressCallback('B', [&context, handle]() {
         if (context.makeOffer) {
-            context.makeOffer(playerInfo);
+            context.makeOffer(handle);
         }
     });
-    context.addKeyPressCallback('l', [&context, playerInfo]() { startLoanFlow(context, playerInfo); });
-    context.addKeyPressCallback('L', [&context, playerInfo]() { startLoanFlow(context, playerInfo); });
+    context.addKeyPressCallback('l', [&context, handle]() { startLoanFlow(context, handle); });
+    context.addKeyPressCallback('L', [&context, handle]() { startLoanFlow(context, handle); });
     context.addKeyPressCallback(SDLK_ESCAPE, [&context]() { clearInput(context); });
 }
 } // namespace
@@ -183,21 +183,12 @@ void ScoutScreen::draw(bool attachClickCallbacks) {
     } else if (context.selectedClub() == -1) {
         context.writeClubMenu("CHOOSE TEAM TO SCOUT", attachClickCallbacks);
     } else {
-        ClubRecord &club = getClub(context.selectedClub());
-        std::vector<club_player> players{};
-
-        for (int i = 0; i < 24; ++i) {
-            if (club.player_index[i] == -1) {
-                continue;
-            }
-            PlayerRecord &p = getPlayer(club.player_index[i]);
-            players.push_back(club_player{club, p});
-        }
+        std::vector<PlayerHandle> players = squadPlayers(context.game(), context.selectedClub());
 
         int textLine = 4;
-        context.writePlayers(players, textLine, attachClickCallbacks ? [this](const club_player &playerInfo) {
-            startLoanOrBuyFlow(context, playerInfo);
-        } : std::function<void(const club_player &)>{});
+        context.writePlayers(players, textLine, attachClickCallbacks ? [this](const PlayerHandle &handle) {
+            startLoanOrBuyFlow(context, handle);
+        } : std::function<void(const PlayerHandle &)>{});
 
         context.writeText(
                 "« Back",
@@ -8,10 +8,14 @@
 #include <SDL.h>
 #include "pm3_defs.hh"
 
+struct GameState;
+
 struct ScreenContext {
     std::function<void(const char *)> drawBackground;
     std::function<void(const char *, int, const std::function<void(void)> &)> writeTextLarge;
     std::function<void(const char *, int, SDL_Color, int, const std::function<void(void)> &, int)> writeText;
+    // writeText at a pixel position, for rows that do not follow the line grid.
+    std::function<void(const char *, int, int, SDL_Color, int, const std::function<void(void)> &)> writeTextAt;
     std::function<void(const char *, int, int, int, SDL_Color, int, const std::function<void(void)> &)> addTextBlock;
     std::function<SDL_Color(int)> defaultTextColor;
     std::function<int()> currentGame;
@@ -19,20 +23,24 @@ struct ScreenContext {
     std::function<void(int, int)> setPagination;
     std::function<const std::filesystem::path &()> gamePath;
     std::function<Pm3GameType()> gameType;
+    // The open save the screens show and edit.
+    std::function<GameState &()> game;
     std::function<void()> choosePm3Folder;
     std::function<void()> importSwosTeams;
     std::function<void()> levelAggression;
     std::function<void(const char *)> setFooter;
     std::function<bool(bool)> ensureMetadataLoaded;
     std::function<void(int, char *, size_t)> formatSaveGameLabel;
+    std::function<bool(int, char *, size_t)> formatSlotSummary;
     std::function<const std::bitset<8> &()> saveFiles;
     std::function<void(int)> loadGameConfirm;
     std::function<void(int)> saveGameConfirm;
     std::function<void(const char *, int, const std::function<void(void)> &)> writeHeader;
     std::function<void(const char *, int, const std::function<void(void)> &)> writeSubHeader;
-    std::function<std::vector<club_player>&()> freePlayersRef;
+    std::function<std::vector<PlayerHandle>&()> freePlayersRef;
     std::function<void()> refreshFreePlayers;
-    std::function<int(std::vector<club_player> &, int &, const std::function<void(const club_player &)> &)> writePlayers;
+    std::function<int(const std::vector<PlayerHandle> &, int &, const std::function<void(const PlayerHandle &)> &)>
+            writePlayers;
     std::function<void(const char *)> setFooterLine;
     std::function<void()> resetTextBlocks;
     std::function<int()> selectedDivision;
@@ -45,7 +53,7 @@ struct ScreenContext {
     std::function<void(std::function<void(void)>)> startReadingTextInput;
     std::function<void()> endReadingTextInput;
     std::function<const char *()> currentTextInput;
-    std::function<void(const club_player &)> makeOffer;
+    std::function<void(const PlayerHandle &)> makeOffer;
     std::function<void(const char *, bool)> writeDivisionsMenu;
     std::function<void(const char *, bool)> writeClubMenu;
     std::function<void(struct gamea::ManagerRecord &, ClubRecord &, int8_t)> convertPlayerToCoach;
@@ -6,6 +6,7 @@
 #include <string>
 #include <vector>
 
+#include "dirty_tracker.h"
 #include "text.h"
 #include "pm3_data.h"
 #include "game_utils.h"
@@ -141,11 +142,12 @@ void TelephoneScreen::draw(bool attachClickCallbacks) {
             showInsufficientFunds();
             return false;
         }
+        dirty_tracker::touch(club);
         club.bank_account -= amount;
         return true;
     };
-    auto isTrainingCampWeek = []() {
-        int currentWeek = static_cast<int>(gameData.turn) / 3 + 1;
+    auto isTrainingCampWeek = [this]() {
+        int currentWeek = static_cast<int>(context.game().game.turn) / 3 + 1;
         return currentWeek == 37;
     };
     auto showTrainingCampRestriction = [this]() {
@@ -160,8 +162,8 @@ void TelephoneScreen::draw(bool attachClickCallbacks) {
                 confirm("ADVERTISE FOR FANS", [this, attemptSpend] {
                     context.resetTextBlocks();
                     context.setFooterLine("");
-                    struct gamea::ManagerRecord &manager = gameData.manager[0];
-                    ClubRecord &club = getClub(manager.club_idx);
+                    struct gamea::ManagerRecord &manager = context.game().game.manager[0];
+                    ClubRecord &club = context.game().club(manager.club_idx);
 
                     if (!attemptSpend(club, 25000)) {
                         return;
@@ -179,15 +181,16 @@ void TelephoneScreen::draw(bool attachClickCallbacks) {
                 confirm("ENTERTAIN TEAM", [this, attemptSpend] {
                     context.resetTextBlocks();
                     context.setFooterLine("");
-                    struct gamea::ManagerRecord &manager = gameData.manager[0];
-                    ClubRecord &club = getClub(manager.club_idx);
+                    struct gamea::ManagerRecord &manager = context.game().game.manager[0];
+                    ClubRecord &club = context.game().club(manager.club_idx);
 
                     if (!attemptSpend(club, 5000)) {
                         return;
                     }
 
                     for (int i = 0; i < 24; ++i) {
-                        PlayerRecord &player = getPlayer(club.player_index[i]);
+                        PlayerRecord &player = context.game().player(club.player_index[i]);
+                        dirty_tracker::touch(player);
                         player.morl = 9;
                     }
 
@@ -204,15 +207,16 @@ void TelephoneScreen::draw(bool attachClickCallbacks) {
                 confirm("ARRANGE SMALL TRAINING CAMP", [this, attemptSpend] {
                     context.resetTextBlocks();
                     context.setFooterLine("");
-                    struct gamea::ManagerRecord &manager = gameData.manager[0];
-                    ClubRecord &club = getClub(manager.club_idx);
+                    struct gamea::ManagerRecord &manager = context.game().game.manager[0];
+                    ClubRecord &club = context.game().club(manager.club_idx);
 
                     if (!attemptSpend(club, 500000)) {
                         return;
                     }
 
                     for (int i = 0; i < 24; ++i) {
-                        PlayerRecord &player = getPlayer(club.player_index[i]);
+                        PlayerRecord &player = context.game().player(club.player_index[i]);
+                        dirty_tracker::touch(player);
                         player.hn = std::min(player.hn + std::rand() % 2, 99);
                         player.tk = std::min(player.tk + std::rand() % 2, 99);
                         player.ps = std::min(player.ps + std::rand() % 2, 99);
@@ -237,15 +241,16 @@ void TelephoneScreen::draw(bool attachClickCallbacks) {
                 confirm("ARRANGE MEDIUM TRAINING CAMP", [this, attemptSpend] {
                     context.resetTextBlocks();
                     context.setFooterLine("");
-                    struct gamea::ManagerRecord &manager = gameData.manager[0];
-                    ClubRecord &club = getClub(manager.club_idx);
+                    struct gamea::ManagerRecord &manager = context.game().game.manager[0];
+                    ClubRecord &club = context.game().club(manager.club_idx);
 
                     if (!attemptSpend(club, 1000000)) {
                         return;
                     }
 
                     for (int i = 0; i < 24; ++i) {
-                        PlayerRecord &player = getPlayer(club.player_index[i]);
+                        PlayerRecord &player = context.game().player(club.player_index[i]);
+                        dirty_tracker::touch(player);
 
                         player.hn += std::rand() % 4;
                         player.hn = player.hn > 99 ? 99 : player.hn;
@@ -278,15 +283,16 @@ void TelephoneScreen::draw(bool attachClickCallbacks) {
                 confirm("ARRANGE LARGE TRAINING CAMP", [this, attemptSpend] {
                     context.resetTextBlocks();
                     context.setFooterLine("");
-                    struct gamea::ManagerRecord &manager = gameData.manager[0];
-                    ClubRecord &club = getClub(manager.club_idx);
+                    struct gamea::ManagerRecord &manager = context.game().game.manager[0];
+                    ClubRecord &club = context.game().club(manager.club_idx);
 
                     if (!attemptSpend(club, 2000000)) {
                         return;
                     }
 
                     for (int i = 0; i < 24; ++i) {
-                        PlayerRecord &player = getPlayer(club.player_index[i]);
+                        PlayerRecord &player = context.game().player(club.player_index[i]);
+                        dirty_tracker::touch(player);
                         player.hn = std::min(player.hn + std::rand() % 8, 99);
                         player.tk = std::min(player.tk + std::rand() % 8, 99);
                         player.ps = std::min(player.ps + std::rand() % 8, 99);
@@ -307,14 +313,15 @@ void TelephoneScreen::draw(bool attachClickCallbacks) {
                 confirm("APPEAL RED CARD", [this, attemptSpend] {
                     context.resetTextBlocks();
                     context.setFooterLine("");
-                    struct gamea::ManagerRecord &manager = gameData.manager[0];
-                    ClubRecord &club = getClub(manager.club_idx);
+                    struct gamea::ManagerRecord &manager = context.game().game.manager[0];
+                    ClubRecord &club = context.game().club(manager.club_idx);
                     std::string result = "No banned player found";
 
                     for (int i = 0; i < 24; ++i) {
-                        PlayerRecord &player = getPlayer(club.player_index[i]);
+                        PlayerRecord &player = context.game().player(club.player_index[i]);
                         if (player.period > 0 && player.period_type == 0) {
                             if (std::rand() % 2 == 0) {
+                                dirty_tracker::touch(player.period);
                                 player.period = 0;
                                 result = "\"We see what you mean. We've overturned the decision for " +
                                          std::string(player.name, sizeof(player.name)) + ".\" - The FA";
@@ -333,8 +340,8 @@ void TelephoneScreen::draw(bool attachClickCallbacks) {
             {"BUILD NEW 25k SEAT STADIUM    (£5,000,000)", 9, [this, confirm, attemptSpend] {
                 confirm("BUILD NEW 25k SEAT STADIUM", [this, attemptSpend] {
                     context.resetTextBlocks();
-                    struct gamea::ManagerRecord &manager = gameData.manager[0];
-                    ClubRecord &club = getClub(manager.club_idx);
+                    struct gamea::ManagerRecord &manager = context.game().game.manager[0];
+                    ClubRecord &club = context.game().club(manager.club_idx);
 
                     int currentStadiumValue = calculateStadiumValue(manager);
                     int upgradeCost = 5000000 - currentStadiumValue;
@@ -343,6 +350,7 @@ void TelephoneScreen::draw(bool attachClickCallbacks) {
                         return;
                     }
 
+                    dirty_tracker::touch(manager.stadium);
                     club.seating_max = 25000;
 
                     manager.stadium.ground_facilities.level = 2;
@@ -376,14 +384,15 @@ void TelephoneScreen::draw(bool attachClickCallbacks) {
             {"BUILD NEW 50k SEAT STADIUM   (£15,000,000)", 10, [this, confirm, attemptSpend] {
                 confirm("BUILD NEW 50k SEAT STADIUM", [this, attemptSpend] {
                     context.resetTextBlocks();
-                    struct gamea::ManagerRecord &manager = gameData.manager[0];
-                    ClubRecord &club = getClub(manager.club_idx);
+                    struct gamea::ManagerRecord &manager = context.game().game.manager[0];
+                    ClubRecord &club = context.game().club(manager.club_idx);
 
                     int currentStadiumValue = calculateStadiumValue(manager);
                     int upgradeCost = 15000000 - currentStadiumValue;
                     if (!attemptSpend(club, upgradeCost)) {
                         return;
                     }
+                    dirty_tracker::touch(manager.stadium);
                     club.seating_max = 50000;
 
                     manager.stadium.ground_facilities.level = 2;
@@ -417,8 +426,8 @@ void TelephoneScreen::draw(bool attachClickCallbacks) {
             {"BUILD NEW 100k SEAT STADIUM  (£30,000,000)", 11, [this, confirm, attemptSpend] {
                 confirm("BUILD NEW 100k SEAT STADIUM", [this, attemptSpend] {
                     context.resetTextBlocks();
-                    struct gamea::ManagerRecord &manager = gameData.manager[0];
-                    ClubRecord &club = getClub(manager.club_idx);
+                    struct gamea::ManagerRecord &manager = context.game().game.manager[0];
+                    ClubRecord &club = context.game().club(manager.club_idx);
 
                     int currentStadiumValue = calculateStadiumValue(manager);
                     int upgradeCost = 30000000 - currentStadiumValue;
@@ -426,6 +435,7 @@ void TelephoneScreen::draw(bool attachClickCallbacks) {
                         return;
                     }
 
+                    dirty_tracker::touch(manager.stadium);
                     club.seating_max = 100000;
 
                     manager.stadium.ground_facilities.level = 3;
@@ -0,0 +1,189 @@
+// Per-slot summaries kept in one small index file next to the backups.
+#include "slot_summary.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <system_error>
+
+#include "crc32c.h"
+#include "pm3_schema.h"
+#include "save_fingerprint.h"
+#include "save_journal.h"
+
+namespace slot_summary {
+
+namespace {
+constexpr const char *kIndexHeader = "PM3000-SLOTS 1";
+
+const char *ordinalSuffix(int n) {
+    if (n % 100 >= 11 && n % 100 <= 13) {
+        return "th";
+    }
+    switch (n % 10) {
+        case 1:
+            return "st";
+        case 2:
+            return "nd";
+        case 3:
+            return "rd";
+        default:
+            return "th";
+    }
+}
+
+std::string groupThousands(int32_t amount) {
+    std::string text = std::to_string(amount < 0 ? -static_cast<int64_t>(amount) : amount);
+    for (int insertPosition = static_cast<int>(text.length()) - 3; insertPosition > 0; insertPosition -= 3) {
+        text.insert(static_cast<std::size_t>(insertPosition), ",");
+    }
+    return amount < 0 ? "-" + text : text;
+}
+} // namespace
+
+Summary compute(const gamea &gameA, const gameb &gameB, const gamec &gameC) {
+    Summary summary;
+    summary.files[0] = {sizeof(gamea), 0, crc32c::compute(&gameA, sizeof(gamea))};
+    summary.files[1] = {sizeof(gameb), 0, crc32c::compute(&gameB, sizeof(gameb))};
+    summary.files[2] = {sizeof(gamec), 0, crc32c::compute(&gameC, sizeof(gamec))};
+
+    summary.clubIdx = gameA.manager[0].club_idx;
+    if (summary.clubIdx < 0 || summary.clubIdx >= kClubIdxMax) {
+        return summary;
+    }
+
+    // The table rows are in divisionNames order; rank the club against the rest of its division.
+    int first = 0;
+    for (int division = 0; division < static_cast<int>(pm3_schema::kDivisionSlots.size()); ++division) {
+        int count = pm3_schema::kDivisionSlots[division];
+        for (int row = first; row < first + count; ++row) {
+            if (gameA.table.all[row].club_idx != summary.clubIdx) {
+                continue;
+            }
+            summary.division = division;
+            summary.points = pm3_schema::tablePoints(gameA.table.all[row]);
+            summary.leaguePosition = pm3_schema::leaguePosition(&gameA.table.all[first], count, row - first);
+        }
+        first += count;
+    }
+
+    const ClubRecord &club = gameB.club[summary.clubIdx];
+    summary.bankBalance = club.bank_account;
+    int skillTotal = 0;
+    for (int slot = 0; slot < static_cast<int>(std::size(club.player_index)); ++slot) {
+        int16_t idx = club.player_index[slot];
+        if (idx < 0 || idx >= static_cast<int>(std::size(gameC.player))) {
+            continue;
+        }
+        const PlayerRecord &player = gameC.player[idx];
+        skillTotal += std::max({player.hn, player.tk, player.ps, player.sh});
+        ++summary.squadSize;
+    }
+    if (summary.squadSize > 0) {
+        summary.squadStrength = (skillTotal + summary.squadSize / 2) / summary.squadSize;
+    }
+    return summary;
+}
+
+std::string describe(const Summary &summary) {
+    char text[96];
+    std::string bank = groupThousands(summary.bankBalance);
+    if (summary.division >= 0) {
+        std::snprintf(text, sizeof(text), "%d%s in %s, %d pts  Bank %s  Squad %d, rating %d",
+                      summary.leaguePosition, ordinalSuffix(summary.leaguePosition),
+                      divisionNames[static_cast<std::size_t>(summary.division)], summary.points, bank.c_str(),
+                      summary.squadSize, summary.squadStrength);
+    } else {
+        std::snprintf(text, sizeof(text), "Bank %s  Squad %d, rating %d", bank.c_str(), summary.squadSize,
+                      summary.squadStrength);
+    }
+    return text;
+}
+
+bool matchesDisk(const Summary &summary, const std::filesystem::path (&files)[kSlotFileCount]) {
+    for (int i = 0; i < kSlotFileCount; ++i) {
+        std::error_code ec;
+        auto size = std::filesystem::file_size(files[i], ec);
+        if (ec || size != summary.files[i].size || summary.files[i].writeTime == 0 ||
+            save_fingerprint::writeTimeOf(files[i]) != summary.files[i].writeTime) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::filesystem::path indexPath(const std::filesystem::path &backupDir) {
+    return backupDir / kIndexFile;
+}
+
+Index read(const std::filesystem::path &index) {
+    Index contents;
+    std::ifstream in(index);
+    std::string line;
+    if (!std::getline(in, line) || line != kIndexHeader) {
+        return contents;
+    }
+
+    Index parsed;
+    Summary *slot = nullptr;
+    int file = 0;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string tag;
+        fields >> tag;
+        if (tag == "slot") {
+            int number = 0;
+            Summary summary;
+            fields >> number >> summary.clubIdx >> summary.division >> summary.leaguePosition >> summary.points >>
+                    summary.bankBalance >> summary.squadSize >> summary.squadStrength;
+            if (!fields || number < 1 || number > kSlotCount) {
+                return contents;
+            }
+            parsed.slots[number - 1] = summary;
+            slot = &*parsed.slots[number - 1];
+            file = 0;
+        } else if (tag == "file" && slot && file < kSlotFileCount) {
+            FileStamp &stamp = slot->files[file++];
+            long long writeTime = 0;
+            std::string crc;
+            fields >> stamp.size >> writeTime >> crc;
+            stamp.writeTime = writeTime;
+            stamp.crc = static_cast<uint32_t>(std::strtoul(crc.c_str(), nullptr, 16));
+        } else if (tag == "end") {
+            return parsed;
+        } else {
+            return contents;
+        }
+    }
+    // Truncated: keep nothing rather than a summary with missing files.
+    return contents;
+}
+
+void write(const std::filesystem::path &index, const Index &contents) {
+    std::ostringstream text;
+    text << kIndexHeader << "\n";
+    for (int i = 0; i < kSlotCount; ++i) {
+        if (!contents.slots[i]) {
+            continue;
+        }
+        const Summary &summary = *contents.slots[i];
+        text << "slot " << i + 1 << " " << summary.clubIdx << " " << summary.division << " "
+             << summary.leaguePosition << " " << summary.points << " " << summary.bankBalance << " "
+             << summary.squadSize << " " << summary.squadStrength << "\n";
+        for (const FileStamp &stamp : summary.files) {
+            char crc[9];
+            std::snprintf(crc, sizeof(crc), "%08x", stamp.crc);
+            text << "file " << stamp.size << " " << static_cast<long long>(stamp.writeTime) << " " << crc << "\n";
+        }
+    }
+    text << "end\n";
+
+    std::filesystem::create_directories(index.parent_path());
+    std::string body = text.str();
+    save_journal::replaceFileDurably(index, body.data(), body.size());
+}
+
+} // namespace slot_summary
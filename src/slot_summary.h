@@ -0,0 +1,58 @@
+// Per-slot summaries (league position, points, bank balance, squad strength) kept in one small index file, so the
+// Load and Save screens can describe every slot without reading its files.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+
+#include "pm3_defs.hh"
+
+namespace slot_summary {
+
+inline constexpr int kSlotCount = 8;
+inline constexpr int kSlotFileCount = 3;
+inline constexpr const char *kIndexFile = "SLOTS.IDX";
+
+// A slot file as summarised: size and mtime tell with one stat() whether the summary still applies, the CRC32C
+// whether two slots hold the same contents.
+struct FileStamp {
+    uint64_t size = 0;
+    int64_t writeTime = 0;
+    uint32_t crc = 0;
+};
+
+struct Summary {
+    int16_t clubIdx = -1;   // the first manager's club
+    int division = -1;      // index into divisionNames; -1 if the club is in no league table
+    int leaguePosition = 0; // 1-based, by points, goal difference, then goals scored
+    int points = 0;
+    int32_t bankBalance = 0;
+    int squadSize = 0;
+    int squadStrength = 0; // mean of each squad player's best skill (HN, TK, PS or SH)
+    FileStamp files[kSlotFileCount];
+};
+
+struct Index {
+    std::optional<Summary> slots[kSlotCount]; // slot n at [n - 1]
+};
+
+// Everything but the write times, which the caller stamps from the files the contents were read from or written to.
+Summary compute(const gamea &gameA, const gameb &gameB, const gamec &gameC);
+
+// "3rd in Division One, 45 pts  Bank 1,250,000  Squad 18, rating 74"
+std::string describe(const Summary &summary);
+
+// True if every file still has the recorded size and mtime. Never true for a summary without write times.
+bool matchesDisk(const Summary &summary, const std::filesystem::path (&files)[kSlotFileCount]);
+
+// <saves>/PM3000/SLOTS.IDX
+std::filesystem::path indexPath(const std::filesystem::path &backupDir);
+// A missing or unreadable index reads as empty.
+Index read(const std::filesystem::path &index);
+// Replaces the index atomically. Like the checksum sidecars it is only a cache, so its directory is not synced.
+void write(const std::filesystem::path &index, const Index &contents);
+
+} // namespace slot_summary
@@ -21,7 +21,10 @@
 
 #include "game_utils.h"
 #include "io.h"
+#include "pm3_codec.h"
 #include "pm3_data.h"
+#include "pm3_schema.h"
+#include "save_validator.h"
 
 #include "swos_extract.hpp"
 
@@ -161,17 +164,17 @@ uint8_t toNibble(uint8_t swosColor) {
 
 using Pm3Kit = std::remove_reference<decltype(ClubRecord::kit[0])>::type;
 
-std::string formatClubLabel(int idx) {
+std::string formatClubLabel(const GameState &state, int idx) {
     if (idx < 0 || idx >= kClubIdxMax) {
         return "<invalid>";
     }
-    const ClubRecord &club = getClub(idx);
+    const ClubRecord &club = state.club(idx);
     auto safeLen = strnlen(club.name, sizeof(club.name));
     return std::string(club.name, safeLen);
 }
 
-std::string clubSortKey(int idx) {
-    std::string name = formatClubLabel(idx);
+std::string clubSortKey(const GameState &state, int idx) {
+    std::string name = formatClubLabel(state, idx);
     for (char &c : name) {
         unsigned char uc = static_cast<unsigned char>(c);
         c = static_cast<char>(std::toupper(uc));
@@ -271,14 +274,10 @@ void writeName(char *dest, size_t destSize, const std::string &name) {
 }
 
 int16_t decodePlayerIndex(int16_t raw, bool swapEndian) {
-    if (!swapEndian) {
-        return raw;
-    }
-    uint16_t u = static_cast<uint16_t>(raw);
-    return static_cast<int16_t>((u >> 8) | (u << 8));
+    return swapEndian ? pm3_codec::byteSwap16(raw) : raw;
 }
 
-int renamePlayers(ClubRecord &club, const std::vector<swos::Player> &swosPlayers) {
+int renamePlayers(GameState &state, ClubRecord &club, const std::vector<swos::Player> &swosPlayers) {
     struct SlotInfo {
         int slot;
         PlayerRecord *record;
@@ -291,10 +290,10 @@ int renamePlayers(ClubRecord &club, const std::vector<swos::Player> &swosPlayers
     slots.reserve(24);
     for (int slot = 0; slot < 24; ++slot) {
         int16_t idx = decodePlayerIndex(club.player_index[slot], true);
-        if (idx < 0 || idx >= static_cast<int>(std::size(playerData.player))) {
+        if (idx < 0 || idx >= static_cast<int>(std::size(state.players.player))) {
             continue;
         }
-        PlayerRecord &p = getPlayer(idx);
+        PlayerRecord &p = state.player(idx);
         slots.push_back({slot, &p, determinePlayerType(p), determinePlayerRating(p), false});
     }
 
@@ -332,7 +331,8 @@ int renamePlayers(ClubRecord &club, const std::vector<swos::Player> &swosPlayers
     return renamed;
 }
 
-void checkGameDataStructure(const std::string &stage, const std::string &pm3Path) {
+void checkGameDataStructure(const std::string &stage, const std::string &pm3Path,
+                            const save_validator::Report &report) {
     std::vector<std::string> issues;
     auto logIssue = [&](std::string msg) {
         issues.push_back(std::move(msg));
@@ -352,117 +352,13 @@ void checkGameDataStructure(const std::string &stage, const std::string &pm3Path
         }
     }
 
-    auto isValidClub = [](int idx) { return idx >= 0 && idx < kClubIdxMax; };
-    auto isValidPlayer = [](int idx) {
-        return idx >= 0 && idx < static_cast<int>(std::size(playerData.player));
-    };
-
-    auto checkClub = [&](const std::string &details, int idx) {
-        if (idx == -1) {
-            return;
-        }
-        if (!isValidClub(idx)) {
-            logIssue(details + " references invalid club " + std::to_string(idx));
-        }
-    };
-
-    auto checkPlayer = [&](const std::string &details, int idx) {
-        if (idx == -1) {
-            return;
-        }
-        if (!isValidPlayer(idx)) {
-            logIssue(details + " references invalid player " + std::to_string(idx));
-        }
-    };
-
-    auto checkIndexArray = [&](const std::string &label, const int16_t *arr, int count) {
-        for (int i = 0; i < count; ++i) {
-            checkClub(label + " slot " + std::to_string(i), arr[i]);
-        }
-    };
-
-    checkIndexArray("club_index.premier_league", gameData.club_index.leagues.premier_league, 22);
-    checkIndexArray("club_index.division_one", gameData.club_index.leagues.division_one, 24);
-    checkIndexArray("club_index.division_two", gameData.club_index.leagues.division_two, 24);
-    checkIndexArray("club_index.division_three", gameData.club_index.leagues.division_three, 22);
-    checkIndexArray("club_index.conference_league", gameData.club_index.leagues.conference_league, 22);
-
-    auto checkTableArray = [&](const std::string &label, const gamea::TableDivision *rows, int count) {
-        for (int i = 0; i < count; ++i) {
-            checkClub(label + " row " + std::to_string(i), rows[i].club_idx);
-        }
-    };
-
-    checkTableArray("table.premier_league", gameData.table.leagues.premier_league, 22);
-    checkTableArray("table.division_one", gameData.table.leagues.division_one, 24);
-    checkTableArray("table.division_two", gameData.table.leagues.division_two, 24);
-    checkTableArray("table.division_three", gameData.table.leagues.division_three, 22);
-    checkTableArray("table.conference_league", gameData.table.leagues.conference_league, 22);
-
-    for (int i = 0; i < 75; ++i) {
-        const auto &entry = gameData.top_scorers.all[i];
-        checkPlayer("top_scorer[" + std::to_string(i) + "].player_idx", entry.player_idx);
-        checkClub("top_scorer[" + std::to_string(i) + "].club_idx", entry.club_idx);
-    }
-
-    for (int i = 0; i < 149; ++i) {
-        const auto &entry = gameData.cuppy.all[i];
-        checkClub("cup_entry[" + std::to_string(i) + "].club[0]", entry.club[0].idx);
-        checkClub("cup_entry[" + std::to_string(i) + "].club[1]", entry.club[1].idx);
-    }
-
-    for (int i = 0; i < 2; ++i) {
-        checkClub("charity_shield.club[" + std::to_string(i) + "]", gameData.the_charity_shield_history.club[i].idx);
-    }
-
-    for (int i = 0; i < 16; ++i) {
-        checkClub("some_table[" + std::to_string(i) + "].club1", gameData.some_table[i].club1_idx);
-        checkClub("some_table[" + std::to_string(i) + "].club2", gameData.some_table[i].club2_idx);
-    }
-
-    for (int i = 0; i < 57; ++i) {
-        const auto &entry = gameData.last_results.all[i];
-        checkClub("last_results[" + std::to_string(i) + "].club[0]", entry.club[0].idx);
-        checkClub("last_results[" + std::to_string(i) + "].club[1]", entry.club[1].idx);
-    }
-
-    for (int i = 0; i < 5; ++i) {
-        for (int j = 0; j < 20; ++j) {
-            const auto &history = gameData.league[i].history[j];
-            checkClub("league[" + std::to_string(i) + "].history[" + std::to_string(j) + "]", history.club_idx);
-        }
-    }
-
-    for (int i = 0; i < 6; ++i) {
-        for (int j = 0; j < 20; ++j) {
-            const auto &history = gameData.cup[i].history[j];
-            checkClub("cup[" + std::to_string(i) + "].history[" + std::to_string(j) + "].winner", history.club_idx_winner);
-            checkClub("cup[" + std::to_string(i) + "].history[" + std::to_string(j) + "].runner_up", history.club_idx_runner_up);
+    // Squad slots are reported by checkConsistency with club names.
+    for (const save_validator::Issue &issue : report.issues) {
+        if (issue.file == 0) {
+            logIssue(save_validator::describe(issue));
         }
     }
 
-    for (int i = 0; i < 20; ++i) {
-        const auto &fixture = gameData.fixture[i];
-        checkClub("fixture[" + std::to_string(i) + "].club1", fixture.club_idx1);
-        checkClub("fixture[" + std::to_string(i) + "].club2", fixture.club_idx2);
-    }
-
-    for (int i = 0; i < 45; ++i) {
-        const auto &entry = gameData.transfer_market[i];
-        checkPlayer("transfer_market[" + std::to_string(i) + "].player_idx", entry.player_idx);
-        checkClub("transfer_market[" + std::to_string(i) + "].club_idx", entry.club_idx);
-    }
-
-    for (int i = 0; i < 6; ++i) {
-        const auto &entry = gameData.transfer[i];
-        checkPlayer("transfer[" + std::to_string(i) + "].player_idx", entry.player_idx);
-        checkClub("transfer[" + std::to_string(i) + "].from_club", entry.from_club_idx);
-        checkClub("transfer[" + std::to_string(i) + "].to_club", entry.to_club_idx);
-    }
-
-    checkClub("retired_manager_club_idx", gameData.retired_manager_club_idx);
-    checkClub("new_manager_club_idx", gameData.new_manager_club_idx);
-
     if (!issues.empty()) {
         std::cerr << "[" << stage << "] GameData structural issues (" << issues.size() << "):\n";
         for (const auto &issue : issues) {
@@ -471,12 +367,28 @@ void checkGameDataStructure(const std::string &stage, const std::string &pm3Path
     }
 }
 
-void checkConsistency(const std::string &stage, const std::string &pm3Path, bool swapIndices) {
-    checkGameDataStructure(stage, pm3Path);
-    constexpr int kPlayerCount = static_cast<int>(std::size(playerData.player));
-    std::vector<int> owner(kPlayerCount, -1);
+void checkConsistency(GameState &state, const std::string &stage, const std::string &pm3Path, bool swapIndices) {
+    save_validator::Options options;
+    options.swappedSquads = swapIndices;
+    options.skipManagers = true;
+    save_validator::Report report = save_validator::validate(state.game, state.clubs, state.players, options);
+    checkGameDataStructure(stage, pm3Path, report);
+
+    constexpr int kPlayerCount = static_cast<int>(std::extent_v<decltype(gamec::player)>);
     std::vector<std::tuple<int, int, int>> duplicates;
     std::vector<std::tuple<int, int, int>> invalidSlots;
+    for (const save_validator::Issue &issue : report.issues) {
+        if (issue.file != 1 || issue.run->fieldPath != "player_index") {
+            continue;
+        }
+        auto clubIdx = static_cast<int>(issue.repeatIndex);
+        auto slot = static_cast<int>(issue.countIndex);
+        if (issue.kind == save_validator::IssueKind::DuplicatePlayer) {
+            duplicates.emplace_back(static_cast<int>(issue.value), issue.firstClub, clubIdx);
+        } else {
+            invalidSlots.emplace_back(clubIdx, slot, static_cast<int>(issue.value));
+        }
+    }
 
     auto clubName = [](const ClubRecord &c) {
         return std::string(c.name, strnlen(c.name, sizeof(c.name)));
@@ -485,34 +397,22 @@ void checkConsistency(const std::string &stage, const std::string &pm3Path, bool
         return std::string(p.name, strnlen(p.name, sizeof(p.name)));
     };
 
+    // Only gathered for the samples; the validator's bitmap already counted them.
+    std::vector<bool> owned(kPlayerCount, false);
     for (int clubIdx = 0; clubIdx < kClubIdxMax; ++clubIdx) {
-        const ClubRecord &club = getClub(clubIdx);
-        for (int slot = 0; slot < 24; ++slot) {
-            int16_t rawIdx = club.player_index[slot];
-            if (rawIdx == -1) {
-                continue;
-            }
-            int16_t idx = swapIndices ? decodePlayerIndex(rawIdx, true) : rawIdx;
-            if (idx < 0 || idx >= kPlayerCount) {
-                invalidSlots.emplace_back(clubIdx, slot, rawIdx);
-                continue;
-            }
-            if (owner[idx] == -1) {
-                owner[idx] = clubIdx;
-            } else {
-                duplicates.emplace_back(idx, owner[idx], clubIdx);
+        const ClubRecord &club = state.club(clubIdx);
+        for (int slot = 0; slot < save_validator::kSquadSize; ++slot) {
+            int16_t idx = decodePlayerIndex(club.player_index[slot], swapIndices);
+            if (idx >= 0 && idx < kPlayerCount) {
+                owned[idx] = true;
             }
         }
     }
-
-    int missing = 0;
+    auto missing = static_cast<int>(report.unassignedPlayers);
     std::vector<int> missingSamples;
-    for (int i = 0; i < kPlayerCount; ++i) {
-        if (owner[i] == -1) {
-            ++missing;
-            if (missingSamples.size() < 8) {
-                missingSamples.push_back(i);
-            }
+    for (int i = 0; i < kPlayerCount && missingSamples.size() < 8; ++i) {
+        if (!owned[i]) {
+            missingSamples.push_back(i);
         }
     }
 
@@ -521,13 +421,13 @@ void checkConsistency(const std::string &stage, const std::string &pm3Path, bool
               << " unassigned=" << missing << "\n";
 
     auto printClub = [&](int idx) {
-        const ClubRecord &club = getClub(idx);
+        const ClubRecord &club = state.club(idx);
         return clubName(club);
     };
 
     for (size_t i = 0; i < duplicates.size() && i < 8; ++i) {
         auto [pidx, firstClub, secondClub] = duplicates[i];
-        std::cerr << "  duplicate player " << pidx << " " << playerName(playerData.player[pidx])
+        std::cerr << "  duplicate player " << pidx << " " << playerName(state.player(static_cast<int16_t>(pidx)))
                   << " in both " << printClub(firstClub) << " and " << printClub(secondClub) << "\n";
     }
     if (duplicates.size() > 8) {
@@ -546,7 +446,7 @@ void checkConsistency(const std::string &stage, const std::string &pm3Path, bool
     if (!missingSamples.empty()) {
         std::cerr << "  sample unassigned players:\n";
         for (int idx : missingSamples) {
-            std::cerr << "    " << idx << " " << playerName(playerData.player[idx]) << "\n";
+            std::cerr << "    " << idx << " " << playerName(state.player(static_cast<int16_t>(idx))) << "\n";
         }
         if (missing > static_cast<int>(missingSamples.size())) {
             std::cerr << "    (+" << (missing - missingSamples.size()) << " more unassigned)\n";
@@ -554,8 +454,8 @@ void checkConsistency(const std::string &stage, const std::string &pm3Path, bool
     }
 }
 
-void rebalanceLeagues(const std::vector<SwosPlacement> &swosPlacements) {
-    constexpr std::array<int, 5> kStorageSizes{{22, 24, 24, 22, 22}};
+void rebalanceLeagues(GameState &state, const std::vector<SwosPlacement> &swosPlacements) {
+    constexpr std::array<int, 5> kStorageSizes = pm3_schema::kDivisionSlots;
     std::array<std::vector<int>, 5> tiers;
     std::array<std::vector<int>, 5> original;
     std::vector<bool> used(kClubIdxMax, false);
@@ -572,11 +472,11 @@ void rebalanceLeagues(const std::vector<SwosPlacement> &swosPlacements) {
             dest.push_back(source[i]);
         }
     };
-    loadLeague(gameData.club_index.leagues.premier_league, 22, original[0]);
-    loadLeague(gameData.club_index.leagues.division_one, 24, original[1]);
-    loadLeague(gameData.club_index.leagues.division_two, 24, original[2]);
-    loadLeague(gameData.club_index.leagues.division_three, 22, original[3]);
-    loadLeague(gameData.club_index.leagues.conference_league, 22, original[4]);
+    loadLeague(state.game.club_index.leagues.premier_league, 22, original[0]);
+    loadLeague(state.game.club_index.leagues.division_one, 24, original[1]);
+    loadLeague(state.game.club_index.leagues.division_two, 24, original[2]);
+    loadLeague(state.game.club_index.leagues.division_three, 22, original[3]);
+    loadLeague(state.game.club_index.leagues.conference_league, 22, original[4]);
 
     std::vector<SwosPlacement> sortedPlacements = swosPlacements;
     std::sort(sortedPlacements.begin(), sortedPlacements.end(),
@@ -641,9 +541,9 @@ void rebalanceLeagues(const std::vector<SwosPlacement> &swosPlacements) {
     };
     fillWithUnused(tiers.back(), kStorageSizes.back());
 
-    auto sortTierAlphabetically = [](std::vector<int> &tier) {
-        std::sort(tier.begin(), tier.end(), [](int lhs, int rhs) {
-            return clubSortKey(lhs) < clubSortKey(rhs);
+    auto sortTierAlphabetically = [&state](std::vector<int> &tier) {
+        std::sort(tier.begin(), tier.end(), [&state](int lhs, int rhs) {
+            return clubSortKey(state, lhs) < clubSortKey(state, rhs);
         });
     };
     for (auto &tier : tiers) {
@@ -661,11 +561,11 @@ void rebalanceLeagues(const std::vector<SwosPlacement> &swosPlacements) {
         }
     };
 
-    writeLeague(gameData.club_index.leagues.premier_league, kStorageSizes[0], tiers[0]);
-    writeLeague(gameData.club_index.leagues.division_one, kStorageSizes[1], tiers[1]);
-    writeLeague(gameData.club_index.leagues.division_two, kStorageSizes[2], tiers[2]);
-    writeLeague(gameData.club_index.leagues.division_three, kStorageSizes[3], tiers[3]);
-    writeLeague(gameData.club_index.leagues.conference_league, kStorageSizes[4], tiers[4]);
+    writeLeague(state.game.club_index.leagues.premier_league, kStorageSizes[0], tiers[0]);
+    writeLeague(state.game.club_index.leagues.division_one, kStorageSizes[1], tiers[1]);
+    writeLeague(state.game.club_index.leagues.division_two, kStorageSizes[2], tiers[2]);
+    writeLeague(state.game.club_index.leagues.division_three, kStorageSizes[3], tiers[3]);
+    writeLeague(state.game.club_index.leagues.conference_league, kStorageSizes[4], tiers[4]);
 }
 
 
@@ -719,7 +619,7 @@ double nameSimilarity(const std::string &aRaw, const std::string &bRaw) {
     return 1.0 - (static_cast<double>(dist) / maxLen);
 }
 
-std::optional<int> findBestClubMatch(const std::string &teamName,
+std::optional<int> findBestClubMatch(const GameState &state, const std::string &teamName,
                                      const std::vector<int> &candidateIdxs,
                                      const std::unordered_set<int> &alreadyMatched) {
     std::string normTeam = normalize(teamName);
@@ -743,7 +643,7 @@ std::optional<int> findBestClubMatch(const std::string &teamName,
         if (alreadyMatched.count(idx)) {
             continue;
         }
-        const ClubRecord &club = getClub(idx);
+        const ClubRecord &club = state.club(idx);
         std::string clubName(club.name, strnlen(club.name, sizeof(club.name)));
         std::string normClub = normalize(clubName);
         auto clubTokens = tokenize(normClub);
@@ -785,7 +685,8 @@ std::optional<int> findBestClubMatch(const std::string &teamName,
 
 } // namespace
 
-ImportReport importTeamsFromFile(const std::string &teamFile, const std::string &pm3Path, bool verbose) {
+ImportReport importTeamsFromFile(GameState &state, const std::string &teamFile, const std::string &pm3Path,
+                                 bool verbose) {
     ImportReport report{};
     constexpr int kImportClubLimit = 114; // Only import into the first 114 clubs of GAMEB.
 
@@ -799,7 +700,7 @@ ImportReport importTeamsFromFile(const std::string &teamFile, const std::string
     int clubLimit = std::min<int>(kImportClubLimit, kClubIdxMax);
     std::cout << "PM3 Teams:\n";
     for (int idx = 0; idx < clubLimit; ++idx) {
-        const ClubRecord &club = getClub(idx);
+        const ClubRecord &club = state.club(idx);
         int length = strnlen(club.name, sizeof(club.name));
         std::cout << "  [" << idx << "] " << std::string(club.name, length) << "\n";
     }
@@ -818,13 +719,13 @@ ImportReport importTeamsFromFile(const std::string &teamFile, const std::string
     std::random_device rd;
     std::mt19937 rng(rd());
 
-    checkConsistency("Before base import", pm3Path, true);
+    checkConsistency(state, "Before base import", pm3Path, true);
 
     for (const auto &team : teamDb.teams) {
-        auto match = findBestClubMatch(team.name, allClubs, matchedClubIdxs);
+        auto match = findBestClubMatch(state, team.name, allClubs, matchedClubIdxs);
             if (match) {
                 int clubIdx = *match;
-                ClubRecord &club = getClub(clubIdx);
+                ClubRecord &club = state.club(clubIdx);
                 matchedClubIdxs.insert(clubIdx);
                 matchedNames.insert(normalize(team.name));
                 ++report.teams_matched;
@@ -845,13 +746,13 @@ ImportReport importTeamsFromFile(const std::string &teamFile, const std::string
             if (verbose) {
                 for (int slot = 0; slot < 24; ++slot) {
                     int16_t idx = decodePlayerIndex(club.player_index[slot], true);
-                    if (idx >= 0 && idx < static_cast<int>(std::size(playerData.player))) {
+                    if (idx >= 0 && idx < static_cast<int>(std::size(state.players.player))) {
                         ++validSlots;
                     }
                 }
             }
             auto players = collectTeamPlayers(team, playerDb);
-            int renamed = renamePlayers(club, players);
+            int renamed = renamePlayers(state, club, players);
                 club.league = static_cast<uint8_t>(team.league);
                 if (!team.kits.empty()) {
                     applyKit(club.kit[0], team.kits[0]);
@@ -897,7 +798,7 @@ ImportReport importTeamsFromFile(const std::string &teamFile, const std::string
         unmatchedClubs.pop_back();
         replacementPlacements.push_back({clubIdx, team.league, norm});
 
-        ClubRecord &club = getClub(clubIdx);
+        ClubRecord &club = state.club(clubIdx);
 
         if (verbose) {
             std::cout << "[REPLACE] " << team.name << " -> club idx " << clubIdx
@@ -918,7 +819,7 @@ ImportReport importTeamsFromFile(const std::string &teamFile, const std::string
         applyKit(club.kit[2], team.kits[0]);
 
         auto players = collectTeamPlayers(team, playerDb);
-        int renamed = renamePlayers(club, players);
+        int renamed = renamePlayers(state, club, players);
 
 
         report.players_renamed += renamed;
@@ -929,8 +830,8 @@ ImportReport importTeamsFromFile(const std::string &teamFile, const std::string
     }
 
     swosPlacements.insert(swosPlacements.end(), replacementPlacements.begin(), replacementPlacements.end());
-    rebalanceLeagues(swosPlacements);
-    checkConsistency("After base import", pm3Path, true);
+    rebalanceLeagues(state, swosPlacements);
+    checkConsistency(state, "After base import", pm3Path, true);
 
     if (!unmatchedIncomingTeams.empty()) {
         std::cout << "Unmatched incoming teams:\n";
@@ -942,7 +843,7 @@ ImportReport importTeamsFromFile(const std::string &teamFile, const std::string
     if (!unmatchedClubs.empty()) {
         std::cout << "Unmatched existing clubs:\n";
         for (int idx : unmatchedClubs) {
-            std::cout << "  [" << idx << "] " << formatClubLabel(idx) << "\n";
+            std::cout << "  [" << idx << "] " << formatClubLabel(state, idx) << "\n";
         }
     }
 
@@ -3,6 +3,7 @@
 
 #include <string>
 
+#include "pm3_data.h"
 #include "pm3_defs.hh"
 
 namespace swos_import {
@@ -15,10 +16,11 @@ struct ImportReport {
     size_t teams_unplaced = 0;
 };
 
-// Import teams from a SWOS TEAM.xxx file into the in-memory gameb/gamec globals.
+// Import teams from a SWOS TEAM.xxx file into `state`'s clubs and players.
 // GAMEB clubs are matched by name; unmatched teams replace the first unmatched clubs.
 // Players are renamed in-place (stats untouched) to match the imported squads.
 // no club replacements are created and no squad structure is changed.
-ImportReport importTeamsFromFile(const std::string &teamFile, const std::string &pm3Path, bool verbose = false);
+ImportReport importTeamsFromFile(GameState &state, const std::string &teamFile, const std::string &pm3Path,
+                                 bool verbose = false);
 
 } // namespace swos_import
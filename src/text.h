@@ -100,8 +100,8 @@ void writeTextLarge(TextRenderer &renderer, const char *text, int textLine,
 void writeTextSmall(TextRenderer &renderer, const char *text, int textLine,
                     const std::function<void(void)> &clickCallback, int offsetLeft);
 
-int writePlayers(TextRenderer &renderer, std::vector<club_player> &players, int &textLine,
-                 const std::function<void(const club_player &)> &clickCallback);
+int writePlayers(TextRenderer &renderer, GameState &state, const std::vector<PlayerHandle> &players, int &textLine,
+                 const std::function<void(const PlayerHandle &)> &clickCallback);
 
 void loadFont(TextRenderer &renderer, const char *path, int type);
 void renderText(TextRenderer &renderer, const std::string &text, const SDL_Color &color, int x, int y, int w,
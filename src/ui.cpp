@@ -107,16 +107,17 @@ void writeClubMenu(ScreenContext &context, int &selectedClub, int selectedDivisi
     int offsetLeft = 0;
 
     std::vector<int> clubs;
+    GameState &state = context.game();
 
     for (int i = 0; i < 114; ++i) {
-        ClubRecord &club = getClub(i);
+        ClubRecord &club = state.club(i);
         if (club.league == divisionHex[selectedDivision]) {
             clubs.push_back(i);
         }
     }
 
-    std::sort(clubs.begin(), clubs.end(), [](int a, int b) {
-        return strcmp(getClub(a).name, getClub(b).name) < 0;
+    std::sort(clubs.begin(), clubs.end(), [&state](int a, int b) {
+        return strcmp(state.club(a).name, state.club(b).name) < 0;
     });
 
     for (auto club_idx: clubs) {
@@ -126,7 +127,7 @@ void writeClubMenu(ScreenContext &context, int &selectedClub, int selectedDivisi
         }
 
         char clubName[17];
-        snprintf(clubName, sizeof(clubName), "%16.16s", getClub(club_idx).name);
+        snprintf(clubName, sizeof(clubName), "%16.16s", state.club(club_idx).name);
 
         context.writeText(
                 clubName,
@@ -171,8 +172,8 @@ void writeClubMenu(ScreenContext &context, int &selectedClub, int selectedDivisi
 }
 
 void drawTopDetails(ScreenContext &context) {
-    struct gamea::ManagerRecord &manager = gameData.manager[0];
-    ClubRecord &club = getClub(manager.club_idx);
+    struct gamea::ManagerRecord &manager = context.game().game.manager[0];
+    ClubRecord &club = context.game().club(manager.club_idx);
 
     char line1[55];
 
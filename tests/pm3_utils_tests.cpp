@@ -124,10 +124,10 @@ int main() {
     premierPlayers.push_back(addPlayer(58, 25, 2, 350));
     ClubRecord premierClub = makeClub(0, 24, premierPlayers);
 
-    ok &= checkPrice("Premier star starter", determinePlayerPrice(playerData.player[premierPlayers[0]], premierClub, 0), 10'000'000, 25'000'000);
-    ok &= checkPrice("Premier first-team starter", determinePlayerPrice(playerData.player[premierPlayers[5]], premierClub, 5), 2'000'000, 10'000'000);
-    ok &= checkPrice("Premier bench", determinePlayerPrice(playerData.player[premierPlayers[12]], premierClub, 12), 1'000'000, 5'000'000);
-    ok &= checkPrice("Premier reserve", determinePlayerPrice(playerData.player[premierPlayers[18]], premierClub, 18), 200'000, 2'000'000);
+    ok &= checkPrice("Premier star starter", determinePlayerPrice(defaultGameState, playerData.player[premierPlayers[0]], premierClub, 0), 10'000'000, 25'000'000);
+    ok &= checkPrice("Premier first-team starter", determinePlayerPrice(defaultGameState, playerData.player[premierPlayers[5]], premierClub, 5), 2'000'000, 10'000'000);
+    ok &= checkPrice("Premier bench", determinePlayerPrice(defaultGameState, playerData.player[premierPlayers[12]], premierClub, 12), 1'000'000, 5'000'000);
+    ok &= checkPrice("Premier reserve", determinePlayerPrice(defaultGameState, playerData.player[premierPlayers[18]], premierClub, 18), 200'000, 2'000'000);
 
     // Premier League small squad (17 players)
     std::vector<int16_t> premierSmall;
@@ -135,8 +135,8 @@ int main() {
         premierSmall.push_back(addPlayer(78 - i, 25, 3, 600));
     }
     ClubRecord premierClubSmall = makeClub(0, 17, premierSmall);
-    ok &= checkPrice("Premier small-squad starter", determinePlayerPrice(playerData.player[premierSmall[1]], premierClubSmall, 1), 1'500'000, 9'000'000);
-    ok &= checkPrice("Premier small-squad bench", determinePlayerPrice(playerData.player[premierSmall[12]], premierClubSmall, 12), 500'000, 3'000'000);
+    ok &= checkPrice("Premier small-squad starter", determinePlayerPrice(defaultGameState, playerData.player[premierSmall[1]], premierClubSmall, 1), 1'500'000, 9'000'000);
+    ok &= checkPrice("Premier small-squad bench", determinePlayerPrice(defaultGameState, playerData.player[premierSmall[12]], premierClubSmall, 12), 500'000, 3'000'000);
 
     // Division 1 club (league = 1), 22 players
     std::vector<int16_t> div1Players;
@@ -145,8 +145,8 @@ int main() {
         div1Players.push_back(addPlayer(rating, 25, 3, 500));
     }
     ClubRecord div1Club = makeClub(1, 22, div1Players);
-    ok &= checkPrice("Div1 starter", determinePlayerPrice(playerData.player[div1Players[2]], div1Club, 2), 400'000, 2'000'000);
-    ok &= checkPrice("Div1 bench", determinePlayerPrice(playerData.player[div1Players[12]], div1Club, 12), 100'000, 1'200'000);
+    ok &= checkPrice("Div1 starter", determinePlayerPrice(defaultGameState, playerData.player[div1Players[2]], div1Club, 2), 400'000, 2'000'000);
+    ok &= checkPrice("Div1 bench", determinePlayerPrice(defaultGameState, playerData.player[div1Players[12]], div1Club, 12), 100'000, 1'200'000);
 
     // Division 2 club (league = 2), 20 players
     std::vector<int16_t> div2Players;
@@ -155,7 +155,7 @@ int main() {
         div2Players.push_back(addPlayer(rating, 25, 3, 450));
     }
     ClubRecord div2Club = makeClub(2, 20, div2Players);
-    ok &= checkPrice("Div2 starter", determinePlayerPrice(playerData.player[div2Players[1]], div2Club, 1), 200'000, 1'100'000);
+    ok &= checkPrice("Div2 starter", determinePlayerPrice(defaultGameState, playerData.player[div2Players[1]], div2Club, 1), 200'000, 1'100'000);
 
     // Division 3 club (league = 3), 18 players
     std::vector<int16_t> div3Players;
@@ -164,7 +164,7 @@ int main() {
         div3Players.push_back(addPlayer(rating, 25, 3, 400));
     }
     ClubRecord div3Club = makeClub(3, 18, div3Players);
-    ok &= checkPrice("Div3 starter", determinePlayerPrice(playerData.player[div3Players[0]], div3Club, 0), 50'000, 800'000);
+    ok &= checkPrice("Div3 starter", determinePlayerPrice(defaultGameState, playerData.player[div3Players[0]], div3Club, 0), 50'000, 800'000);
 
     // Load real-world samples from CSV (tests/pricing_samples.csv)
     std::ifstream csv("tests/pricing_samples.csv");
@@ -227,7 +227,7 @@ int main() {
         char valuationRole = roleStr.empty() ? determineValuationRole(sample) : roleStr[0];
         (void)valuationRole; // currently pricing uses internal determination
 
-        int price = determinePlayerPrice(sample, club, slot);
+        int price = determinePlayerPrice(defaultGameState, sample, club, slot);
         double ratio = expected > 0 ? static_cast<double>(price) / expected : 1.0;
         bool within = ratio >= 0.5 && ratio <= 1.5;
         std::cout << playerName << " price=" << price << " expected~" << expected << " ratio=" << ratio << std::endl;
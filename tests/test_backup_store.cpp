@@ -0,0 +1,116 @@
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include "backup_store.h"
+#include "config/constants.h"
+#include "io.h"
+#include "test_util.h"
+
+namespace {
+
+std::size_t countChunks(const std::filesystem::path &storeRoot) {
+    std::size_t count = 0;
+    for (const auto &entry : std::filesystem::recursive_directory_iterator(storeRoot / "chunks")) {
+        count += entry.is_regular_file() ? 1 : 0;
+    }
+    return count;
+}
+
+std::vector<char> readAll(const std::filesystem::path &path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<char>((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+} // namespace
+
+int main() {
+    namespace fs = std::filesystem;
+    fs::path root = fs::temp_directory_path() / "pm3000_test_backup_store";
+    fs::remove_all(root);
+    fs::create_directories(root / std::string{kStandardSavesPath});
+    std::ofstream(root / std::string{kExeStandardFilename}).put('\0');
+
+    auto a = std::make_unique<gamea>();
+    auto b = std::make_unique<gameb>();
+    auto c = std::make_unique<gamec>();
+    std::memset(a.get(), 0, sizeof(gamea));
+    std::memset(b.get(), 0, sizeof(gameb));
+    std::memset(c.get(), 0, sizeof(gamec));
+    for (int i = 0; i < 3932; ++i) {
+        c->player[i].age = static_cast<uint8_t>(16 + i % 20);
+        c->player[i].wage = static_cast<int16_t>(i);
+    }
+    for (int i = 0; i < 244; ++i) {
+        b->club[i].bank_account = i * 1000;
+    }
+    a->year = 1995;
+
+    auto writeSlot = [&]() {
+        writeStruct(io::constructSaveFilePath(root, 1, 'A'), *a);
+        writeStruct(io::constructSaveFilePath(root, 1, 'B'), *b);
+        writeStruct(io::constructSaveFilePath(root, 1, 'C'), *c);
+    };
+    writeSlot();
+
+    Settings settings;
+    settings.gamePath = root;
+    if (!io::backupSaveFile(settings, 1)) {
+        std::cerr << "first backup failed: " << io::pm3LastError() << "\n";
+        return 1;
+    }
+
+    fs::path storeRoot = io::backupStorePath(io::constructSavesFolderPath(root) / BACKUP_SAVE_PATH);
+    backup_store::Store store(storeRoot);
+    std::size_t baseChunks = countChunks(storeRoot);
+
+    // Identical contents do not create a new version.
+    io::backupSaveFile(settings, 1);
+    if (store.latestVersion("GAME1") != 1) {
+        std::cerr << "unchanged slot should not add a version\n";
+        return 1;
+    }
+
+    // One edited player and one edited club add exactly one chunk each.
+    c->player[2500].hn = 99;
+    b->club[100].bank_account = -5;
+    writeSlot();
+    io::backupSaveFile(settings, 1);
+    if (store.latestVersion("GAME1") != 2 || countChunks(storeRoot) != baseChunks + 2) {
+        std::cerr << "record edit should store only its chunks, got " << countChunks(storeRoot) - baseChunks << "\n";
+        return 1;
+    }
+
+    // Restore version 1 and check the slot matches the original bytes.
+    auto original = std::make_unique<gamec>();
+    std::memcpy(original.get(), c.get(), sizeof(gamec));
+    original->player[2500].hn = 0;
+    if (!io::restoreSaveBackup(root, 1, 1)) {
+        std::cerr << "restore failed: " << io::pm3LastError() << "\n";
+        return 1;
+    }
+    std::vector<char> restoredC = readAll(io::constructSaveFilePath(root, 1, 'C'));
+    if (restoredC.size() != sizeof(gamec) || std::memcmp(restoredC.data(), original.get(), sizeof(gamec)) != 0) {
+        std::cerr << "restored slot does not match version 1\n";
+        return 1;
+    }
+
+    // Pruning the first version lets GC drop the chunks only it referenced.
+    if (store.prune("GAME1", 1) != 1 || store.collectGarbage() != 2) {
+        std::cerr << "gc should remove the two chunks unique to version 1\n";
+        return 1;
+    }
+    auto latest = store.read("GAME1", 2);
+    if (latest.size() != 3 || latest[2].contents.size() != sizeof(gamec) ||
+        reinterpret_cast<const gamec *>(latest[2].contents.data())->player[2500].hn != 99) {
+        std::cerr << "surviving version is unreadable after gc\n";
+        return 1;
+    }
+
+    fs::remove_all(root);
+    return 0;
+}
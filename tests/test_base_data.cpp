@@ -0,0 +1,109 @@
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base_data.h"
+#include "config/constants.h"
+#include "io.h"
+#include "pm3_data.h"
+#include "test_util.h"
+
+int main() {
+    namespace fs = std::filesystem;
+
+    fs::path root = fs::temp_directory_path() / "pm3000_test_base_data";
+    fs::remove_all(root);
+    fs::create_directories(root);
+
+    static gamea baseGame{};
+    static gameb baseClubs{};
+    static gamec basePlayers{};
+    baseGame.year = 1995;
+    std::strncpy(baseClubs.club[7].manager, "A. Manager", sizeof(baseClubs.club[7].manager));
+    basePlayers.player[42].hn = 77;
+    const std::vector<uint8_t> tail = {1, 2, 3, 4, 5};
+    writeStruct(root / std::string{kGameDataFile}, baseGame);
+    std::ofstream(root / std::string{kGameDataFile}, std::ios::binary | std::ios::app)
+        .write(reinterpret_cast<const char *>(tail.data()), static_cast<std::streamsize>(tail.size()));
+    writeStruct(root / std::string{kClubDataFile}, baseClubs);
+    writeStruct(root / std::string{kPlayDataFile}, basePlayers);
+
+    // One store per installation: the views read the files, and asking again hands out the same store.
+    std::shared_ptr<const io::BaseData> base = io::baseDataFor(root);
+    if (base->gameA().year != 1995 || std::string(base->club(7).manager) != "A. Manager" ||
+        base->player(42).hn != 77 || base->gameaTailSize() != tail.size() ||
+        std::memcmp(base->gameaTail(), tail.data(), tail.size()) != 0) {
+        std::cerr << "the views do not match the base files\n";
+        return 1;
+    }
+    if (io::baseDataFor(root) != base) {
+        std::cerr << "an unchanged installation should reuse its store\n";
+        return 1;
+    }
+
+    // The loaders copy out of the store, and GAMEDATA.DAT's tail still survives a load and save.
+    static gamea game{};
+    static gameb clubs{};
+    io::loadDefaultGamedata(root, game);
+    io::loadDefaultClubdata(root, clubs);
+    if (game.year != 1995 || io::getGameaExtraBytes() != tail.size() ||
+        std::string(clubs.club[7].manager) != "A. Manager") {
+        std::cerr << "the default loaders should copy the store\n";
+        return 1;
+    }
+    std::strncpy(clubs.club[7].manager, "B. Manager", sizeof(clubs.club[7].manager));
+    io::saveDefaultGamedata(root, game);
+    io::saveDefaultClubdata(root, clubs);
+    if (fs::file_size(root / std::string{kGameDataFile}) != sizeof(gamea) + tail.size()) {
+        std::cerr << "saving GAMEDATA.DAT lost its tail\n";
+        return 1;
+    }
+
+    // Writing the base files drops the store; holders keep the snapshot they had.
+    std::shared_ptr<const io::BaseData> rewritten = io::baseDataFor(root);
+    if (rewritten == base || std::string(rewritten->club(7).manager) != "B. Manager" ||
+        std::string(base->club(7).manager) != "A. Manager") {
+        std::cerr << "saving the base files should replace the store\n";
+        return 1;
+    }
+    base.reset();
+    rewritten.reset();
+
+    // A file changed behind our back (say, by another editor) is noticed too, even at the same size.
+    basePlayers.player[42].hn = 12;
+    writeStruct(root / std::string{kPlayDataFile}, basePlayers);
+    fs::last_write_time(root / std::string{kPlayDataFile},
+                        fs::last_write_time(root / std::string{kPlayDataFile}) + std::chrono::seconds(5));
+    if (io::baseDataFor(root)->player(42).hn != 12) {
+        std::cerr << "an external change should replace the store\n";
+        return 1;
+    }
+
+    // A missing or truncated file is an error, reported like the other loaders.
+    fs::resize_file(root / std::string{kClubDataFile}, sizeof(gameb) - 1);
+    try {
+        io::loadDefaultClubdata(root, clubs);
+        std::cerr << "a truncated CLUBDATA.DAT should throw\n";
+        return 1;
+    } catch (const std::runtime_error &e) {
+        if (io::pm3LastError().find("too small") == std::string::npos) {
+            std::cerr << "unexpected error: " << e.what() << "\n";
+            return 1;
+        }
+    }
+    fs::remove(root / std::string{kPlayDataFile});
+    try {
+        io::baseDataFor(root);
+        std::cerr << "a missing PLAYDATA.DAT should throw\n";
+        return 1;
+    } catch (const std::runtime_error &) {
+    }
+
+    fs::remove_all(root);
+    return 0;
+}
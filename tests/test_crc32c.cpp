@@ -0,0 +1,105 @@
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "config/constants.h"
+#include "crc32c.h"
+#include "io.h"
+#include "pm3_data.h"
+#include "save_fingerprint.h"
+#include "test_util.h"
+
+int main() {
+    namespace fs = std::filesystem;
+
+    // Standard check values for CRC-32C.
+    const char *digits = "123456789";
+    std::vector<uint8_t> zeros(32, 0);
+    if (crc32c::compute(digits, 9) != 0xE3069283 || crc32c::compute(zeros.data(), zeros.size()) != 0x8A9136AA ||
+        crc32c::extendPortable(0, digits, 9) != 0xE3069283) {
+        std::cerr << "CRC32C check values do not match\n";
+        return 1;
+    }
+
+    // The accelerated path agrees with the table fallback at every length and alignment, including when split.
+    std::mt19937 rng(1995);
+    std::vector<uint8_t> buffer(9000);
+    for (auto &byte : buffer) {
+        byte = static_cast<uint8_t>(rng());
+    }
+    for (std::size_t offset = 0; offset < 8; ++offset) {
+        for (std::size_t size : {0u, 1u, 7u, 8u, 63u, 4096u, 8191u}) {
+            uint32_t whole = crc32c::compute(buffer.data() + offset, size);
+            uint32_t split = crc32c::extend(crc32c::compute(buffer.data() + offset, size / 3),
+                                            buffer.data() + offset + size / 3, size - size / 3);
+            if (whole != crc32c::extendPortable(0, buffer.data() + offset, size) || whole != split) {
+                std::cerr << "hardware and portable CRC disagree at offset " << offset << " size " << size << "\n";
+                return 1;
+            }
+        }
+    }
+
+    // A one-byte edit is located to its 4 KB chunk.
+    std::vector<uint8_t> edited = buffer;
+    edited[5000] ^= 0xFF;
+    auto regions = save_fingerprint::changedRegions(save_fingerprint::compute(buffer.data(), buffer.size()),
+                                                    save_fingerprint::compute(edited.data(), edited.size()));
+    if (regions.size() != 1 || regions[0].offset != 4096 || regions[0].length != 4096) {
+        std::cerr << "changed region should be the second chunk\n";
+        return 1;
+    }
+
+    // End to end: a save records the sidecar, and a backup of the unchanged slot is skipped once stored.
+    fs::path root = fs::temp_directory_path() / "pm3000_test_crc32c";
+    fs::remove_all(root);
+    fs::create_directories(root / std::string{kStandardSavesPath});
+    std::ofstream(root / std::string{kExeStandardFilename}).put('\0');
+
+    std::memset(&gameData, 0, sizeof(gameData));
+    std::memset(&clubData, 0, sizeof(clubData));
+    std::memset(&playerData, 0, sizeof(playerData));
+    writeStruct(io::constructSaveFilePath(root, 1, 'A'), gameData);
+    writeStruct(io::constructSaveFilePath(root, 1, 'B'), clubData);
+    writeStruct(io::constructSaveFilePath(root, 1, 'C'), playerData);
+
+    Settings settings;
+    settings.gamePath = root;
+    char footer[70]{};
+    playerData.player[12].age = 22;
+    if (!io::saveGame(settings, 1, footer, sizeof(footer))) {
+        std::cerr << "saveGame failed: " << footer << "\n";
+        return 1;
+    }
+
+    fs::path backupDir = io::constructSavesFolderPath(root) / BACKUP_SAVE_PATH;
+    save_fingerprint::SlotFingerprint slot;
+    if (!save_fingerprint::read(save_fingerprint::sidecarPath(backupDir, 1), slot) || slot.backedUp ||
+        slot.files[2].crc != crc32c::compute(&playerData, sizeof(playerData)) ||
+        !save_fingerprint::matchesDisk(slot.files[2], io::constructSaveFilePath(root, 1, 'C'))) {
+        std::cerr << "save should leave a current sidecar\n";
+        return 1;
+    }
+
+    io::backupSaveFile(settings, 1);
+    fs::path storeRoot = io::backupStorePath(backupDir);
+    std::size_t manifests = 0;
+    for (const auto &entry : fs::recursive_directory_iterator(storeRoot / "versions")) {
+        manifests += entry.is_regular_file() ? 1 : 0;
+    }
+    fs::remove_all(storeRoot / "versions");
+    if (!io::backupSaveFile(settings, 1) || fs::exists(storeRoot / "versions")) {
+        std::cerr << "backup of an unchanged, already stored slot should not touch the store\n";
+        return 1;
+    }
+    if (manifests != 1) {
+        std::cerr << "a save should not copy the slot into the store, got " << manifests << " versions\n";
+        return 1;
+    }
+
+    fs::remove_all(root);
+    return 0;
+}
@@ -0,0 +1,126 @@
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+#include "dirty_tracker.h"
+#include "game_utils.h"
+#include "io.h"
+#include "pm3_data.h"
+#include "test_util.h"
+
+namespace {
+
+std::vector<char> readAll(const std::filesystem::path &path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<char>((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+std::size_t offsetIn(const void *base, const void *field) {
+    return static_cast<std::size_t>(static_cast<const char *>(field) - static_cast<const char *>(base));
+}
+
+} // namespace
+
+int main() {
+    namespace fs = std::filesystem;
+
+    // Spans are recorded relative to the owning struct and merged when close together.
+    dirty_tracker::clear();
+    dirty_tracker::touch(clubData.club[5].name);
+    dirty_tracker::touch(clubData.club[5].stadium);
+    dirty_tracker::touchPlayer(100);
+    dirty_tracker::touchPlayer(3000);
+    ClubRecord scratch{};
+    dirty_tracker::touch(scratch);
+
+    auto clubSpans = dirty_tracker::dirtySpans(dirty_tracker::kGameB);
+    if (clubSpans.size() != 1 || clubSpans[0].offset < offsetIn(&clubData, &clubData.club[5]) ||
+        clubSpans[0].offset + clubSpans[0].length > offsetIn(&clubData, &clubData.club[6])) {
+        std::cerr << "club spans were not merged within the record\n";
+        return 1;
+    }
+    auto playerSpans = dirty_tracker::dirtySpans(dirty_tracker::kGameC);
+    if (playerSpans.size() != 2 || playerSpans[0].offset != offsetIn(&playerData, &playerData.player[100]) ||
+        playerSpans[0].length != sizeof(PlayerRecord)) {
+        std::cerr << "distant player records should stay separate\n";
+        return 1;
+    }
+    if (dirty_tracker::isDirty(dirty_tracker::kGameA)) {
+        std::cerr << "addresses outside the save structs must be ignored\n";
+        return 1;
+    }
+
+    // End to end: load a slot, edit through a helper, and check only the touched bytes reach disk.
+    fs::path root = fs::temp_directory_path() / "pm3000_test_dirty_tracker";
+    fs::remove_all(root);
+    fs::create_directories(root / std::string{kStandardSavesPath});
+    std::ofstream(root / std::string{kExeStandardFilename}).put('\0');
+
+    std::memset(&gameData, 0, sizeof(gameData));
+    std::memset(&clubData, 0, sizeof(clubData));
+    std::memset(&playerData, 0, sizeof(playerData));
+    for (auto &club : clubData.club) {
+        for (int slot = 0; slot < 24; ++slot) {
+            club.player_index[slot] = -1;
+        }
+    }
+    clubData.club[10].player_index[0] = 42;
+    writeStruct(io::constructSaveFilePath(root, 1, 'A'), gameData);
+    writeStruct(io::constructSaveFilePath(root, 1, 'B'), clubData);
+    writeStruct(io::constructSaveFilePath(root, 1, 'C'), playerData);
+
+    Settings settings;
+    settings.gamePath = root;
+    settings.gameType = Pm3GameType::Standard;
+    char footer[70]{};
+    if (!io::loadGame(settings, 1, footer, sizeof(footer)) || dirty_tracker::isDirty(dirty_tracker::kGameC)) {
+        std::cerr << "loadGame should succeed with a clean tracker\n";
+        return 1;
+    }
+
+    game_utils::completeTransfer(defaultGameState, 42, 10, 20, 250000);
+    if (!io::saveGame(settings, 1, footer, sizeof(footer))) {
+        std::cerr << "saveGame failed: " << footer << "\n";
+        return 1;
+    }
+
+    const auto &report = dirty_tracker::lastWrite();
+    if (report.fullRewrite[0] || report.fullRewrite[1] || report.fullRewrite[2] || report.bytesWritten[0] != 0 ||
+        report.bytesWritten[1] > 2 * sizeof(ClubRecord) || report.bytesWritten[2] != sizeof(PlayerRecord)) {
+        std::cerr << "incremental save wrote more than the touched records\n";
+        return 1;
+    }
+    if (dirty_tracker::isDirty(dirty_tracker::kGameB)) {
+        std::cerr << "tracker should be clean after a save\n";
+        return 1;
+    }
+
+    std::vector<char> savedB = readAll(io::constructSaveFilePath(root, 1, 'B'));
+    std::vector<char> savedC = readAll(io::constructSaveFilePath(root, 1, 'C'));
+    if (savedB.size() != sizeof(gameb) || std::memcmp(savedB.data(), &clubData, sizeof(gameb)) != 0 ||
+        savedC.size() != sizeof(gamec) || std::memcmp(savedC.data(), &playerData, sizeof(gamec)) != 0) {
+        std::cerr << "patched files do not match memory\n";
+        return 1;
+    }
+
+    // Saving into a different slot has no baseline there and must write everything.
+    if (!io::saveGame(settings, 2, footer, sizeof(footer)) || !dirty_tracker::lastWrite().fullRewrite[2]) {
+        std::cerr << "saving to another slot should rewrite the files\n";
+        return 1;
+    }
+
+#ifndef NDEBUG
+    // A mutation that skipped touch() is caught before it can be lost.
+    playerData.player[7].hn = 99;
+    if (!io::saveGame(settings, 2, footer, sizeof(footer)) || !dirty_tracker::lastWrite().fullRewrite[2]) {
+        std::cerr << "untracked change should force a full rewrite\n";
+        return 1;
+    }
+#endif
+
+    fs::remove_all(root);
+    return 0;
+}
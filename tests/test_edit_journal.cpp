@@ -0,0 +1,139 @@
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+
+#include "dirty_tracker.h"
+#include "edit_journal.h"
+#include "pm3_data.h"
+
+namespace {
+
+// Puts the three structs back to `base`, as loading the slot again after a crash would.
+void reload(const gamea &game, const gameb &clubs, const gamec &players) {
+    gameData = game;
+    clubData = clubs;
+    playerData = players;
+    dirty_tracker::clear();
+}
+
+bool sameAs(const gamea &game, const gameb &clubs, const gamec &players) {
+    return std::memcmp(&gameData, &game, sizeof(gamea)) == 0 && std::memcmp(&clubData, &clubs, sizeof(gameb)) == 0 &&
+           std::memcmp(&playerData, &players, sizeof(gamec)) == 0;
+}
+
+} // namespace
+
+int main() {
+    namespace fs = std::filesystem;
+
+    fs::path root = fs::temp_directory_path() / "pm3000_test_edit_journal";
+    fs::remove_all(root);
+    fs::path journal = edit_journal::crashFilePath(root / "PM3000", 3);
+
+    clubData.club[5].bank_account = 1000;
+    playerData.player[100].hn = 60;
+    auto baseGame = std::make_unique<gamea>(gameData);
+    auto baseClubs = std::make_unique<gameb>(clubData);
+    auto basePlayers = std::make_unique<gamec>(playerData);
+    edit_journal::restart(journal, 3);
+
+    // Only the bytes that changed are kept, however much the action touched.
+    edit_journal::begin();
+    dirty_tracker::touch(clubData.club[5]);
+    clubData.club[5].bank_account = 250000;
+    dirty_tracker::touch(playerData.player[100]);
+    playerData.player[100].hn = 70;
+    if (!edit_journal::commit("TELEPHONE")) {
+        std::cerr << "the first step should be recorded\n";
+        return 1;
+    }
+    edit_journal::begin();
+    dirty_tracker::touch(playerData.player[200]);
+    if (edit_journal::commit("SCOUT") || edit_journal::undoLabel() != "TELEPHONE") {
+        std::cerr << "a step that changed nothing should not be recorded\n";
+        return 1;
+    }
+    edit_journal::begin();
+    dirty_tracker::touch(playerData.player[100]);
+    playerData.player[100].hn = 80;
+    edit_journal::commit("MY TEAM");
+
+    // A step that is rolled back puts the old bytes back and leaves the history alone.
+    edit_journal::begin();
+    dirty_tracker::touch(clubData.club[5]);
+    clubData.club[5].bank_account = 5;
+    if (!edit_journal::rollback() || clubData.club[5].bank_account != 250000 ||
+        edit_journal::undoLabel() != "MY TEAM" || edit_journal::canRedo()) {
+        std::cerr << "a rolled back step should restore the old bytes without being recorded\n";
+        return 1;
+    }
+    auto editedPlayers = std::make_unique<gamec>(playerData);
+
+    // Undo walks back one step at a time and marks the restored bytes dirty; redo walks forward again.
+    dirty_tracker::clear();
+    if (!edit_journal::undo() || playerData.player[100].hn != 70 || !edit_journal::undo() ||
+        playerData.player[100].hn != 60 || clubData.club[5].bank_account != 1000 || edit_journal::canUndo()) {
+        std::cerr << "undo should restore the old bytes\n";
+        return 1;
+    }
+    if (!dirty_tracker::isDirty(dirty_tracker::kGameB) || !dirty_tracker::isDirty(dirty_tracker::kGameC)) {
+        std::cerr << "undone bytes must be saved\n";
+        return 1;
+    }
+    if (!edit_journal::redo() || clubData.club[5].bank_account != 250000 || edit_journal::redoLabel() != "MY TEAM") {
+        std::cerr << "redo should reapply the step\n";
+        return 1;
+    }
+
+    // The crash file replays the history, undone steps included, over the slot as it was loaded.
+    auto gameBefore = std::make_unique<gamea>(gameData);
+    auto clubsBefore = std::make_unique<gameb>(clubData);
+    auto playersBefore = std::make_unique<gamec>(playerData);
+    reload(*baseGame, *baseClubs, *basePlayers);
+    if (edit_journal::recover(journal, 3) != 1 || !sameAs(*gameBefore, *clubsBefore, *playersBefore) ||
+        !edit_journal::canRedo() || !dirty_tracker::isDirty(dirty_tracker::kGameB)) {
+        std::cerr << "recovery should rebuild the edits and the history\n";
+        return 1;
+    }
+    if (!edit_journal::redo() || std::memcmp(&playerData, editedPlayers.get(), sizeof(gamec)) != 0) {
+        std::cerr << "a recovered history should keep working\n";
+        return 1;
+    }
+
+    // A record torn by a crash is dropped, and the file goes on from the last good one.
+    auto intactSize = fs::file_size(journal);
+    {
+        std::ofstream out(journal, std::ios::binary | std::ios::app);
+        out.write("\x40\x00\x00\x00S", 5);
+    }
+    reload(*baseGame, *baseClubs, *basePlayers);
+    if (edit_journal::recover(journal, 3) != 2 || fs::file_size(journal) != intactSize ||
+        std::memcmp(&playerData, editedPlayers.get(), sizeof(gamec)) != 0) {
+        std::cerr << "a torn record should be cut off\n";
+        return 1;
+    }
+
+    // Bytes changed behind the journal's back (a reload from disk) are not overwritten.
+    playerData.player[100].hn = 99;
+    if (edit_journal::undo() || playerData.player[100].hn != 99) {
+        std::cerr << "undo must not clobber bytes it did not leave there\n";
+        return 1;
+    }
+
+    // A journal written for another slot, or for other contents, is not replayed.
+    reload(*baseGame, *baseClubs, *basePlayers);
+    if (edit_journal::recover(journal, 4) != 0 || edit_journal::canUndo()) {
+        std::cerr << "a journal for another slot must be ignored\n";
+        return 1;
+    }
+    playerData.player[1].hn = 1;
+    if (edit_journal::recover(journal, 3) != 0 || fs::file_size(journal) >= intactSize) {
+        std::cerr << "a journal for other contents must be started afresh\n";
+        return 1;
+    }
+
+    fs::remove_all(root);
+    return 0;
+}
@@ -0,0 +1,336 @@
+#include <algorithm>
+#include <bitset>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "config/constants.h"
+#include "fat_image.h"
+#include "io.h"
+
+namespace {
+
+// Lays out a FAT12/16 volume in memory, optionally behind an MBR, the way FORMAT and DOSBox's imgmount see it.
+class ImageBuilder {
+public:
+    ImageBuilder(int bits, uint32_t totalSectors, uint32_t sectorsPerFat, uint32_t rootEntries,
+                 uint32_t partitionStart = 0)
+        : bits(bits), sectorsPerFat(sectorsPerFat), rootEntries(rootEntries), partitionStart(partitionStart) {
+        volume = partitionStart * 512;
+        bytes.assign(volume + static_cast<std::size_t>(totalSectors) * 512, 0);
+        uint8_t *boot = bytes.data() + volume;
+        boot[0] = 0xEB;
+        put16(boot + 0x0B, 512);
+        boot[0x0D] = 1;
+        put16(boot + 0x0E, 1);
+        boot[0x10] = 2;
+        put16(boot + 0x11, static_cast<uint16_t>(rootEntries));
+        put16(boot + 0x13, totalSectors < 0x10000 ? static_cast<uint16_t>(totalSectors) : 0);
+        put16(boot + 0x16, static_cast<uint16_t>(sectorsPerFat));
+        put32(boot + 0x20, totalSectors < 0x10000 ? 0 : totalSectors);
+        boot[510] = 0x55;
+        boot[511] = 0xAA;
+        if (partitionStart != 0) {
+            bytes[0x1BE + 4] = 0x06;
+            put32(bytes.data() + 0x1BE + 8, partitionStart);
+            bytes[510] = 0x55;
+            bytes[511] = 0xAA;
+        }
+        rootStart = volume + (1 + 2 * sectorsPerFat) * 512;
+        dataStart = rootStart + rootEntries * 32;
+        clusterCount = static_cast<uint32_t>((bytes.size() - dataStart) / 512);
+        setFat(0, 0xFFF8);
+        setFat(1, 0xFFFF);
+    }
+
+    // Returns the first cluster of a new subdirectory of `parent` (0 for the root).
+    uint32_t addDirectory(uint32_t parent, const std::string &name) {
+        uint32_t cluster = allocate(512, false);
+        addEntry(parent, name, 0x10, cluster, 0);
+        return cluster;
+    }
+
+    // `fragmented` spreads the chain over every other free cluster, so reads have to follow the FAT.
+    void addFile(uint32_t parent, const std::string &name, const std::vector<uint8_t> &data, bool fragmented) {
+        uint32_t first = allocate(data.size(), fragmented);
+        uint32_t cluster = first;
+        for (std::size_t offset = 0; offset < data.size(); offset += 512) {
+            std::memcpy(clusterData(cluster), data.data() + offset, std::min<std::size_t>(512, data.size() - offset));
+            cluster = getFat(cluster);
+        }
+        addEntry(parent, name, 0x20, first, static_cast<uint32_t>(data.size()));
+    }
+
+    // Entries PM3 never uses must be skipped: a deleted file, a long-name fragment and the volume label.
+    void addNoise(uint32_t parent) {
+        addEntry(parent, "PM3DISK", 0x08, 0, 0);
+        addEntry(parent, "LONGNAME", 0x0F, 0, 0);
+        addEntry(parent, "GONE.TXT", 0x20, 0, 0);
+        directorySlot(parent, nextSlot[parent] - 1)[0] = 0xE5;
+    }
+
+    void save(const std::filesystem::path &path) const {
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    uint32_t clusters() const { return clusterCount; }
+
+private:
+    static void put16(uint8_t *p, uint16_t v) {
+        p[0] = static_cast<uint8_t>(v);
+        p[1] = static_cast<uint8_t>(v >> 8);
+    }
+
+    static void put32(uint8_t *p, uint32_t v) {
+        put16(p, static_cast<uint16_t>(v));
+        put16(p + 2, static_cast<uint16_t>(v >> 16));
+    }
+
+    uint8_t *clusterData(uint32_t cluster) { return bytes.data() + dataStart + (cluster - 2) * 512; }
+
+    uint32_t getFat(uint32_t cluster) const {
+        const uint8_t *fat = bytes.data() + volume + 512;
+        if (bits == 12) {
+            uint16_t v = static_cast<uint16_t>(fat[cluster * 3 / 2] | (fat[cluster * 3 / 2 + 1] << 8));
+            return (cluster & 1) ? v >> 4 : v & 0xFFF;
+        }
+        return static_cast<uint32_t>(fat[cluster * 2] | (fat[cluster * 2 + 1] << 8));
+    }
+
+    void setFat(uint32_t cluster, uint32_t value) {
+        for (uint32_t copy = 0; copy < 2; ++copy) {
+            uint8_t *fat = bytes.data() + volume + 512 + copy * sectorsPerFat * 512;
+            if (bits == 12) {
+                value &= 0xFFF;
+                uint8_t *p = fat + cluster * 3 / 2;
+                if (cluster & 1) {
+                    p[0] = static_cast<uint8_t>((p[0] & 0x0F) | (value << 4));
+                    p[1] = static_cast<uint8_t>(value >> 4);
+                } else {
+                    p[0] = static_cast<uint8_t>(value);
+                    p[1] = static_cast<uint8_t>((p[1] & 0xF0) | (value >> 8));
+                }
+            } else {
+                put16(fat + cluster * 2, static_cast<uint16_t>(value));
+            }
+        }
+    }
+
+    uint32_t allocate(std::size_t size, bool fragmented) {
+        std::size_t count = std::max<std::size_t>(1, (size + 511) / 512);
+        uint32_t first = 0;
+        uint32_t previous = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            while (getFat(nextFree) != 0) {
+                ++nextFree;
+            }
+            uint32_t cluster = nextFree;
+            if (cluster > clusterCount + 1) {
+                throw std::runtime_error("test image is full");
+            }
+            nextFree += fragmented ? 2 : 1;
+            setFat(cluster, 0xFFFF);
+            if (previous != 0) {
+                setFat(previous, cluster);
+            } else {
+                first = cluster;
+            }
+            previous = cluster;
+        }
+        // Fragmented files leave holes for the next file, which interleaves with them.
+        nextFree = 2;
+        return first;
+    }
+
+    uint8_t *directorySlot(uint32_t parent, uint32_t slot) {
+        return parent == 0 ? bytes.data() + rootStart + slot * 32 : clusterData(parent) + slot * 32;
+    }
+
+    void addEntry(uint32_t parent, const std::string &name, uint8_t attributes, uint32_t cluster, uint32_t size) {
+        uint8_t *entry = directorySlot(parent, nextSlot[parent]++);
+        std::memset(entry, ' ', 11);
+        std::size_t dot = name.find('.');
+        std::memcpy(entry, name.data(), std::min<std::size_t>(dot, name.size()));
+        if (dot != std::string::npos) {
+            std::memcpy(entry + 8, name.data() + dot + 1, name.size() - dot - 1);
+        }
+        entry[11] = attributes;
+        put16(entry + 26, static_cast<uint16_t>(cluster));
+        put32(entry + 28, size);
+    }
+
+    int bits;
+    uint32_t sectorsPerFat;
+    uint32_t rootEntries;
+    uint32_t partitionStart;
+    std::size_t volume = 0;
+    std::size_t rootStart = 0;
+    std::size_t dataStart = 0;
+    uint32_t clusterCount = 0;
+    uint32_t nextFree = 2;
+    std::vector<uint8_t> bytes;
+    std::vector<uint32_t> nextSlot = std::vector<uint32_t>(70000, 0);
+};
+
+std::vector<uint8_t> pattern(std::size_t size, uint8_t seed) {
+    std::vector<uint8_t> data(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        data[i] = static_cast<uint8_t>(seed + i * 7 + i / 251);
+    }
+    return data;
+}
+
+} // namespace
+
+int main() {
+    namespace fs = std::filesystem;
+    fs::path root = fs::temp_directory_path() / "pm3000_test_fat_image";
+    fs::remove_all(root);
+    fs::create_directories(root);
+
+    // A 1.44 MB floppy: FAT12, no partition table, fragmented files in a subdirectory.
+    {
+        ImageBuilder floppy(12, 2880, 9, 224);
+        floppy.addNoise(0);
+        uint32_t dir = floppy.addDirectory(0, "SAVES");
+        std::vector<uint8_t> a = pattern(5000, 1);
+        std::vector<uint8_t> b = pattern(3000, 2);
+        floppy.addFile(dir, "GAME1A", a, true);
+        floppy.addFile(dir, "GAME1B", b, true);
+        floppy.addFile(0, "SAVES.DIR", pattern(10, 3), false);
+        floppy.save(root / "floppy.img");
+
+        fat_image::Image image(root / "floppy.img", true);
+        auto entry = image.find("saves\\game1a");
+        if (image.fatBits() != 12 || !entry || entry->size != a.size() || image.read(*entry) != a ||
+            image.list("").size() != 2 || image.find("GONE.TXT") || image.find("SAVES/GAME1C")) {
+            std::cerr << "FAT12 lookup or read failed\n";
+            return 1;
+        }
+        std::vector<uint8_t> middle(1100);
+        image.read(*entry, 900, middle.data(), middle.size());
+        if (std::memcmp(middle.data(), a.data() + 900, middle.size()) != 0) {
+            std::cerr << "a read across clusters returned the wrong bytes\n";
+            return 1;
+        }
+
+        // In-place writes land in the file's own clusters and leave its neighbour alone.
+        std::vector<uint8_t> patch(700, 0xAB);
+        image.write(*entry, 400, patch.data(), patch.size());
+        std::memcpy(a.data() + 400, patch.data(), patch.size());
+        fat_image::Image reopened(root / "floppy.img");
+        if (reopened.read(*reopened.find("SAVES/GAME1A")) != a || reopened.read(*reopened.find("SAVES/GAME1B")) != b) {
+            std::cerr << "in-place write did not round-trip\n";
+            return 1;
+        }
+        bool threw = false;
+        try {
+            image.write(*entry, a.size() - 1, patch.data(), 2);
+        } catch (const std::runtime_error &) {
+            threw = true;
+        }
+        if (!threw) {
+            std::cerr << "a write past the end of the file must be refused\n";
+            return 1;
+        }
+    }
+
+    // A partitioned hard-disk image with PM3 in a folder, used as the game path through io.
+    ImageBuilder disk(16, 6000, 24, 512, 63);
+    if (disk.clusters() <= 4084) {
+        std::cerr << "test image should be FAT16\n";
+        return 1;
+    }
+    uint32_t pm3 = disk.addDirectory(0, "PM3");
+    uint32_t savesFolder = disk.addDirectory(pm3, "SAVES");
+    disk.addFile(pm3, "PM3GAME.EXE", pattern(100, 9), false);
+    gamea a{};
+    gameb b{};
+    auto c = std::make_unique<gamec>();
+    std::memset(c.get(), 0, sizeof(gamec));
+    a.year = 1995;
+    b.club[17].bank_account = 12345;
+    c->player[2011].age = 33;
+    auto bytesOf = [](const void *data, std::size_t size) {
+        return std::vector<uint8_t>(static_cast<const uint8_t *>(data), static_cast<const uint8_t *>(data) + size);
+    };
+    disk.addFile(savesFolder, "GAME1A", bytesOf(&a, sizeof(a)), true);
+    disk.addFile(savesFolder, "GAME1B", bytesOf(&b, sizeof(b)), true);
+    disk.addFile(savesFolder, "GAME1C", bytesOf(c.get(), sizeof(gamec)), false);
+    saves savesDir{};
+    prefs prefsData{};
+    disk.addFile(savesFolder, "SAVES.DIR", bytesOf(&savesDir, sizeof(savesDir)), false);
+    disk.addFile(savesFolder, "PREFS", bytesOf(&prefsData, sizeof(prefsData)), false);
+    disk.save(root / "hdd.img");
+
+    fs::path gamePath = io::findPm3InDiskImage(root / "hdd.img");
+    if (gamePath != root / "hdd.img" / "PM3" || io::getPm3GameType(gamePath) != Pm3GameType::Standard) {
+        std::cerr << "PM3 was not found inside the image: " << gamePath << "\n";
+        return 1;
+    }
+    Settings settings;
+    settings.gamePath = gamePath;
+    std::bitset<8> saveFiles;
+    io::memoizeSaveFiles(settings, saveFiles);
+    if (saveFiles.to_ulong() != 1) {
+        std::cerr << "slot list inside the image is wrong\n";
+        return 1;
+    }
+
+    io::LoadedGame loaded;
+    std::string error;
+    if (!io::readGame(gamePath, 1, loaded, error) || loaded.gameA->year != 1995 ||
+        loaded.gameB->club[17].bank_account != 12345 || loaded.gameC->player[2011].age != 33) {
+        std::cerr << "readGame from the image failed: " << error << "\n";
+        return 1;
+    }
+
+    io::installLoadedGame(loaded, defaultGameState);
+    playerData.player[2011].age = 34;
+    dirty_tracker::touchPlayer(2011);
+    io::PendingSave pending = io::captureSave(settings, 1, defaultGameState);
+    dirty_tracker::WriteReport report;
+    if (!io::writeSave(pending, report, error)) {
+        std::cerr << "writeSave into the image failed: " << error << "\n";
+        return 1;
+    }
+    io::finishSave(pending);
+    io::LoadedGame reloaded;
+    if (!io::readGame(gamePath, 1, reloaded, error) || reloaded.gameC->player[2011].age != 34 ||
+        reloaded.gameB->club[17].bank_account != 12345) {
+        std::cerr << "the save did not land inside the image\n";
+        return 1;
+    }
+    fs::path backupDir = root / BACKUP_SAVE_PATH / "hdd.img";
+    if (!fs::exists(backupDir / "store") || fs::exists(backupDir / "staging")) {
+        std::cerr << "the slot should be backed up beside the image\n";
+        return 1;
+    }
+    if (io::manageSlot(gamePath, io::SlotOperation::Copy, 1, 2, error)) {
+        std::cerr << "slot copies cannot create files inside an image\n";
+        return 1;
+    }
+
+    // FAT32 volumes carry a zero 16-bit FAT size and are refused.
+    ImageBuilder fat32(16, 6000, 0, 512);
+    fat32.save(root / "fat32.img");
+    bool refused = false;
+    try {
+        fat_image::Image image(root / "fat32.img");
+    } catch (const std::runtime_error &) {
+        refused = true;
+    }
+    if (!refused) {
+        std::cerr << "FAT32 must be refused\n";
+        return 1;
+    }
+
+    fs::remove_all(root);
+    return 0;
+}
@@ -1,6 +1,8 @@
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <memory>
+#include <thread>
 #include <vector>
 
 #include "game_utils.h"
@@ -33,15 +35,17 @@ int main() {
     playerData.player[1] = bench;
     club.player_index[0] = 0;
     club.player_index[1] = 1;
-    int importance = determinePlayerImportance(playerData.player[0], club);
+    int importance = determinePlayerImportance(defaultGameState, playerData.player[0], club);
     if (importance < 3) return 1;
-    int priceStarter = determinePlayerPrice(playerData.player[0], club, 0);
-    int priceBench = determinePlayerPrice(playerData.player[1], club, 12);
+    int priceStarter = determinePlayerPrice(defaultGameState, playerData.player[0], club, 0);
+    int priceBench = determinePlayerPrice(defaultGameState, playerData.player[1], club, 12);
     if (priceStarter <= priceBench) return 1;
 
-    // findPlayerIndex and findEmptySlot.
-    int16_t idx = game_utils::findPlayerIndex(playerData.player[0]);
-    if (idx != 0) return 1;
+    // Squad handles and findEmptySlot.
+    clubData.club[0] = club;
+    std::vector<PlayerHandle> squad = squadPlayers(defaultGameState, 0);
+    if (squad.size() != 2 || squad[0].playerIdx != 0 || squad[1].playerIdx != 1 || squad[1].slot != 1) return 1;
+    if (&defaultGameState.player(squad[0]) != &playerData.player[0] || !defaultGameState.isCurrent(squad[1])) return 1;
     if (game_utils::findEmptySlot(club) != 2) return 1; // first open slot after two starters
 
     // findFreePlayers respects contract/league.
@@ -54,14 +58,50 @@ int main() {
     clubData.club[0].league = 2;
     clubData.club[0].player_index[0] = 0;
     playerData.player[0].contract = 0;
-    auto freeList = findFreePlayers();
+    auto freeList = findFreePlayers(defaultGameState);
     if (freeList.size() != 1) return 1;
+    if (freeList[0].playerIdx != 0 || freeList[0].clubIdx != 0 || freeList[0].slot != 0) return 1;
+
+    // Handles read the records as they are now, and notice when the player has left the slot.
+    playerData.player[0].wage = 777;
+    if (defaultGameState.player(freeList[0]).wage != 777 || !defaultGameState.isCurrent(freeList[0])) return 1;
+    defaultGameState.setSquadSlot(0, 0, -1);
+    defaultGameState.setSquadSlot(5, 2, 0);
+    PlayerHandle moved = defaultGameState.handleFor(0);
+    if (defaultGameState.isCurrent(freeList[0]) || moved.clubIdx != 5 || moved.slot != 2) return 1;
+    if (game_utils::findClubIndexForPlayer(defaultGameState, 0) != 5) return 1;
+    defaultGameState.setSquadSlot(5, 2, -1);
+    defaultGameState.setSquadSlot(0, 0, 0);
 
     // levelAggression sets all to 5.
     playerData.player[0].aggr = 9;
     playerData.player[3920].aggr = 2;
-    levelAggression();
+    levelAggression(defaultGameState);
     if (playerData.player[0].aggr != 5 || playerData.player[3920].aggr != 5) return 1;
 
+    // Other GameStates are independent of the globals and of each other, and can be worked on in parallel.
+    std::vector<std::unique_ptr<GameState>> states;
+    for (int i = 0; i < 4; ++i) {
+        states.push_back(std::make_unique<GameState>(defaultGameState));
+        for (int slot = 1; slot <= i; ++slot) {
+            states[i]->club(0).player_index[slot] = static_cast<int16_t>(100 + slot);
+        }
+    }
+    std::vector<std::size_t> freeCounts(states.size());
+    std::vector<std::thread> workers;
+    for (std::size_t i = 0; i < states.size(); ++i) {
+        workers.emplace_back([&states, &freeCounts, i] {
+            levelAggression(*states[i]);
+            freeCounts[i] = findFreePlayers(*states[i]).size();
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    for (std::size_t i = 0; i < states.size(); ++i) {
+        if (freeCounts[i] != i + 1 || states[i]->player(3920).aggr != 5) return 1;
+    }
+    if (findFreePlayers(defaultGameState).size() != 1) return 1;
+
     return 0;
 }
@@ -0,0 +1,115 @@
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "history_archive.h"
+#include "pm3_defs.hh"
+
+int main() {
+    namespace fs = std::filesystem;
+    fs::path root = fs::temp_directory_path() / "pm3000_test_history_archive";
+    fs::remove_all(root);
+    fs::path path = history_archive::archivePath(root, 1);
+
+    auto a = std::make_unique<gamea>();
+    auto b = std::make_unique<gameb>();
+    auto c = std::make_unique<gamec>();
+    std::memset(a.get(), 0, sizeof(gamea));
+    std::memset(b.get(), 0, sizeof(gameb));
+    std::memset(c.get(), 0, sizeof(gamec));
+    for (int i = 0; i < 3932; ++i) {
+        c->player[i].age = static_cast<uint8_t>(16 + i % 20);
+        c->player[i].wage = static_cast<int16_t>(i);
+    }
+    for (int i = 0; i < 244; ++i) {
+        b->club[i].bank_account = i * 1000;
+    }
+    a->year = 1995;
+    const void *const files[history_archive::kFileCount] = {a.get(), b.get(), c.get()};
+
+    // More turns than kKeyInterval, so the busy chunks get cut by a key part-way through.
+    constexpr int kTurns = 300;
+    std::vector<uint8_t> midSeason;
+    {
+        history_archive::Archive archive(path);
+        for (int turn = 0; turn < kTurns; ++turn) {
+            a->turn = static_cast<uint16_t>(turn);
+            b->club[17].bank_account = 17000 + turn * 250;
+            c->player[2011].morl = static_cast<uint8_t>(turn % 10);
+            auto result = archive.append(files, 1000 + turn);
+            if (result.unchanged || result.changedChunks == 0) {
+                std::cerr << "turn " << turn << " should have been recorded\n";
+                return 1;
+            }
+            if (turn == 150) {
+                midSeason.assign(reinterpret_cast<const uint8_t *>(c.get()),
+                                 reinterpret_cast<const uint8_t *>(c.get()) + sizeof(gamec));
+            }
+        }
+        if (!archive.append(files, 5000).unchanged || archive.snapshots().size() != kTurns) {
+            std::cerr << "an unchanged slot should not add a snapshot\n";
+            return 1;
+        }
+        // One full copy plus a few bytes per turn.
+        if (archive.sizeOnDisk() > 64 * 1024) {
+            std::cerr << "archive is " << archive.sizeOnDisk() << " bytes\n";
+            return 1;
+        }
+    }
+
+    // A fresh reader sees the same history through the index alone.
+    history_archive::Archive archive(path);
+    if (archive.snapshots().size() != kTurns || archive.snapshots()[42].turn != 42 ||
+        archive.snapshots()[42].year != 1995 || archive.snapshots()[42].recorded != 1042) {
+        std::cerr << "reopened archive should list every snapshot\n";
+        return 1;
+    }
+    std::vector<int32_t> balances;
+    archive.history(1, offsetof(gameb, club[17].bank_account), sizeof(int32_t),
+                    [&](const history_archive::SnapshotInfo &, const uint8_t *bytes) {
+                        int32_t value;
+                        std::memcpy(&value, bytes, sizeof(value));
+                        balances.push_back(value);
+                    });
+    for (int turn = 0; turn < kTurns; ++turn) {
+        if (balances.size() != kTurns || balances[turn] != 17000 + turn * 250) {
+            std::cerr << "bank balance history is wrong at turn " << turn << "\n";
+            return 1;
+        }
+    }
+    if (archive.read(2, 150) != midSeason) {
+        std::cerr << "read() should rebuild the player file as of snapshot 150\n";
+        return 1;
+    }
+    auto latest = archive.read(2, kTurns - 1);
+    if (std::memcmp(latest.data(), c.get(), sizeof(gamec)) != 0) {
+        std::cerr << "read() should rebuild the latest player file across a key\n";
+        return 1;
+    }
+
+    // A torn final record is dropped and overwritten by the next append.
+    fs::resize_file(path, fs::file_size(path) - 3);
+    {
+        history_archive::Archive torn(path);
+        if (torn.snapshots().size() != kTurns - 1) {
+            std::cerr << "a torn record should be ignored\n";
+            return 1;
+        }
+        if (torn.append(files, 9000).unchanged) {
+            std::cerr << "the lost snapshot should be recorded again\n";
+            return 1;
+        }
+    }
+    history_archive::Archive repaired(path);
+    if (repaired.snapshots().size() != kTurns || repaired.snapshots().back().recorded != 9000 ||
+        std::memcmp(repaired.read(1, kTurns - 1).data(), b.get(), sizeof(gameb)) != 0) {
+        std::cerr << "append after a torn record should leave a readable archive\n";
+        return 1;
+    }
+
+    fs::remove_all(root);
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "installation.h"
+#include "io.h"
+
+int main() {
+    namespace fs = std::filesystem;
+    fs::path root = fs::temp_directory_path() / "pm3000_test_installation";
+    fs::remove_all(root);
+    fs::create_directories(root / std::string{kStandardSavesPath});
+    std::ofstream(root / std::string{kExeStandardFilename}).put('\0');
+    std::ofstream(root / std::string{kStandardSavesPath} / "GAME2A") << "abc";
+    std::ofstream(root / std::string{kStandardSavesPath} / "game2b") << "abcd";
+    std::ofstream(root / std::string{kStandardSavesPath} / "GAME2C") << "abcde";
+    std::ofstream(root / std::string{kStandardSavesPath} / "GAME9A") << "x";
+
+    auto installation = io::installationFor(root);
+    if (installation->gameType() != Pm3GameType::Standard ||
+        installation->savesFolder() != root / std::string{kStandardSavesPath}) {
+        std::cerr << "standard install not detected\n";
+        return 1;
+    }
+    if (!installation->hasSlot(2) || installation->hasSlot(1) || installation->saveFileSize(2, 'B') != 4 ||
+        installation->hasSaveFile(9, 'A')) {
+        std::cerr << "slot scan is wrong\n";
+        return 1;
+    }
+    if (io::constructSaveFilePath(root, 3, 'C') != root / std::string{kStandardSavesPath} / "GAME3C") {
+        std::cerr << "save path built from the wrong folder\n";
+        return 1;
+    }
+
+    // Repeated lookups reuse the probe while nothing changes.
+    if (io::installationFor(root) != installation) {
+        std::cerr << "unchanged folder should not be re-probed\n";
+        return 1;
+    }
+
+    std::bitset<8> saveFiles;
+    Settings settings;
+    settings.gamePath = root;
+    if (installation->watched()) {
+        // Writes that leave the slot files where they are keep the probe.
+        std::ofstream(root / std::string{kStandardSavesPath} / "GAME2A") << "rewritten";
+        std::ofstream(root / std::string{kStandardSavesPath} / "SAVES.DIR") << "dir";
+        fs::create_directories(root / std::string{kStandardSavesPath} / "PM3000");
+        if (io::installationFor(root) != installation) {
+            std::cerr << "writes into the saves folder should not re-probe\n";
+            return 1;
+        }
+
+        // A new slot file shows up without an explicit refresh.
+        std::ofstream(root / std::string{kStandardSavesPath} / "GAME1A") << "a";
+        std::ofstream(root / std::string{kStandardSavesPath} / "GAME1B") << "b";
+        std::ofstream(root / std::string{kStandardSavesPath} / "GAME1C") << "c";
+        io::memoizeSaveFiles(settings, saveFiles);
+        if (!saveFiles.test(0) || !saveFiles.test(1) || saveFiles.count() != 2) {
+            std::cerr << "watch did not pick up the new slot\n";
+            return 1;
+        }
+
+        fs::remove(root / std::string{kExeStandardFilename});
+        if (io::installationFor(root)->gameType() != Pm3GameType::Unknown) {
+            std::cerr << "removing the executable should invalidate the install\n";
+            return 1;
+        }
+    } else {
+        io::memoizeSaveFiles(settings, saveFiles);
+        if (!saveFiles.test(1) || saveFiles.count() != 1) {
+            std::cerr << "memoizeSaveFiles should rescan an unwatched folder\n";
+            return 1;
+        }
+    }
+
+    fs::remove_all(root);
+    return 0;
+}
@@ -0,0 +1,230 @@
+#include <atomic>
+#include <bitset>
+#include <condition_variable>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "config/constants.h"
+#include "dirty_tracker.h"
+#include "edit_journal.h"
+#include "io.h"
+#include "io_worker.h"
+#include "pm3_data.h"
+#include "save_ledger.h"
+#include "test_util.h"
+
+int main() {
+    namespace fs = std::filesystem;
+
+    std::atomic<int> notifications{0};
+    io::IoWorker worker([&notifications] { ++notifications; });
+
+    // A job holds its slot until the owner pumps its completion; other slots stay free.
+    std::mutex gateMutex;
+    std::condition_variable gate;
+    bool release = false;
+    std::thread::id completionThread;
+    bool submitted = worker.submit(3, [&](const io::IoWorker::Report &progress) -> io::IoWorker::Completion {
+        progress("WORKING ON GAME 3");
+        std::unique_lock<std::mutex> lock(gateMutex);
+        gate.wait(lock, [&release] { return release; });
+        return [&completionThread] { completionThread = std::this_thread::get_id(); };
+    });
+    if (!submitted || !worker.isBusy(3) || worker.isBusy(4)) {
+        std::cerr << "submitted job should claim only its own slot\n";
+        return 1;
+    }
+    if (worker.submit(3, [](const io::IoWorker::Report &) { return io::IoWorker::Completion{}; })) {
+        std::cerr << "a busy slot must reject a second job\n";
+        return 1;
+    }
+    while (worker.progress().empty()) {
+        std::this_thread::yield();
+    }
+    if (worker.progress() != "WORKING ON GAME 3") {
+        std::cerr << "progress text was not published\n";
+        return 1;
+    }
+    {
+        std::lock_guard<std::mutex> lock(gateMutex);
+        release = true;
+    }
+    gate.notify_all();
+    worker.drain();
+    if (completionThread != std::this_thread::get_id() || worker.isBusy(3) || !worker.idle() ||
+        notifications.load() < 2) {
+        std::cerr << "completion should run on the pumping thread and free the slot\n";
+        return 1;
+    }
+
+    // A two-slot job claims both slots, or neither if one is taken.
+    worker.submit(5, [](const io::IoWorker::Report &) { return io::IoWorker::Completion{}; });
+    if (worker.submit({5, 6}, [](const io::IoWorker::Report &) { return io::IoWorker::Completion{}; }) ||
+        worker.isBusy(6)) {
+        std::cerr << "a multi-slot job must not claim part of its slots\n";
+        return 1;
+    }
+    worker.drain();
+    if (!worker.submit({5, 6}, [](const io::IoWorker::Report &) { return io::IoWorker::Completion{}; }) ||
+        !worker.isBusy(5) || !worker.isBusy(6)) {
+        std::cerr << "a multi-slot job should claim every slot\n";
+        return 1;
+    }
+    worker.drain();
+
+    // A job that throws frees its slot, and its message is kept for the owner once pumped.
+    worker.submit(4, [](const io::IoWorker::Report &) -> io::IoWorker::Completion {
+        throw std::runtime_error("DISK FULL");
+    });
+    worker.drain();
+    if (worker.isBusy(4) || worker.takeError() != "DISK FULL" || !worker.takeError().empty()) {
+        std::cerr << "a failed job's message should be visible after drain, once\n";
+        return 1;
+    }
+
+    // End to end: an async save lands on disk while the globals keep changing, then an async load brings it back.
+    fs::path root = fs::temp_directory_path() / "pm3000_test_io_worker";
+    fs::remove_all(root);
+    fs::create_directories(root / std::string{kStandardSavesPath});
+    std::ofstream(root / std::string{kExeStandardFilename}).put('\0');
+
+    std::memset(&gameData, 0, sizeof(gameData));
+    std::memset(&clubData, 0, sizeof(clubData));
+    std::memset(&playerData, 0, sizeof(playerData));
+    // Empty squads, or the load would find player 0 in every slot. One slot is corrupt and repaired on load.
+    for (ClubRecord &club : clubData.club) {
+        std::memset(club.player_index, 0xFF, sizeof(club.player_index));
+    }
+    clubData.club[2].player_index[3] = 9999;
+    writeStruct(io::constructSaveFilePath(root, 1, 'A'), gameData);
+    writeStruct(io::constructSaveFilePath(root, 1, 'B'), clubData);
+    writeStruct(io::constructSaveFilePath(root, 1, 'C'), playerData);
+
+    Settings settings;
+    settings.gamePath = root;
+    char footer[70]{};
+    int currentGame = 0;
+    io::loadGameAsync(worker, settings, 1, currentGame, footer, sizeof(footer));
+    worker.drain();
+    if (currentGame != 1 || std::strcmp(footer, "GAME 1 LOADED, 1 ERRORS REPAIRED") != 0 ||
+        clubData.club[2].player_index[3] != -1 || !dirty_tracker::isDirty(dirty_tracker::kGameB)) {
+        std::cerr << "async load did not complete with the repair pending: " << footer << "\n";
+        return 1;
+    }
+
+    // A save that fails keeps the undo history; only one that lands starts a new history.
+    edit_journal::begin();
+    dirty_tracker::touchPlayer(7);
+    playerData.player[7].age = 30;
+    edit_journal::commit("AGE");
+    Settings missing;
+    missing.gamePath = root / "missing";
+    io::saveGameAsync(worker, missing, 1, footer, sizeof(footer));
+    worker.drain();
+    if (std::strncmp(footer, "GAME 1 SAVED", 12) == 0 || !edit_journal::canUndo()) {
+        std::cerr << "a failed save must keep the undo history: " << footer << "\n";
+        return 1;
+    }
+
+    dirty_tracker::touchPlayer(7);
+    io::saveGameAsync(worker, settings, 1, footer, sizeof(footer));
+    // Edits made after the save was queued belong to the next save, not this one.
+    dirty_tracker::touchPlayer(8);
+    playerData.player[8].age = 31;
+    worker.drain();
+    if (std::strncmp(footer, "GAME 1 SAVED", 12) != 0 || !dirty_tracker::isDirty(dirty_tracker::kGameC) ||
+        edit_journal::canUndo()) {
+        std::cerr << "async save did not complete: " << footer << "\n";
+        return 1;
+    }
+
+    playerData.player[7].age = 0;
+    playerData.player[8].age = 0;
+    io::loadGameAsync(worker, settings, 1, currentGame, footer, sizeof(footer));
+    worker.drain();
+    if (playerData.player[7].age != 30 || playerData.player[8].age != 0 ||
+        std::strcmp(footer, "GAME 1 LOADED") != 0) {
+        std::cerr << "reloaded slot should hold exactly the state captured at save time, repair included\n";
+        return 1;
+    }
+
+    // Slot management: copy, swap, move and delete rewrite only the SAVES.DIR entries of the slots involved.
+    saves savesDir{};
+    for (int i = 0; i < 8; ++i) {
+        savesDir.game[i].year = static_cast<uint16_t>(1991 + i);
+    }
+    prefs prefsData{};
+    fs::path savesPath = io::constructSavesFolderPath(root);
+    writeStruct(savesPath / std::string{kSavesDirFile}, savesDir);
+    writeStruct(savesPath / std::string{kPrefsFile}, prefsData);
+    auto slotYears = [&]() {
+        saves loaded{};
+        prefs unused{};
+        io::loadMetadata(root, loaded, unused);
+        std::string years;
+        for (const auto &entry : loaded.game) {
+            years += std::to_string(entry.year % 10);
+        }
+        return years;
+    };
+    auto readSlot = [&](int gameNumber) {
+        std::ifstream in(io::constructSaveFilePath(root, gameNumber, 'C'), std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    };
+    std::string slotOne = readSlot(1);
+
+    // The copy takes slot 1's ledger along; a crash file left for slot 2 no longer applies.
+    fs::path backupDir = savesPath / BACKUP_SAVE_PATH;
+    std::ofstream(edit_journal::crashFilePath(backupDir, 2)).put('\0');
+    std::bitset<8> saveFiles;
+    io::manageSlotAsync(worker, settings, io::SlotOperation::Copy, 1, 2, saveFiles, footer, sizeof(footer));
+    worker.drain();
+    if (std::strcmp(footer, "GAME 1 COPIED TO GAME 2") != 0 || readSlot(2) != slotOne || slotYears() != "11345678" ||
+        saveFiles.to_ulong() != 0b11) {
+        std::cerr << "slot copy failed: " << footer << " " << slotYears() << "\n";
+        return 1;
+    }
+    if (!fs::exists(save_ledger::ledgerPath(backupDir, 2)) || fs::exists(edit_journal::crashFilePath(backupDir, 2)) ||
+        !fs::exists(edit_journal::crashFilePath(backupDir, 1))) {
+        std::cerr << "the ledger should follow the copy and only the target's crash file go\n";
+        return 1;
+    }
+
+    std::string error;
+    playerData.player[0].age = 42;
+    io::saveBinaries(3, root, gameData, clubData, playerData);
+    std::string slotThree = readSlot(3);
+    if (!io::manageSlot(root, io::SlotOperation::Swap, 3, 1, error) || readSlot(1) != slotThree ||
+        readSlot(3) != slotOne || slotYears() != "31145678") {
+        std::cerr << "slot swap failed: " << error << " " << slotYears() << "\n";
+        return 1;
+    }
+    if (!io::manageSlot(root, io::SlotOperation::Move, 3, 7, error) ||
+        fs::exists(io::constructSaveFilePath(root, 3, 'A')) || readSlot(7) != slotOne || slotYears() != "31045618") {
+        std::cerr << "slot move failed: " << error << " " << slotYears() << "\n";
+        return 1;
+    }
+    if (!io::manageSlot(root, io::SlotOperation::Delete, 2, 0, error) ||
+        fs::exists(io::constructSaveFilePath(root, 2, 'B')) || slotYears() != "30045618") {
+        std::cerr << "slot delete failed: " << error << " " << slotYears() << "\n";
+        return 1;
+    }
+    if (fs::exists(save_ledger::ledgerPath(backupDir, 2))) {
+        std::cerr << "a deleted slot's ledger should go with it\n";
+        return 1;
+    }
+    if (io::manageSlot(root, io::SlotOperation::Swap, 1, 2, error) || error != "GAME 2 IS EMPTY") {
+        std::cerr << "swapping with an empty slot should be refused\n";
+        return 1;
+    }
+
+    fs::remove_all(root);
+    return 0;
+}
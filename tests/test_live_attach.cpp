@@ -0,0 +1,168 @@
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "io.h"
+#include "live_attach.h"
+#include "pm3_data.h"
+
+namespace {
+
+// Stands in for DOSBox: holds the base data in memory, prints where, and changes it when told to.
+int standIn(const std::filesystem::path &root) {
+    auto state = std::make_unique<GameState>();
+    io::loadDefaultData(root, *state);
+    std::printf("%" PRIxPTR " %" PRIxPTR " %" PRIxPTR "\n", reinterpret_cast<uintptr_t>(&state->game),
+                reinterpret_cast<uintptr_t>(&state->clubs), reinterpret_cast<uintptr_t>(&state->players));
+    std::fflush(stdout);
+    char command[16];
+    while (std::fgets(command, sizeof(command), stdin) != nullptr && command[0] != 'q') {
+        state->player(100).hn = 99;
+        state->club(3).bank_account = 123456;
+        std::printf("ok\n");
+        std::fflush(stdout);
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    namespace fs = std::filesystem;
+
+    if (argc == 3 && std::string(argv[1]) == "--stand-in") {
+        return standIn(argv[2]);
+    }
+
+    fs::path root = fs::temp_directory_path() / "pm3000_test_live_attach";
+    fs::remove_all(root);
+    fs::create_directories(root);
+
+    auto reference = std::make_unique<GameState>();
+    std::memset(&reference->game, 0, sizeof(gamea));
+    std::memset(&reference->clubs, 0, sizeof(gameb));
+    std::memset(&reference->players, 0, sizeof(gamec));
+    for (int i = 0; i < static_cast<int>(std::extent_v<decltype(gameb::club)>); ++i) {
+        std::snprintf(reference->club(i).name, sizeof(ClubRecord::name), "CLUB %03d", i);
+    }
+    for (int16_t i = 0; i < static_cast<int16_t>(std::extent_v<decltype(gamec::player)>); ++i) {
+        char name[16];
+        std::snprintf(name, sizeof(name), "PLAYER %04d", i);
+        std::memcpy(reference->player(i).name, name, sizeof(PlayerRecord::name));
+    }
+    for (int year = 0; year < 20; ++year) {
+        reference->game.league[0].history[year].year = static_cast<int16_t>(1975 + year);
+        reference->game.league[0].history[year].club_idx = static_cast<int16_t>(year);
+    }
+    io::saveDefaultData(root, *reference);
+
+    // A fresh process image, so the only copy of the data in it is the one the stand-in loads.
+    int toChild[2];
+    int fromChild[2];
+    if (pipe(toChild) != 0 || pipe(fromChild) != 0) {
+        std::cerr << "pipe failed\n";
+        return 1;
+    }
+    pid_t pid = fork();
+    if (pid == 0) {
+        dup2(toChild[0], STDIN_FILENO);
+        dup2(fromChild[1], STDOUT_FILENO);
+        close(toChild[1]);
+        close(fromChild[0]);
+        execl("/proc/self/exe", argv[0], "--stand-in", root.c_str(), static_cast<char *>(nullptr));
+        _exit(127);
+    }
+    close(toChild[0]);
+    close(fromChild[1]);
+    FILE *commands = fdopen(toChild[1], "w");
+    FILE *replies = fdopen(fromChild[0], "r");
+    auto finish = [&](int code) {
+        std::fputs("q\n", commands);
+        std::fclose(commands);
+        std::fclose(replies);
+        waitpid(pid, nullptr, 0);
+        fs::remove_all(root);
+        return code;
+    };
+    uintptr_t expected[3]{};
+    if (std::fscanf(replies, "%" SCNxPTR " %" SCNxPTR " %" SCNxPTR, &expected[0], &expected[1], &expected[2]) != 3) {
+        std::cerr << "the stand-in did not start\n";
+        return finish(1);
+    }
+
+    // The signatures find the blocks where the stand-in holds them.
+    io::LiveAttach::Location location;
+    std::string error;
+    if (!io::LiveAttach::find(pid, *reference, location, error)) {
+        std::cerr << "find failed: " << error << "\n";
+        return finish(1);
+    }
+    io::LiveAttach live;
+    live.attach(location);
+    for (int file = io::kWatchGameA; file <= io::kWatchGameC; ++file) {
+        if (live.address(file) != expected[file]) {
+            std::cerr << "block " << file << " found at the wrong address\n";
+            return finish(1);
+        }
+    }
+
+    // The first refresh copies everything; after that only chunks the process changed are copied, and edits to
+    // the rest of the view stay.
+    auto view = std::make_unique<GameState>();
+    if (live.refresh(*view, error).count() != 3 || std::memcmp(&view->clubs, &reference->clubs, sizeof(gameb)) != 0 ||
+        std::memcmp(&view->players, &reference->players, sizeof(gamec)) != 0) {
+        std::cerr << "the first refresh should copy the blocks\n";
+        return finish(1);
+    }
+    if (live.refresh(*view, error).any()) {
+        std::cerr << "nothing changed\n";
+        return finish(1);
+    }
+    view->player(3000).hn = 5;
+    char reply[8];
+    std::fputs("c\n", commands);
+    std::fflush(commands);
+    if (std::fscanf(replies, "%7s", reply) != 1) {
+        std::cerr << "the stand-in did not answer\n";
+        return finish(1);
+    }
+    io::WatchedFiles changed = live.refresh(*view, error);
+    if (changed.test(io::kWatchGameA) || !changed.test(io::kWatchGameB) || !changed.test(io::kWatchGameC) ||
+        view->player(100).hn != 99 || view->club(3).bank_account != 123456 || view->player(3000).hn != 5 ||
+        live.lastCopied() > 2 * io::LiveAttach::kChunkSize) {
+        std::cerr << "only the changed chunks should be copied\n";
+        return finish(1);
+    }
+
+    // poll() keeps to the interval.
+    live.setInterval(std::chrono::seconds(60));
+    io::LiveAttach::Clock::time_point now = io::LiveAttach::Clock::now();
+    live.poll(*view, error, now);
+    if (live.poll(*view, error, now + std::chrono::seconds(1)).any() || live.lastCopied() != 0) {
+        std::cerr << "poll should wait for the interval\n";
+        return finish(1);
+    }
+
+    // Once the process is gone the view detaches.
+    std::fputs("q\n", commands);
+    std::fflush(commands);
+    waitpid(pid, nullptr, 0);
+    error.clear();
+    live.refresh(*view, error);
+    if (live.isAttached() || error.empty()) {
+        std::cerr << "a refresh after the process exited should detach\n";
+        return finish(1);
+    }
+
+    std::fclose(commands);
+    std::fclose(replies);
+    fs::remove_all(root);
+    return 0;
+}
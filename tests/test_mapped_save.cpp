@@ -0,0 +1,104 @@
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "io.h"
+#include "mapped_save.h"
+#include "test_util.h"
+
+namespace {
+
+std::vector<char> readAll(const std::filesystem::path &path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<char>((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+} // namespace
+
+int main() {
+    namespace fs = std::filesystem;
+    fs::path root = fs::temp_directory_path() / "pm3000_test_mapped_save";
+    fs::remove_all(root);
+    fs::create_directories(root / std::string{kStandardSavesPath});
+    std::ofstream(root / std::string{kExeStandardFilename}).put('\0');
+
+    auto a = std::make_unique<gamea>();
+    auto b = std::make_unique<gameb>();
+    auto c = std::make_unique<gamec>();
+    std::memset(a.get(), 0, sizeof(gamea));
+    std::memset(b.get(), 0, sizeof(gameb));
+    std::memset(c.get(), 0, sizeof(gamec));
+    a->year = 1995;
+    std::strncpy(b->club[17].name, "Arsenal", sizeof(b->club[17].name));
+    c->player[2011].hn = 42;
+
+    writeStruct(io::constructSaveFilePath(root, 3, 'A'), *a);
+    writeStruct(io::constructSaveFilePath(root, 3, 'B'), *b);
+    writeStruct(io::constructSaveFilePath(root, 3, 'C'), *c);
+
+    io::MappedGame readOnly;
+    if (!readOnly.open(root, 3)) {
+        std::cerr << "read-only open failed: " << io::pm3LastError() << "\n";
+        return 1;
+    }
+    if (readOnly.gameA().year != 1995 || std::strcmp(readOnly.gameB().club[17].name, "Arsenal") != 0 ||
+        readOnly.gameC().player[2011].hn != 42) {
+        std::cerr << "mapped views do not match file contents\n";
+        return 1;
+    }
+    readOnly.close();
+
+    io::MappedGame mapped;
+    if (!mapped.open(root, 3, true)) {
+        std::cerr << "writable open failed: " << io::pm3LastError() << "\n";
+        return 1;
+    }
+
+    // Edits stay private until commit.
+    mapped.gameB().club[17].bank_account = 123456;
+    mapped.gameC().player[2011].hn = 77;
+    std::vector<char> beforeCommit = readAll(io::constructSaveFilePath(root, 3, 'C'));
+    if (reinterpret_cast<const gamec *>(beforeCommit.data())->player[2011].hn != 42) {
+        std::cerr << "copy-on-write mapping leaked to disk before commit\n";
+        return 1;
+    }
+
+    std::size_t written = mapped.commit();
+    std::size_t pageSize = io::mappedPageSize();
+    if (written == 0 || written > 2 * pageSize) {
+        std::cerr << "commit wrote " << written << " bytes, expected at most two pages\n";
+        return 1;
+    }
+    if (mapped.commit() != 0) {
+        std::cerr << "second commit should have nothing left to write\n";
+        return 1;
+    }
+    mapped.close();
+
+    std::vector<char> afterB = readAll(io::constructSaveFilePath(root, 3, 'B'));
+    std::vector<char> afterC = readAll(io::constructSaveFilePath(root, 3, 'C'));
+    if (afterB.size() != sizeof(gameb) || afterC.size() != sizeof(gamec)) {
+        std::cerr << "commit changed file sizes\n";
+        return 1;
+    }
+    const auto *committedB = reinterpret_cast<const gameb *>(afterB.data());
+    const auto *committedC = reinterpret_cast<const gamec *>(afterC.data());
+    if (committedB->club[17].bank_account != 123456 || committedC->player[2011].hn != 77 ||
+        std::strcmp(committedB->club[17].name, "Arsenal") != 0) {
+        std::cerr << "committed contents are wrong\n";
+        return 1;
+    }
+
+    // Wrong-sized files are rejected instead of mapped.
+    fs::resize_file(io::constructSaveFilePath(root, 3, 'A'), sizeof(gamea) - 1);
+    if (mapped.open(root, 3) || io::pm3LastError().empty()) {
+        std::cerr << "truncated save should not map\n";
+        return 1;
+    }
+
+    fs::remove_all(root);
+    return 0;
+}
@@ -0,0 +1,174 @@
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "pm3_codec.h"
+#include "pm3_defs.hh"
+
+namespace {
+
+void putBigEndian(void *base, std::size_t offset, uint32_t value, int width) {
+    auto *p = static_cast<uint8_t *>(base) + offset;
+    for (int i = 0; i < width; ++i) {
+        p[i] = static_cast<uint8_t>(value >> (8 * (width - 1 - i)));
+    }
+}
+
+void fillRandom(void *data, std::size_t size, std::mt19937 &rng) {
+    auto *p = static_cast<uint8_t *>(data);
+    for (std::size_t i = 0; i < size; ++i) {
+        p[i] = static_cast<uint8_t>(rng());
+    }
+}
+
+// Runs are sorted, stay inside the struct, and never swap a byte twice.
+template <typename T>
+bool schemaIsSound(const char *name) {
+    std::vector<int> covered(sizeof(T), 0);
+    uint32_t lastOffset = 0;
+    for (const auto &run : pm3_codec::schema<T>()) {
+        if (run.offset < lastOffset || (run.width != 2 && run.width != 4)) {
+            std::cerr << name << ": runs out of order or bad width at offset " << run.offset << "\n";
+            return false;
+        }
+        lastOffset = run.offset;
+        for (uint32_t r = 0; r < run.repeat; ++r) {
+            std::size_t start = run.offset + static_cast<std::size_t>(r) * run.stride;
+            std::size_t end = start + static_cast<std::size_t>(run.count) * run.width;
+            if (end > sizeof(T)) {
+                std::cerr << name << ": run at " << run.offset << " overruns the struct\n";
+                return false;
+            }
+            for (std::size_t i = start; i < end; ++i) {
+                if (covered[i]++) {
+                    std::cerr << name << ": byte " << i << " is swapped twice\n";
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+template <typename T>
+bool roundTrips(const char *name, std::mt19937 &rng) {
+    auto original = std::make_unique<T>();
+    fillRandom(original.get(), sizeof(T), rng);
+    auto copy = std::make_unique<T>(*original);
+    pm3_codec::encode(*copy, pm3_codec::Endian::Big);
+    bool changed = std::memcmp(copy.get(), original.get(), sizeof(T)) != 0;
+    pm3_codec::decode(*copy, pm3_codec::Endian::Big);
+    if (!changed || std::memcmp(copy.get(), original.get(), sizeof(T)) != 0) {
+        std::cerr << name << ": big-endian round trip is not the identity\n";
+        return false;
+    }
+    pm3_codec::decode(*copy, pm3_codec::kNativeEndian);
+    if (std::memcmp(copy.get(), original.get(), sizeof(T)) != 0) {
+        std::cerr << name << ": decoding native order should not touch the data\n";
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(1994);
+
+    if (!schemaIsSound<gamea>("gamea") || !schemaIsSound<gameb>("gameb") || !schemaIsSound<gamec>("gamec") ||
+        !schemaIsSound<saves>("saves") || !schemaIsSound<prefs>("prefs")) {
+        return 1;
+    }
+    if (!roundTrips<gamea>("gamea", rng) || !roundTrips<gameb>("gameb", rng) || !roundTrips<gamec>("gamec", rng) ||
+        !roundTrips<saves>("saves", rng) || !roundTrips<prefs>("prefs", rng)) {
+        return 1;
+    }
+
+    // The vector kernels agree with the scalar loops at every length and alignment.
+    std::vector<uint8_t> buffer(300);
+    fillRandom(buffer.data(), buffer.size(), rng);
+    for (std::size_t offset = 0; offset < 4; ++offset) {
+        for (std::size_t count : {0u, 1u, 3u, 7u, 8u, 9u, 31u, 64u}) {
+            std::vector<uint8_t> fast = buffer;
+            std::vector<uint8_t> slow = buffer;
+            pm3_codec::swap16(fast.data() + offset, count);
+            pm3_codec::swap16Portable(slow.data() + offset, count);
+            if (fast != slow) {
+                std::cerr << "swap16 disagrees with the scalar loop at offset " << offset << " count " << count << "\n";
+                return 1;
+            }
+            pm3_codec::swap32(fast.data() + offset, count);
+            pm3_codec::swap32Portable(slow.data() + offset, count);
+            if (fast != slow) {
+                std::cerr << "swap32 disagrees with the scalar loop at offset " << offset << " count " << count << "\n";
+                return 1;
+            }
+        }
+    }
+
+    // A synthetic Amiga slot: big-endian values at known fields decode to native ones, text is left alone.
+    auto game = std::make_unique<gamea>();
+    auto clubs = std::make_unique<gameb>();
+    auto players = std::make_unique<gamec>();
+    std::memset(game.get(), 0, sizeof(gamea));
+    std::memset(clubs.get(), 0, sizeof(gameb));
+    std::memset(players.get(), 0, sizeof(gamec));
+
+    putBigEndian(game.get(), offsetof(gamea, club_index.all[3]), 0x00C1, 2);
+    putBigEndian(game.get(), offsetof(gamea, table.all[113].aa), 0xFFFE, 2);
+    putBigEndian(game.get(), offsetof(gamea, cuppy.all[148].club[1].audience), 45000, 4);
+    putBigEndian(game.get(), offsetof(gamea, year), 1996, 2);
+    putBigEndian(game.get(), offsetof(gamea, manager[1].bank_statement[1].account_interest[1]), 0xFFFFFC18, 4);
+    putBigEndian(game.get(), offsetof(gamea, manager[1].match_summary.club[1].lineup[13].player_idx), 3931, 2);
+    putBigEndian(game.get(), offsetof(gamea, manager[1].match_history[241].goals_a), 7, 2);
+    putBigEndian(game.get(), offsetof(gamea, inc_number3), 0x0102, 2);
+    std::memcpy(game->manager[0].name, "MARK       ", 11);
+
+    putBigEndian(clubs.get(), offsetof(gameb, club[5].bank_account), 0x00123456, 4);
+    putBigEndian(clubs.get(), offsetof(gameb, club[243].player_index[23]), 0xFFFF, 2);
+    putBigEndian(clubs.get(), offsetof(gameb, club[243].seating_max), 30000, 4);
+    putBigEndian(players.get(), offsetof(gamec, player[3931].ins_cost), 0x1234, 2);
+    players->player[3931].age = 33;
+
+    auto amigaGame = std::make_unique<gamea>(*game);
+    auto amigaClubs = std::make_unique<gameb>(*clubs);
+    auto amigaPlayers = std::make_unique<gamec>(*players);
+    pm3_codec::decode(*game, pm3_codec::Endian::Big);
+    pm3_codec::decode(*clubs, pm3_codec::Endian::Big);
+    pm3_codec::decode(*players, pm3_codec::Endian::Big);
+
+    if (game->club_index.all[3] != 0xC1 || game->table.all[113].aa != -2 ||
+        game->cuppy.all[148].club[1].audience != 45000 || game->year != 1996 ||
+        game->manager[1].bank_statement[1].account_interest[1] != -1000 ||
+        game->manager[1].match_summary.club[1].lineup[13].player_idx != 3931 ||
+        game->manager[1].match_history[241].goals_a != 7 || game->inc_number3 != 0x0102 ||
+        std::memcmp(game->manager[0].name, "MARK       ", 11) != 0) {
+        std::cerr << "big-endian gamea fields did not decode\n";
+        return 1;
+    }
+    if (clubs->club[5].bank_account != 0x00123456 || clubs->club[243].player_index[23] != -1 ||
+        clubs->club[243].seating_max != 30000 || players->player[3931].ins_cost != 0x1234 ||
+        players->player[3931].age != 33) {
+        std::cerr << "big-endian club or player fields did not decode\n";
+        return 1;
+    }
+
+    pm3_codec::encode(*game, pm3_codec::Endian::Big);
+    pm3_codec::encode(*clubs, pm3_codec::Endian::Big);
+    pm3_codec::encode(*players, pm3_codec::Endian::Big);
+    if (std::memcmp(game.get(), amigaGame.get(), sizeof(gamea)) != 0 ||
+        std::memcmp(clubs.get(), amigaClubs.get(), sizeof(gameb)) != 0 ||
+        std::memcmp(players.get(), amigaPlayers.get(), sizeof(gamec)) != 0) {
+        std::cerr << "re-encoding should reproduce the big-endian image\n";
+        return 1;
+    }
+
+    if (pm3_codec::byteSwap16(0x0102) != 0x0201 || pm3_codec::byteSwap16(-2) != static_cast<int16_t>(0xFEFF)) {
+        std::cerr << "byteSwap16 is wrong\n";
+        return 1;
+    }
+    return 0;
+}
@@ -1,3 +1,6 @@
+#include <cstring>
+#include <iostream>
+#include <memory>
 #include <type_traits>
 
 #include "pm3_data.h"
@@ -14,5 +17,45 @@ int main() {
     static_assert(sizeof(gamec) == 157280, "gamec size must match PM3 binary");
     static_assert(sizeof(ClubRecord) == 570, "ClubRecord size must match PM3 binary");
     static_assert(sizeof(PlayerRecord) == 40, "PlayerRecord size must match PM3 binary");
+
+    auto state = std::make_unique<GameState>();
+    std::memset(&state->clubs, 0xFF, sizeof(gameb));
+    state->club(3).player_index[5] = 42;
+    state->club(200).player_index[0] = 43;
+    state->club(7).player_index[1] = 44;
+    state->club(9).player_index[2] = 44;
+
+    // The index is built on the first lookup and lists each player's first squad.
+    SquadPlace place = state->squadPlace(42);
+    if (state->squadIndex.empty() || place.clubIdx != 3 || place.slot != 5 || place.listings != 1 ||
+        state->squadPlace(43).clubIdx != 200 || state->squadPlace(100).clubIdx != -1 ||
+        state->squadPlace(44).clubIdx != 7 || state->squadPlace(44).listings != 2 ||
+        state->squadPlace(-1).clubIdx != -1) {
+        std::cerr << "unexpected squad places\n";
+        return 1;
+    }
+
+    // setSquadSlot keeps the entries current without a rebuild.
+    state->setSquadSlot(3, 5, -1);
+    state->setSquadSlot(12, 0, 42);
+    state->setSquadSlot(12, 1, 100);
+    state->setSquadSlot(7, 1, -1);
+    const SquadPlace &moved = state->squadIndex[42];
+    const SquadPlace &signing = state->squadIndex[100];
+    const SquadPlace &single = state->squadIndex[44];
+    if (moved.clubIdx != 12 || moved.slot != 0 || signing.clubIdx != 12 || signing.slot != 1 ||
+        single.listings != 1 || state->squadPlace(44).clubIdx != 9 || state->squadPlace(44).slot != 2) {
+        std::cerr << "setSquadSlot should update the index\n";
+        return 1;
+    }
+
+    // Blocks written wholesale are picked up after squadsReplaced().
+    std::memset(&state->clubs, 0xFF, sizeof(gameb));
+    state->club(50).player_index[3] = 42;
+    state->squadsReplaced();
+    if (state->squadPlace(42).clubIdx != 50 || state->squadPlace(100).clubIdx != -1) {
+        std::cerr << "squadsReplaced should rebuild the index\n";
+        return 1;
+    }
     return 0;
 }
@@ -0,0 +1,147 @@
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "pm3_defs.hh"
+#include "pm3_schema.h"
+
+namespace {
+
+const pm3_schema::Field *find(const pm3_schema::Record &record, const char *name) {
+    for (const auto &field : record) {
+        if (std::strcmp(field.name, name) == 0) {
+            return &field;
+        }
+    }
+    return nullptr;
+}
+
+// Reads `name` out of `data` through the schema; -999 if the field is missing.
+int64_t read(const pm3_schema::Record &record, const void *data, const char *name) {
+    const pm3_schema::Field *field = find(record, name);
+    return field ? pm3_schema::readValue(*field, static_cast<const uint8_t *>(data) + field->offset) : -999;
+}
+
+} // namespace
+
+int main() {
+    using namespace pm3_schema;
+
+    // Bitfield descriptors agree with how the compiler packs the structs.
+    PlayerRecord player{};
+    player.morl = 9;
+    player.aggr = 5;
+    player.ins = 2;
+    player.age = 33;
+    player.foot = 3;
+    player.dpts = 41;
+    player.period_type = 17;
+    player.contract = 5;
+    player.train = 7;
+    player.intense = 12;
+    player.wage = 1250;
+    const std::map<std::string, int64_t> expected{{"morl", 9},        {"aggr", 5},     {"ins", 2},
+                                                  {"age", 33},        {"foot", 3},     {"dpts", 41},
+                                                  {"period_type", 17}, {"contract", 5}, {"train", 7},
+                                                  {"intense", 12},    {"wage", 1250}};
+    for (const auto &[name, value] : expected) {
+        if (read(kPlayer, &player, name.c_str()) != value) {
+            std::cerr << "PlayerRecord." << name << " read " << read(kPlayer, &player, name.c_str()) << " expected "
+                      << value << "\n";
+            return 1;
+        }
+    }
+
+    ClubRecord club{};
+    club.kit[1].shirt_primary_color_g = 6;
+    club.kit[1].shirt_secondary_color_r = 11;
+    club.kit[1].socks_color_b = 13;
+    club.timetable.week[2].day[1].meta.type.type = 19;
+    club.timetable.week[2].day[1].meta.type.game = 6;
+    if (read(kKit, &club.kit[1], "shirt_primary_color_g") != 6 ||
+        read(kKit, &club.kit[1], "shirt_secondary_color_r") != 11 || read(kKit, &club.kit[1], "socks_color_b") != 13 ||
+        read(kTimetableDay, &club.timetable.week[2].day[1], "type") != 19 ||
+        read(kTimetableDay, &club.timetable.week[2].day[1], "game") != 6) {
+        std::cerr << "kit or timetable bitfields do not match the compiler's layout\n";
+        return 1;
+    }
+
+    auto game = std::make_unique<gamea>();
+    std::memset(game.get(), 0, sizeof(gamea));
+    auto &manager = game->manager[1];
+    manager.stadium.flood_lights.level = 5;
+    manager.stadium.flood_lights.time = 300000;
+    manager.stadium.capacity[2].seating = 20000;
+    manager.stadium.capacity[2].terraces = 1;
+    manager.employee[4].type = 3;
+    manager.employee[4].age = 14;
+    manager.scout[2].division = 4;
+    manager.scout[2].foot = 17;
+    game->referee[7].age = 29;
+    if (read(kFacility, &manager.stadium.flood_lights, "level") != 5 ||
+        read(kFacility, &manager.stadium.flood_lights, "time") != 300000 ||
+        read(kCapacity, &manager.stadium.capacity[2], "seating") != 20000 ||
+        read(kCapacity, &manager.stadium.capacity[2], "terraces") != 1 ||
+        read(kEmployee, &manager.employee[4], "type") != 3 || read(kEmployee, &manager.employee[4], "age") != 14 ||
+        read(kScout, &manager.scout[2], "division") != 4 || read(kScout, &manager.scout[2], "foot") != 17 ||
+        read(kReferee, &game->referee[7], "age") != 29) {
+        std::cerr << "manager or referee bitfields do not match the compiler's layout\n";
+        return 1;
+    }
+
+    // Writes touch only their own bits, and signed fields sign-extend.
+    const Field *age = find(kPlayer, "age");
+    writeValue(*age, reinterpret_cast<uint8_t *>(&player) + age->offset, 20);
+    if (player.age != 20 || player.ins != 2) {
+        std::cerr << "writeValue should replace only the age bits\n";
+        return 1;
+    }
+    game->club_index.leagues.division_two[3] = -1;
+    const Field *divisionTwo = find(kClubIndexLeagues, "division_two");
+    const auto *slots = reinterpret_cast<const uint8_t *>(&game->club_index) + divisionTwo->offset;
+    if (readValue(*divisionTwo, slots + 3 * divisionTwo->width) != -1 || !inRange(*divisionTwo, -1) ||
+        !inRange(*divisionTwo, kClubIdxMax - 1) || inRange(*divisionTwo, kClubIdxMax)) {
+        std::cerr << "club index fields should read signed and accept -1..243\n";
+        return 1;
+    }
+
+    // visit() reaches every element with its full path.
+    manager.news[3].amount = -5000;
+    std::size_t leaves = 0;
+    std::size_t visitedBytes = 0;
+    int64_t newsAmount = 0;
+    std::ptrdiff_t newsOffset = -1;
+    visit(kGameA, game.get(), [&](const std::string &path, const Field &field, const uint8_t *element) {
+        ++leaves;
+        visitedBytes += field.kind == Kind::Bits && field.shift != 0 ? 0 : field.width;
+        if (path == "manager[1].news[3].amount") {
+            newsAmount = readValue(field, element);
+            newsOffset = element - reinterpret_cast<const uint8_t *>(game.get());
+        }
+    });
+    if (newsAmount != -5000 ||
+        newsOffset != static_cast<std::ptrdiff_t>(offsetof(gamea, manager[1].news[3].amount))) {
+        std::cerr << "visit should resolve manager[1].news[3].amount\n";
+        return 1;
+    }
+    if (visitedBytes != sizeof(gamea) || leaves < 5000) {
+        std::cerr << "visit covered " << visitedBytes << " bytes in " << leaves << " leaves\n";
+        return 1;
+    }
+
+    std::size_t clubLeaves = 0;
+    bool sawLastSlot = false;
+    auto clubs = std::make_unique<gameb>();
+    visit(kGameB, clubs.get(), [&](const std::string &path, const Field &, const uint8_t *) {
+        ++clubLeaves;
+        sawLastSlot |= path == "club[243].player_index[23]";
+    });
+    if (!sawLastSlot || clubLeaves % kClubIdxMax != 0) {
+        std::cerr << "gameb visit should end at club[243] and give every club the same fields\n";
+        return 1;
+    }
+    return 0;
+}
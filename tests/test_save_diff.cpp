@@ -0,0 +1,94 @@
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "pm3_defs.hh"
+#include "pm3_schema.h"
+#include "save_diff.h"
+
+namespace {
+
+const save_diff::Change *find(const std::vector<save_diff::Change> &changes, const std::string &path) {
+    for (const auto &change : changes) {
+        if (change.path == path) {
+            return &change;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+int main() {
+    // Ranges are exact at word boundaries and adjacent differences merge.
+    uint8_t a[40] = {};
+    uint8_t b[40] = {};
+    b[7] = 1;
+    b[8] = 1;
+    b[39] = 1;
+    auto ranges = save_diff::differingRanges(a, b, sizeof(a));
+    if (ranges.size() != 2 || ranges[0].offset != 7 || ranges[0].length != 2 || ranges[1].offset != 39 ||
+        ranges[1].length != 1) {
+        std::cerr << "differingRanges should give [7,9) and [39,40)\n";
+        return 1;
+    }
+    if (!save_diff::differingRanges(a, a, sizeof(a)).empty()) {
+        std::cerr << "identical buffers should have no ranges\n";
+        return 1;
+    }
+
+    auto clubsBefore = std::make_unique<gameb>();
+    std::memset(clubsBefore.get(), 0, sizeof(gameb));
+    std::memcpy(clubsBefore->club[17].name, "ARSENAL     ", 12);
+    auto clubsAfter = std::make_unique<gameb>(*clubsBefore);
+    clubsAfter->club[17].bank_account = 250000;
+    clubsAfter->club[17].player_index[3] = 2011;
+    auto changes = save_diff::diff(pm3_schema::kGameB, clubsBefore.get(), clubsAfter.get());
+    const auto *bank = find(changes, "club[17].bank_account");
+    const auto *slot = find(changes, "club[17].player_index[3]");
+    if (changes.size() != 2 || !bank || bank->before != 0 || bank->after != 250000 || !slot || slot->after != 2011) {
+        std::cerr << "gameb diff should report club[17].bank_account and player_index[3] only\n";
+        return 1;
+    }
+    auto groups = save_diff::group(changes, pm3_schema::kGameB, clubsAfter.get());
+    if (groups.size() != 1 || groups[0].name != "club[17]" || groups[0].label != "ARSENAL" ||
+        groups[0].changes[0].path != "bank_account") {
+        std::cerr << "club changes should group under club[17] ARSENAL\n";
+        return 1;
+    }
+
+    // A bitfield change names only the bits that moved, not the rest of the unit.
+    auto playersBefore = std::make_unique<gamec>();
+    std::memset(playersBefore.get(), 0, sizeof(gamec));
+    playersBefore->player[2011].aggr = 6;
+    playersBefore->player[2011].morl = 3;
+    auto playersAfter = std::make_unique<gamec>(*playersBefore);
+    playersAfter->player[2011].morl = 8;
+    std::memcpy(playersAfter->player[2011].name, "J.SMITH", 7);
+    changes = save_diff::diff(pm3_schema::kGameC, playersBefore.get(), playersAfter.get());
+    const auto *morale = find(changes, "player[2011].morl");
+    const auto *name = find(changes, "player[2011].name");
+    if (changes.size() != 2 || !morale || morale->before != 3 || morale->after != 8 || !name ||
+        name->beforeText != "" || name->afterText != "J.SMITH") {
+        std::cerr << "gamec diff should report player[2011].name and morl only\n";
+        return 1;
+    }
+    groups = save_diff::group(changes, pm3_schema::kGameC, playersAfter.get());
+    if (groups.size() != 1 || groups[0].label != "J.SMITH" || groups[0].changes.size() != 2) {
+        std::cerr << "player changes should group under player[2011] J.SMITH\n";
+        return 1;
+    }
+
+    // A scalar at the top level forms its own group with an empty relative path.
+    auto gameBefore = std::make_unique<gamea>();
+    std::memset(gameBefore.get(), 0, sizeof(gamea));
+    auto gameAfter = std::make_unique<gamea>(*gameBefore);
+    gameAfter->manager[1].news[3].amount = -5000;
+    changes = save_diff::diff(pm3_schema::kGameA, gameBefore.get(), gameAfter.get());
+    if (changes.size() != 1 || changes[0].path != "manager[1].news[3].amount" || changes[0].after != -5000) {
+        std::cerr << "gamea diff should report manager[1].news[3].amount\n";
+        return 1;
+    }
+    return 0;
+}
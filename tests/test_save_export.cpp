@@ -0,0 +1,153 @@
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "pm3_data.h"
+#include "pm3_schema.h"
+#include "save_export.h"
+
+namespace {
+
+std::string readText(const std::filesystem::path &path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+std::string line(const std::string &text, std::size_t n) {
+    std::size_t start = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        start = text.find('\n', start) + 1;
+    }
+    return text.substr(start, text.find('\n', start) - start);
+}
+
+template <typename T>
+T readLe(const std::string &bytes, std::size_t offset) {
+    T value{};
+    std::memcpy(&value, bytes.data() + offset, sizeof(T));
+    return value;
+}
+
+} // namespace
+
+int main() {
+    namespace fs = std::filesystem;
+
+    fs::path root = fs::temp_directory_path() / "pm3000_test_save_export";
+    fs::remove_all(root);
+
+    auto state = std::make_unique<GameState>();
+    std::memset(&state->game, 0, sizeof(gamea));
+    std::memset(&state->clubs, 0, sizeof(gameb));
+    std::memset(&state->players, 0, sizeof(gamec));
+    for (auto &club : state->clubs.club) {
+        for (std::size_t i = 0; i < std::size(club.player_index); ++i) {
+            club.player_index[i] = -1;
+        }
+    }
+    for (auto &entry : state->game.table.all) {
+        entry.club_idx = -1;
+    }
+    for (auto &entry : state->game.top_scorers.all) {
+        entry.player_idx = -1;
+    }
+    ClubRecord &club = state->club(7);
+    std::memcpy(club.name, "Leeds, Utd      ", sizeof(club.name));
+    club.bank_account = 250000;
+    club.league = divisionHex[1];
+    club.player_index[0] = 42;
+    PlayerRecord &player = state->player(42);
+    std::memcpy(player.name, "A \"QUOTE\"   ", sizeof(player.name));
+    player.hn = 77;
+    // morl and aggr share a byte, as do ins and age.
+    auto *playerBytes = reinterpret_cast<uint8_t *>(&state->players);
+    pm3_schema::Location morl = *pm3_schema::lookup(pm3_schema::kGameC, "player[42].morl");
+    pm3_schema::writeValue(*morl.field, playerBytes + morl.offset, 9);
+    pm3_schema::Location age = *pm3_schema::lookup(pm3_schema::kGameC, "player[42].age");
+    pm3_schema::writeValue(*age.field, playerBytes + age.offset, 23);
+    // PM3 keeps table rows in its own order; the export ranks them by points, goal difference and goals scored.
+    std::memcpy(state->club(9).name, "Hull City       ", sizeof(club.name));
+    state->game.table.leagues.division_one[0].club_idx = 7;
+    state->game.table.leagues.division_one[1].club_idx = 9;
+    state->game.table.leagues.division_one[1].hw = 1;
+    state->game.top_scorers.leagues.division_one[0].player_idx = 42;
+    state->game.top_scorers.leagues.division_one[0].club_idx = 7;
+    state->game.top_scorers.leagues.division_one[0].sc = 19;
+
+    // CSV: every player and club gets a row, bitfields are split and names resolved and quoted.
+    save_export::Summary summary = save_export::exportGame(*state, root / "csv", save_export::Format::Csv);
+    std::string players = readText(root / "csv" / "players.csv");
+    std::string header = line(players, 0);
+    if (summary.tables != 6 || header.find(",morl,aggr,ins,age,") == std::string::npos ||
+        header.rfind("idx,club_idx,club,name,", 0) != 0) {
+        std::cerr << "unexpected players header: " << header << "\n";
+        return 1;
+    }
+    std::string row = line(players, 43);
+    if (row.rfind("42,7,\"Leeds, Utd\",\"A \"\"QUOTE\"\"\",", 0) != 0 || row.find(",9,0,0,23,") == std::string::npos) {
+        std::cerr << "unexpected player row: " << row << "\n";
+        return 1;
+    }
+    std::size_t rows = 0;
+    for (char c : players) {
+        rows += c == '\n' ? 1 : 0;
+    }
+    if (rows != static_cast<std::size_t>(pm3_schema::kPlayerCount) + 1) {
+        std::cerr << "expected a row per player, got " << rows - 1 << "\n";
+        return 1;
+    }
+    std::string table = readText(root / "csv" / "league_table.csv");
+    std::string scorers = readText(root / "csv" / "top_scorers.csv");
+    if (line(table, 1).rfind("Division One,1,Hull City,9,", 0) != 0 ||
+        line(table, 2).rfind("Division One,2,\"Leeds, Utd\",7,", 0) != 0 ||
+        line(scorers, 1).rfind("Division One,1,\"A \"\"QUOTE\"\"\",\"Leeds, Utd\",42,7,", 0) != 0 ||
+        !line(table, 3).empty()) {
+        std::cerr << "unexpected league table or scorers:\n" << table << scorers;
+        return 1;
+    }
+
+    // JSON Lines: one object per row with escaped strings.
+    save_export::exportGame(*state, root / "jsonl", save_export::Format::JsonLines);
+    std::string clubs = readText(root / "jsonl" / "clubs.jsonl");
+    std::string clubRow = line(clubs, 7);
+    if (clubRow.rfind("{\"idx\":7,\"division\":\"Division One\",\"squad_size\":1,\"name\":\"Leeds, Utd\",", 0) != 0 ||
+        clubRow.find("\"bank_account\":250000") == std::string::npos || clubRow.back() != '}') {
+        std::cerr << "unexpected club object: " << clubRow << "\n";
+        return 1;
+    }
+
+    // Columns: the header names each column, and a column is one contiguous array.
+    save_export::exportGame(*state, root / "columns", save_export::Format::Columns);
+    std::string bytes = readText(root / "columns" / "players.pm3c");
+    if (bytes.compare(0, 8, "PM3COLS1") != 0 || readLe<uint32_t>(bytes, 8) != pm3_schema::kPlayerCount) {
+        std::cerr << "bad columns header\n";
+        return 1;
+    }
+    uint16_t columns = readLe<uint16_t>(bytes, 12);
+    std::size_t pos = 14;
+    std::size_t data = 0;
+    std::size_t hnOffset = 0;
+    std::size_t dataSize = 0;
+    for (uint16_t i = 0; i < columns; ++i) {
+        uint16_t width = readLe<uint16_t>(bytes, pos + 1);
+        std::string name = bytes.substr(pos + 4, static_cast<uint8_t>(bytes[pos + 3]));
+        pos += 4 + name.size();
+        if (name == "hn") {
+            hnOffset = dataSize;
+        }
+        dataSize += std::size_t{width} * pm3_schema::kPlayerCount;
+    }
+    data = pos;
+    if (bytes.size() != data + dataSize || readLe<int64_t>(bytes, data + hnOffset + 42 * 8) != 77) {
+        std::cerr << "the hn column does not hold the player's value\n";
+        return 1;
+    }
+
+    fs::remove_all(root);
+    return 0;
+}
@@ -0,0 +1,184 @@
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+#include "save_journal.h"
+
+namespace {
+
+std::string readAll(const std::filesystem::path &path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+void writeAll(const std::filesystem::path &path, const std::string &text) {
+    std::ofstream out(path, std::ios::binary);
+    out << text;
+}
+
+bool hasTempFiles(const std::filesystem::path &dir) {
+    for (const auto &entry : std::filesystem::directory_iterator(dir)) {
+        if (entry.path().extension() == save_journal::kTempSuffix) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+int main() {
+    namespace fs = std::filesystem;
+    fs::path dir = fs::temp_directory_path() / "pm3000_test_save_journal";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    writeAll(dir / "GAME1A", "old-a");
+    writeAll(dir / "SAVES.DIR", "old-dir");
+
+    // A normal commit replaces every file and leaves nothing behind.
+    {
+        save_journal::Transaction transaction(dir);
+        transaction.replace("GAME1A", "new-a", 5);
+        transaction.replace("SAVES.DIR", "new-dir", 7);
+        transaction.commit();
+    }
+    if (readAll(dir / "GAME1A") != "new-a" || readAll(dir / "SAVES.DIR") != "new-dir") {
+        std::cerr << "commit did not replace files\n";
+        return 1;
+    }
+    if (fs::exists(dir / save_journal::kJournalFile) || hasTempFiles(dir)) {
+        std::cerr << "commit left journal or temp files behind\n";
+        return 1;
+    }
+    if (save_journal::recover(dir) != save_journal::Recovery::Clean) {
+        std::cerr << "clean directory should not need recovery\n";
+        return 1;
+    }
+
+    // Crash after the journal is written: recovery must finish the commit.
+    {
+        save_journal::Transaction transaction(dir);
+        transaction.replace("GAME1A", "rolled-a", 8);
+        transaction.replace("SAVES.DIR", "rolled-dir", 10);
+        transaction.prepare();
+    }
+    if (readAll(dir / "GAME1A") != "new-a") {
+        std::cerr << "prepare should not touch the live files\n";
+        return 1;
+    }
+    if (save_journal::recover(dir) != save_journal::Recovery::RolledForward) {
+        std::cerr << "decided journal should roll forward\n";
+        return 1;
+    }
+    if (readAll(dir / "GAME1A") != "rolled-a" || readAll(dir / "SAVES.DIR") != "rolled-dir" ||
+        fs::exists(dir / save_journal::kJournalFile) || hasTempFiles(dir)) {
+        std::cerr << "roll forward left an inconsistent directory\n";
+        return 1;
+    }
+
+    // Crash before the journal is written: the half-written temps are discarded.
+    writeAll(dir / (std::string("GAME1A") + save_journal::kTempSuffix), "torn");
+    if (save_journal::recover(dir) != save_journal::Recovery::RolledBack) {
+        std::cerr << "stray temp files should roll back\n";
+        return 1;
+    }
+    if (readAll(dir / "GAME1A") != "rolled-a" || hasTempFiles(dir)) {
+        std::cerr << "roll back changed live files or kept temps\n";
+        return 1;
+    }
+
+    // A torn journal is treated as undecided.
+    writeAll(dir / (std::string("GAME1A") + save_journal::kTempSuffix), "torn");
+    writeAll(dir / save_journal::kJournalFile, "PM3000-JOURNAL 1\nR GAME1A\n");
+    if (save_journal::recover(dir) != save_journal::Recovery::RolledBack || readAll(dir / "GAME1A") != "rolled-a") {
+        std::cerr << "incomplete journal should roll back\n";
+        return 1;
+    }
+
+    // Patches are staged and replayed from the temp file if the crash happens after the journal.
+    {
+        save_journal::Transaction transaction(dir);
+        transaction.patch("GAME1A", 0, "R", 1);
+        transaction.patch("GAME1A", 7, "!", 1);
+        transaction.prepare();
+    }
+    if (readAll(dir / "GAME1A") != "rolled-a") {
+        std::cerr << "prepare should not patch the live file\n";
+        return 1;
+    }
+    if (save_journal::recover(dir) != save_journal::Recovery::RolledForward || readAll(dir / "GAME1A") != "Rolled-!" ||
+        hasTempFiles(dir)) {
+        std::cerr << "patch roll forward failed\n";
+        return 1;
+    }
+
+    {
+        save_journal::Transaction transaction(dir);
+        transaction.patch("GAME1A", 1, "OLLED", 5);
+        transaction.commit();
+    }
+    if (readAll(dir / "GAME1A") != "ROLLED-!") {
+        std::cerr << "patch commit failed\n";
+        return 1;
+    }
+
+    // Copies and removals are journalled too: a swap through copies plus a removal rolls forward as one.
+    writeAll(dir / "GAME2A", "game-two");
+    {
+        save_journal::Transaction transaction(dir);
+        transaction.replaceWithCopy("GAME2A", dir / "GAME1A");
+        transaction.replaceWithCopy("GAME1A", dir / "GAME2A");
+        transaction.remove("SAVES.DIR");
+        transaction.prepare();
+    }
+    if (readAll(dir / "GAME2A") != "game-two" || !fs::exists(dir / "SAVES.DIR")) {
+        std::cerr << "prepare should not copy over or remove live files\n";
+        return 1;
+    }
+    if (save_journal::recover(dir) != save_journal::Recovery::RolledForward || readAll(dir / "GAME1A") != "game-two" ||
+        readAll(dir / "GAME2A") != "ROLLED-!" || fs::exists(dir / "SAVES.DIR") || hasTempFiles(dir)) {
+        std::cerr << "copy and remove roll forward failed\n";
+        return 1;
+    }
+
+    // Sidecars one directory down commit with the slot files, and their torn temps are discarded.
+    fs::create_directories(dir / "PM3000");
+    writeAll(dir / "PM3000" / "GAME1.HST", "history-one");
+    {
+        save_journal::Transaction transaction(dir);
+        transaction.replaceWithCopy("PM3000/GAME2.HST", dir / "PM3000" / "GAME1.HST");
+        transaction.remove("PM3000/GAME1.HST");
+        transaction.prepare();
+    }
+    if (save_journal::recover(dir) != save_journal::Recovery::RolledForward ||
+        readAll(dir / "PM3000" / "GAME2.HST") != "history-one" || fs::exists(dir / "PM3000" / "GAME1.HST") ||
+        hasTempFiles(dir / "PM3000")) {
+        std::cerr << "a sidecar in a subdirectory should roll forward\n";
+        return 1;
+    }
+    writeAll(dir / "PM3000" / (std::string("GAME2.HST") + save_journal::kTempSuffix), "torn");
+    if (save_journal::recover(dir) != save_journal::Recovery::RolledBack || hasTempFiles(dir / "PM3000") ||
+        readAll(dir / "PM3000" / "GAME2.HST") != "history-one") {
+        std::cerr << "a torn sidecar temp should roll back\n";
+        return 1;
+    }
+
+    writeAll(dir / "COPY", "");
+    save_journal::copyFileDurably(dir / "GAME1A", dir / "COPY");
+    if (readAll(dir / "COPY") != "game-two") {
+        std::cerr << "copyFileDurably should replace the target\n";
+        return 1;
+    }
+
+    save_journal::replaceFileDurably(dir / "COPY", "replaced", 8);
+    if (readAll(dir / "COPY") != "replaced" || hasTempFiles(dir)) {
+        std::cerr << "replaceFileDurably should replace the file and leave no temp\n";
+        return 1;
+    }
+
+    fs::remove_all(dir);
+    return 0;
+}
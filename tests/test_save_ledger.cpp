@@ -0,0 +1,152 @@
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include "pm3_data.h"
+#include "save_ledger.h"
+
+namespace {
+
+// A loan as the Scout screen makes it.
+void loan(GameState &state, int16_t playerIdx, int ownerIdx, int borrowerIdx, int weeks) {
+    state.setSquadSlot(ownerIdx, 0, -1);
+    state.setSquadSlot(borrowerIdx, 1, playerIdx);
+    state.player(playerIdx).period = static_cast<uint8_t>(weeks * save_ledger::kTurnsPerWeek);
+    state.player(playerIdx).period_type = save_ledger::kLoanPeriodType;
+    save_ledger::recordLoan(state, playerIdx, ownerIdx, borrowerIdx, weeks * 100, weeks);
+}
+
+} // namespace
+
+int main() {
+    namespace fs = std::filesystem;
+
+    fs::path root = fs::temp_directory_path() / "pm3000_test_save_ledger";
+    fs::remove_all(root);
+    fs::path ledger = save_ledger::ledgerPath(root / "PM3000", 3);
+
+    auto state = std::make_unique<GameState>();
+    std::memset(&state->game, 0, sizeof(gamea));
+    std::memset(&state->clubs, 0, sizeof(gameb));
+    std::memset(&state->players, 0, sizeof(gamec));
+    for (auto &club : state->clubs.club) {
+        for (std::size_t i = 0; i < std::size(club.player_index); ++i) {
+            club.player_index[i] = -1;
+        }
+    }
+    state->game.year = 1996;
+    state->game.turn = 12;
+    std::memcpy(state->player(42).name, "A. LOANEE   ", sizeof(PlayerRecord::name));
+    state->club(5).player_index[0] = 42;
+
+    if (save_ledger::open(ledger, 3, *state, false) != 0 || !save_ledger::entries().empty() || !fs::exists(ledger)) {
+        std::cerr << "a new slot should start an empty ledger\n";
+        return 1;
+    }
+
+    // Each action is one entry, dated and indexed by player and club.
+    save_ledger::recordTransfer(*state, 7, 10, 11, 250000);
+    loan(*state, 42, 5, 11, 4);
+    save_ledger::recordCoachConversion(*state, 9, 11, 95);
+    // Actions on another GameState, e.g. a copy of the slot, are not this slot's history.
+    auto copy = std::make_unique<GameState>(*state);
+    save_ledger::recordTransfer(*copy, 8, 10, 11, 1000);
+    if (save_ledger::entries().size() != 3 || !save_ledger::playerHistory(8).empty() ||
+        save_ledger::reconcile(*copy) != 0) {
+        std::cerr << "only the opened state should be recorded\n";
+        return 1;
+    }
+    const save_ledger::Entry *active = save_ledger::activeLoan(42);
+    if (active == nullptr || active->fromClubIdx != 5 || active->toClubIdx != 11 || active->weeks != 4 ||
+        active->year != 1996 || active->turn != 12 || std::memcmp(active->playerName, "A. LOANEE", 9) != 0) {
+        std::cerr << "the loan should be active with its owner and length\n";
+        return 1;
+    }
+    if (save_ledger::clubHistory(11).size() != 3 || save_ledger::playerHistory(7).size() != 1 ||
+        save_ledger::clubHistory(95).front()->kind != save_ledger::Kind::CoachConversion) {
+        std::cerr << "entries should be found by club and player\n";
+        return 1;
+    }
+
+    // Entries made after the last save are dropped with the unsaved edits, unless the edits came back.
+    save_ledger::markSaved(ledger, 3);
+    save_ledger::recordTransfer(*state, 8, 10, 11, 1000);
+    if (save_ledger::open(ledger, 3, *state, true) != 0 || save_ledger::entries().size() != 4) {
+        std::cerr << "recovered edits should keep their entries\n";
+        return 1;
+    }
+    if (save_ledger::open(ledger, 3, *state, false) != 0 || save_ledger::entries().size() != 3 ||
+        !save_ledger::playerHistory(8).empty() || save_ledger::activeLoan(42) == nullptr) {
+        std::cerr << "a reload should drop what was never saved\n";
+        return 1;
+    }
+
+    // A torn record is cut off.
+    auto intactSize = fs::file_size(ledger);
+    {
+        std::ofstream out(ledger, std::ios::binary | std::ios::app);
+        out.write("T\x00\xcc\x07", 4);
+    }
+    if (save_ledger::open(ledger, 3, *state, true) != 0 || save_ledger::entries().size() != 3 ||
+        fs::file_size(ledger) != intactSize) {
+        std::cerr << "a torn record should be dropped\n";
+        return 1;
+    }
+
+    // The save wins over the ledger: a loan it no longer shows ends, one it shows without an entry is added.
+    state->setSquadSlot(11, 1, -1);
+    state->setSquadSlot(20, 3, 42);
+    state->setSquadSlot(30, 0, 100);
+    state->player(100).period = 5;
+    state->player(100).period_type = save_ledger::kLoanPeriodType;
+    if (save_ledger::open(ledger, 3, *state, false) != 2 || save_ledger::activeLoan(42) != nullptr) {
+        std::cerr << "reconciling should end the loan and adopt the other\n";
+        return 1;
+    }
+    const save_ledger::Entry &ended = *save_ledger::playerHistory(42).back();
+    const save_ledger::Entry *adopted = save_ledger::activeLoan(100);
+    if (ended.kind != save_ledger::Kind::LoanEnded || ended.loanEnd != save_ledger::LoanEnd::Moved ||
+        adopted == nullptr || adopted->fromClubIdx != -1 || adopted->toClubIdx != 30 || adopted->weeks != 2) {
+        std::cerr << "unexpected reconciled entries\n";
+        return 1;
+    }
+    state->player(100).period_type = 0;
+    if (save_ledger::reconcile(*state) != 1 ||
+        save_ledger::playerHistory(100).back()->loanEnd != save_ledger::LoanEnd::Expired) {
+        std::cerr << "a loan the save no longer marks should expire\n";
+        return 1;
+    }
+
+    // Saving into another slot takes the ledger along; a ledger for another slot is not read.
+    fs::path other = save_ledger::ledgerPath(root / "PM3000", 4);
+    save_ledger::markSaved(other, 4);
+    if (save_ledger::open(other, 4, *state, false) != 0 || save_ledger::entries().size() != 6) {
+        std::cerr << "the copied ledger should hold every entry\n";
+        return 1;
+    }
+    // Slot management renumbers a ledger it copies or moves, so it is read in its new slot.
+    fs::path moved = save_ledger::ledgerPath(root / "PM3000", 5);
+    std::ifstream in(other, std::ios::binary);
+    std::vector<uint8_t> bytes{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    bool renumbered = save_ledger::renumber(bytes, 5);
+    std::ofstream(moved, std::ios::binary).write(reinterpret_cast<const char *>(bytes.data()),
+                                                 static_cast<std::streamsize>(bytes.size()));
+    std::vector<uint8_t> notALedger(bytes.begin(), bytes.begin() + 4);
+    if (!renumbered || save_ledger::open(moved, 5, *state, false) != 0 || save_ledger::entries().size() != 6 ||
+        save_ledger::renumber(notALedger, 5)) {
+        std::cerr << "a renumbered ledger should open in its new slot\n";
+        return 1;
+    }
+    state->player(42).period_type = 0;
+    if (save_ledger::open(other, 3, *state, false) != 0 || !save_ledger::entries().empty()) {
+        std::cerr << "a ledger for another slot must be ignored\n";
+        return 1;
+    }
+
+    fs::remove_all(root);
+    return 0;
+}
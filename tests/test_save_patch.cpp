@@ -0,0 +1,106 @@
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "pm3_defs.hh"
+#include "save_patch.h"
+
+int main() {
+    auto before = std::make_unique<gameb>();
+    auto after = std::make_unique<gameb>();
+    auto players = std::make_unique<gamec>();
+    auto playersAfter = std::make_unique<gamec>();
+    std::memset(before.get(), 0, sizeof(gameb));
+    std::memset(players.get(), 0, sizeof(gamec));
+    before->club[17].bank_account = 1000;
+    *after = *before;
+    *playersAfter = *players;
+    after->club[17].bank_account = 250000;
+    // HN and TK are one byte apart, so they travel as one hunk.
+    playersAfter->player[100].hn = 90;
+    playersAfter->player[100].tk = 85;
+    std::memcpy(playersAfter->player[2000].name, "NEW NAME    ", 12);
+
+    save_patch::Patch patch;
+    save_patch::append(patch, 1, before.get(), after.get());
+    save_patch::append(patch, 2, players.get(), playersAfter.get());
+    if (patch.hunks.size() != 3 || save_patch::describe(patch.hunks[0]) != "club[17]+32" ||
+        save_patch::describe(patch.hunks[1]) != "player[100]+13" || patch.hunks[1].after.size() != 3 ||
+        save_patch::describe(patch.hunks[2]) != "player[2000]") {
+        std::cerr << "unexpected hunks:";
+        for (const auto &hunk : patch.hunks) {
+            std::cerr << " " << save_patch::describe(hunk);
+        }
+        std::cerr << "\n";
+        return 1;
+    }
+
+    // The encoding round-trips and stays small; any damage is caught.
+    std::vector<uint8_t> bytes = save_patch::encode(patch);
+    if (bytes.size() > 128) {
+        std::cerr << "a three-hunk patch should be tiny, got " << bytes.size() << " bytes\n";
+        return 1;
+    }
+    save_patch::Patch decoded;
+    std::string error;
+    if (!save_patch::decode(bytes.data(), bytes.size(), decoded, error) || decoded.hunks.size() != 3 ||
+        decoded.hunks[2].after != patch.hunks[2].after) {
+        std::cerr << "decode failed: " << error << "\n";
+        return 1;
+    }
+    std::vector<uint8_t> damaged = bytes;
+    damaged[20] ^= 1;
+    if (save_patch::decode(damaged.data(), damaged.size(), decoded, error) ||
+        save_patch::decode(bytes.data(), bytes.size() - 5, decoded, error)) {
+        std::cerr << "damaged or truncated patches must be rejected\n";
+        return 1;
+    }
+
+    // Applying gives the new copy and reports the written bytes as merged spans.
+    auto target = std::make_unique<gameb>(*before);
+    auto targetPlayers = std::make_unique<gamec>(*players);
+    void *const files[save_patch::kFileCount] = {nullptr, target.get(), targetPlayers.get()};
+    save_patch::Outcome outcome = save_patch::apply(patch, files);
+    if (outcome.applied != 3 || !outcome.conflicts.empty() ||
+        std::memcmp(target.get(), after.get(), sizeof(gameb)) != 0 ||
+        std::memcmp(targetPlayers.get(), playersAfter.get(), sizeof(gamec)) != 0) {
+        std::cerr << "apply should reproduce the new copy\n";
+        return 1;
+    }
+    if (outcome.spans[1].size() != 1 || outcome.spans[1][0].length != 3 || outcome.spans[2].size() != 2) {
+        std::cerr << "unexpected spans\n";
+        return 1;
+    }
+
+    // Applying twice is harmless.
+    outcome = save_patch::apply(patch, files);
+    if (outcome.applied != 0 || outcome.alreadyApplied != 3 || !outcome.conflicts.empty()) {
+        std::cerr << "a patch applied twice should find everything already applied\n";
+        return 1;
+    }
+
+    // A second mod built on top of the first stacks; one that disagrees about a field is refused as a whole.
+    auto stacked = std::make_unique<gamec>(*playersAfter);
+    stacked->player[100].hn = 99;
+    save_patch::Patch second;
+    save_patch::append(second, 2, playersAfter.get(), stacked.get());
+    outcome = save_patch::apply(second, files);
+    if (outcome.applied != 1 || targetPlayers->player[100].hn != 99) {
+        std::cerr << "a patch made on top of another should apply after it\n";
+        return 1;
+    }
+    auto rival = std::make_unique<gamec>(*players);
+    rival->player[100].hn = 50;
+    rival->player[3].sh = 40;
+    save_patch::Patch third;
+    save_patch::append(third, 2, players.get(), rival.get());
+    outcome = save_patch::apply(third, files);
+    if (outcome.conflicts.size() != 1 || outcome.conflicts[0] != "GAMEnC player[100]+13" ||
+        outcome.applied != 0 || targetPlayers->player[3].sh != 0) {
+        std::cerr << "a conflicting patch must not be applied in part\n";
+        return 1;
+    }
+    return 0;
+}
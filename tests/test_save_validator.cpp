@@ -0,0 +1,150 @@
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "pm3_codec.h"
+#include "pm3_data.h"
+#include "pm3_schema.h"
+#include "save_validator.h"
+
+namespace {
+
+constexpr int kPlayersPerSquad = 16;
+
+struct Save {
+    std::unique_ptr<gamea> gameA = std::make_unique<gamea>();
+    std::unique_ptr<gameb> gameB = std::make_unique<gameb>();
+    std::unique_ptr<gamec> gameC = std::make_unique<gamec>();
+
+    // Every reference empty and club c owning players 16c .. 16c + 15, so the last players are free agents.
+    explicit Save(bool swapped = false) {
+        std::memset(gameA.get(), 0xFF, sizeof(gamea));
+        std::memset(gameB.get(), 0xFF, sizeof(gameb));
+        std::memset(gameC.get(), 0, sizeof(gamec));
+        for (int club = 0; club < kClubIdxMax; ++club) {
+            for (int slot = 0; slot < kPlayersPerSquad; ++slot) {
+                setSlot(club, slot, static_cast<int16_t>(club * kPlayersPerSquad + slot), swapped);
+            }
+        }
+    }
+
+    void setSlot(int club, int slot, int16_t player, bool swapped = false) {
+        int16_t stored = swapped ? pm3_codec::byteSwap16(player) : player;
+        std::memcpy(&gameB->club[club].player_index[slot], &stored, sizeof(stored));
+    }
+
+    int16_t slot(int club, int slot) const {
+        int16_t player;
+        std::memcpy(&player, &gameB->club[club].player_index[slot], sizeof(player));
+        return player;
+    }
+
+    save_validator::Report validate(const save_validator::Options &options = {}) {
+        return save_validator::validate(*gameA, *gameB, *gameC, options);
+    }
+};
+
+} // namespace
+
+int main() {
+    constexpr std::size_t kFreeAgents = pm3_schema::kPlayerCount - kClubIdxMax * kPlayersPerSquad;
+
+    Save save;
+    save_validator::Report report = save.validate();
+    if (!report.clean() || report.unassignedPlayers != kFreeAgents) {
+        std::cerr << "a consistent save should validate clean, with " << kFreeAgents << " free agents\n";
+        return 1;
+    }
+
+    // One of each problem: a squad slot past the last player, a player in two squads, a bad club in gamea.
+    save.setSlot(17, 4, 5000);
+    save.setSlot(30, 2, 3 * kPlayersPerSquad + 1);
+    save.gameA->retired_manager_club_idx = 300;
+    report = save.validate();
+    if (report.issues.size() != 3 || report.repaired != 0 || save.slot(17, 4) != 5000) {
+        std::cerr << "expected three issues and no repairs, got " << report.issues.size() << "\n";
+        return 1;
+    }
+    bool sawBadSlot = false;
+    bool sawDuplicate = false;
+    bool sawBadClub = false;
+    for (const save_validator::Issue &issue : report.issues) {
+        std::string text = save_validator::describe(issue);
+        sawBadSlot |= text == "club[17].player_index[4] = 5000 is not a player";
+        sawDuplicate |= text == "club[30].player_index[2]: player 49 is already in club 3" && issue.firstClub == 3;
+        sawBadClub |= text == "retired_manager_club_idx = 300 is not a club" && issue.file == 0;
+    }
+    if (!sawBadSlot || !sawDuplicate || !sawBadClub) {
+        for (const save_validator::Issue &issue : report.issues) {
+            std::cerr << save_validator::describe(issue) << "\n";
+        }
+        std::cerr << "issues were not located or described as expected\n";
+        return 1;
+    }
+    // Club 17 lost its slot 4 player and club 30 its own slot 2 player to the duplicate.
+    if (report.unassignedPlayers != kFreeAgents + 2) {
+        std::cerr << "the two displaced players should be unassigned\n";
+        return 1;
+    }
+
+    // Repair clears the bad references and the later slot of the duplicate, and nothing else.
+    report = save.validate({true});
+    if (report.repaired != 3 || save.slot(17, 4) != -1 || save.slot(30, 2) != -1 ||
+        save.slot(3, 1) != 3 * kPlayersPerSquad + 1 || save.gameA->retired_manager_club_idx != -1) {
+        std::cerr << "repair should reset exactly the flagged values to -1\n";
+        return 1;
+    }
+    if (!save.validate().clean()) {
+        std::cerr << "a repaired save should validate clean\n";
+        return 1;
+    }
+
+    // References whose meaning is unconfirmed are reported but never repaired: their bytes stay as loaded.
+    gamea::ManagerRecord &manager = save.gameA->manager[0];
+    manager.player3_idx = 9000;
+    manager.scout[0].results[0].ix1 = 30000;
+    manager.match_summary.club[0].lineup[0].player_idx = -2;
+    auto before = std::make_unique<gamea>(*save.gameA);
+    report = save.validate({true});
+    if (report.issues.size() != 3 || report.repaired != 0 ||
+        std::memcmp(before.get(), save.gameA.get(), sizeof(gamea)) != 0) {
+        std::cerr << "unconfirmed references should be reported and left as they are, got "
+                  << report.issues.size() << " issues and " << report.repaired << " repairs\n";
+        return 1;
+    }
+    std::memset(&manager, 0xFF, sizeof(manager));
+
+    // Manager records can be left out, as the SWOS import does.
+    save.gameA->manager[1].club_idx = 400;
+    save_validator::Options skipManagers;
+    skipManagers.skipManagers = true;
+    if (save.validate().issues.size() != 1 || !save.validate(skipManagers).clean()) {
+        std::cerr << "skipManagers should ignore only the manager records\n";
+        return 1;
+    }
+
+    // Byte-swapped squads, as in base data halfway through the import, are decoded before checking.
+    Save swapped(true);
+    save_validator::Options swappedSquads;
+    swappedSquads.swappedSquads = true;
+    report = swapped.validate(swappedSquads);
+    if (!report.clean() || report.unassignedPlayers != kFreeAgents) {
+        std::cerr << "swapped squads should validate clean when decoded\n";
+        return 1;
+    }
+    swapped.setSlot(9, 0, 0, true);
+    report = swapped.validate(swappedSquads);
+    if (report.issues.size() != 1 || report.issues[0].kind != save_validator::IssueKind::DuplicatePlayer ||
+        report.issues[0].value != 0 || report.issues[0].firstClub != 0) {
+        std::cerr << "a duplicate in swapped squads was not found\n";
+        return 1;
+    }
+    if (swapped.validate().clean()) {
+        std::cerr << "swapped squads read natively should be out of range\n";
+        return 1;
+    }
+
+    std::cout << "save_validator tests passed\n";
+    return 0;
+}
@@ -0,0 +1,119 @@
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "dirty_tracker.h"
+#include "io.h"
+#include "pm3_data.h"
+#include "save_watcher.h"
+#include "test_util.h"
+
+int main() {
+    namespace fs = std::filesystem;
+    using namespace std::chrono_literals;
+
+    fs::path root = fs::temp_directory_path() / "pm3000_test_save_watcher";
+    fs::remove_all(root);
+    fs::create_directories(root / std::string{kStandardSavesPath});
+    std::ofstream(root / std::string{kExeStandardFilename}).put('\0');
+
+    std::memset(&gameData, 0, sizeof(gameData));
+    std::memset(&clubData, 0, sizeof(clubData));
+    std::memset(&playerData, 0, sizeof(playerData));
+    writeStruct(io::constructSaveFilePath(root, 1, 'A'), gameData);
+    writeStruct(io::constructSaveFilePath(root, 1, 'B'), clubData);
+    writeStruct(io::constructSaveFilePath(root, 1, 'C'), playerData);
+
+    Settings settings;
+    settings.gamePath = root;
+    char footer[70]{};
+    if (!io::loadGame(settings, 1, footer, sizeof(footer))) {
+        std::cerr << "loadGame failed: " << footer << "\n";
+        return 1;
+    }
+
+    io::SaveWatcher watcher;
+    if (!watcher.watch(root, 1)) {
+        std::cerr << "watcher should find the saves folder\n";
+        return 1;
+    }
+    auto t0 = io::SaveWatcher::Clock::now();
+
+    // A half-written file is never reported, however long it sits.
+    auto edited = std::make_unique<gameb>();
+    std::memcpy(edited.get(), &clubData, sizeof(gameb));
+    edited->club[3].bank_account = 123456;
+    writeStruct(io::constructSaveFilePath(root, 1, 'B'), *edited, sizeof(gameb) / 2);
+    if (watcher.poll(t0).any() || watcher.poll(t0 + 2s).any()) {
+        std::cerr << "partial write must not be reported\n";
+        return 1;
+    }
+
+    // Once complete it is reported after the quiet period, and only GAME1B.
+    writeStruct(io::constructSaveFilePath(root, 1, 'B'), *edited);
+    if (watcher.poll(t0 + 2s).any()) {
+        std::cerr << "a fresh write must settle first\n";
+        return 1;
+    }
+    io::WatchedFiles changed = watcher.poll(t0 + 4s);
+    if (changed.count() != 1 || !changed.test(io::kWatchGameB)) {
+        std::cerr << "expected only GAME1B to be reported, got " << changed << "\n";
+        return 1;
+    }
+
+    // Unsaved edits to the file hold the reload back, leaving memory and the dirty spans alone.
+    dirty_tracker::touchClub(3);
+    clubData.club[3].bank_account = 7;
+    std::string error;
+    if (io::reloadSaveFile(root, 1, 'B', defaultGameState, error) != io::Reload::HeldForEdits ||
+        clubData.club[3].bank_account != 7 || !dirty_tracker::isDirty(dirty_tracker::kGameB)) {
+        std::cerr << "GAME1B must not be reloaded over unsaved edits\n";
+        return 1;
+    }
+    dirty_tracker::clear();
+    if (io::reloadSaveFile(root, 1, 'B', defaultGameState, error) != io::Reload::Reloaded ||
+        clubData.club[3].bank_account != 123456 || dirty_tracker::isDirty(dirty_tracker::kGameB)) {
+        std::cerr << "GAME1B was not reloaded cleanly: " << error << "\n";
+        return 1;
+    }
+
+    // A rewritten file is repaired like a loaded one, and the repairs are left dirty for the next save.
+    edited->club[5].player_index[0] = 30000;
+    writeStruct(io::constructSaveFilePath(root, 1, 'B'), *edited);
+    fs::last_write_time(io::constructSaveFilePath(root, 1, 'B'),
+                        fs::last_write_time(io::constructSaveFilePath(root, 1, 'B')) + 5s);
+    if (io::reloadSaveFile(root, 1, 'B', defaultGameState, error) != io::Reload::Reloaded ||
+        clubData.club[5].player_index[0] != -1 || !dirty_tracker::isDirty(dirty_tracker::kGameB)) {
+        std::cerr << "a reloaded file should be repaired\n";
+        return 1;
+    }
+
+    // Another GameState takes the file whole; the editor's state and its dirty spans are left alone.
+    auto other = std::make_unique<GameState>();
+    if (io::reloadSaveFile(root, 1, 'B', *other, error) != io::Reload::Reloaded ||
+        other->clubs.club[3].bank_account != 123456 || other->clubs.club[5].player_index[0] != -1 ||
+        !dirty_tracker::isDirty(dirty_tracker::kGameB)) {
+        std::cerr << "GAME1B was not reloaded into a separate state: " << error << "\n";
+        return 1;
+    }
+
+    // Our own save is not picked up again as an outside change.
+    if (!io::saveGame(settings, 1, footer, sizeof(footer))) {
+        std::cerr << "saveGame failed: " << footer << "\n";
+        return 1;
+    }
+    watcher.poll(t0 + 6s);
+    changed = watcher.poll(t0 + 8s);
+    if (changed.test(io::kWatchGameB) &&
+        io::reloadSaveFile(root, 1, 'B', defaultGameState, error) != io::Reload::Unchanged) {
+        std::cerr << "own save should not be reloaded\n";
+        return 1;
+    }
+
+    fs::remove_all(root);
+    return 0;
+}
@@ -0,0 +1,168 @@
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "config/constants.h"
+#include "io.h"
+#include "pm3_data.h"
+#include "slot_summary.h"
+#include "test_util.h"
+
+namespace {
+
+void setRow(gamea::TableDivision &row, int16_t club, int16_t won, int16_t drawn, int16_t scored, int16_t conceded) {
+    std::memset(&row, 0, sizeof(row));
+    row.club_idx = club;
+    row.hw = won;
+    row.hd = drawn;
+    row.hf = scored;
+    row.ha = conceded;
+}
+
+std::string summaryOf(int gameNumber) {
+    char label[96];
+    return io::formatSlotSummary(gameNumber, label, sizeof(label)) ? label : "";
+}
+
+} // namespace
+
+int main() {
+    namespace fs = std::filesystem;
+
+    // Club 30 is level on points with club 31 but has the better goal difference, and club 32 is ahead on points.
+    std::memset(&gameData, 0xFF, sizeof(gameData));
+    std::memset(&clubData, 0xFF, sizeof(clubData));
+    std::memset(&playerData, 0, sizeof(playerData));
+    gameData.manager[0].club_idx = 30;
+    auto &divisionOne = gameData.table.leagues.division_one;
+    for (auto &row : divisionOne) {
+        setRow(row, -1, 0, 0, 0, 0);
+    }
+    setRow(divisionOne[0], 31, 10, 4, 20, 15);
+    setRow(divisionOne[1], 30, 10, 4, 25, 12);
+    setRow(divisionOne[2], 32, 12, 0, 30, 10);
+    setRow(divisionOne[3], 33, 2, 1, 5, 30);
+    clubData.club[30].bank_account = -1250000;
+    clubData.club[30].player_index[0] = 100;
+    clubData.club[30].player_index[5] = 101;
+    playerData.player[100].hn = 80;
+    playerData.player[100].sh = 60;
+    playerData.player[101].ps = 71;
+
+    slot_summary::Summary summary = slot_summary::compute(gameData, clubData, playerData);
+    if (summary.division != 1 || summary.leaguePosition != 2 || summary.points != 34 ||
+        summary.bankBalance != -1250000 || summary.squadSize != 2 || summary.squadStrength != 76) {
+        std::cerr << "unexpected summary: division " << summary.division << " position " << summary.leaguePosition
+                  << " points " << summary.points << " strength " << summary.squadStrength << "\n";
+        return 1;
+    }
+    std::string text = slot_summary::describe(summary);
+    if (text != "2nd in Division One, 34 pts  Bank -1,250,000  Squad 2, rating 76") {
+        std::cerr << "unexpected description: " << text << "\n";
+        return 1;
+    }
+
+    // The index round-trips, and a torn index reads as empty rather than half-filled.
+    fs::path root = fs::temp_directory_path() / "pm3000_test_slot_summary";
+    fs::remove_all(root);
+    fs::path indexPath = slot_summary::indexPath(root / BACKUP_SAVE_PATH);
+    slot_summary::Index index;
+    summary.files[1].writeTime = 1234;
+    index.slots[4] = summary;
+    slot_summary::write(indexPath, index);
+    slot_summary::Index reread = slot_summary::read(indexPath);
+    if (reread.slots[0] || !reread.slots[4] || reread.slots[4]->files[1].crc != summary.files[1].crc ||
+        reread.slots[4]->files[1].writeTime != 1234 || slot_summary::describe(*reread.slots[4]) != text) {
+        std::cerr << "index did not round-trip\n";
+        return 1;
+    }
+    {
+        std::ofstream torn(indexPath, std::ios::binary | std::ios::trunc);
+        torn << "PM3000-SLOTS 1\nslot 5 30 1 2 34 0 2 76\nfile 1 2 ";
+    }
+    if (slot_summary::read(indexPath).slots[4]) {
+        std::cerr << "a truncated index must not yield summaries\n";
+        return 1;
+    }
+    fs::remove_all(root);
+
+    // Loading and saving through io keep the index current; the screens then read nothing but the index.
+    fs::create_directories(root / std::string{kStandardSavesPath});
+    std::ofstream(root / std::string{kExeStandardFilename}).put('\0');
+    writeStruct(io::constructSaveFilePath(root, 1, 'A'), gameData);
+    writeStruct(io::constructSaveFilePath(root, 1, 'B'), clubData);
+    writeStruct(io::constructSaveFilePath(root, 1, 'C'), playerData);
+    fs::path savesPath = io::constructSavesFolderPath(root);
+    writeStruct(savesPath / std::string{kSavesDirFile}, saves{});
+    writeStruct(savesPath / std::string{kPrefsFile}, prefs{});
+
+    // A slot the editor has never seen is summarised from read-only mappings of its files.
+    io::loadSlotSummaries(root);
+    if (summaryOf(1) != "2nd in Division One, 34 pts  Bank -1,250,000  Squad 2, rating 76") {
+        std::cerr << "an unseen slot should be summarised from its files, got \"" << summaryOf(1) << "\"\n";
+        return 1;
+    }
+    io::LoadedGame loaded;
+    std::string error;
+    if (!io::readGame(root, 1, loaded, error)) {
+        std::cerr << "readGame failed: " << error << "\n";
+        return 1;
+    }
+    io::installLoadedGame(loaded, defaultGameState);
+    io::loadSlotSummaries(root);
+    if (summaryOf(1) != "2nd in Division One, 34 pts  Bank -1,250,000  Squad 2, rating 76") {
+        std::cerr << "loading should record the slot's summary, got \"" << summaryOf(1) << "\"\n";
+        return 1;
+    }
+
+    Settings settings;
+    settings.gamePath = root;
+    char footer[70]{};
+    dirty_tracker::touch(clubData.club[30]);
+    clubData.club[30].bank_account = 500000;
+    if (!io::saveGame(settings, 1, footer, sizeof(footer))) {
+        std::cerr << "save failed: " << footer << "\n";
+        return 1;
+    }
+    io::loadSlotSummaries(root);
+    if (summaryOf(1).find("Bank 500,000") == std::string::npos) {
+        std::cerr << "saving should refresh the summary, got \"" << summaryOf(1) << "\"\n";
+        return 1;
+    }
+
+    // A copy has the same contents, so its summary follows; a file changed behind our back is summarised again.
+    if (!io::manageSlot(root, io::SlotOperation::Copy, 1, 4, error)) {
+        std::cerr << "copy failed: " << error << "\n";
+        return 1;
+    }
+    io::loadSlotSummaries(root);
+    if (summaryOf(4) != summaryOf(1) || summaryOf(4).empty()) {
+        std::cerr << "the copied slot should carry the summary\n";
+        return 1;
+    }
+    clubData.club[30].bank_account = 750000;
+    writeStruct(io::constructSaveFilePath(root, 1, 'B'), clubData);
+    fs::last_write_time(io::constructSaveFilePath(root, 1, 'B'),
+                        fs::last_write_time(io::constructSaveFilePath(root, 1, 'B')) + std::chrono::seconds(5));
+    io::loadSlotSummaries(root);
+    if (summaryOf(1).find("Bank 750,000") == std::string::npos ||
+        summaryOf(4).find("Bank 500,000") == std::string::npos) {
+        std::cerr << "only the changed slot should get a new summary\n";
+        return 1;
+    }
+    if (!io::manageSlot(root, io::SlotOperation::Delete, 4, 0, error)) {
+        std::cerr << "delete failed: " << error << "\n";
+        return 1;
+    }
+    if (slot_summary::read(slot_summary::indexPath(savesPath / BACKUP_SAVE_PATH)).slots[3]) {
+        std::cerr << "a deleted slot should leave the index\n";
+        return 1;
+    }
+
+    fs::remove_all(root);
+    return 0;
+}
@@ -0,0 +1,13 @@
+// Helpers shared by the test programs.
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+
+// Writes the first `size` bytes of `data` to `path`, replacing the file; a short size leaves a torn file.
+template <typename T>
+void writeStruct(const std::filesystem::path &path, const T &data, std::size_t size = sizeof(T)) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(&data), static_cast<std::streamsize>(size));
+}
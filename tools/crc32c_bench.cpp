@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "config/constants.h"
+#include "crc32c.h"
+#include "io.h"
+#include "save_fingerprint.h"
+
+namespace {
+
+void printUsage() {
+    std::cerr << "Usage: crc32c_bench [--pm3 /path/to/PM3 --game <1-8>] [--iterations <n>]\n";
+}
+
+// Mean microseconds per call of `body` over `iterations` runs.
+double timeIt(int iterations, const std::function<void()> &body) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        body();
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+void report(const char *label, double micros) {
+    std::cout << "  " << label << ": " << micros << " us\n";
+}
+
+std::vector<uint8_t> readAll(const std::filesystem::path &path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<uint8_t>((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    std::filesystem::path pm3Path;
+    int gameNumber = 0;
+    int iterations = 200;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if ((a == "--pm3" || a == "-p") && i + 1 < argc) {
+            pm3Path = argv[++i];
+        } else if ((a == "--game" || a == "-g") && i + 1 < argc) {
+            gameNumber = std::atoi(argv[++i]);
+        } else if (a == "--iterations" && i + 1 < argc) {
+            iterations = std::max(1, std::atoi(argv[++i]));
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    // Raw throughput over one save slot's worth of bytes (GAMEnA + GAMEnB + GAMEnC).
+    std::vector<uint8_t> slot(29554 + 139080 + 157280);
+    std::mt19937 rng(3);
+    for (auto &byte : slot) {
+        byte = static_cast<uint8_t>(rng());
+    }
+    volatile uint32_t sink = 0;
+    double hardware = timeIt(iterations, [&] { sink = crc32c::compute(slot.data(), slot.size()); });
+    double portable = timeIt(iterations, [&] { sink = crc32c::extendPortable(0, slot.data(), slot.size()); });
+    double megabytes = static_cast<double>(slot.size()) / (1024.0 * 1024.0);
+    std::cout << "CRC32C over " << slot.size() << " bytes ("
+              << (crc32c::hardwareAccelerated() ? "hardware" : "no hardware support") << ")\n";
+    report("extend()", hardware);
+    report("portable", portable);
+    std::cout << "  throughput: " << megabytes / (hardware / 1e6) << " MB/s vs " << megabytes / (portable / 1e6)
+              << " MB/s\n";
+
+    if (pm3Path.empty()) {
+        return 0;
+    }
+    if (gameNumber < 1 || gameNumber > 8 || io::getPm3GameType(pm3Path) == Pm3GameType::Unknown) {
+        printUsage();
+        return 1;
+    }
+
+    std::filesystem::path files[3];
+    for (int i = 0; i < 3; ++i) {
+        files[i] = io::constructSaveFilePath(pm3Path, gameNumber, static_cast<char>('A' + i));
+    }
+    std::filesystem::path sidecar =
+            save_fingerprint::sidecarPath(io::constructSavesFolderPath(pm3Path) / BACKUP_SAVE_PATH, gameNumber);
+
+    std::cout << "Change detection for game " << gameNumber << "\n";
+    // The size-only validation io::readGame does before loading: three file_size() calls, blind to same-size edits.
+    report("size-only check", timeIt(iterations, [&] {
+        for (const auto &path : files) {
+            sink = static_cast<uint32_t>(std::filesystem::file_size(path));
+        }
+    }));
+    report("sidecar check (size + mtime)", timeIt(iterations, [&] {
+        save_fingerprint::SlotFingerprint fingerprint;
+        bool current = save_fingerprint::read(sidecar, fingerprint);
+        for (int i = 0; current && i < 3; ++i) {
+            current = save_fingerprint::matchesDisk(fingerprint.files[i], files[i]);
+        }
+        sink = current;
+    }));
+    report("read + CRC32C", timeIt(iterations, [&] {
+        for (const auto &path : files) {
+            std::vector<uint8_t> bytes = readAll(path);
+            sink = save_fingerprint::compute(bytes.data(), bytes.size()).crc;
+        }
+    }));
+    report("read only", timeIt(iterations, [&] {
+        for (const auto &path : files) {
+            sink = static_cast<uint32_t>(readAll(path).size());
+        }
+    }));
+    return 0;
+}
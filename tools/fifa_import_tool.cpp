@@ -21,6 +21,8 @@
 #include <array>
 
 #include "io.h"
+#include "pm3_codec.h"
+#include "pm3_schema.h"
 #include "pm3_defs.hh"
 
 namespace {
@@ -912,19 +914,11 @@ std::string clubSortKey(const ClubRecord &club) {
 }
 
 int16_t decodePlayerIndex(int16_t raw, bool swapEndian) {
-    if (!swapEndian) {
-        return raw;
-    }
-    uint16_t u = static_cast<uint16_t>(raw);
-    return static_cast<int16_t>((u >> 8) | (u << 8));
+    return swapEndian ? pm3_codec::byteSwap16(raw) : raw;
 }
 
 int16_t encodePlayerIndex(int16_t raw, bool swapEndian) {
-    if (!swapEndian) {
-        return raw;
-    }
-    uint16_t u = static_cast<uint16_t>(raw);
-    return static_cast<int16_t>((u >> 8) | (u << 8));
+    return swapEndian ? pm3_codec::byteSwap16(raw) : raw;
 }
 
 void writeLeagueSlots(gamea &gd, const std::array<std::vector<int>, 5> &tiers) {
@@ -939,7 +933,7 @@ void writeLeagueSlots(gamea &gd, const std::array<std::vector<int>, 5> &tiers) {
         }
     };
 
-    constexpr std::array<int, 5> kStorageSizes{{22, 24, 24, 22, 22}};
+    constexpr std::array<int, 5> kStorageSizes = pm3_schema::kDivisionSlots;
     writeLeague(gd.club_index.leagues.premier_league, kStorageSizes[0], tiers[0]);
     writeLeague(gd.club_index.leagues.division_one, kStorageSizes[1], tiers[1]);
     writeLeague(gd.club_index.leagues.division_two, kStorageSizes[2], tiers[2]);
@@ -1537,7 +1531,7 @@ ImportStats importCsvToPlayers(const std::string &csvPath, int baseYear, bool ve
         });
     }
 
-    constexpr std::array<int, 5> kStorageSizes{{22, 24, 24, 22, 22}};
+    constexpr std::array<int, 5> kStorageSizes = pm3_schema::kDivisionSlots;
     std::vector<int> dropped;
     while (static_cast<int>(tiers[3].size()) > kStorageSizes[3]) {
         dropped.push_back(tiers[3].back());
@@ -8,6 +8,7 @@
 #include <string>
 
 #include "pm3_defs.hh"
+#include "pm3_schema.h"
 
 template <typename T>
 void printArray(const std::string &label, const T *data, std::size_t count) {
@@ -19,23 +20,11 @@ void printArray(const std::string &label, const T *data, std::size_t count) {
 }
 
 void dumpClubIndex(const gamea &gameData) {
-    constexpr std::array<const char *, 5> labels{
-            "premier_league",
-            "division_one",
-            "division_two",
-            "division_three",
-            "conference_league"
-    };
-    constexpr std::array<int, 5> lengths{22, 24, 24, 22, 22};
-    const int16_t *arrays[] = {
-            gameData.club_index.leagues.premier_league,
-            gameData.club_index.leagues.division_one,
-            gameData.club_index.leagues.division_two,
-            gameData.club_index.leagues.division_three,
-            gameData.club_index.leagues.conference_league
-    };
-    for (std::size_t i = 0; i < labels.size(); ++i) {
-        printArray(std::string{"club_index_leagues."} + labels[i], arrays[i], lengths[i]);
+    const auto *base = reinterpret_cast<const uint8_t *>(&gameData.club_index);
+    for (std::size_t i = 0; i < pm3_schema::kDivisionSlots.size(); ++i) {
+        const pm3_schema::Field &field = pm3_schema::kClubIndexLeaguesFields[i];
+        printArray(std::string{"club_index_leagues."} + field.name,
+                   reinterpret_cast<const int16_t *>(base + field.offset), field.count);
     }
 }
 
@@ -48,7 +37,7 @@ void dumpLeagueTable(const gamea &gameData) {
             leagues.division_three,
             leagues.conference_league
     };
-    constexpr std::array<int, 5> lengths{22, 24, 24, 22, 22};
+    constexpr std::array<int, 5> lengths = pm3_schema::kDivisionSlots;
     const char *labels[] = {"premier", "division_one", "division_two", "division_three", "conference"};
     for (std::size_t li = 0; li < std::size(lengths); ++li) {
         for (int row = 0; row < lengths[li]; ++row) {
@@ -108,12 +97,35 @@ void dumpCups(const gamea &gameData) {
     }
 }
 
+// Every field of gamedata.dat, one "path=value" line each, straight from the schema.
+void dumpAll(const gamea &gameData) {
+    pm3_schema::visit(pm3_schema::kGameA, &gameData,
+                      [](const std::string &path, const pm3_schema::Field &field, const uint8_t *element) {
+        std::cout << path << "=";
+        if (field.kind == pm3_schema::Kind::Text) {
+            std::cout << '"' << std::string(reinterpret_cast<const char *>(element), field.width) << '"';
+        } else if (field.kind == pm3_schema::Kind::Bytes) {
+            std::cout << std::hex << std::setfill('0');
+            for (uint32_t i = 0; i < field.width; ++i) {
+                std::cout << std::setw(2) << static_cast<int>(element[i]);
+            }
+            std::cout << std::dec << std::setfill(' ');
+        } else {
+            std::cout << pm3_schema::readValue(field, element);
+        }
+        std::cout << "\n";
+    });
+}
+
 int main(int argc, char **argv) {
     std::string pm3Path;
+    bool all = false;
     for (int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
         if (arg == "--pm3" && i + 1 < argc) {
             pm3Path = argv[++i];
+        } else if (arg == "--all") {
+            all = true;
         }
     }
     if (pm3Path.empty()) {
@@ -134,6 +146,10 @@ int main(int argc, char **argv) {
         return 1;
     }
 
+    if (all) {
+        dumpAll(data);
+        return 0;
+    }
     dumpClubIndex(data);
     dumpLeagueTable(data);
     dumpTopScorers(data);
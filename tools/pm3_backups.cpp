@@ -0,0 +1,252 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "backup_store.h"
+#include "config/constants.h"
+#include "history_archive.h"
+#include "io.h"
+#include "pm3_schema.h"
+#include "save_journal.h"
+
+namespace {
+
+void printUsage() {
+    std::cerr << "Usage: pm3_backups --pm3 /path/to/PM3 list <1-8|base>\n"
+                 "       pm3_backups --pm3 /path/to/PM3 restore <1-8> <version>\n"
+                 "       pm3_backups --pm3 /path/to/PM3 gc [--keep <versions>]\n"
+                 "       pm3_backups --pm3 /path/to/PM3 history <1-8> [<field>...]\n"
+                 "       pm3_backups --pm3 /path/to/PM3 copy|move|swap <1-8> <1-8>\n"
+                 "       pm3_backups --pm3 /path/to/PM3 delete <1-8>\n"
+                 "Fields are schema paths such as club[17].bank_account or player[2011].morl.\n";
+}
+
+const char *copyMethodName(save_journal::CopyMethod method) {
+    switch (method) {
+        case save_journal::CopyMethod::Reflink:
+            return "reflink";
+        case save_journal::CopyMethod::CopyFileRange:
+            return "copy_file_range";
+        case save_journal::CopyMethod::Bytes:
+            return "byte copy";
+    }
+    return "";
+}
+
+std::filesystem::path storeDirFor(const std::filesystem::path &pm3Path, bool baseData) {
+    std::filesystem::path backupDir = baseData ? pm3Path / BACKUP_SAVE_PATH
+                                               : io::constructSavesFolderPath(pm3Path) / BACKUP_SAVE_PATH;
+    return io::backupStorePath(backupDir);
+}
+
+void listVersions(const backup_store::Store &store, const std::string &set) {
+    for (const auto &info : store.versions(set)) {
+        char when[32] = "?";
+        if (const std::tm *tm = std::localtime(&info.created)) {
+            std::strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", tm);
+        }
+        std::cout << set << " v" << info.id << "  " << when << "  " << info.totalBytes << " bytes\n";
+    }
+}
+
+std::string formatTime(int64_t recorded) {
+    char when[32] = "?";
+    auto time = static_cast<std::time_t>(recorded);
+    if (const std::tm *tm = std::localtime(&time)) {
+        std::strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", tm);
+    }
+    return when;
+}
+
+std::string formatValue(const pm3_schema::Field &field, const uint8_t *element) {
+    if (field.kind == pm3_schema::Kind::Text) {
+        std::string text(reinterpret_cast<const char *>(element), strnlen(reinterpret_cast<const char *>(element),
+                                                                            field.width));
+        return "\"" + text.substr(0, text.find_last_not_of(' ') + 1) + "\"";
+    }
+    if (field.kind == pm3_schema::Kind::Bytes) {
+        std::string hex;
+        char digits[3];
+        for (uint32_t i = 0; i < field.width; ++i) {
+            std::snprintf(digits, sizeof(digits), "%02x", element[i]);
+            hex += digits;
+        }
+        return hex;
+    }
+    return std::to_string(pm3_schema::readValue(field, element));
+}
+
+// One row per snapshot: when it was taken, the game date, then each field's value at that point.
+bool printHistory(const history_archive::Archive &archive, const std::vector<std::string> &fields) {
+    const pm3_schema::Record *records[history_archive::kFileCount] = {&pm3_schema::kGameA, &pm3_schema::kGameB,
+                                                                      &pm3_schema::kGameC};
+    std::vector<std::vector<std::string>> columns;
+    for (const auto &path : fields) {
+        int file = 0;
+        std::optional<pm3_schema::Location> location;
+        for (int i = 0; i < history_archive::kFileCount && !location; ++i) {
+            location = pm3_schema::lookup(*records[i], path);
+            file = i;
+        }
+        if (!location) {
+            std::cerr << "Unknown field: " << path << "\n";
+            return false;
+        }
+        std::vector<std::string> column;
+        archive.history(file, location->offset, location->field->width,
+                        [&](const history_archive::SnapshotInfo &, const uint8_t *bytes) {
+                            column.push_back(formatValue(*location->field, bytes));
+                        });
+        columns.push_back(std::move(column));
+    }
+
+    std::cout << "#  recorded             year turn";
+    for (const auto &path : fields) {
+        std::cout << "  " << path;
+    }
+    std::cout << "\n";
+    for (const auto &snapshot : archive.snapshots()) {
+        char row[64];
+        std::snprintf(row, sizeof(row), "%-4u %s %4u %4u", snapshot.index, formatTime(snapshot.recorded).c_str(),
+                      snapshot.year, snapshot.turn);
+        std::cout << row;
+        for (const auto &column : columns) {
+            std::cout << "  " << column[snapshot.index];
+        }
+        std::cout << "\n";
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    std::filesystem::path pm3Path;
+    std::size_t keep = backup_store::kDefaultKeepVersions;
+    std::string command;
+    std::vector<std::string> args;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if ((a == "--pm3" || a == "-p") && i + 1 < argc) {
+            pm3Path = argv[++i];
+        } else if (a == "--keep" && i + 1 < argc) {
+            keep = static_cast<std::size_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (command.empty()) {
+            command = a;
+        } else {
+            args.push_back(a);
+        }
+    }
+
+    if (pm3Path.empty() || io::getPm3GameType(pm3Path) == Pm3GameType::Unknown) {
+        printUsage();
+        return 1;
+    }
+
+    try {
+        if (command == "list" && args.size() == 1) {
+            bool baseData = args[0] == "base";
+            int gameNumber = baseData ? 0 : std::atoi(args[0].c_str());
+            if (!baseData && (gameNumber < 1 || gameNumber > 8)) {
+                printUsage();
+                return 1;
+            }
+            backup_store::Store store(storeDirFor(pm3Path, baseData));
+            listVersions(store, baseData ? io::kBaseBackupSet : backup_store::slotSetName(gameNumber));
+            return 0;
+        }
+
+        if (command == "restore" && args.size() == 2) {
+            int gameNumber = std::atoi(args[0].c_str());
+            auto version = static_cast<uint32_t>(std::strtoul(args[1].c_str(), nullptr, 10));
+            if (gameNumber < 1 || gameNumber > 8 || version == 0) {
+                printUsage();
+                return 1;
+            }
+            Settings settings;
+            settings.gamePath = pm3Path;
+            if (!io::backupSaveFile(settings, gameNumber) || !io::restoreSaveBackup(pm3Path, gameNumber, version)) {
+                std::cerr << io::pm3LastError() << "\n";
+                return 1;
+            }
+            std::cout << "Restored game " << gameNumber << " to version " << version << "\n";
+            return 0;
+        }
+
+        if (command == "gc" && args.empty()) {
+            std::size_t pruned = 0;
+            std::size_t collected = 0;
+            for (bool baseData : {false, true}) {
+                backup_store::Store store(storeDirFor(pm3Path, baseData));
+                if (baseData) {
+                    pruned += store.prune(io::kBaseBackupSet, keep);
+                } else {
+                    for (int gameNumber = 1; gameNumber <= 8; ++gameNumber) {
+                        pruned += store.prune(backup_store::slotSetName(gameNumber), keep);
+                    }
+                }
+                collected += store.collectGarbage();
+            }
+            std::cout << "Pruned " << pruned << " versions, removed " << collected << " unused chunks\n";
+            return 0;
+        }
+
+        if (command == "history" && !args.empty()) {
+            int gameNumber = std::atoi(args[0].c_str());
+            if (gameNumber < 1 || gameNumber > 8) {
+                printUsage();
+                return 1;
+            }
+            history_archive::Archive archive(history_archive::archivePath(
+                    io::constructSavesFolderPath(pm3Path) / BACKUP_SAVE_PATH, gameNumber));
+            std::vector<std::string> fields(args.begin() + 1, args.end());
+            if (fields.empty()) {
+                for (const auto &snapshot : archive.snapshots()) {
+                    std::cout << "#" << snapshot.index << "  " << formatTime(snapshot.recorded) << "  year "
+                              << snapshot.year << " turn " << snapshot.turn << "\n";
+                }
+                std::cout << archive.snapshots().size() << " snapshots, " << archive.sizeOnDisk() << " bytes\n";
+                return 0;
+            }
+            return printHistory(archive, fields) ? 0 : 1;
+        }
+
+        const std::pair<const char *, io::SlotOperation> slotCommands[] = {
+                {"copy", io::SlotOperation::Copy}, {"move", io::SlotOperation::Move},
+                {"swap", io::SlotOperation::Swap}, {"delete", io::SlotOperation::Delete}};
+        for (const auto &[name, operation] : slotCommands) {
+            bool twoSlots = operation != io::SlotOperation::Delete;
+            if (command != name || args.size() != (twoSlots ? 2u : 1u)) {
+                continue;
+            }
+            int from = std::atoi(args[0].c_str());
+            int to = twoSlots ? std::atoi(args[1].c_str()) : 0;
+            std::string error;
+            save_journal::CopyMethod method = save_journal::CopyMethod::Reflink;
+            if (!io::manageSlot(pm3Path, operation, from, to, error, &method)) {
+                std::cerr << error << "\n";
+                return 1;
+            }
+            std::cout << "Game " << from;
+            if (twoSlots) {
+                std::cout << " -> game " << to << " (" << copyMethodName(method) << ")";
+            }
+            std::cout << ": " << io::slotOperationName(operation) << " done\n";
+            return 0;
+        }
+    } catch (const std::exception &ex) {
+        std::cerr << ex.what() << "\n";
+        return 1;
+    }
+
+    printUsage();
+    return 1;
+}
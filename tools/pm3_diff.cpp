@@ -0,0 +1,312 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "io.h"
+#include "mapped_save.h"
+#include "pm3_defs.hh"
+#include "pm3_schema.h"
+#include "save_diff.h"
+
+namespace {
+
+namespace fs = std::filesystem;
+
+void printUsage() {
+    std::cerr << "Usage: pm3_diff [--json] [--game <1-8>] <before-dir> <after-dir>\n"
+                 "       pm3_diff [--json] --pm3 /path/to/PM3 <slot> <slot>\n"
+                 "       pm3_diff [--json] [--game <1-8>] --series <dir>\n"
+                 "Directories hold GAMEnA/B/C files, e.g. copies of the SAVES folder. --series compares each\n"
+                 "subdirectory of <dir> with the next one in name order.\n";
+}
+
+// Read-only mappings of GAMEnA/B/C; a long series only faults in the pages the diff actually compares.
+struct Slot {
+    io::MappedFile files[3];
+};
+
+struct SlotFiles {
+    fs::path files[3];
+};
+
+bool readSlot(const SlotFiles &files, Slot &slot) {
+    constexpr std::size_t sizes[3] = {sizeof(gamea), sizeof(gameb), sizeof(gamec)};
+    for (int i = 0; i < 3; ++i) {
+        if (!slot.files[i].open(files.files[i], sizes[i], false)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string upper(std::string value) {
+    for (char &c : value) {
+        c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+    return value;
+}
+
+// GAMEnA/B/C in `dir`, matched case-insensitively since the Deluxe edition writes lower-case names.
+std::optional<SlotFiles> findSlot(const fs::path &dir, int gameNumber) {
+    SlotFiles slot;
+    int found = 0;
+    std::error_code ec;
+    for (const auto &entry : fs::directory_iterator(dir, ec)) {
+        std::string name = upper(entry.path().filename().string());
+        for (int i = 0; i < 3; ++i) {
+            if (name == "GAME" + std::to_string(gameNumber) + static_cast<char>('A' + i)) {
+                slot.files[i] = entry.path();
+                ++found;
+            }
+        }
+    }
+    return found == 3 ? std::optional<SlotFiles>{slot} : std::nullopt;
+}
+
+std::string jsonString(const std::string &value) {
+    std::string out = "\"";
+    for (char c : value) {
+        auto byte = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (byte < 0x20 || byte >= 0x7F) {
+            // PM3 names are Latin-1, which is not UTF-8; \u00XX decodes to the same character.
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", byte);
+            out += escaped;
+        } else {
+            out += c;
+        }
+    }
+    return out + "\"";
+}
+
+std::string describeValue(const save_diff::Change &change, bool before, bool json) {
+    switch (change.field->kind) {
+    case pm3_schema::Kind::Text:
+        return json ? jsonString(before ? change.beforeText : change.afterText)
+                    : "\"" + (before ? change.beforeText : change.afterText) + "\"";
+    case pm3_schema::Kind::Bytes:
+        return json ? jsonString(before ? change.beforeText : change.afterText)
+                    : (before ? change.beforeText : change.afterText);
+    default:
+        return std::to_string(before ? change.before : change.after);
+    }
+}
+
+std::string changePath(const save_diff::Group &group, const save_diff::Change &change) {
+    std::string path = change.path.empty() ? group.name : change.path;
+    if (change.field->kind == pm3_schema::Kind::Bytes) {
+        path += "+" + std::to_string(change.byteOffset);
+    }
+    return path;
+}
+
+struct FileDiff {
+    char letter;
+    std::vector<save_diff::Group> groups;
+};
+
+std::vector<FileDiff> diffSlot(const Slot &before, const Slot &after) {
+    std::vector<FileDiff> files;
+    auto add = [&](char letter, const pm3_schema::Record &record, const void *a, const void *b) {
+        auto changes = save_diff::diff(record, a, b);
+        if (!changes.empty()) {
+            files.push_back({letter, save_diff::group(changes, record, b)});
+        }
+    };
+    add('A', pm3_schema::kGameA, before.files[0].data(), after.files[0].data());
+    add('B', pm3_schema::kGameB, before.files[1].data(), after.files[1].data());
+    add('C', pm3_schema::kGameC, before.files[2].data(), after.files[2].data());
+    return files;
+}
+
+void printText(const std::string &beforeName, const std::string &afterName, int gameNumber,
+               const std::vector<FileDiff> &files) {
+    std::cout << "== " << beforeName << " -> " << afterName << " (game " << gameNumber << ")\n";
+    for (const auto &file : files) {
+        std::cout << "GAME" << gameNumber << file.letter << "\n";
+        for (const auto &group : file.groups) {
+            bool scalar = group.changes.size() == 1 && group.changes[0].path.empty();
+            if (!scalar) {
+                std::cout << "  " << group.name << (group.label.empty() ? "" : " " + group.label) << "\n";
+            }
+            for (const auto &change : group.changes) {
+                std::cout << (scalar ? "  " : "    ") << changePath(group, change) << ": "
+                          << describeValue(change, true, false) << " -> " << describeValue(change, false, false)
+                          << "\n";
+            }
+        }
+    }
+}
+
+void printJson(const std::string &beforeName, const std::string &afterName, int gameNumber,
+               const std::vector<FileDiff> &files, bool first) {
+    std::cout << (first ? "" : ",\n") << "{\"before\":" << jsonString(beforeName)
+              << ",\"after\":" << jsonString(afterName) << ",\"game\":" << gameNumber << ",\"files\":{";
+    for (std::size_t f = 0; f < files.size(); ++f) {
+        std::cout << (f ? "," : "") << "\"" << files[f].letter << "\":[";
+        for (std::size_t g = 0; g < files[f].groups.size(); ++g) {
+            const auto &group = files[f].groups[g];
+            std::cout << (g ? "," : "") << "{\"group\":" << jsonString(group.name);
+            if (!group.label.empty()) {
+                std::cout << ",\"label\":" << jsonString(group.label);
+            }
+            std::cout << ",\"changes\":[";
+            for (std::size_t c = 0; c < group.changes.size(); ++c) {
+                const auto &change = group.changes[c];
+                const std::string &field = change.path.empty() ? group.name : change.path;
+                std::cout << (c ? "," : "") << "{\"field\":" << jsonString(field);
+                if (change.field->kind == pm3_schema::Kind::Bytes) {
+                    std::cout << ",\"offset\":" << change.byteOffset;
+                }
+                std::cout << ",\"before\":" << describeValue(change, true, true)
+                          << ",\"after\":" << describeValue(change, false, true) << "}";
+            }
+            std::cout << "]}";
+        }
+        std::cout << "]";
+    }
+    std::cout << "}}";
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    fs::path pm3Path;
+    fs::path seriesDir;
+    bool json = false;
+    int onlyGame = 0;
+    std::vector<std::string> args;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if ((a == "--pm3" || a == "-p") && i + 1 < argc) {
+            pm3Path = argv[++i];
+        } else if ((a == "--game" || a == "-g") && i + 1 < argc) {
+            onlyGame = std::atoi(argv[++i]);
+        } else if (a == "--series" && i + 1 < argc) {
+            seriesDir = argv[++i];
+        } else if (a == "--json") {
+            json = true;
+        } else if (!a.empty() && a[0] != '-') {
+            args.push_back(a);
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+    if (onlyGame < 0 || onlyGame > 8) {
+        printUsage();
+        return 1;
+    }
+
+    // Each comparison is (before, after, game number, slot files of each side).
+    struct Comparison {
+        std::string beforeName;
+        std::string afterName;
+        int gameNumber;
+        SlotFiles before;
+        SlotFiles after;
+    };
+    std::vector<Comparison> comparisons;
+    auto addDirectories = [&](const fs::path &beforeDir, const fs::path &afterDir) {
+        for (int game = 1; game <= 8; ++game) {
+            if (onlyGame != 0 && game != onlyGame) {
+                continue;
+            }
+            auto before = findSlot(beforeDir, game);
+            auto after = findSlot(afterDir, game);
+            if (before && after) {
+                comparisons.push_back({beforeDir.string(), afterDir.string(), game, *before, *after});
+            }
+        }
+    };
+
+    if (!pm3Path.empty()) {
+        if (args.size() != 2 || io::getPm3GameType(pm3Path) == Pm3GameType::Unknown) {
+            printUsage();
+            return 1;
+        }
+        int slots[2] = {std::atoi(args[0].c_str()), std::atoi(args[1].c_str())};
+        SlotFiles files[2];
+        for (int s = 0; s < 2; ++s) {
+            if (slots[s] < 1 || slots[s] > 8) {
+                printUsage();
+                return 1;
+            }
+            for (int i = 0; i < 3; ++i) {
+                files[s].files[i] = io::constructSaveFilePath(pm3Path, slots[s], static_cast<char>('A' + i));
+            }
+        }
+        comparisons.push_back({"game " + args[0], "game " + args[1], slots[1], files[0], files[1]});
+    } else if (!seriesDir.empty()) {
+        std::vector<fs::path> snapshots;
+        std::error_code ec;
+        for (const auto &entry : fs::directory_iterator(seriesDir, ec)) {
+            if (entry.is_directory()) {
+                snapshots.push_back(entry.path());
+            }
+        }
+        std::sort(snapshots.begin(), snapshots.end());
+        for (std::size_t i = 1; i < snapshots.size(); ++i) {
+            addDirectories(snapshots[i - 1], snapshots[i]);
+        }
+    } else if (args.size() == 2) {
+        addDirectories(args[0], args[1]);
+    } else {
+        printUsage();
+        return 1;
+    }
+
+    if (json) {
+        std::cout << "[";
+    }
+    // In a series the newer side of one comparison is the older side of the next one for the same game, so keep
+    // the newest side of each game mapped.
+    struct Loaded {
+        std::string name; // empty if nothing is kept for the game
+        Slot slot;
+    };
+    Loaded newest[9];
+    bool first = true;
+    int failures = 0;
+    for (const auto &comparison : comparisons) {
+        Loaded &kept = newest[comparison.gameNumber];
+        Slot before;
+        Slot after;
+        bool reuse = !kept.name.empty() && kept.name == comparison.beforeName;
+        if (reuse) {
+            before = std::move(kept.slot);
+        }
+        kept.name.clear();
+        if ((!reuse && !readSlot(comparison.before, before)) || !readSlot(comparison.after, after)) {
+            std::cerr << "Could not read game " << comparison.gameNumber << " from " << comparison.beforeName
+                      << " or " << comparison.afterName << "\n";
+            ++failures;
+            continue;
+        }
+
+        auto files = diffSlot(before, after);
+        if (json) {
+            printJson(comparison.beforeName, comparison.afterName, comparison.gameNumber, files, first);
+        } else {
+            printText(comparison.beforeName, comparison.afterName, comparison.gameNumber, files);
+        }
+        first = false;
+        kept.name = comparison.afterName;
+        kept.slot = std::move(after);
+    }
+    if (json) {
+        std::cout << "]\n";
+    }
+    return failures == 0 ? 0 : 1;
+}
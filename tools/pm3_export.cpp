@@ -0,0 +1,126 @@
+// Exports players, clubs, league tables, top scorers and history from save slots or base data as tables.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "io.h"
+#include "pm3_data.h"
+#include "save_export.h"
+
+namespace {
+
+namespace fs = std::filesystem;
+
+void printUsage() {
+    std::cerr << "Usage: pm3_export [--format csv|jsonl|columns] [--game <1-8>|all] <pm3> <out-dir>\n"
+                 "Without --game the base data files are exported. With --game all every slot that exists is\n"
+                 "exported to <out-dir>/gameN, several at a time.\n";
+}
+
+// Slot `game` of the installation, or its base files when `game` is 0, into `dir`. Returns false after printing
+// the error.
+bool exportOne(const fs::path &pm3Path, int game, const fs::path &dir, save_export::Format format,
+               std::mutex &outputMutex) {
+    auto started = std::chrono::steady_clock::now();
+    auto state = std::make_unique<GameState>();
+    save_export::Summary summary;
+    try {
+        if (game == 0) {
+            io::loadDefaultData(pm3Path, *state);
+        } else {
+            io::loadBinaries(game, pm3Path, *state);
+        }
+        summary = save_export::exportGame(*state, dir, format);
+    } catch (const std::exception &e) {
+        std::lock_guard<std::mutex> lock(outputMutex);
+        std::cerr << (game == 0 ? std::string("base data") : "game " + std::to_string(game)) << ": " << e.what()
+                  << "\n";
+        return false;
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started);
+    std::lock_guard<std::mutex> lock(outputMutex);
+    std::cout << dir.string() << ": " << summary.tables << " tables, " << summary.rows << " rows in "
+              << elapsed.count() / 1000.0 << " ms\n";
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    save_export::Format format = save_export::Format::Csv;
+    int game = 0;
+    bool allGames = false;
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if ((a == "--format" || a == "-f") && i + 1 < argc) {
+            if (!save_export::parseFormat(argv[++i], format)) {
+                printUsage();
+                return 1;
+            }
+        } else if ((a == "--game" || a == "-g") && i + 1 < argc) {
+            std::string value = argv[++i];
+            allGames = value == "all";
+            game = allGames ? 0 : std::atoi(value.c_str());
+            if (!allGames && (game < 1 || game > 8)) {
+                printUsage();
+                return 1;
+            }
+        } else if (!a.empty() && a[0] != '-') {
+            args.push_back(a);
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+    if (args.size() != 2) {
+        printUsage();
+        return 1;
+    }
+    fs::path pm3Path = args[0];
+    fs::path outDir = args[1];
+    std::mutex outputMutex;
+
+    if (!allGames) {
+        return exportOne(pm3Path, game, outDir, format, outputMutex) ? 0 : 1;
+    }
+
+    // Each slot loads into its own GameState, so the exports share nothing but the output lock.
+    std::vector<int> slots;
+    for (int slot = 1; slot <= 8; ++slot) {
+        std::error_code ec;
+        if (fs::exists(io::constructSaveFilePath(pm3Path, slot, 'A'), ec)) {
+            slots.push_back(slot);
+        }
+    }
+    if (slots.empty()) {
+        std::cerr << "No saved games in " << pm3Path.string() << "\n";
+        return 1;
+    }
+    std::atomic<std::size_t> next{0};
+    std::atomic<bool> failed{false};
+    unsigned workers = std::max(1u, std::min(std::thread::hardware_concurrency(), static_cast<unsigned>(slots.size())));
+    std::vector<std::thread> threads;
+    for (unsigned w = 0; w < workers; ++w) {
+        threads.emplace_back([&] {
+            for (std::size_t i = next++; i < slots.size(); i = next++) {
+                fs::path dir = outDir / ("game" + std::to_string(slots[i]));
+                if (!exportOne(pm3Path, slots[i], dir, format, outputMutex)) {
+                    failed = true;
+                }
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    return failed ? 1 : 0;
+}
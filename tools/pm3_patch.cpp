@@ -0,0 +1,241 @@
+// Creates, applies and lists record-level patches for save slots and the base data files.
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "config/constants.h"
+#include "dirty_tracker.h"
+#include "io.h"
+#include "pm3_data.h"
+#include "save_diff.h"
+#include "save_patch.h"
+
+namespace {
+
+namespace fs = std::filesystem;
+
+void printUsage() {
+    std::cerr << "Usage: pm3_patch create [--game <1-8>] <before-pm3> <after-pm3> <patch>\n"
+                 "       pm3_patch apply [--game <1-8>] [--dry-run] <pm3> <patch>...\n"
+                 "       pm3_patch show <patch>\n"
+                 "Without --game the patch is made from or applied to GAMEDATA.DAT, CLUBDATA.DAT and PLAYDATA.DAT.\n"
+                 "Patches apply to slots and base files alike, and several are applied in the order given.\n";
+}
+
+struct Files {
+    std::unique_ptr<gamea> gameA = std::make_unique<gamea>();
+    std::unique_ptr<gameb> gameB = std::make_unique<gameb>();
+    std::unique_ptr<gamec> gameC = std::make_unique<gamec>();
+};
+
+// Slot `game` of the installation, or its base files when `game` is 0. Throws like the io loaders.
+void load(const fs::path &pm3Path, int game, gamea &gameA, gameb &gameB, gamec &gameC) {
+    if (game == 0) {
+        io::loadDefaultGamedata(pm3Path, gameA);
+        io::loadDefaultClubdata(pm3Path, gameB);
+        io::loadDefaultPlaydata(pm3Path, gameC);
+    } else {
+        io::loadBinaries(game, pm3Path, gameA, gameB, gameC);
+    }
+}
+
+bool readPatch(const fs::path &path, save_patch::Patch &patch) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        std::cerr << "Could not read " << path.string() << "\n";
+        return false;
+    }
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)), {});
+    std::string error;
+    if (!save_patch::decode(bytes.data(), bytes.size(), patch, error)) {
+        std::cerr << path.string() << ": " << error << "\n";
+        return false;
+    }
+    return true;
+}
+
+int create(int game, const fs::path &beforePath, const fs::path &afterPath, const fs::path &patchPath) {
+    Files before;
+    Files after;
+    try {
+        load(beforePath, game, *before.gameA, *before.gameB, *before.gameC);
+        load(afterPath, game, *after.gameA, *after.gameB, *after.gameC);
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    save_patch::Patch patch;
+    save_patch::append(patch, 0, before.gameA.get(), after.gameA.get());
+    save_patch::append(patch, 1, before.gameB.get(), after.gameB.get());
+    save_patch::append(patch, 2, before.gameC.get(), after.gameC.get());
+    std::vector<uint8_t> bytes = save_patch::encode(patch);
+    std::ofstream out(patchPath, std::ios::binary | std::ios::trunc);
+    if (!out.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()))) {
+        std::cerr << "Could not write " << patchPath.string() << "\n";
+        return 1;
+    }
+    std::cout << patchPath.string() << ": " << patch.hunks.size() << " hunks, " << bytes.size() << " bytes\n";
+    return 0;
+}
+
+int apply(int game, bool dryRun, const fs::path &pm3Path, const std::vector<fs::path> &patchPaths) {
+    std::vector<save_patch::Patch> patches(patchPaths.size());
+    for (std::size_t i = 0; i < patchPaths.size(); ++i) {
+        if (!readPatch(patchPaths[i], patches[i])) {
+            return 1;
+        }
+    }
+    try {
+        load(pm3Path, game, gameData, clubData, playerData);
+        if (game != 0 && !io::loadMetadata(pm3Path)) {
+            std::cerr << io::pm3LastError() << "\n";
+            return 1;
+        }
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    // Each patch sees the result of the ones before it, so a mod may build on another. Nothing is written unless
+    // all of them apply.
+    void *const files[save_patch::kFileCount] = {&gameData, &clubData, &playerData};
+    std::vector<dirty_tracker::Span> spans[save_patch::kFileCount];
+    for (std::size_t i = 0; i < patches.size(); ++i) {
+        save_patch::Outcome outcome = save_patch::apply(patches[i], files);
+        std::cout << patchPaths[i].string() << ": " << outcome.applied << " hunks applied";
+        if (outcome.alreadyApplied > 0) {
+            std::cout << ", " << outcome.alreadyApplied << " already applied";
+        }
+        std::cout << "\n";
+        if (!outcome.conflicts.empty()) {
+            for (const std::string &conflict : outcome.conflicts) {
+                std::cerr << "  conflict: " << conflict << " holds neither the old nor the new value\n";
+            }
+            std::cerr << "Nothing was written.\n";
+            return 1;
+        }
+        for (int f = 0; f < save_patch::kFileCount; ++f) {
+            spans[f].insert(spans[f].end(), outcome.spans[f].begin(), outcome.spans[f].end());
+        }
+    }
+
+    // Stacked patches can write the same bytes twice; merge their spans into one sorted list per file.
+    for (auto &fileSpans : spans) {
+        std::sort(fileSpans.begin(), fileSpans.end(),
+                  [](const dirty_tracker::Span &a, const dirty_tracker::Span &b) { return a.offset < b.offset; });
+        std::vector<dirty_tracker::Span> merged;
+        for (const auto &span : fileSpans) {
+            if (!merged.empty() && span.offset <= merged.back().offset + merged.back().length) {
+                merged.back().length = std::max(merged.back().length, span.offset + span.length - merged.back().offset);
+            } else {
+                merged.push_back(span);
+            }
+        }
+        fileSpans = std::move(merged);
+    }
+    if (dryRun || (spans[0].empty() && spans[1].empty() && spans[2].empty())) {
+        return 0;
+    }
+
+    try {
+        if (game == 0) {
+            if (!spans[0].empty()) {
+                io::saveDefaultGamedata(pm3Path, gameData);
+            }
+            if (!spans[1].empty()) {
+                io::saveDefaultClubdata(pm3Path, clubData);
+            }
+            if (!spans[2].empty()) {
+                io::saveDefaultPlaydata(pm3Path, playerData);
+            }
+        } else {
+            io::updateMetadata(game, pm3Path);
+            dirty_tracker::WriteReport report =
+                    io::commitSaveGame(game, pm3Path, gameData, clubData, playerData, savesDir, preferences, spans);
+            std::cout << "wrote " << report.total() << " bytes to game " << game << "\n";
+        }
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+// Lists the fields a patch touches. The patch only carries the changed bytes, so values are not shown.
+int show(const fs::path &patchPath) {
+    save_patch::Patch patch;
+    if (!readPatch(patchPath, patch)) {
+        return 1;
+    }
+    for (int f = 0; f < save_patch::kFileCount; ++f) {
+        const pm3_schema::Record &record = save_patch::recordFor(f);
+        std::vector<uint8_t> before(record.size);
+        std::vector<uint8_t> after(record.size);
+        std::size_t hunks = 0;
+        for (const save_patch::Hunk &hunk : patch.hunks) {
+            if (hunk.file == f) {
+                std::copy(hunk.before.begin(), hunk.before.end(), before.begin() + save_patch::absoluteOffset(hunk));
+                std::copy(hunk.after.begin(), hunk.after.end(), after.begin() + save_patch::absoluteOffset(hunk));
+                ++hunks;
+            }
+        }
+        if (hunks == 0) {
+            continue;
+        }
+        std::cout << "GAMEn" << static_cast<char>('A' + f) << " (" << hunks << " hunks)\n";
+        auto changes = save_diff::diff(record, before.data(), after.data());
+        for (const auto &group : save_diff::group(changes, record, after.data())) {
+            std::cout << "  " << group.name << (group.label.empty() ? "" : " " + group.label) << "\n";
+            for (const auto &change : group.changes) {
+                if (!change.path.empty()) {
+                    std::cout << "    " << change.path << "\n";
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    int game = 0;
+    bool dryRun = false;
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if ((a == "--game" || a == "-g") && i + 1 < argc) {
+            game = std::atoi(argv[++i]);
+            if (game < 1 || game > 8) {
+                printUsage();
+                return 1;
+            }
+        } else if (a == "--dry-run" || a == "-n") {
+            dryRun = true;
+        } else if (!a.empty() && a[0] != '-') {
+            args.push_back(a);
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (args.size() == 4 && args[0] == "create") {
+        return create(game, args[1], args[2], args[3]);
+    }
+    if (args.size() >= 3 && args[0] == "apply") {
+        return apply(game, dryRun, args[1], std::vector<fs::path>(args.begin() + 2, args.end()));
+    }
+    if (args.size() == 2 && args[0] == "show") {
+        return show(args[1]);
+    }
+    printUsage();
+    return 1;
+}
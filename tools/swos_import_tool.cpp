@@ -6,6 +6,7 @@
 #include <fstream>
 #include <iostream>
 #include <iterator>
+#include <memory>
 #include <optional>
 #include <string>
 #include <system_error>
@@ -141,13 +142,12 @@ int main(int argc, char **argv) {
         }
     }
 
+    auto state = std::make_unique<GameState>();
     try {
         if (args.baseData) {
-            io::loadDefaultGamedata(args.pm3Path, gameData); // read-only ordering reference
-            io::loadDefaultClubdata(args.pm3Path, clubData);
-            io::loadDefaultPlaydata(args.pm3Path, playerData);
+            io::loadDefaultData(args.pm3Path, *state);
         } else {
-            io::loadBinaries(args.gameNumber, args.pm3Path, gameData, clubData, playerData);
+            io::loadBinaries(args.gameNumber, args.pm3Path, *state);
         }
     } catch (const std::exception &ex) {
         std::cerr << "Failed to load data: " << ex.what() << "\n";
@@ -155,10 +155,10 @@ int main(int argc, char **argv) {
     }
 
     if (args.year != 0) {
-        gameData.year = args.year;
+        state->game.year = args.year;
     }
 
-    auto report = swos_import::importTeamsFromFile(args.teamFile, args.pm3Path, args.verbose);
+    auto report = swos_import::importTeamsFromFile(*state, args.teamFile, args.pm3Path, args.verbose);
     std::cout << "Imported " << report.teams_requested << " teams. "
               << "Matched: " << report.teams_matched
               << ", Created: " << report.teams_created
@@ -166,11 +166,9 @@ int main(int argc, char **argv) {
               << ", Players renamed: " << report.players_renamed << "\n";
 
     if (args.baseData) {
-        io::saveDefaultGamedata(args.pm3Path, gameData);
-        io::saveDefaultClubdata(args.pm3Path, clubData);
-        io::saveDefaultPlaydata(args.pm3Path, playerData);
+        io::saveDefaultData(args.pm3Path, *state);
     } else {
-        io::saveBinaries(args.gameNumber, args.pm3Path, gameData, clubData, playerData);
+        io::saveBinaries(args.gameNumber, args.pm3Path, *state);
     }
     return 0;
 }